@@ -32,6 +32,8 @@ inline constexpr char kProfilingPluginName[] = "dive_drawcall_metrics";
 // is the base path since GFXR can reliably write there.
 inline constexpr char kReplayStateLoadedSignalFile[] = "/sdcard/Download/replay_state_loaded";
 inline constexpr char kGpuTimingFile[] = "gpu_time.csv";  // produced by GFXR replay
+// Per-frame distributions of the GPU times, produced by GFXR replay next to kGpuTimingFile
+inline constexpr char kGpuTimingDistributionFile[] = "gpu_time_distribution.csv";
 inline constexpr char kCaptureScreenshotFile[] =
     "capture_screenshot.png";  // produced during GFXR capture
 
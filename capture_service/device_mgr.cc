@@ -1022,7 +1022,12 @@ absl::Status DeviceManager::RunReplayGfxrScript(const GfxrReplaySettings& settin
         std::string remote_gpu_time_path = absl::StrFormat(
             "%s/%s", parse_remote_capture.parent_path().string().c_str(), kGpuTimingFile);
 
+        std::string remote_gpu_time_distribution_path =
+            absl::StrFormat("%s/%s", parse_remote_capture.parent_path().string().c_str(),
+                            kGpuTimingDistributionFile);
+
         std::string gpu_time_csv_local_name = "";
+        std::string gpu_time_distribution_csv_local_name = "";
         {
             absl::StatusOr<Dive::ComponentFilePaths> ret = GetComponentFilesHostPaths(
                 settings.local_download_dir, parse_remote_capture.stem().string());
@@ -1031,6 +1036,8 @@ absl::Status DeviceManager::RunReplayGfxrScript(const GfxrReplaySettings& settin
                 return ret.status();
             }
             gpu_time_csv_local_name = ret->gpu_timing_csv.filename().string();
+            gpu_time_distribution_csv_local_name =
+                ret->gpu_timing_distribution_csv.filename().string();
         }
         if (absl::Status s =
                 m_device->RetrieveFile(remote_gpu_time_path, settings.local_download_dir,
@@ -1042,6 +1049,16 @@ absl::Status DeviceManager::RunReplayGfxrScript(const GfxrReplaySettings& settin
         }
         LOG(INFO) << "Gpu time file " << remote_gpu_time_path << " downloaded to "
                   << settings.local_download_dir;
+
+        // The distributions are supplementary, and are missing with older replay binaries.
+        if (absl::Status s = m_device->RetrieveFile(
+                remote_gpu_time_distribution_path, settings.local_download_dir,
+                /*delete_after_retrieve=*/true, gpu_time_distribution_csv_local_name);
+            !s.ok())
+        {
+            LOG(WARNING) << "Failed to download the gpu time distribution file "
+                         << remote_gpu_time_distribution_path << ": " << s.message();
+        }
     }
     else if (settings.run_type == GfxrReplayOptions::kRenderDoc)
     {
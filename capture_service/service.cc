@@ -24,6 +24,7 @@ limitations under the License.
 
 #include "absl/base/log_severity.h"
 #include "absl/log/log.h"
+#include "absl/synchronization/mutex.h"
 #include "constants.h"
 #include "dive/utils/device_resources_constants.h"
 #include "network/message_utils.h"
@@ -32,11 +33,24 @@ limitations under the License.
 namespace Dive
 {
 
+namespace
+{
+
+// The server handles several clients at once, while the trace manager runs one capture at a time.
+// Serializes the captures, so that each client gets the file of its own capture.
+ABSL_CONST_INIT absl::Mutex g_capture_mutex(absl::kConstInit);
+
+}  // namespace
+
 absl::Status StartPm4Capture(Network::SocketConnection* client_conn)
 {
-    GetTraceMgr().TriggerTrace();
-    GetTraceMgr().WaitForTraceDone();
-    std::string capture_file_path = GetTraceMgr().GetTraceFilePath();
+    std::string capture_file_path;
+    {
+        absl::MutexLock lock(&g_capture_mutex);
+        GetTraceMgr().TriggerTrace();
+        GetTraceMgr().WaitForTraceDone();
+        capture_file_path = GetTraceMgr().GetTraceFilePath();
+    }
 
     Network::Pm4CaptureResponse response;
     response.SetString(capture_file_path);
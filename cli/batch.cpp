@@ -0,0 +1,536 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include "batch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "dive_core/data_core.h"
+#include "dive_core/pm4_capture_data.h"
+#include "pm4_info.h"
+
+namespace Dive
+{
+namespace cli
+{
+
+namespace
+{
+
+const char* LoadResultToString(CaptureData::LoadResult result)
+{
+    switch (result)
+    {
+        case CaptureData::LoadResult::kSuccess:
+            return "success";
+        case CaptureData::LoadResult::kFileIoError:
+            return "file I/O error";
+        case CaptureData::LoadResult::kCorruptData:
+            return "corrupt data";
+        case CaptureData::LoadResult::kVersionError:
+            return "unsupported version";
+    }
+    return "unknown error";
+}
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+void WriteJsonString(std::ostream& out, std::string_view str)
+{
+    out << '"';
+    for (char c : str)
+    {
+        switch (c)
+        {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            case '\r':
+                out << "\\r";
+                break;
+            case '\t':
+                out << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+                    out << escaped;
+                }
+                else
+                {
+                    out << c;
+                }
+                break;
+        }
+    }
+    out << '"';
+}
+
+void WriteCsvString(std::ostream& out, std::string_view str)
+{
+    if (str.find_first_of(",\"\r\n") == std::string_view::npos)
+    {
+        out << str;
+        return;
+    }
+    out << '"';
+    for (char c : str)
+    {
+        out << c;
+        if (c == '"')
+        {
+            out << '"';
+        }
+    }
+    out << '"';
+}
+
+// Analyzes the captures of a batch with a bounded number of threads and memory.
+//
+// The PM4 register tables are selected by a process-wide GPU ID, which loading a capture sets. The
+// ID is atomic, so concurrent loads don't race, but a capture decoded while another one changes it
+// to another GPU is decoded with the wrong tables. The captures of a batch normally come from a
+// single GPU, in which case they are analyzed concurrently. A capture from another GPU, and any
+// capture analyzed while it was loaded, are analyzed again one by one at the end.
+class BatchRunner
+{
+ public:
+    BatchRunner(const std::vector<std::string>& captures, unsigned int jobs,
+                uint64_t max_memory_bytes);
+
+    std::vector<BatchResult> Run();
+
+ private:
+    // Range of tickets during which a capture was analyzed, to find the captures that overlapped
+    struct Span
+    {
+        uint64_t m_begin = 0;
+        uint64_t m_end = 0;
+        bool m_other_gpu = false;
+    };
+
+    void WorkerImpl();
+
+    // Returns false if the capture was loaded but comes from another GPU than the batch, and must
+    // be analyzed again on its own.
+    bool AnalyzeCapture(size_t index, bool concurrent);
+
+    bool IsBatchGpu(uint32_t gpu_id);
+
+    void AcquireMemory(uint64_t size);
+    void ReleaseMemory(uint64_t size);
+
+    const std::vector<std::string>& m_captures;
+    const unsigned int m_jobs;
+    const uint64_t m_max_memory_bytes;
+
+    std::vector<BatchResult> m_results;
+    std::vector<Span> m_spans;
+    std::atomic<size_t> m_next_index = 0;
+    std::atomic<uint64_t> m_next_ticket = 0;
+
+    std::mutex m_gpu_mutex;
+    uint32_t m_gpu_id = 0;
+
+    std::mutex m_memory_mutex;
+    std::condition_variable m_memory_condition;
+    uint64_t m_memory_in_use = 0;
+};
+
+//--------------------------------------------------------------------------------------------------
+BatchRunner::BatchRunner(const std::vector<std::string>& captures, unsigned int jobs,
+                         uint64_t max_memory_bytes)
+    : m_captures(captures), m_jobs(jobs), m_max_memory_bytes(max_memory_bytes)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+std::vector<BatchResult> BatchRunner::Run()
+{
+    m_results.assign(m_captures.size(), BatchResult());
+    m_spans.assign(m_captures.size(), Span());
+
+    std::vector<std::thread> workers;
+    const size_t worker_count = std::min<size_t>(m_jobs, m_captures.size());
+    for (size_t i = 0; i < worker_count; ++i)
+    {
+        workers.emplace_back([this]() { WorkerImpl(); });
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    for (size_t i = 0; i < m_captures.size(); ++i)
+    {
+        bool rerun = m_spans[i].m_other_gpu;
+        for (size_t j = 0; j < m_captures.size() && !rerun; ++j)
+        {
+            rerun = m_spans[j].m_other_gpu && m_spans[i].m_begin < m_spans[j].m_end &&
+                    m_spans[j].m_begin < m_spans[i].m_end;
+        }
+        if (rerun)
+        {
+            // A capture without a GPU ID of its own is decoded with the ID of the batch, rather
+            // than with the one the previous rerun left behind.
+            SetGPUID(m_gpu_id);
+            AnalyzeCapture(i, /*concurrent=*/false);
+        }
+    }
+    return std::move(m_results);
+}
+
+//--------------------------------------------------------------------------------------------------
+void BatchRunner::WorkerImpl()
+{
+    for (size_t index = m_next_index++; index < m_captures.size(); index = m_next_index++)
+    {
+        std::error_code error;
+        uint64_t file_size = std::filesystem::file_size(m_captures[index], error);
+        if (error)
+        {
+            file_size = 0;
+        }
+
+        AcquireMemory(file_size);
+        Span& span = m_spans[index];
+        span.m_begin = m_next_ticket++;
+        span.m_other_gpu = !AnalyzeCapture(index, /*concurrent=*/true);
+        span.m_end = m_next_ticket++;
+        ReleaseMemory(file_size);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+bool BatchRunner::AnalyzeCapture(size_t index, bool concurrent)
+{
+    BatchResult& result = m_results[index];
+    result = BatchResult();
+    result.m_file = m_captures[index];
+
+    std::error_code error;
+    const uintmax_t file_size = std::filesystem::file_size(result.m_file, error);
+    if (error)
+    {
+        result.m_error = error.message();
+        return true;
+    }
+    result.m_file_size = file_size;
+
+    const auto load_start = std::chrono::steady_clock::now();
+    auto data_core = std::make_unique<DataCore>();
+    CaptureData::LoadResult load_result = data_core->LoadPm4CaptureData(result.m_file);
+    result.m_gpu_id = data_core->GetPm4CaptureData().GetGPUID();
+    if (concurrent && !IsBatchGpu(result.m_gpu_id))
+    {
+        result.m_error = "analyzed concurrently with a capture from another GPU";
+        return false;
+    }
+    result.m_load_ms = MillisecondsSince(load_start);
+    if (load_result != CaptureData::LoadResult::kSuccess)
+    {
+        result.m_error = LoadResultToString(load_result);
+        return true;
+    }
+
+    const auto analyze_start = std::chrono::steady_clock::now();
+    if (!data_core->CreatePm4MetaData())
+    {
+        result.m_error = "failed to create metadata";
+        return true;
+    }
+    const CaptureMetadata& meta_data = data_core->GetCaptureMetadata();
+    result.m_num_submits = data_core->GetPm4CaptureData().GetNumSubmits();
+    result.m_num_pm4_packets = meta_data.m_num_pm4_packets;
+    result.m_num_events = meta_data.m_event_info.size();
+    for (const EventInfo& info : meta_data.m_event_info)
+    {
+        result.m_num_draws += (info.m_type == Util::EventType::kDraw);
+        result.m_num_dispatches += (info.m_type == Util::EventType::kDispatch);
+    }
+    result.m_num_shaders = meta_data.m_shaders.size();
+    result.m_analyze_ms = MillisecondsSince(analyze_start);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool BatchRunner::IsBatchGpu(uint32_t gpu_id)
+{
+    // Captures without a GPU ID don't change the process-wide one.
+    if (gpu_id == 0)
+    {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(m_gpu_mutex);
+    if (m_gpu_id == 0)
+    {
+        m_gpu_id = gpu_id;
+    }
+    if (gpu_id == m_gpu_id)
+    {
+        return true;
+    }
+    // Restores the GPU ID of the batch for the captures that are loaded after this one.
+    SetGPUID(m_gpu_id);
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+void BatchRunner::AcquireMemory(uint64_t size)
+{
+    if (m_max_memory_bytes == 0)
+    {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m_memory_mutex);
+    m_memory_condition.wait(lock, [this, size]() {
+        return m_memory_in_use == 0 || m_memory_in_use + size <= m_max_memory_bytes;
+    });
+    m_memory_in_use += size;
+}
+
+//--------------------------------------------------------------------------------------------------
+void BatchRunner::ReleaseMemory(uint64_t size)
+{
+    if (m_max_memory_bytes == 0)
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_memory_mutex);
+        m_memory_in_use -= size;
+    }
+    m_memory_condition.notify_all();
+}
+
+}  // namespace
+
+//--------------------------------------------------------------------------------------------------
+bool MatchWildcard(std::string_view pattern, std::string_view name)
+{
+    // Greedy matching that backtracks to the last `*` on a mismatch.
+    size_t p = 0;
+    size_t n = 0;
+    size_t star = std::string_view::npos;
+    size_t star_n = 0;
+    while (n < name.size())
+    {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n]))
+        {
+            ++p;
+            ++n;
+        }
+        else if (p < pattern.size() && pattern[p] == '*')
+        {
+            star = p++;
+            star_n = n;
+        }
+        else if (star != std::string_view::npos)
+        {
+            p = star + 1;
+            n = ++star_n;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*')
+    {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+//--------------------------------------------------------------------------------------------------
+bool ExpandBatchInputs(const BatchOptions& options, std::vector<std::string>& captures,
+                       std::ostream& err)
+{
+    for (const std::string& manifest : options.m_manifests)
+    {
+        std::ifstream manifest_file(manifest);
+        if (!manifest_file.is_open())
+        {
+            err << "Can't read manifest " << manifest << std::endl;
+            return false;
+        }
+        // Relative paths are relative to the manifest.
+        const std::filesystem::path manifest_dir = std::filesystem::path(manifest).parent_path();
+        for (std::string line; std::getline(manifest_file, line);)
+        {
+            const size_t begin = line.find_first_not_of(" \t\r");
+            if (begin == std::string::npos || line[begin] == '#')
+            {
+                continue;
+            }
+            const size_t end = line.find_last_not_of(" \t\r") + 1;
+            const std::filesystem::path path = line.substr(begin, end - begin);
+            captures.push_back((path.is_relative() ? manifest_dir / path : path).string());
+        }
+    }
+
+    for (const std::string& input : options.m_inputs)
+    {
+        const std::filesystem::path path(input);
+        const std::string pattern = path.filename().string();
+        if (pattern.find_first_of("*?") == std::string::npos)
+        {
+            captures.push_back(input);
+            continue;
+        }
+
+        const std::filesystem::path dir = path.has_parent_path() ? path.parent_path() : ".";
+        std::vector<std::string> matches;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(dir, error))
+        {
+            if (entry.is_regular_file() && MatchWildcard(pattern, entry.path().filename().string()))
+            {
+                matches.push_back(entry.path().string());
+            }
+        }
+        if (error)
+        {
+            err << "Can't list " << dir.string() << ": " << error.message() << std::endl;
+            return false;
+        }
+        if (matches.empty())
+        {
+            err << "No capture matches " << input << std::endl;
+            return false;
+        }
+        std::sort(matches.begin(), matches.end());
+        captures.insert(captures.end(), matches.begin(), matches.end());
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void WriteBatchReport(const std::vector<BatchResult>& results, BatchReportFormat format,
+                      std::ostream& out)
+{
+    const std::ios_base::fmtflags out_flags = out.flags();
+    out << std::fixed << std::setprecision(3);
+    if (format == BatchReportFormat::kCsv)
+    {
+        out << "file,status,error,file_size,gpu_id,submits,pm4_packets,events,draws,dispatches,"
+               "shaders,load_ms,analyze_ms\n";
+    }
+    for (const BatchResult& result : results)
+    {
+        const char* status = result.m_error.empty() ? "ok" : "error";
+        if (format == BatchReportFormat::kCsv)
+        {
+            WriteCsvString(out, result.m_file);
+            out << "," << status << ",";
+            WriteCsvString(out, result.m_error);
+            out << "," << result.m_file_size << "," << result.m_gpu_id << ","
+                << result.m_num_submits << "," << result.m_num_pm4_packets << ","
+                << result.m_num_events << "," << result.m_num_draws << ","
+                << result.m_num_dispatches << "," << result.m_num_shaders << ","
+                << result.m_load_ms << "," << result.m_analyze_ms << "\n";
+        }
+        else
+        {
+            out << "{\"file\":";
+            WriteJsonString(out, result.m_file);
+            out << ",\"status\":\"" << status << "\"";
+            if (!result.m_error.empty())
+            {
+                out << ",\"error\":";
+                WriteJsonString(out, result.m_error);
+            }
+            out << ",\"file_size\":" << result.m_file_size << ",\"gpu_id\":" << result.m_gpu_id
+                << ",\"submits\":" << result.m_num_submits
+                << ",\"pm4_packets\":" << result.m_num_pm4_packets
+                << ",\"events\":" << result.m_num_events << ",\"draws\":" << result.m_num_draws
+                << ",\"dispatches\":" << result.m_num_dispatches
+                << ",\"shaders\":" << result.m_num_shaders << ",\"load_ms\":" << result.m_load_ms
+                << ",\"analyze_ms\":" << result.m_analyze_ms << "}\n";
+        }
+    }
+    out.flags(out_flags);
+}
+
+//--------------------------------------------------------------------------------------------------
+int RunBatch(const BatchOptions& options)
+{
+    std::vector<std::string> captures;
+    if (!ExpandBatchInputs(options, captures, std::cerr))
+    {
+        return EXIT_FAILURE;
+    }
+    if (captures.empty())
+    {
+        std::cerr << "No capture to analyze" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream output_file;
+    if (!options.m_output.empty())
+    {
+        output_file.open(options.m_output);
+        if (!output_file.is_open())
+        {
+            std::cerr << "Can't write " << options.m_output << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    const unsigned int jobs = options.m_jobs != 0 ?
+                                  options.m_jobs :
+                                  std::max(1u, std::thread::hardware_concurrency());
+    BatchRunner runner(captures, jobs, options.m_max_memory_bytes);
+    const std::vector<BatchResult> results = runner.Run();
+
+    WriteBatchReport(results, options.m_format, output_file.is_open() ? output_file : std::cout);
+
+    const size_t failed_count = std::count_if(results.begin(), results.end(),
+                                              [](const BatchResult& result) {
+                                                  return !result.m_error.empty();
+                                              });
+    std::cerr << "Analyzed " << results.size() - failed_count << " of " << results.size()
+              << " captures" << std::endl;
+    return failed_count == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace cli
+}  // namespace Dive
@@ -0,0 +1,88 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Dive
+{
+namespace cli
+{
+
+enum class BatchReportFormat
+{
+    kJsonLines,
+    kCsv
+};
+
+struct BatchOptions
+{
+    // Capture files, or patterns with `*` and `?` wildcards in the file name, e.g. `captures/*.rd`
+    std::vector<std::string> m_inputs;
+    // Files listing one capture per line. Empty lines and lines starting with '#' are ignored.
+    std::vector<std::string> m_manifests;
+    // Report file name, or empty for the standard output
+    std::string m_output;
+    BatchReportFormat m_format = BatchReportFormat::kJsonLines;
+    // Maximum number of captures analyzed at the same time, or 0 for one per hardware thread
+    unsigned int m_jobs = 0;
+    // Maximum total size of the capture files analyzed at the same time, or 0 for no limit. A
+    // capture larger than the limit is analyzed on its own.
+    uint64_t m_max_memory_bytes = 0;
+};
+
+// Summary of one capture of the batch
+struct BatchResult
+{
+    std::string m_file;
+    // Empty if the capture was analyzed
+    std::string m_error;
+    uint64_t m_file_size = 0;
+    uint32_t m_gpu_id = 0;
+    uint64_t m_num_submits = 0;
+    uint64_t m_num_pm4_packets = 0;
+    uint64_t m_num_events = 0;
+    uint64_t m_num_draws = 0;
+    uint64_t m_num_dispatches = 0;
+    uint64_t m_num_shaders = 0;
+    double m_load_ms = 0;
+    double m_analyze_ms = 0;
+};
+
+// Whether `name` matches `pattern`, where `*` matches any sequence of characters and `?` any
+// single character
+bool MatchWildcard(std::string_view pattern, std::string_view name);
+
+// Expands the inputs and manifests of `options` into the list of captures. Captures matching a
+// pattern are sorted by name. Returns false, after reporting the error to `err`, if a manifest
+// can't be read or an input matches no capture.
+bool ExpandBatchInputs(const BatchOptions& options, std::vector<std::string>& captures,
+                       std::ostream& err);
+
+void WriteBatchReport(const std::vector<BatchResult>& results, BatchReportFormat format,
+                      std::ostream& out);
+
+// Analyzes the captures of `options` concurrently and writes one report line per capture, in input
+// order. Returns EXIT_SUCCESS if all the captures were analyzed.
+int RunBatch(const BatchOptions& options);
+
+}  // namespace cli
+}  // namespace Dive
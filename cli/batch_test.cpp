@@ -0,0 +1,175 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include "batch.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Dive::cli
+{
+namespace
+{
+
+TEST(BatchTest, MatchWildcard)
+{
+    EXPECT_TRUE(MatchWildcard("*.rd", "capture.rd"));
+    EXPECT_TRUE(MatchWildcard("*.rd", ".rd"));
+    EXPECT_FALSE(MatchWildcard("*.rd", "capture.rd.bak"));
+    EXPECT_TRUE(MatchWildcard("capture_?.rd", "capture_1.rd"));
+    EXPECT_FALSE(MatchWildcard("capture_?.rd", "capture_.rd"));
+    EXPECT_FALSE(MatchWildcard("capture_?.rd", "capture_12.rd"));
+    EXPECT_TRUE(MatchWildcard("a*b*c", "aXbYbZc"));
+    EXPECT_FALSE(MatchWildcard("a*b*c", "aXbYbZ"));
+    EXPECT_TRUE(MatchWildcard("*", ""));
+    EXPECT_TRUE(MatchWildcard("", ""));
+    EXPECT_FALSE(MatchWildcard("", "a"));
+}
+
+class ExpandBatchInputsTest : public testing::Test
+{
+ protected:
+    void SetUp() override
+    {
+        m_directory = std::filesystem::path(testing::TempDir()) /
+                      testing::UnitTest::GetInstance()->current_test_info()->name();
+        std::filesystem::remove_all(m_directory);
+        std::filesystem::create_directories(m_directory);
+    }
+    void TearDown() override { std::filesystem::remove_all(m_directory); }
+
+    std::string CreateFile(const std::string& name, const std::string& contents = "")
+    {
+        const std::filesystem::path path = m_directory / name;
+        std::ofstream(path, std::ios::binary) << contents;
+        return path.string();
+    }
+
+    std::filesystem::path m_directory;
+};
+
+TEST_F(ExpandBatchInputsTest, ExpandsPatternsInNameOrder)
+{
+    const std::string b = CreateFile("b.rd");
+    const std::string a = CreateFile("a.rd");
+    CreateFile("c.txt");
+    std::filesystem::create_directories(m_directory / "d.rd");
+
+    BatchOptions options;
+    options.m_inputs = {(m_directory / "*.rd").string(), "missing_but_explicit.rd"};
+    std::vector<std::string> captures;
+    std::ostringstream err;
+    ASSERT_TRUE(ExpandBatchInputs(options, captures, err)) << err.str();
+    EXPECT_EQ(captures, (std::vector<std::string>{a, b, "missing_but_explicit.rd"}));
+}
+
+TEST_F(ExpandBatchInputsTest, ReadsManifests)
+{
+    const std::string manifest = CreateFile("captures.txt",
+                                            "# comment\n"
+                                            "\n"
+                                            "  relative.rd \r\n"
+                                            "/absolute/capture.rd\n");
+
+    BatchOptions options;
+    options.m_manifests = {manifest};
+    std::vector<std::string> captures;
+    std::ostringstream err;
+    ASSERT_TRUE(ExpandBatchInputs(options, captures, err)) << err.str();
+    EXPECT_EQ(captures,
+              (std::vector<std::string>{(m_directory / "relative.rd").string(),
+                                        std::filesystem::path("/absolute/capture.rd").string()}));
+}
+
+TEST_F(ExpandBatchInputsTest, FailsOnUnmatchedPatternOrMissingManifest)
+{
+    CreateFile("a.txt");
+
+    BatchOptions options;
+    options.m_inputs = {(m_directory / "*.rd").string()};
+    std::vector<std::string> captures;
+    std::ostringstream err;
+    EXPECT_FALSE(ExpandBatchInputs(options, captures, err));
+    EXPECT_NE(err.str().find("No capture matches"), std::string::npos);
+
+    options = BatchOptions();
+    options.m_manifests = {(m_directory / "missing.txt").string()};
+    err.str("");
+    EXPECT_FALSE(ExpandBatchInputs(options, captures, err));
+    EXPECT_NE(err.str().find("Can't read manifest"), std::string::npos);
+}
+
+std::vector<BatchResult> MakeResults()
+{
+    BatchResult ok;
+    ok.m_file = "a.rd";
+    ok.m_file_size = 100;
+    ok.m_gpu_id = 730;
+    ok.m_num_submits = 1;
+    ok.m_num_pm4_packets = 2;
+    ok.m_num_events = 3;
+    ok.m_num_draws = 4;
+    ok.m_num_dispatches = 5;
+    ok.m_num_shaders = 6;
+    ok.m_load_ms = 1.5;
+    ok.m_analyze_ms = 0.25;
+
+    BatchResult failed;
+    failed.m_file = "b,\"c\".rd";
+    failed.m_error = "corrupt\ndata";
+    return {ok, failed};
+}
+
+TEST(BatchTest, WriteBatchReportJsonLines)
+{
+    std::ostringstream out;
+    WriteBatchReport(MakeResults(), BatchReportFormat::kJsonLines, out);
+    EXPECT_EQ(out.str(),
+              "{\"file\":\"a.rd\",\"status\":\"ok\",\"file_size\":100,\"gpu_id\":730,"
+              "\"submits\":1,\"pm4_packets\":2,\"events\":3,\"draws\":4,\"dispatches\":5,"
+              "\"shaders\":6,\"load_ms\":1.500,\"analyze_ms\":0.250}\n"
+              "{\"file\":\"b,\\\"c\\\".rd\",\"status\":\"error\",\"error\":\"corrupt\\ndata\","
+              "\"file_size\":0,\"gpu_id\":0,\"submits\":0,\"pm4_packets\":0,\"events\":0,"
+              "\"draws\":0,\"dispatches\":0,\"shaders\":0,\"load_ms\":0.000,"
+              "\"analyze_ms\":0.000}\n");
+}
+
+TEST(BatchTest, WriteBatchReportCsv)
+{
+    std::ostringstream out;
+    WriteBatchReport(MakeResults(), BatchReportFormat::kCsv, out);
+    EXPECT_EQ(out.str(),
+              "file,status,error,file_size,gpu_id,submits,pm4_packets,events,draws,dispatches,"
+              "shaders,load_ms,analyze_ms\n"
+              "a.rd,ok,,100,730,1,2,3,4,5,6,1.500,0.250\n"
+              "\"b,\"\"c\"\".rd\",error,\"corrupt\ndata\",0,0,0,0,0,0,0,0,0.000,0.000\n");
+}
+
+TEST(BatchTest, WriteBatchReportRestoresStreamFlags)
+{
+    std::ostringstream out;
+    WriteBatchReport({}, BatchReportFormat::kJsonLines, out);
+    out << 0.5;
+    EXPECT_EQ(out.str(), "0.5");
+}
+
+}  // namespace
+}  // namespace Dive::cli
@@ -23,6 +23,7 @@
 #include <map>
 #include <string>
 
+#include "batch.h"
 #include "format_output.h"
 #include "utils/version_info.h"
 
@@ -200,6 +201,100 @@ int ExtractCommand::Help(int argc, int at, char** argv) const
 
 std::string ExtractCommand::Description() const { return "extract the content of a dive file"; }
 
+//--------------------------------------------------------------------------------------------------
+struct BatchCommand : Command
+{
+    BatchCommand();
+    int operator()(int argc, int at, char** argv) const override;
+    int Help(int argc, int at, char** argv) const override;
+    std::string Description() const override;
+};
+
+BatchCommand::BatchCommand() : Command("batch", kNormal) {}
+
+int BatchCommand::operator()(int argc, int at, char** argv) const
+{
+    BatchOptions options;
+    bool format_set = false;
+    for (int i = at + 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if ((arg == "-o" || arg == "--output") && has_value)
+        {
+            options.m_output = argv[++i];
+        }
+        else if ((arg == "-m" || arg == "--manifest") && has_value)
+        {
+            options.m_manifests.push_back(argv[++i]);
+        }
+        else if ((arg == "-j" || arg == "--jobs") && has_value)
+        {
+            options.m_jobs = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--max-memory" && has_value)
+        {
+            options.m_max_memory_bytes = strtoull(argv[++i], nullptr, 10) * 1024 * 1024;
+        }
+        else if (arg == "--format" && has_value)
+        {
+            const std::string format = argv[++i];
+            if (format != "jsonl" && format != "csv")
+            {
+                std::cerr << "Unknown report format " << format << std::endl;
+                Help(argc, at, argv);
+                return EXIT_FAILURE;
+            }
+            options.m_format =
+                (format == "csv" ? BatchReportFormat::kCsv : BatchReportFormat::kJsonLines);
+            format_set = true;
+        }
+        else if (!arg.empty() && arg[0] == '-')
+        {
+            Help(argc, at, argv);
+            return EXIT_FAILURE;
+        }
+        else
+        {
+            options.m_inputs.push_back(arg);
+        }
+    }
+    if (options.m_inputs.empty() && options.m_manifests.empty())
+    {
+        Help(argc, at, argv);
+        return EXIT_FAILURE;
+    }
+    if (!format_set && std::filesystem::path(options.m_output).extension() == ".csv")
+    {
+        options.m_format = BatchReportFormat::kCsv;
+    }
+    return RunBatch(options);
+}
+
+int BatchCommand::Help(int argc, int at, char** argv) const
+{
+    std::cout << "usage: " << ProgramName(argv[0]) << " " << GetName()
+              << " [options] [-m <manifest>]... [<capture|pattern>]..." << std::endl;
+    std::cout << "  -m,--manifest <file>: file listing one capture per line" << std::endl;
+    std::cout << "  -o,--output <file>: report file, standard output by default" << std::endl;
+    std::cout << "  --format <jsonl|csv>: report format, from the report file extension by "
+                 "default"
+              << std::endl;
+    std::cout << "  -j,--jobs <n>: captures analyzed at the same time, one per hardware thread "
+                 "by default"
+              << std::endl;
+    std::cout << "  --max-memory <MiB>: limit on the total size of the captures analyzed at the "
+                 "same time"
+              << std::endl;
+    std::cout << "Patterns can use * and ? in the file name, e.g. \"captures/*.rd\"." << std::endl;
+    return EXIT_SUCCESS;
+}
+
+std::string BatchCommand::Description() const
+{
+    return "analyze many captures and write a merged report";
+}
+
 //--------------------------------------------------------------------------------------------------
 struct PacketCommand : Command
 {
@@ -443,6 +538,7 @@ const Command& CommandOf<T>::Get()
 
 template const Command& CommandOf<VersionCommand>::Get();
 template const Command& CommandOf<ExtractCommand>::Get();
+template const Command& CommandOf<BatchCommand>::Get();
 template const Command& CommandOf<PacketCommand>::Get();
 template const Command& CommandOf<InfoCommand>::Get();
 template const Command& CommandOf<RawPM4Command>::Get();
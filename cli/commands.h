@@ -57,6 +57,7 @@ class Command
 struct HelpCommand;
 struct VersionCommand;
 struct ExtractCommand;
+struct BatchCommand;
 
 // Internal utilities, originally from capture_reporter.
 // Hiding from user as they are not intended for normal end user flow.
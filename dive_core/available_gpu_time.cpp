@@ -17,13 +17,16 @@
 #include "dive_core/available_gpu_time.h"
 
 #include <filesystem>
-#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "utils/csv_reader.h"
+
 namespace Dive
 {
 
@@ -133,14 +136,14 @@ bool AvailableGpuTiming::LoadFromCsv(const std::filesystem::path& file_path)
         return false;
     }
 
-    std::ifstream file(file_path);
-    if (!file.is_open())
+    MappedFile file;
+    if (!file.Open(file_path))
     {
         std::cerr << "Failed to open file: " << file_path << std::endl;
         return false;
     }
 
-    if (!LoadFromStream(file))
+    if (!LoadFromData(file.GetContents()))
     {
         return false;
     }
@@ -158,8 +161,7 @@ bool AvailableGpuTiming::LoadFromString(const std::string& full_text)
     }
     m_loaded = true;
 
-    std::stringstream ss(full_text);
-    if (!LoadFromStream(ss))
+    if (!LoadFromData(full_text))
     {
         return false;
     }
@@ -168,42 +170,29 @@ bool AvailableGpuTiming::LoadFromString(const std::string& full_text)
     return IsValid();
 }
 
-bool AvailableGpuTiming::LoadFromStream(std::istream& stream)
+bool AvailableGpuTiming::LoadFromData(std::string_view data)
 {
-    std::string line;
+    CsvReader reader(data);
+    std::vector<std::string_view> fields;
     uint32_t row = 0;
-    while (std::getline(stream, line))
+    size_t line_start = reader.GetOffset();
+    while (reader.ReadRecord(fields))
     {
-        if (line.empty())
-        {
-            continue;
-        }
-        if (!LoadLine(row, line))
+        if (!LoadLine(row, fields))
         {
+            std::string_view line = data.substr(line_start, reader.GetOffset() - line_start);
             std::cerr << "Could not parse row (" << row << ") line: " << line << std::endl;
             return false;
         }
+        line_start = reader.GetOffset();
         row++;
     }
     return true;
 }
 
-bool AvailableGpuTiming::LoadLine(uint32_t row, const std::string& line)
+bool AvailableGpuTiming::LoadLine(uint32_t row, std::span<const std::string_view> fields)
 {
-    std::stringstream ss(line);
-    std::string field;
-    std::vector<std::string> fields;
-    while (std::getline(ss, field, ','))
-    {
-        fields.push_back(field);
-    }
-
-    if (fields.size() == 0)
-    {
-        return true;
-    }
-
-    if (fields.size() != GetColumns())
+    if (fields.size() != static_cast<size_t>(GetColumns()))
     {
         std::cerr << "Unexpected number of columns: " << fields.size() << std::endl;
         return false;
@@ -223,48 +212,31 @@ bool AvailableGpuTiming::LoadLine(uint32_t row, const std::string& line)
         return true;
     }
 
-    // TODO(b/443122531): Improve integer and float parsing here, this has edge cases that aren't
-    // covered
     uint32_t id = 0;
     Stats stats{};
-    try
-    {
-        id = static_cast<uint32_t>(std::stoi(fields[1]));
-        stats.mean_ms = std::stof(fields[2]);
-        stats.median_ms = std::stof(fields[3]);
-    }
-    catch (const std::invalid_argument& e)
-    {
-        std::cerr << "Caught invalid_argument exception: " << e.what() << std::endl;
-        return false;
-    }
-    catch (const std::out_of_range& e)
-    {
-        std::cerr << "Caught out_of_range exception: " << e.what() << std::endl;
-        return false;
-    }
-
-    if (fields[1].find('.') != std::string::npos)
+    if (!ParseCsvNumber(fields[1], id))
     {
-        std::cerr << "Expecting an integer id, not float: " << fields[1] << std::endl;
+        std::cerr << "Expecting an integer id: " << fields[1] << std::endl;
         return false;
     }
-    if ((fields[2].find('.') == std::string::npos))
+    if (!ParseCsvNumber(fields[2], stats.mean_ms) ||
+        (fields[2].find('.') == std::string_view::npos))
     {
-        std::cerr << "Expecting a float mean, not integer: " << fields[2] << std::endl;
+        std::cerr << "Expecting a float mean: " << fields[2] << std::endl;
         return false;
     }
-    if ((fields[3].find('.') == std::string::npos))
+    if (!ParseCsvNumber(fields[3], stats.median_ms) ||
+        (fields[3].find('.') == std::string_view::npos))
     {
-        std::cerr << "Expecting a float median, not integer: " << fields[3] << std::endl;
+        std::cerr << "Expecting a float median: " << fields[3] << std::endl;
         return false;
     }
 
     Entry entry{};
-    ObjectType object_type = GetObjectType(fields[0]);
+    ObjectType object_type = GetObjectType(std::string(fields[0]));
     if (object_type == ObjectType::nObjectTypes)
     {
-        std::cerr << "Expecting a float median, not integer: " << fields[3] << std::endl;
+        std::cerr << "Unexpected object type: " << fields[0] << std::endl;
         return false;
     }
 
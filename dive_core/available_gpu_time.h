@@ -18,7 +18,9 @@
 
 #include <filesystem>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace Dive
@@ -120,11 +122,11 @@ class AvailableGpuTiming
     int GetColumns() const { return static_cast<int>(ColumnType::nColumnTypes); }
 
  private:
-    // Load statistics from stream
-    bool LoadFromStream(std::istream& stream);
+    // Load statistics from the CSV contents of a file or string
+    bool LoadFromData(std::string_view data);
 
-    // Load statistics from non-header CSV row
-    bool LoadLine(uint32_t row, const std::string& line);
+    // Load statistics from a CSV row, or check the header if `row` is 0
+    bool LoadLine(uint32_t row, std::span<const std::string_view> fields);
 
     // Check m_ordered_entries against info stored in *_stats members
     void Validate();
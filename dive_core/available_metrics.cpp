@@ -124,6 +124,18 @@ const MetricInfo* AvailableMetrics::GetMetricInfo(const std::string& key) const
     return nullptr;
 }
 
+const MetricInfo* AvailableMetrics::GetMetricInfoById(uint32_t metric_id) const
+{
+    for (const auto& [key, info] : m_metrics)
+    {
+        if (info.m_metric_id == metric_id)
+        {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
 MetricType AvailableMetrics::GetMetricType(const std::string& key) const
 {
     const MetricInfo* info = GetMetricInfo(key);
@@ -57,6 +57,9 @@ class AvailableMetrics
     // Get the metric info for a given key
     const MetricInfo* GetMetricInfo(const std::string& key) const;
 
+    // Get the metric info for a given metric id
+    const MetricInfo* GetMetricInfoById(uint32_t metric_id) const;
+
     // Get the metric type for a given key, return kUnknown if not found.
     MetricType GetMetricType(const std::string& key) const;
 
@@ -128,6 +128,37 @@ void Topology::AddChildren(uint64_t node_index, const DiveVector<uint64_t>& chil
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+void Topology::InsertChildren(uint64_t node_index, const DiveVector<uint64_t>& children)
+{
+    DIVE_ASSERT(node_index < m_node_children.size());
+    if (children.empty()) return;
+
+    // The existing children cannot be moved in place without shifting the children of every later
+    // node, so the node gets a new range at the end of m_children_list
+    ChildrenInfo old_info = m_node_children[node_index];
+    uint64_t num_old_children = old_info.m_num_children;
+    uint64_t prev_size = m_children_list.size();
+    m_children_list.resize(prev_size + children.size() + num_old_children);
+    std::copy(children.begin(), children.end(), m_children_list.begin() + prev_size);
+    for (uint64_t i = 0; i < num_old_children; ++i)
+    {
+        m_children_list[prev_size + children.size() + i] =
+            m_children_list[old_info.m_start_index + i];
+    }
+    m_node_children[node_index].m_start_index = prev_size;
+    m_node_children[node_index].m_num_children = children.size() + num_old_children;
+
+    for (uint64_t i = 0; i < children.size() + num_old_children; ++i)
+    {
+        uint64_t child_node_index = m_children_list[prev_size + i];
+        DIVE_ASSERT(child_node_index < m_node_children.size());
+        DIVE_ASSERT(i >= children.size() || m_node_parent[child_node_index] == UINT64_MAX);
+        m_node_parent[child_node_index] = node_index;
+        m_node_child_index[child_node_index] = i;
+    }
+}
+
 // =================================================================================================
 // SharedNodeTopology
 // =================================================================================================
@@ -214,6 +245,12 @@ CommandHierarchy::CommandHierarchy() {}
 //--------------------------------------------------------------------------------------------------
 CommandHierarchy::~CommandHierarchy() {}
 
+//--------------------------------------------------------------------------------------------------
+CommandHierarchy::CommandHierarchy(CommandHierarchy&&) = default;
+
+//--------------------------------------------------------------------------------------------------
+CommandHierarchy& CommandHierarchy::operator=(CommandHierarchy&&) = default;
+
 //--------------------------------------------------------------------------------------------------
 const SharedNodeTopology& CommandHierarchy::GetSubmitHierarchyTopology() const
 {
@@ -394,6 +431,61 @@ uint64_t CommandHierarchy::AddGfxrNode(NodeType type, std::string&& desc)
     return m_nodes.AddGfxrNode(type, std::move(desc));
 }
 
+//--------------------------------------------------------------------------------------------------
+uint64_t CommandHierarchy::GetNumPendingChildren(uint64_t node_index) const
+{
+    if (!m_pending_children_source) return 0;
+    return m_pending_children_source->GetNumPendingChildren(node_index);
+}
+
+//--------------------------------------------------------------------------------------------------
+bool CommandHierarchy::PendingChildrenContain(uint64_t node_index, std::string_view text) const
+{
+    if (!m_pending_children_source) return false;
+    return m_pending_children_source->PendingChildrenContain(node_index, text);
+}
+
+//--------------------------------------------------------------------------------------------------
+void CommandHierarchy::ExpandNode(uint64_t node_index)
+{
+    if (GetNumPendingChildren(node_index) == 0) return;
+
+    DiveVector<PendingNode> pending_nodes =
+        m_pending_children_source->TakePendingChildren(node_index);
+
+    // Children of the expanded node, then children of each pending node
+    DiveVector<DiveVector<uint64_t>> children(pending_nodes.size() + 1);
+    uint64_t first_node_index = size();
+    for (uint64_t i = 0; i < pending_nodes.size(); ++i)
+    {
+        PendingNode& pending_node = pending_nodes[i];
+        uint64_t added_node_index = AddGfxrNode(pending_node.type, std::move(pending_node.desc));
+        DIVE_ASSERT(added_node_index == first_node_index + i);
+        if (pending_node.parent == PendingNode::kExpandedNode)
+        {
+            children[0].push_back(added_node_index);
+        }
+        else
+        {
+            DIVE_ASSERT(pending_node.parent < i);
+            children[pending_node.parent + 1].push_back(added_node_index);
+        }
+    }
+
+    // Only hierarchies with a pending children source are expanded, and these (the GFXR command
+    // hierarchy) only build the All Event topology
+    SharedNodeTopology& topology = m_topology[kAllEventTopology];
+    topology.SetNumNodes(size());
+    for (uint64_t i = 0; i < pending_nodes.size(); ++i)
+    {
+        topology.AddChildren(first_node_index + i, children[i + 1]);
+    }
+    topology.InsertChildren(node_index, children[0]);
+}
+
+//--------------------------------------------------------------------------------------------------
+void CommandHierarchy::ClearPendingChildren() { m_pending_children_source.reset(); }
+
 //--------------------------------------------------------------------------------------------------
 size_t CommandHierarchy::GetEventIndex(uint64_t node_index) const
 {
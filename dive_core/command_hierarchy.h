@@ -23,6 +23,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -134,6 +135,9 @@ class Topology
     virtual void SetNumNodes(uint64_t num_nodes);
     void AddChildren(uint64_t node_index, const DiveVector<uint64_t>& children);
 
+    // Puts `children` in front of the existing children of a node, once the topology is built
+    void InsertChildren(uint64_t node_index, const DiveVector<uint64_t>& children);
+
  private:
     friend class CommandHierarchy;
     friend class GfxrVulkanCommandHierarchyCreator;
@@ -208,6 +212,8 @@ class CommandHierarchy
     };
     CommandHierarchy();
     ~CommandHierarchy();
+    CommandHierarchy(CommandHierarchy&&);
+    CommandHierarchy& operator=(CommandHierarchy&&);
 
     inline size_t size() const { return m_nodes.m_node_type.size(); }
 
@@ -268,6 +274,49 @@ class CommandHierarchy
         return m_filter_exclude_indices_list[filter_type];
     }
 
+    // A node that is created on demand. Pending nodes are listed in pre-order, and `parent` is
+    // the position of the parent in the list, or kExpandedNode for a child of the expanded node.
+    struct PendingNode
+    {
+        static constexpr uint64_t kExpandedNode = UINT64_MAX;
+
+        NodeType type;
+        std::string desc;
+        uint64_t parent;
+    };
+
+    // Provides the children of nodes that are not created with the rest of the hierarchy, e.g.
+    // the argument nodes of GFXR commands
+    class PendingChildrenSource
+    {
+     public:
+        virtual ~PendingChildrenSource() = default;
+
+        // Number of direct children that TakePendingChildren() will return for this node
+        virtual uint64_t GetNumPendingChildren(uint64_t node_index) const = 0;
+
+        // Whether the description of a pending descendant of this node contains `text`, ignoring
+        // case
+        virtual bool PendingChildrenContain(uint64_t node_index, std::string_view text) const = 0;
+
+        // Returns all the pending descendants of a node, which are then no longer pending
+        virtual DiveVector<PendingNode> TakePendingChildren(uint64_t node_index) = 0;
+    };
+
+    // Some nodes only get their children when they are first needed, so that creating the
+    // hierarchy of a large capture is not dominated by nodes that are rarely looked at.
+    // ExpandNode() adds the pending children of a node in front of its existing children in the
+    // All Event topology. Note that this does not change the indices of existing nodes.
+    // PendingChildrenContain() lets searches look into pending children without creating them.
+    uint64_t GetNumPendingChildren(uint64_t node_index) const;
+    bool PendingChildrenContain(uint64_t node_index, std::string_view text) const;
+    void ExpandNode(uint64_t node_index);
+
+    // Drops the children that have not been created yet. The pending children may refer to the
+    // capture data the hierarchy was created from, so this must be called before that data is
+    // replaced.
+    void ClearPendingChildren();
+
  private:
     friend class CommandHierarchyCreator;
     friend class GfxrVulkanCommandHierarchyCreator;
@@ -366,6 +415,7 @@ class CommandHierarchy
     Nodes m_nodes;
     std::unordered_set<uint64_t> m_filter_exclude_indices_list[kFilterListTypeCount];
     SharedNodeTopology m_topology[kTopologyTypeCount];
+    std::unique_ptr<PendingChildrenSource> m_pending_children_source;
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -22,6 +22,7 @@
 
 #include "dive_core/command_hierarchy.h"
 #include "dive_core/gfxr_vulkan_command_hierarchy.h"
+#include "dive_core/task_scheduler.h"
 #include "pm4_info.h"
 
 namespace Dive
@@ -34,11 +35,15 @@ namespace Dive
 //--------------------------------------------------------------------------------------------------
 DataCore::DataCore(ProgressTracker* progress_tracker) : m_progress_tracker(progress_tracker) {}
 
+//--------------------------------------------------------------------------------------------------
+DataCore::~DataCore() { StopDisassembly(); }
+
 //--------------------------------------------------------------------------------------------------
 CaptureData::LoadResult DataCore::LoadDiveCaptureData(const std::string& file_name)
 {
     std::filesystem::path rd_file_path(file_name);
     rd_file_path.replace_extension(".rd");
+    StopDisassembly();
     m_capture_metadata = CaptureMetadata();
     return m_dive_capture_data.LoadFiles(rd_file_path.string(), file_name);
 }
@@ -46,6 +51,7 @@ CaptureData::LoadResult DataCore::LoadDiveCaptureData(const std::string& file_na
 //--------------------------------------------------------------------------------------------------
 CaptureData::LoadResult DataCore::LoadPm4CaptureData(const std::string& file_name)
 {
+    StopDisassembly();
     m_pm4_capture_data = Pm4CaptureData(m_progress_tracker);  // Clear any previously loaded data
     m_capture_metadata = CaptureMetadata();
     return m_pm4_capture_data.LoadCaptureFile(file_name);
@@ -54,10 +60,24 @@ CaptureData::LoadResult DataCore::LoadPm4CaptureData(const std::string& file_nam
 //--------------------------------------------------------------------------------------------------
 CaptureData::LoadResult DataCore::LoadGfxrCaptureData(const std::string& file_name)
 {
+    // The hierarchy keeps views into the capture data until it is rebuilt
+    m_capture_metadata.m_command_hierarchy.ClearPendingChildren();
     m_gfxr_capture_data = GfxrCaptureData();
+    m_gfxr_capture_data.SetCaptureIndexEnabled(true);
     return m_gfxr_capture_data.LoadCaptureFile(file_name);
 }
 
+//--------------------------------------------------------------------------------------------------
+CaptureData::LoadResult DataCore::LoadGfxrCaptureData(const std::string& file_name,
+                                                      const GfxrCaptureRange& range)
+{
+    // The hierarchy keeps views into the capture data until it is rebuilt
+    m_capture_metadata.m_command_hierarchy.ClearPendingChildren();
+    m_gfxr_capture_data = GfxrCaptureData();
+    m_gfxr_capture_data.SetCaptureIndexEnabled(true);
+    return m_gfxr_capture_data.LoadCaptureFile(file_name, range);
+}
+
 //--------------------------------------------------------------------------------------------------
 bool DataCore::CreateDiveCommandHierarchy()
 {
@@ -153,6 +173,28 @@ bool DataCore::CreatePm4MetaData()
     return true;
 }
 
+//--------------------------------------------------------------------------------------------------
+void DataCore::StartDisassembly()
+{
+    StopDisassembly();
+    m_disassembly_context = SimpleContext::Create();
+    m_disassembly_group = std::make_unique<TaskGroup>(TaskScheduler::GetDefault(),
+                                                      m_disassembly_context);
+    QueueDisassembly(*m_disassembly_group, m_capture_metadata.m_shaders);
+}
+
+//--------------------------------------------------------------------------------------------------
+void DataCore::StopDisassembly()
+{
+    if (!m_disassembly_context.IsNull())
+    {
+        m_disassembly_context->Cancel();
+    }
+    // Waits for the tasks already running; the cancelled ones are skipped
+    m_disassembly_group.reset();
+    m_disassembly_context = SimpleContext();
+}
+
 //--------------------------------------------------------------------------------------------------
 bool DataCore::ParseDiveCaptureData()
 {
@@ -161,11 +203,15 @@ bool DataCore::ParseDiveCaptureData()
         m_progress_tracker->sendMessage("Processing command buffers...");
     }
 
+    // The metadata is rebuilt under the shaders being disassembled
+    StopDisassembly();
     if (!CreateDiveMetaData())
     {
         return false;
     }
 
+    StartDisassembly();
+
     if (!CreateDiveCommandHierarchy())
     {
         return false;
@@ -182,11 +228,15 @@ bool DataCore::ParsePm4CaptureData()
         m_progress_tracker->sendMessage("Processing command buffers...");
     }
 
+    // The metadata is rebuilt under the shaders being disassembled
+    StopDisassembly();
     if (!CreatePm4MetaData())
     {
         return false;
     }
 
+    StartDisassembly();
+
     if (!CreatePm4CommandHierarchy())
     {
         return false;
@@ -229,6 +279,12 @@ const CommandHierarchy& DataCore::GetCommandHierarchy() const
     return m_capture_metadata.m_command_hierarchy;
 }
 
+//--------------------------------------------------------------------------------------------------
+CommandHierarchy& DataCore::GetMutableCommandHierarchy()
+{
+    return m_capture_metadata.m_command_hierarchy;
+}
+
 //--------------------------------------------------------------------------------------------------
 const CaptureMetadata& DataCore::GetCaptureMetadata() const { return m_capture_metadata; }
 
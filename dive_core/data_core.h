@@ -29,6 +29,7 @@
 #include "gfxr_capture_data.h"
 #include "pm4_capture_data.h"
 #include "progress_tracker.h"
+#include "task_scheduler.h"
 
 namespace Dive
 {
@@ -66,11 +67,16 @@ class DataCore
     DataCore() = default;
 
     DataCore(ProgressTracker* progress_tracker);
+    ~DataCore();
 
     // Load the capture file
     CaptureData::LoadResult LoadDiveCaptureData(const std::string& file_name);
     CaptureData::LoadResult LoadPm4CaptureData(const std::string& file_name);
     CaptureData::LoadResult LoadGfxrCaptureData(const std::string& file_name);
+    // Only loads `range` of the capture, so that ParseGfxrCaptureData() creates the command
+    // hierarchy of that part. See GfxrCaptureData::LoadCaptureFile().
+    CaptureData::LoadResult LoadGfxrCaptureData(const std::string& file_name,
+                                                const GfxrCaptureRange& range);
 
     // Parse the capture to generate info that describes the capture
     bool ParseDiveCaptureData();
@@ -94,6 +100,7 @@ class DataCore
 
     // Get the command-hierarchy, which is a tree view interpretation of the command buffer
     const CommandHierarchy& GetCommandHierarchy() const;
+    CommandHierarchy& GetMutableCommandHierarchy();
 
     // Get metadata describing the capture (info obtained by parsing the capture)
     const CaptureMetadata& GetCaptureMetadata() const;
@@ -103,6 +110,15 @@ class DataCore
     bool CreateDiveCommandHierarchy();
     bool CreatePm4CommandHierarchy();
     bool CreateGfxrCommandHierarchy();
+
+    // Queues the disassembly of the shaders in m_capture_metadata on the default TaskScheduler.
+    // It runs while the command hierarchy is created and finishes in the background, so that
+    // neither loading the capture nor opening the shader list waits for every shader.
+    void StartDisassembly();
+    // Skips the queued disassembly and waits for the running one, before the shaders or the
+    // capture data they read are replaced.
+    void StopDisassembly();
+
     // The relatively raw captured dive data (memory & submit blocks)
     DiveCaptureData m_dive_capture_data;
     // The relatively raw captured pm4 data (memory & submit blocks)
@@ -112,6 +128,9 @@ class DataCore
 
     // Metadata for the capture data in m_capture_data
     CaptureMetadata m_capture_metadata;
+
+    SimpleContext m_disassembly_context;
+    std::unique_ptr<TaskGroup> m_disassembly_group;
 };
 
 //--------------------------------------------------------------------------------------------------
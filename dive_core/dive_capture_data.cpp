@@ -29,6 +29,7 @@ CaptureData::LoadResult DiveCaptureData::LoadFiles(const std::string& pm4_file_n
 {
     // Initialize capture data objects
     m_gfxr_capture_data = GfxrCaptureData();
+    m_gfxr_capture_data.SetCaptureIndexEnabled(true);
     m_pm4_capture_data = Pm4CaptureData(m_progress_tracker);
 
     // 1. Load the PM4 capture file
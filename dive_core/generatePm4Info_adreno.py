@@ -153,6 +153,7 @@ def outputHeaderCpp(pm4_info_header_file_name, pm4_info_file):
   pm4_info_file.writelines('''
 #include <assert.h>
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <map>
 #include <string>
@@ -168,8 +169,11 @@ static DiveVector<DiveVector<const char*>> g_sEnumReflection;
 static DiveVector<PacketInfo> g_sPacketInfo;
 static std::unordered_map<uint32_t, PacketInfo> g_sPacketInfoVariant;
 static std::multimap<uint32_t, PacketInfo> g_sPacketInfoMultiple;
-static GPUVariantType g_sGPU_variant = kGPUVariantNone;
-static uint32_t g_sGPU_id = 0;
+// Atomic since captures may be loaded on several threads (see cli/batch.cpp) while other threads
+// decode or disassemble. Callers that load captures of different GPUs concurrently still have to
+// serialize the decoding themselves.
+static std::atomic<GPUVariantType> g_sGPU_variant = kGPUVariantNone;
+static std::atomic<uint32_t> g_sGPU_id = 0;
 
 std::string GetGPUStr(GPUVariantType variant)
 {
@@ -952,7 +956,7 @@ const RegInfo *GetRegInfo(uint32_t reg)
     if (g_sRegInfo[reg].m_name == nullptr)
     {
         // check with variant as key
-        uint32_t key = (reg << kGPUVariantsBits) | g_sGPU_variant;
+        uint32_t key = (reg << kGPUVariantsBits) | GetGPUVariantType();
         auto it = g_sRegInfoVariant.find(key);
         if (it == g_sRegInfoVariant.end())
         {
@@ -992,13 +996,14 @@ uint32_t GetRegOffsetByName(const char *name)
 {
     Pm4InfoInit();
 
-    if (g_sGPU_variant == kGPUVariantNone) 
+    const GPUVariantType gpu_variant = GetGPUVariantType();
+    if (gpu_variant == kGPUVariantNone)
     {
         return kInvalidRegOffset;
     }
 
     std::string str = std::string(name);
-    std::string name_with_variant = str + "_" + GetGPUStr(g_sGPU_variant);
+    std::string name_with_variant = str + "_" + GetGPUStr(gpu_variant);
     if (auto i = g_sRegNameToIndex.find(name_with_variant); i != g_sRegNameToIndex.end())
     {
         return i->second;
@@ -1027,7 +1032,7 @@ const PacketInfo *GetPacketInfo(uint32_t op_code)
     if (g_sPacketInfo[op_code].m_name == nullptr)
     {
         // check with variant as key
-        uint32_t key = (op_code << kGPUVariantsBits) | g_sGPU_variant;
+        uint32_t key = (op_code << kGPUVariantsBits) | GetGPUVariantType();
         auto it = g_sPacketInfoVariant.find(key);
         if (it == g_sPacketInfoVariant.end())
         {
@@ -1055,32 +1060,34 @@ const PacketInfo *GetPacketInfo(uint32_t op_code, const char *name)
 
 void SetGPUID(uint32_t gpu_id)
 {
-    g_sGPU_id = gpu_id;
+    g_sGPU_id.store(gpu_id, std::memory_order_relaxed);
     uint32_t gpu_series = gpu_id / 100;
     if((gpu_series >= 2) && (gpu_series <= 7))
     {
-        g_sGPU_variant = static_cast<GPUVariantType>(1 << (gpu_series - 2));
+        g_sGPU_variant.store(static_cast<GPUVariantType>(1 << (gpu_series - 2)),
+                             std::memory_order_relaxed);
     }
     else
     {
-        g_sGPU_variant = kGPUVariantNone;
+        g_sGPU_variant.store(kGPUVariantNone, std::memory_order_relaxed);
     }
 }
 
 uint32_t GetGPUID()
 {
-    return g_sGPU_id;
+    return g_sGPU_id.load(std::memory_order_relaxed);
 }
 
 GPUVariantType GetGPUVariantType()
 {
-    return g_sGPU_variant;
+    return g_sGPU_variant.load(std::memory_order_relaxed);
 }
 
 bool IsFieldEnabled(const RegField* field)
 {
-    DIVE_ASSERT(g_sGPU_variant != kGPUVariantNone);
-    return (g_sGPU_variant & field->m_gpu_variants) != 0;
+    const GPUVariantType gpu_variant = GetGPUVariantType();
+    DIVE_ASSERT(gpu_variant != kGPUVariantNone);
+    return (gpu_variant & field->m_gpu_variants) != 0;
 }
 '''
   )
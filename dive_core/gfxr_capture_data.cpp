@@ -16,16 +16,24 @@
 
 #include "gfxr_capture_data.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <iostream>
+#include <limits>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <utility>
 
 #include "absl/cleanup/cleanup.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "dive_core/common/common.h"
+#include "dive_core/gfxr_capture_index.h"
 #include "generated/generated_vulkan_dive_consumer.h"
 #include "gfxr_ext/decode/dive_file_processor.h"
+#include "gfxr_ext/decode/dive_vulkan_command_args.h"
 #include "third_party/gfxreconstruct/framework/generated/generated_vulkan_decoder.h"
 #include "util/platform.h"
 
@@ -67,14 +75,77 @@ absl::StatusOr<uint64_t> GetFileSize(const std::filesystem::path& file_path)
     GFXRECON_ASSERT(file_size >= 0);
     return static_cast<uint64_t>(file_size);
 }
+
+// Processes frames until the end of the capture or the block limit of `file_processor`, recording
+// the first block of each frame in `frame_first_blocks` if it's not null. Unlike
+// FileProcessor::ProcessAllFrames(), this doesn't restart the block count, so processing can start
+// at a block found with DiveFileProcessor::SeekToBlock().
+bool ProcessFrames(gfxrecon::decode::FileProcessor& file_processor,
+                   std::vector<uint64_t>* frame_first_blocks)
+{
+    bool more_frames = true;
+    while (more_frames)
+    {
+        if (frame_first_blocks != nullptr)
+        {
+            // The last entry is past the last block; it's dropped once the block count is known.
+            frame_first_blocks->push_back(file_processor.GetCurrentBlockIndex());
+        }
+        more_frames = file_processor.ProcessNextFrame();
+    }
+    return file_processor.GetErrorState() == gfxrecon::decode::kErrorNone;
+}
+
 }  // namespace
 
+//--------------------------------------------------------------------------------------------------
+std::pair<uint64_t, uint64_t> GetGfxrRangeBlocks(const std::vector<uint64_t>& frame_first_blocks,
+                                                 uint64_t block_count,
+                                                 const GfxrCaptureRange& range)
+{
+    if (range.first_frame >= frame_first_blocks.size())
+    {
+        return {0, 0};
+    }
+
+    uint64_t first_block = std::max(range.first_block, frame_first_blocks[range.first_frame]);
+    uint64_t end_block = block_count;
+    if (range.last_block < block_count)
+    {
+        end_block = range.last_block + 1;
+    }
+    if (range.last_frame < frame_first_blocks.size() - 1)
+    {
+        end_block = std::min(end_block, frame_first_blocks[range.last_frame + 1]);
+    }
+
+    if (first_block >= end_block)
+    {
+        return {first_block, 0};
+    }
+    return {first_block, end_block - first_block};
+}
+
 // =================================================================================================
 // GfxrCaptureData
 // =================================================================================================
 
 //--------------------------------------------------------------------------------------------------
 CaptureData::LoadResult GfxrCaptureData::LoadCaptureFile(const std::string& file_name)
+{
+    return Load(file_name, std::nullopt);
+}
+
+//--------------------------------------------------------------------------------------------------
+CaptureData::LoadResult GfxrCaptureData::LoadCaptureFile(const std::string& file_name,
+                                                         const GfxrCaptureRange& range)
+{
+    return Load(file_name, range);
+}
+
+//--------------------------------------------------------------------------------------------------
+CaptureData::LoadResult GfxrCaptureData::Load(const std::string& file_name,
+                                              const std::optional<GfxrCaptureRange>& range)
 {
     if (m_gfxr_capture_block_data != nullptr)
     {
@@ -83,16 +154,162 @@ CaptureData::LoadResult GfxrCaptureData::LoadCaptureFile(const std::string& file
         return LoadResult::kFileIoError;
     }
 
+    absl::StatusOr<uint64_t> file_size = GetFileSize(file_name);
+    if (!file_size.ok())
+    {
+        std::cerr << file_size.status().message() << '\n';
+        return LoadResult::kFileIoError;
+    }
+
     m_gfxr_capture_block_data = std::make_shared<gfxrecon::decode::DiveBlockData>();
+    // Don't keep the keys and enum names of previous captures once they are closed.
+    VulkanCommandArgs::ResetSharedTables();
+
+    std::optional<GfxrCaptureIndexKey> index_key;
+    if (m_capture_index_enabled)
+    {
+        if (absl::StatusOr<GfxrCaptureIndexKey> key = ComputeGfxrCaptureIndexKey(file_name);
+            key.ok() && key->file_size == *file_size)
+        {
+            index_key = *key;
+        }
+    }
+
+    // A partial load only needs the blocks up front; the range is decoded once they are known.
+    bool loaded_from_index = false;
+    if (index_key.has_value())
+    {
+        loaded_from_index = range.has_value() ? LoadBlocksFromCaptureIndex(file_name, *index_key)
+                                              : LoadFromCaptureIndex(file_name, *index_key);
+    }
+    if (!loaded_from_index)
+    {
+        bool loaded = range.has_value() ? ScanCaptureFile(file_name) : DecodeCaptureFile(file_name);
+        if (!loaded)
+        {
+            return LoadResult::kFileIoError;
+        }
+    }
+
+    if (!m_gfxr_capture_block_data->FinalizeOriginalBlocksMapSizes(*file_size))
+    {
+        std::cerr << "Error: cannot lock gfxrecon DiveBlockData" << std::endl;
+        return LoadResult::kFileIoError;
+    }
+
+    m_cur_capture_file = file_name;
+
+    uint64_t block_count = m_gfxr_capture_block_data->GetOriginalBlockCount();
+    while (!m_gfxr_frame_first_blocks.empty() && m_gfxr_frame_first_blocks.back() >= block_count)
+    {
+        m_gfxr_frame_first_blocks.pop_back();
+    }
+
+    if (!range.has_value())
+    {
+        m_first_loaded_block = 0;
+        m_loaded_block_count = block_count;
+        if (index_key.has_value() && !loaded_from_index)
+        {
+            SaveCaptureIndex(file_name, *index_key);
+        }
+        return LoadResult::kSuccess;
+    }
+
+    std::tie(m_first_loaded_block, m_loaded_block_count) =
+        GetGfxrRangeBlocks(m_gfxr_frame_first_blocks, block_count, *range);
+    if (m_loaded_block_count != 0 &&
+        !DecodeCaptureBlocks(file_name, m_first_loaded_block,
+                             m_first_loaded_block + m_loaded_block_count - 1))
+    {
+        return LoadResult::kFileIoError;
+    }
+
+    return LoadResult::kSuccess;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool GfxrCaptureData::LoadFromCaptureIndex(const std::string& file_name,
+                                           const GfxrCaptureIndexKey& key)
+{
+    absl::StatusOr<GfxrCaptureIndexData> data =
+        LoadGfxrCaptureIndex(GetGfxrCaptureIndexPath(file_name), key);
+    if (!data.ok())
+    {
+        if (!absl::IsNotFound(data.status()))
+        {
+            std::cerr << "Ignoring capture index: " << data.status().message() << std::endl;
+        }
+        return false;
+    }
+    if (data->block_offsets.empty() || data->submits.empty())
+    {
+        return false;
+    }
+
+    m_gfxr_capture_block_data->ReserveOriginalBlocks(data->block_offsets.size());
+    for (size_t i = 0; i < data->block_offsets.size(); ++i)
+    {
+        if (!m_gfxr_capture_block_data->AddOriginalBlock(i, data->block_offsets[i]))
+        {
+            // Start over with the decoding.
+            m_gfxr_capture_block_data = std::make_shared<gfxrecon::decode::DiveBlockData>();
+            return false;
+        }
+    }
+    m_gfxr_frame_first_blocks = std::move(data->frame_first_blocks);
+    m_gfxr_submits = std::move(data->submits);
+    m_gfxr_command_buffers = std::move(data->command_buffers);
+    m_gfxr_draw_call_counts = std::move(data->draw_call_counts);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool GfxrCaptureData::LoadBlocksFromCaptureIndex(const std::string& file_name,
+                                                 const GfxrCaptureIndexKey& key)
+{
+    absl::StatusOr<GfxrCaptureIndexData> data =
+        LoadGfxrCaptureIndexBlocks(GetGfxrCaptureIndexPath(file_name), key);
+    if (!data.ok())
+    {
+        if (!absl::IsNotFound(data.status()))
+        {
+            std::cerr << "Ignoring capture index: " << data.status().message() << std::endl;
+        }
+        return false;
+    }
+    if (data->block_offsets.empty())
+    {
+        return false;
+    }
+
+    m_gfxr_capture_block_data->ReserveOriginalBlocks(data->block_offsets.size());
+    for (size_t i = 0; i < data->block_offsets.size(); ++i)
+    {
+        if (!m_gfxr_capture_block_data->AddOriginalBlock(i, data->block_offsets[i]))
+        {
+            // Start over with the scan.
+            m_gfxr_capture_block_data = std::make_shared<gfxrecon::decode::DiveBlockData>();
+            return false;
+        }
+    }
+    m_gfxr_frame_first_blocks = std::move(data->frame_first_blocks);
+    return true;
+}
 
+//--------------------------------------------------------------------------------------------------
+bool GfxrCaptureData::DecodeCaptureFile(const std::string& file_name)
+{
     gfxrecon::decode::DiveFileProcessor file_processor;
 
     if (!file_processor.Initialize(file_name))
     {
-        return LoadResult::kFileIoError;
+        return false;
     }
 
     file_processor.SetDiveBlockData(m_gfxr_capture_block_data);
+    // Decompress blocks on worker threads while this thread decodes.
+    file_processor.EnableBlockPrefetch();
 
     gfxrecon::decode::VulkanExportDiveConsumer dive_consumer;
     gfxrecon::decode::VulkanDecoder decoder;
@@ -103,35 +320,139 @@ CaptureData::LoadResult GfxrCaptureData::LoadCaptureFile(const std::string& file
     file_processor.SetAnnotationProcessor(&dive_annotation_processor);
     dive_consumer.Initialize(&dive_annotation_processor);
 
-    if (!file_processor.ProcessAllFrames())
+    if (!ProcessFrames(file_processor, &m_gfxr_frame_first_blocks))
     {
         std::cerr << "Error using gfxrecon DiveFileProcessor to load file: " << file_name
                   << std::endl;
         std::cerr << file_processor.GetErrorState() << std::endl;
-        return LoadResult::kFileIoError;
+        return false;
     }
 
     m_gfxr_submits = dive_annotation_processor.TakeSubmits();
     DIVE_ASSERT(!m_gfxr_submits.empty());
     m_gfxr_command_buffers = dive_annotation_processor.TakeVkCommandsCache();
     m_gfxr_draw_call_counts = dive_annotation_processor.TakeDrawCallMap();
+    return true;
+}
 
-    absl::StatusOr<uint64_t> file_size = GetFileSize(file_name);
-    if (!file_size.ok())
+//--------------------------------------------------------------------------------------------------
+bool GfxrCaptureData::ScanCaptureFile(const std::string& file_name)
+{
+    gfxrecon::decode::DiveFileProcessor file_processor;
+
+    if (!file_processor.Initialize(file_name))
     {
-        std::cerr << file_size.status().message() << '\n';
-        return LoadResult::kFileIoError;
+        return false;
     }
 
-    if (!m_gfxr_capture_block_data->FinalizeOriginalBlocksMapSizes(*file_size))
+    // Without decoders, the blocks are only read and parsed, which is enough to find the frames.
+    file_processor.SetDiveBlockData(m_gfxr_capture_block_data);
+    file_processor.EnableBlockPrefetch();
+
+    if (!ProcessFrames(file_processor, &m_gfxr_frame_first_blocks))
     {
-        std::cerr << "Error: cannot lock gfxrecon DiveBlockData" << std::endl;
-        return LoadResult::kFileIoError;
+        std::cerr << "Error using gfxrecon DiveFileProcessor to scan file: " << file_name
+                  << std::endl;
+        std::cerr << file_processor.GetErrorState() << std::endl;
+        return false;
     }
+    return true;
+}
 
-    m_cur_capture_file = file_name;
+//--------------------------------------------------------------------------------------------------
+bool GfxrCaptureData::DecodeCaptureBlocks(const std::string& file_name, uint64_t first_block,
+                                          uint64_t last_block)
+{
+    // FileProcessor takes a block limit of 0 as no limit. Block 0 alone can't hold a submit
+    // anyway, since it comes before any queue is created.
+    if (last_block == 0)
+    {
+        return true;
+    }
 
-    return LoadResult::kSuccess;
+    gfxrecon::decode::DiveFileProcessor file_processor(last_block);
+
+    if (!file_processor.Initialize(file_name))
+    {
+        return false;
+    }
+
+    if (first_block != 0)
+    {
+        // The frame of first_block is the last one that starts at or before it.
+        auto next_frame = std::upper_bound(m_gfxr_frame_first_blocks.begin(),
+                                           m_gfxr_frame_first_blocks.end(), first_block);
+        uint64_t frame_number = 0;
+        if (next_frame != m_gfxr_frame_first_blocks.begin())
+        {
+            frame_number = (next_frame - m_gfxr_frame_first_blocks.begin()) - 1;
+        }
+        uint64_t offset = m_gfxr_capture_block_data->GetOriginalBlockOffsets()[first_block];
+        if (!file_processor.SeekToBlock(first_block, offset, frame_number))
+        {
+            std::cerr << "Error seeking to block " << first_block << " of file: " << file_name
+                      << std::endl;
+            return false;
+        }
+    }
+    // Decompress blocks on worker threads while this thread decodes.
+    file_processor.EnableBlockPrefetch();
+
+    gfxrecon::decode::VulkanExportDiveConsumer dive_consumer;
+    gfxrecon::decode::VulkanDecoder decoder;
+    decoder.AddConsumer(&dive_consumer);
+    file_processor.AddDecoder(&decoder);
+
+    DiveAnnotationProcessor dive_annotation_processor;
+    file_processor.SetAnnotationProcessor(&dive_annotation_processor);
+    dive_consumer.Initialize(&dive_annotation_processor);
+
+    if (!ProcessFrames(file_processor, nullptr))
+    {
+        std::cerr << "Error using gfxrecon DiveFileProcessor to load blocks " << first_block
+                  << " to " << last_block << " of file: " << file_name << std::endl;
+        std::cerr << file_processor.GetErrorState() << std::endl;
+        return false;
+    }
+
+    m_gfxr_submits = dive_annotation_processor.TakeSubmits();
+    m_gfxr_command_buffers = dive_annotation_processor.TakeVkCommandsCache();
+    m_gfxr_draw_call_counts = dive_annotation_processor.TakeDrawCallMap();
+
+    // Command buffers recorded before the range are submitted without their commands.
+    for (const auto& submit : m_gfxr_submits)
+    {
+        for (uint64_t handle : submit->vk_command_buffer_handles)
+        {
+            m_gfxr_command_buffers.try_emplace(handle);
+            m_gfxr_draw_call_counts.try_emplace(handle);
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void GfxrCaptureData::SaveCaptureIndex(const std::string& file_name, const GfxrCaptureIndexKey& key)
+{
+    // Lend the decoded data to the index while it is written rather than copying it.
+    GfxrCaptureIndexData data;
+    data.block_offsets = m_gfxr_capture_block_data->GetOriginalBlockOffsets();
+    data.frame_first_blocks = m_gfxr_frame_first_blocks;
+    data.submits = std::move(m_gfxr_submits);
+    data.command_buffers = std::move(m_gfxr_command_buffers);
+    data.draw_call_counts = std::move(m_gfxr_draw_call_counts);
+
+    absl::Status status = SaveGfxrCaptureIndex(GetGfxrCaptureIndexPath(file_name), key, data);
+
+    m_gfxr_submits = std::move(data.submits);
+    m_gfxr_command_buffers = std::move(data.command_buffers);
+    m_gfxr_draw_call_counts = std::move(data.draw_call_counts);
+
+    if (!status.ok())
+    {
+        // The index is only an optimization; e.g. the capture may be in a read-only directory.
+        std::cerr << "Not saving capture index: " << status.message() << std::endl;
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -152,6 +473,29 @@ bool GfxrCaptureData::WriteModifiedGfxrFile(const char* new_file_name)
     return true;
 }
 
+//--------------------------------------------------------------------------------------------------
+bool GfxrCaptureData::WriteModifiedGfxrFiles(
+    const std::vector<const gfxrecon::decode::DiveBlockData*>& variants,
+    const std::vector<std::string>& new_file_names)
+{
+    if (m_cur_capture_file.empty())
+    {
+        std::cerr << "Error: no loaded gfxr file" << std::endl;
+        return false;
+    }
+
+    // The new files are written in parallel, mostly waiting on I/O.
+    size_t thread_count = std::max(1u, std::thread::hardware_concurrency());
+    if (!gfxrecon::decode::DiveBlockData::WriteGFXRFiles(m_cur_capture_file, variants,
+                                                         new_file_names, thread_count))
+    {
+        std::cerr << "Error writing modified GFXR files" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
 //--------------------------------------------------------------------------------------------------
 const std::vector<std::unique_ptr<DiveAnnotationProcessor::SubmitInfo>>&
 GfxrCaptureData::GetGfxrSubmits() const
@@ -15,7 +15,15 @@
 */
 
 #pragma once
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "dive_core/capture_data.h"
+#include "dive_core/gfxr_capture_index.h"
 #include "gfxr_ext/decode/dive_annotation_processor.h"
 #include "gfxr_ext/decode/dive_block_data.h"
 
@@ -24,6 +32,22 @@ namespace Dive
 
 class CommandHierarchy;
 
+// The part of a GFXR capture to decode. Both ranges are inclusive, and a block is decoded if it is
+// in both. Frames are numbered from 0 in the order they are processed.
+struct GfxrCaptureRange
+{
+    uint64_t first_frame = 0;
+    uint64_t last_frame = std::numeric_limits<uint64_t>::max();
+    uint64_t first_block = 0;
+    uint64_t last_block = std::numeric_limits<uint64_t>::max();
+};
+
+// Returns the first block in `range` and the number of blocks in it, for a capture of
+// `block_count` blocks whose frames start at `frame_first_blocks`.
+std::pair<uint64_t, uint64_t> GetGfxrRangeBlocks(const std::vector<uint64_t>& frame_first_blocks,
+                                                 uint64_t block_count,
+                                                 const GfxrCaptureRange& range);
+
 //--------------------------------------------------------------------------------------------------
 class GfxrCaptureData : public CaptureData
 {
@@ -40,6 +64,28 @@ class GfxrCaptureData : public CaptureData
     // Sets m_cur_capture_file and m_gfxr_capture_block_data with info from the original GFXR file
     LoadResult LoadCaptureFile(const std::string& file_name) override;
 
+    // Like LoadCaptureFile(), but only decodes the submits and commands of the blocks in `range`.
+    // m_gfxr_capture_block_data still describes every block, so that the capture can be modified
+    // and written as usual.
+    //
+    // The block offsets and frames come from the capture index if it's enabled and up to date, and
+    // decoding then seeks straight to the range. Otherwise the blocks are read once without being
+    // decoded to find them. Command buffers recorded before the range have no commands.
+    LoadResult LoadCaptureFile(const std::string& file_name, const GfxrCaptureRange& range);
+
+    // When enabled, LoadCaptureFile() reads the decoded data from the index next to the capture
+    // (see gfxr_capture_index.h) if it is up to date, and otherwise writes the index after
+    // decoding. Disabled by default so that loading never writes next to the capture.
+    void SetCaptureIndexEnabled(bool enabled) { m_capture_index_enabled = enabled; }
+
+    // Index of the first block of each frame in the capture.
+    const std::vector<uint64_t>& GetFrameFirstBlocks() const { return m_gfxr_frame_first_blocks; }
+
+    // The decoded blocks; the whole capture unless it was loaded with a range. The count is 0 if
+    // no block was in the range.
+    uint64_t GetFirstLoadedBlock() const { return m_first_loaded_block; }
+    uint64_t GetLoadedBlockCount() const { return m_loaded_block_count; }
+
     // Get the gfxr data
     bool IsDiveBlockDataInitialized() const { return m_gfxr_capture_block_data != nullptr; }
     std::shared_ptr<gfxrecon::decode::DiveBlockData> GetMutableGfxrData()
@@ -51,7 +97,31 @@ class GfxrCaptureData : public CaptureData
     // recorded in m_gfxr_capture_block_data
     bool WriteModifiedGfxrFile(const char* new_file_name);
 
+    // Writes new_file_names[i] from variants[i], with a single read of the original GFXR file. The
+    // variants must be copies of m_gfxr_capture_block_data made with CopyWithoutModifications().
+    bool WriteModifiedGfxrFiles(const std::vector<const gfxrecon::decode::DiveBlockData*>& variants,
+                                const std::vector<std::string>& new_file_names);
+
  private:
+    // Loads the whole capture, or only `range` of it.
+    LoadResult Load(const std::string& file_name, const std::optional<GfxrCaptureRange>& range);
+    // Loads the decoded data from the capture index. Returns false if there is no usable index.
+    bool LoadFromCaptureIndex(const std::string& file_name, const GfxrCaptureIndexKey& key);
+    // Decodes the capture with gfxrecon.
+    bool DecodeCaptureFile(const std::string& file_name);
+    // Loads the block offsets and frames from the capture index. Returns false if there is no
+    // usable index.
+    bool LoadBlocksFromCaptureIndex(const std::string& file_name, const GfxrCaptureIndexKey& key);
+    // Reads the blocks of the capture to find their offsets and the frames, without decoding them.
+    bool ScanCaptureFile(const std::string& file_name);
+    // Decodes blocks `first_block` to `last_block` of the capture, which must have been scanned.
+    bool DecodeCaptureBlocks(const std::string& file_name, uint64_t first_block,
+                             uint64_t last_block);
+    // Writes the capture index; failures are only reported since the index is a cache.
+    void SaveCaptureIndex(const std::string& file_name, const GfxrCaptureIndexKey& key);
+
+    bool m_capture_index_enabled = false;
+
     // Metadata for the original GFXR file m_cur_capture_file, as well as modifications
     std::shared_ptr<gfxrecon::decode::DiveBlockData> m_gfxr_capture_block_data = nullptr;
 
@@ -60,6 +130,10 @@ class GfxrCaptureData : public CaptureData
     std::unordered_map<uint64_t, std::vector<DiveAnnotationProcessor::VulkanCommandInfo>>
         m_gfxr_command_buffers;
     std::unordered_map<uint64_t, DiveAnnotationProcessor::DrawCallCounts> m_gfxr_draw_call_counts;
+
+    std::vector<uint64_t> m_gfxr_frame_first_blocks;
+    uint64_t m_first_loaded_block = 0;
+    uint64_t m_loaded_block_count = 0;
 };
 
 }  // namespace Dive
@@ -0,0 +1,491 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include "gfxr_capture_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "absl/strings/str_format.h"
+
+namespace Dive
+{
+
+namespace
+{
+
+constexpr char kIndexMagic[8] = {'D', 'I', 'V', 'E', 'G', 'I', 'D', 'X'};
+// Bump when the layout of the index, of VulkanCommandArgs or of the annotation results changes.
+constexpr uint32_t kIndexVersion = 3;
+constexpr uint32_t kByteOrderMark = 0x01020304;
+constexpr uint64_t kFingerprintRegionSize = 1 << 20;
+// Regions sampled between the first and last MiB of the capture.
+constexpr uint64_t kFingerprintSampleCount = 64;
+constexpr uint64_t kFingerprintSampleSize = 4096;
+
+// FNV-1a, which is stable across runs and platforms unlike absl::Hash.
+class Fnv1a
+{
+ public:
+    void Update(const void* data, size_t size)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            m_hash = (m_hash ^ bytes[i]) * 0x100000001b3ull;
+        }
+    }
+    uint64_t Get() const { return m_hash; }
+
+ private:
+    uint64_t m_hash = 0xcbf29ce484222325ull;
+};
+
+class IndexWriter
+{
+ public:
+    template<typename T> void Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    void WriteString(std::string_view value)
+    {
+        Write(static_cast<uint32_t>(value.size()));
+        m_buffer.append(value);
+    }
+    void WriteUint64s(const std::vector<uint64_t>& values)
+    {
+        Write(static_cast<uint64_t>(values.size()));
+        m_buffer.append(reinterpret_cast<const char*>(values.data()),
+                        values.size() * sizeof(uint64_t));
+    }
+    void WriteCommands(const std::vector<DiveAnnotationProcessor::VulkanCommandInfo>& commands,
+                       VulkanCommandArgs::SavedTables& tables)
+    {
+        Write(static_cast<uint64_t>(commands.size()));
+        for (const auto& command : commands)
+        {
+            WriteString(command.name);
+            Write(command.index);
+            command.args.Save(m_buffer, tables);
+        }
+    }
+    void Append(const IndexWriter& other) { m_buffer.append(other.m_buffer); }
+
+    const std::string& GetBuffer() const { return m_buffer; }
+
+ private:
+    std::string m_buffer;
+};
+
+// Reads the index; every read fails once the data is exhausted.
+class IndexReader
+{
+ public:
+    explicit IndexReader(const std::string& buffer)
+        : m_data(buffer.data()), m_end(buffer.data() + buffer.size())
+    {
+    }
+
+    bool AtEnd() const { return m_data == m_end; }
+
+    template<typename T> bool Read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (static_cast<size_t>(m_end - m_data) < sizeof(T))
+        {
+            return false;
+        }
+        std::memcpy(&value, m_data, sizeof(T));
+        m_data += sizeof(T);
+        return true;
+    }
+    bool ReadString(std::string& value)
+    {
+        uint32_t size = 0;
+        if (!Read(size) || static_cast<size_t>(m_end - m_data) < size)
+        {
+            return false;
+        }
+        value.assign(m_data, size);
+        m_data += size;
+        return true;
+    }
+    // Reads an element count, rejecting counts that cannot fit in the remaining data so that a
+    // corrupt index does not cause huge allocations.
+    bool ReadCount(uint64_t& count, size_t min_element_size)
+    {
+        return Read(count) && count <= static_cast<size_t>(m_end - m_data) / min_element_size;
+    }
+    bool ReadUint64s(std::vector<uint64_t>& values)
+    {
+        uint64_t count = 0;
+        if (!ReadCount(count, sizeof(uint64_t)))
+        {
+            return false;
+        }
+        values.resize(count);
+        if (count != 0)
+        {
+            std::memcpy(values.data(), m_data, count * sizeof(uint64_t));
+        }
+        m_data += count * sizeof(uint64_t);
+        return true;
+    }
+    bool ReadCommands(std::vector<DiveAnnotationProcessor::VulkanCommandInfo>& commands,
+                      const VulkanCommandArgs::IdRemap& remap)
+    {
+        uint64_t count = 0;
+        if (!ReadCount(count, sizeof(uint32_t)))
+        {
+            return false;
+        }
+        commands.reserve(count);
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            std::string name;
+            uint32_t index = 0;
+            if (!ReadString(name) || !Read(index))
+            {
+                return false;
+            }
+            std::optional<VulkanCommandArgs> args = VulkanCommandArgs::Load(m_data, m_end, remap);
+            if (!args)
+            {
+                return false;
+            }
+            commands.emplace_back(std::move(name), index, *std::move(args));
+        }
+        return true;
+    }
+
+ private:
+    const char* m_data;
+    const char* m_end;
+};
+
+absl::Status ReadFileRegion(std::ifstream& file, uint64_t offset, uint64_t size, Fnv1a& hash)
+{
+    std::vector<char> buffer(size);
+    file.seekg(static_cast<std::streamoff>(offset));
+    file.read(buffer.data(), static_cast<std::streamsize>(size));
+    if (!file)
+    {
+        return absl::DataLossError("Failed to read the capture");
+    }
+    hash.Update(buffer.data(), buffer.size());
+    return absl::OkStatus();
+}
+
+// Reads the index at `index_path`. With `blocks_only`, stops after the block offsets and frames.
+absl::StatusOr<GfxrCaptureIndexData> LoadIndex(const std::string& index_path,
+                                               const GfxrCaptureIndexKey& key, bool blocks_only)
+{
+    std::ifstream file(index_path, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        return absl::NotFoundError(absl::StrFormat("No index: %s", index_path));
+    }
+    std::string buffer(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!file)
+    {
+        return absl::DataLossError(absl::StrFormat("Can't read: %s", index_path));
+    }
+
+    IndexReader reader(buffer);
+    char magic[sizeof(kIndexMagic)] = {};
+    uint32_t version = 0;
+    uint32_t byte_order_mark = 0;
+    GfxrCaptureIndexKey saved_key;
+    if (!reader.Read(magic) || std::memcmp(magic, kIndexMagic, sizeof(kIndexMagic)) != 0 ||
+        !reader.Read(version) || !reader.Read(byte_order_mark) ||
+        !reader.Read(saved_key.file_size) || !reader.Read(saved_key.modification_time) ||
+        !reader.Read(saved_key.fingerprint))
+    {
+        return absl::DataLossError(absl::StrFormat("Not an index: %s", index_path));
+    }
+    if (version != kIndexVersion || byte_order_mark != kByteOrderMark || saved_key != key)
+    {
+        return absl::FailedPreconditionError(
+            absl::StrFormat("Index is for another capture or version: %s", index_path));
+    }
+
+    auto corrupt = [&index_path]() {
+        return absl::DataLossError(absl::StrFormat("Corrupt index: %s", index_path));
+    };
+
+    GfxrCaptureIndexData data;
+    if (!reader.ReadUint64s(data.block_offsets) || !reader.ReadUint64s(data.frame_first_blocks))
+    {
+        return corrupt();
+    }
+    if (blocks_only)
+    {
+        return data;
+    }
+
+    VulkanCommandArgs::SharedTables tables;
+    for (std::vector<std::string>* table : {&tables.keys, &tables.strings})
+    {
+        uint64_t count = 0;
+        if (!reader.ReadCount(count, sizeof(uint32_t)))
+        {
+            return corrupt();
+        }
+        table->resize(count);
+        for (std::string& string : *table)
+        {
+            if (!reader.ReadString(string))
+            {
+                return corrupt();
+            }
+        }
+    }
+    std::optional<VulkanCommandArgs::IdRemap> remap =
+        VulkanCommandArgs::InternSharedTables(tables);
+    if (!remap)
+    {
+        return absl::ResourceExhaustedError("Too many distinct argument names");
+    }
+
+    uint64_t num_submits = 0;
+    if (!reader.ReadCount(num_submits, sizeof(uint32_t)))
+    {
+        return corrupt();
+    }
+    for (uint64_t i = 0; i < num_submits; ++i)
+    {
+        std::string name;
+        if (!reader.ReadString(name))
+        {
+            return corrupt();
+        }
+        auto submit = std::make_unique<DiveAnnotationProcessor::SubmitInfo>(name);
+        if (!reader.ReadUint64s(submit->vk_command_buffer_handles) ||
+            !reader.ReadCommands(submit->none_cmd_vk_commands, *remap))
+        {
+            return corrupt();
+        }
+        data.submits.push_back(std::move(submit));
+    }
+
+    uint64_t num_command_buffers = 0;
+    if (!reader.ReadCount(num_command_buffers, sizeof(uint64_t)))
+    {
+        return corrupt();
+    }
+    for (uint64_t i = 0; i < num_command_buffers; ++i)
+    {
+        uint64_t handle = 0;
+        if (!reader.Read(handle) || !reader.ReadCommands(data.command_buffers[handle], *remap))
+        {
+            return corrupt();
+        }
+    }
+
+    uint64_t num_draw_call_counts = 0;
+    if (!reader.ReadCount(num_draw_call_counts, sizeof(uint64_t)))
+    {
+        return corrupt();
+    }
+    for (uint64_t i = 0; i < num_draw_call_counts; ++i)
+    {
+        uint64_t handle = 0;
+        DiveAnnotationProcessor::DrawCallCounts counts;
+        if (!reader.Read(handle) || !reader.Read(counts.begin_command_buffer_draw_call_count) ||
+            !reader.ReadUint64s(counts.render_pass_draw_call_counts))
+        {
+            return corrupt();
+        }
+        data.draw_call_counts[handle] = std::move(counts);
+    }
+
+    if (!reader.AtEnd())
+    {
+        return corrupt();
+    }
+    return data;
+}
+
+}  // namespace
+
+//--------------------------------------------------------------------------------------------------
+std::string GetGfxrCaptureIndexPath(const std::string& capture_path)
+{
+    return capture_path + ".diveidx";
+}
+
+//--------------------------------------------------------------------------------------------------
+absl::StatusOr<GfxrCaptureIndexKey> ComputeGfxrCaptureIndexKey(const std::string& capture_path)
+{
+    std::error_code error;
+    uint64_t file_size = std::filesystem::file_size(capture_path, error);
+    if (error)
+    {
+        return absl::NotFoundError(
+            absl::StrFormat("Can't get the size of %s: %s", capture_path, error.message()));
+    }
+    std::filesystem::file_time_type modification_time =
+        std::filesystem::last_write_time(capture_path, error);
+    if (error)
+    {
+        return absl::NotFoundError(absl::StrFormat("Can't get the modification time of %s: %s",
+                                                   capture_path, error.message()));
+    }
+    std::ifstream file(capture_path, std::ios::binary);
+    if (!file)
+    {
+        return absl::NotFoundError(absl::StrFormat("Can't open: %s", capture_path));
+    }
+
+    Fnv1a hash;
+    hash.Update(&file_size, sizeof(file_size));
+    uint64_t head_size = std::min(file_size, kFingerprintRegionSize);
+    if (absl::Status status = ReadFileRegion(file, 0, head_size, hash); !status.ok())
+    {
+        return status;
+    }
+    uint64_t tail_offset = std::max(head_size, file_size - head_size);
+    if (absl::Status status = ReadFileRegion(file, tail_offset, file_size - tail_offset, hash);
+        !status.ok())
+    {
+        return status;
+    }
+    if (uint64_t middle_size = tail_offset - head_size;
+        middle_size > kFingerprintSampleCount * kFingerprintSampleSize)
+    {
+        uint64_t stride = middle_size / kFingerprintSampleCount;
+        for (uint64_t i = 0; i < kFingerprintSampleCount; ++i)
+        {
+            uint64_t offset = head_size + i * stride + (stride - kFingerprintSampleSize) / 2;
+            if (absl::Status status = ReadFileRegion(file, offset, kFingerprintSampleSize, hash);
+                !status.ok())
+            {
+                return status;
+            }
+        }
+    }
+    else if (absl::Status status = ReadFileRegion(file, head_size, middle_size, hash);
+             !status.ok())
+    {
+        return status;
+    }
+    return GfxrCaptureIndexKey{
+        .file_size = file_size,
+        .modification_time = static_cast<int64_t>(modification_time.time_since_epoch().count()),
+        .fingerprint = hash.Get()};
+}
+
+//--------------------------------------------------------------------------------------------------
+absl::Status SaveGfxrCaptureIndex(const std::string& index_path, const GfxrCaptureIndexKey& key,
+                                  const GfxrCaptureIndexData& data)
+{
+    IndexWriter writer;
+    writer.Write(kIndexMagic);
+    writer.Write(kIndexVersion);
+    writer.Write(kByteOrderMark);
+    writer.Write(key.file_size);
+    writer.Write(key.modification_time);
+    writer.Write(key.fingerprint);
+
+    writer.WriteUint64s(data.block_offsets);
+    writer.WriteUint64s(data.frame_first_blocks);
+
+    // The arguments refer to keys and strings by id, so the tables of the ones they use are saved
+    // before them.
+    VulkanCommandArgs::SavedTables tables;
+    IndexWriter commands_writer;
+    commands_writer.Write(static_cast<uint64_t>(data.submits.size()));
+    for (const auto& submit : data.submits)
+    {
+        commands_writer.WriteString(submit->name);
+        commands_writer.WriteUint64s(submit->vk_command_buffer_handles);
+        commands_writer.WriteCommands(submit->none_cmd_vk_commands, tables);
+    }
+
+    commands_writer.Write(static_cast<uint64_t>(data.command_buffers.size()));
+    for (const auto& [handle, commands] : data.command_buffers)
+    {
+        commands_writer.Write(handle);
+        commands_writer.WriteCommands(commands, tables);
+    }
+
+    for (const std::vector<std::string>* table :
+         {&tables.GetTables().keys, &tables.GetTables().strings})
+    {
+        writer.Write(static_cast<uint64_t>(table->size()));
+        for (const std::string& string : *table)
+        {
+            writer.WriteString(string);
+        }
+    }
+    writer.Append(commands_writer);
+
+    writer.Write(static_cast<uint64_t>(data.draw_call_counts.size()));
+    for (const auto& [handle, counts] : data.draw_call_counts)
+    {
+        writer.Write(handle);
+        writer.Write(counts.begin_command_buffer_draw_call_count);
+        writer.WriteUint64s(counts.render_pass_draw_call_counts);
+    }
+
+    std::string temp_path = index_path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        file.write(writer.GetBuffer().data(),
+                   static_cast<std::streamsize>(writer.GetBuffer().size()));
+        if (!file)
+        {
+            file.close();
+            std::filesystem::remove(temp_path);
+            return absl::UnavailableError(absl::StrFormat("Can't write: %s", temp_path));
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, index_path, error);
+    if (error)
+    {
+        std::filesystem::remove(temp_path);
+        return absl::UnavailableError(
+            absl::StrFormat("Can't rename %s: %s", temp_path, error.message()));
+    }
+    return absl::OkStatus();
+}
+
+//--------------------------------------------------------------------------------------------------
+absl::StatusOr<GfxrCaptureIndexData> LoadGfxrCaptureIndex(const std::string& index_path,
+                                                          const GfxrCaptureIndexKey& key)
+{
+    return LoadIndex(index_path, key, /*blocks_only=*/false);
+}
+
+//--------------------------------------------------------------------------------------------------
+absl::StatusOr<GfxrCaptureIndexData> LoadGfxrCaptureIndexBlocks(const std::string& index_path,
+                                                                const GfxrCaptureIndexKey& key)
+{
+    return LoadIndex(index_path, key, /*blocks_only=*/true);
+}
+
+}  // namespace Dive
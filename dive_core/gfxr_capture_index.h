@@ -0,0 +1,89 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+// The GFXR capture index is a sidecar file, next to a .gfxr capture, that holds everything
+// GfxrCaptureData gets from decoding the capture: the offsets of the blocks and the submits,
+// commands and draw call counts collected by DiveAnnotationProcessor. Loading it skips the decoding
+// pass when a capture is opened again.
+//
+// The index is a cache: it is keyed by the format version, the capture size and a fingerprint of
+// its content, and a stale, truncated or corrupt index is simply ignored. It is written in the
+// native byte order of the host, since it is never shared between machines.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "gfxr_ext/decode/dive_annotation_processor.h"
+
+namespace Dive
+{
+
+// Identifies the capture an index was created from.
+struct GfxrCaptureIndexKey
+{
+    uint64_t file_size = 0;
+    // Last modification time of the capture, so that an edit that keeps the size invalidates the
+    // index even where the fingerprint does not sample the file.
+    int64_t modification_time = 0;
+    // Hash of the size, of the first and last MiB of the capture, and of small regions spread
+    // evenly between them. Hashing the whole capture would take as long as a part of the decoding
+    // that the index saves.
+    uint64_t fingerprint = 0;
+
+    bool operator==(const GfxrCaptureIndexKey&) const = default;
+};
+
+// Results of decoding a GFXR capture.
+struct GfxrCaptureIndexData
+{
+    std::vector<uint64_t> block_offsets;
+    // Index of the first block of each frame.
+    std::vector<uint64_t> frame_first_blocks;
+    std::vector<std::unique_ptr<DiveAnnotationProcessor::SubmitInfo>> submits;
+    std::unordered_map<uint64_t, std::vector<DiveAnnotationProcessor::VulkanCommandInfo>>
+        command_buffers;
+    std::unordered_map<uint64_t, DiveAnnotationProcessor::DrawCallCounts> draw_call_counts;
+};
+
+// Returns the path of the index of `capture_path`.
+std::string GetGfxrCaptureIndexPath(const std::string& capture_path);
+
+// Computes the key of the capture at `capture_path`.
+absl::StatusOr<GfxrCaptureIndexKey> ComputeGfxrCaptureIndexKey(const std::string& capture_path);
+
+// Writes the index to `index_path`. The file is replaced atomically, so a concurrent reader sees
+// either the old or the new index.
+absl::Status SaveGfxrCaptureIndex(const std::string& index_path, const GfxrCaptureIndexKey& key,
+                                  const GfxrCaptureIndexData& data);
+
+// Reads the index at `index_path`. Returns NotFoundError if there is no index, and
+// FailedPreconditionError if it was created from another capture or by another version.
+absl::StatusOr<GfxrCaptureIndexData> LoadGfxrCaptureIndex(const std::string& index_path,
+                                                          const GfxrCaptureIndexKey& key);
+
+// Like LoadGfxrCaptureIndex(), but only reads the block offsets and the frames, which is all that
+// is needed to seek to a part of the capture.
+absl::StatusOr<GfxrCaptureIndexData> LoadGfxrCaptureIndexBlocks(const std::string& index_path,
+                                                                const GfxrCaptureIndexKey& key);
+
+}  // namespace Dive
@@ -13,6 +13,8 @@
 
 #include "dive_core/gfxr_vulkan_command_hierarchy.h"
 
+#include <algorithm>
+#include <cctype>
 #include <functional>
 #include <iostream>
 #include <string_view>
@@ -27,31 +29,33 @@ namespace Dive
 namespace
 {
 
+using ArgValue = VulkanCommandArgs::Value;
+
 // Helper function to extract and convert a value associated with a specific
-// key from a JSON node into a string representation.
-std::string GetValueStr(const nlohmann::ordered_json& node, const std::string& key)
+// key from an argument object into a string representation.
+std::string GetValueStr(const ArgValue& node, std::string_view key)
 {
-    if (node.contains(key))
+    ArgValue val = node.Find(key);
+    if (val.IsValid())
     {
-        const auto& val = node[key];
-        if (val.is_string())
+        if (val.IsString())
         {
-            return val.get<std::string>();
+            return std::string(val.GetString());
         }
-        return val.dump();
+        return val.Dump();
     }
     return "0";
 }
 
 // Appends a summary of draw call arguments (vertex/index count, instance count) to the
 // given stream.
-void AppendDrawCallSummary(std::ostringstream& s, const nlohmann::ordered_json& args,
+void AppendDrawCallSummary(std::ostringstream& s, const ArgValue& args,
                            const std::string& primary_key)
 {
-    if (args.contains(primary_key))
+    if (args.Contains(primary_key))
     {
         s << "(" << primary_key << ": " << GetValueStr(args, primary_key);
-        if (args.contains("instanceCount"))
+        if (args.Contains("instanceCount"))
         {
             std::string instance_count = GetValueStr(args, "instanceCount");
             if (instance_count != "1")
@@ -64,10 +68,10 @@ void AppendDrawCallSummary(std::ostringstream& s, const nlohmann::ordered_json&
 }
 
 // Appends a formatted enum value to the given stream, stripping a specified prefix if present.
-void AppendEnumSummary(std::ostringstream& s, const nlohmann::ordered_json& args,
-                       const std::string& key, const std::string& prefix)
+void AppendEnumSummary(std::ostringstream& s, const ArgValue& args, const std::string& key,
+                       const std::string& prefix)
 {
-    if (args.contains(key))
+    if (args.Contains(key))
     {
         std::string val = GetValueStr(args, key);
         size_t prefix_pos = val.find(prefix);
@@ -81,11 +85,11 @@ void AppendEnumSummary(std::ostringstream& s, const nlohmann::ordered_json& args
 
 // Creates a summary string containing key arguments
 // and their values for a given Vulkan command.
-std::string GetCommandSummary(const std::string& cmd_name, const nlohmann::ordered_json& args)
+std::string GetCommandSummary(const std::string& cmd_name, const ArgValue& args)
 {
     std::ostringstream s;
 
-    using SummaryHandler = std::function<void(std::ostringstream&, const nlohmann::ordered_json&)>;
+    using SummaryHandler = std::function<void(std::ostringstream&, const ArgValue&)>;
 
     static const std::unordered_map<std::string_view, SummaryHandler> handlers = {
         {"vkCmdDrawIndexed",
@@ -94,10 +98,10 @@ std::string GetCommandSummary(const std::string& cmd_name, const nlohmann::order
          [](auto& s, const auto& args) { AppendDrawCallSummary(s, args, "vertexCount"); }},
         {"vkCmdSetViewport",
          [](auto& s, const auto& args) {
-             if (args.contains("pViewports") && args["pViewports"].is_array() &&
-                 !args["pViewports"].empty())
+             ArgValue viewports = args.Find("pViewports");
+             if (viewports.IsArray() && !viewports.Empty())
              {
-                 const auto& vp = args["pViewports"][0];
+                 ArgValue vp = viewports.At(0);
                  s << "(x:" << GetValueStr(vp, "x") << ", y:" << GetValueStr(vp, "y")
                    << ", width:" << GetValueStr(vp, "width")
                    << ", height:" << GetValueStr(vp, "height") << ")";
@@ -105,14 +109,14 @@ std::string GetCommandSummary(const std::string& cmd_name, const nlohmann::order
          }},
         {"vkCmdSetScissor",
          [](auto& s, const auto& args) {
-             if (args.contains("pScissors") && args["pScissors"].is_array() &&
-                 !args["pScissors"].empty())
+             ArgValue scissors = args.Find("pScissors");
+             if (scissors.IsArray() && !scissors.Empty())
              {
-                 const auto& sc = args["pScissors"][0];
-                 if (sc.contains("offset") && sc.contains("extent"))
+                 ArgValue sc = scissors.At(0);
+                 ArgValue offset = sc.Find("offset");
+                 ArgValue extent = sc.Find("extent");
+                 if (offset.IsValid() && extent.IsValid())
                  {
-                     const auto& offset = sc["offset"];
-                     const auto& extent = sc["extent"];
                      s << "(x:" << GetValueStr(offset, "x") << ", y:" << GetValueStr(offset, "y")
                        << ", width:" << GetValueStr(extent, "width")
                        << ", height:" << GetValueStr(extent, "height") << ")";
@@ -121,7 +125,7 @@ std::string GetCommandSummary(const std::string& cmd_name, const nlohmann::order
          }},
         {"vkCmdDispatch",
          [](auto& s, const auto& args) {
-             if (args.contains("groupCountX"))
+             if (args.Contains("groupCountX"))
              {
                  s << "(x:" << GetValueStr(args, "groupCountX")
                    << ", y:" << GetValueStr(args, "groupCountY")
@@ -134,7 +138,7 @@ std::string GetCommandSummary(const std::string& cmd_name, const nlohmann::order
          [](auto& s, const auto& args) { AppendDrawCallSummary(s, args, "drawCount"); }},
         {"vkCmdDrawIndirect",
          [](auto& s, const auto& args) {
-             if (args.contains("drawCount"))
+             if (args.Contains("drawCount"))
              {
                  std::string draw_count = GetValueStr(args, "drawCount");
                  if (draw_count != "1")
@@ -145,7 +149,7 @@ std::string GetCommandSummary(const std::string& cmd_name, const nlohmann::order
          }},
         {"vkCmdDrawIndexedIndirect",
          [](auto& s, const auto& args) {
-             if (args.contains("drawCount"))
+             if (args.Contains("drawCount"))
              {
                  std::string draw_count = GetValueStr(args, "drawCount");
                  if (draw_count != "1")
@@ -160,7 +164,7 @@ std::string GetCommandSummary(const std::string& cmd_name, const nlohmann::order
          }},
         {"vkCmdBindDescriptorSets",
          [](auto& s, const auto& args) {
-             if (args.contains("firstSet") && args.contains("descriptorSetCount"))
+             if (args.Contains("firstSet") && args.Contains("descriptorSetCount"))
              {
                  s << "(firstSet: " << GetValueStr(args, "firstSet")
                    << ", setCount: " << GetValueStr(args, "descriptorSetCount") << ")";
@@ -168,7 +172,7 @@ std::string GetCommandSummary(const std::string& cmd_name, const nlohmann::order
          }},
         {"vkCmdBindVertexBuffers",
          [](auto& s, const auto& args) {
-             if (args.contains("firstBinding") && args.contains("bindingCount"))
+             if (args.Contains("firstBinding") && args.Contains("bindingCount"))
              {
                  s << "(firstBinding: " << GetValueStr(args, "firstBinding")
                    << ", bindingCount: " << GetValueStr(args, "bindingCount") << ")";
@@ -187,8 +191,179 @@ std::string GetCommandSummary(const std::string& cmd_name, const nlohmann::order
     return s.str();
 }
 
+// Adds one node per argument below `parent_index`, recursively. `add_node` takes the description
+// of the node and the index of its parent, and returns the index of the added node.
+using AddArgNodeFunc = std::function<uint64_t(std::string&& desc, uint64_t parent_index)>;
+void CreateArgNodes(const ArgValue& args, uint64_t parent_index, const AddArgNodeFunc& add_node)
+{
+    // This block processes key-value pairs where keys represent field names
+    // and values can be objects, arrays, or primitives.
+    if (args.IsObject())
+    {
+        args.ForEachChild([&](const ArgValue& val) {
+            std::string key(val.GetKey());
+            if (val.IsObject())
+            {
+                // If the value is another object, create a new node for it
+                // and recursively process it.
+                uint64_t object_node_index = add_node(std::move(key), parent_index);
+                CreateArgNodes(val, object_node_index, add_node);
+            }
+            else if (val.IsArray())
+            {
+                // If the value is an array, create a new node for the array
+                // and then iterate through its elements.
+                uint64_t array_node_index = add_node(std::move(key), parent_index);
+                size_t i = 0;
+                val.ForEachChild([&](const ArgValue& element) {
+                    if (element.IsObject())
+                    {
+                        // If an array element is an object, recursively process it.
+                        CreateArgNodes(element, array_node_index, add_node);
+                    }
+                    else if (element.IsArray())
+                    {
+                        // If an array element is a nested array,
+                        // create a node for it and recursively process it.
+                        uint64_t nested_array_node_index =
+                            add_node("element_" + std::to_string(i), array_node_index);
+                        CreateArgNodes(element, nested_array_node_index, add_node);
+                    }
+                    else
+                    {
+                        // If an array element is a primitive,
+                        // create a node containing its string representation.
+                        add_node(element.Dump(), array_node_index);
+                    }
+                    ++i;
+                });
+            }
+            else
+            {
+                // If the value is a primitive,
+                // create a node containing the "key:value" pair.
+                add_node(key + ":" + val.Dump(), parent_index);
+            }
+        });
+    }
+    // This block processes each element of an array.
+    else if (args.IsArray())
+    {
+        args.ForEachChild([&](const ArgValue& element) {
+            if (element.IsObject() || element.IsArray())
+            {
+                // If an array element is an object or another array,
+                // recursively process it, and associate it with the current parent node.
+                CreateArgNodes(element, parent_index, add_node);
+            }
+            else
+            {
+                // If an array element is a primitive, create a node for its string representation.
+                add_node(element.Dump(), parent_index);
+            }
+        });
+    }
+}
+
+// Number of nodes that CreateArgNodes() adds directly below its parent.
+uint64_t CountArgNodes(const ArgValue& args)
+{
+    if (args.IsObject())
+    {
+        return args.Size();
+    }
+    uint64_t count = 0;
+    if (args.IsArray())
+    {
+        args.ForEachChild([&](const ArgValue& element) {
+            count += (element.IsObject() || element.IsArray()) ? CountArgNodes(element) : 1;
+        });
+    }
+    return count;
+}
+
+
+// Whether `text` is in `str`, ignoring the case of ASCII letters.
+bool ContainsIgnoreCase(std::string_view str, std::string_view text)
+{
+    auto equal = [](char a, char b) {
+        return std::tolower(static_cast<unsigned char>(a)) ==
+               std::tolower(static_cast<unsigned char>(b));
+    };
+    return std::search(str.begin(), str.end(), text.begin(), text.end(), equal) != str.end();
+}
+
 }  // namespace
 
+// =================================================================================================
+// GfxrVulkanCommandArgsSource
+// =================================================================================================
+// Keeps a view of the arguments of each command node, and turns them into argument nodes when the
+// command is expanded. The views point into the GfxrCaptureData the hierarchy was created from.
+class GfxrVulkanCommandArgsSource : public CommandHierarchy::PendingChildrenSource
+{
+ public:
+    void SetArgs(uint64_t node_index, const ArgValue& args)
+    {
+        if (node_index >= m_args.size())
+        {
+            m_args.resize(node_index + 1);
+        }
+        m_args[node_index] = {args, CountArgNodes(args)};
+    }
+
+    uint64_t GetNumPendingChildren(uint64_t node_index) const override
+    {
+        if (node_index >= m_args.size())
+        {
+            return 0;
+        }
+        return m_args[node_index].num_children;
+    }
+
+    bool PendingChildrenContain(uint64_t node_index, std::string_view text) const override
+    {
+        if (GetNumPendingChildren(node_index) == 0)
+        {
+            return false;
+        }
+        bool found = false;
+        uint64_t num_nodes = 0;
+        CreateArgNodes(m_args[node_index].args, CommandHierarchy::PendingNode::kExpandedNode,
+                       [&](std::string&& desc, uint64_t) {
+                           found = found || ContainsIgnoreCase(desc, text);
+                           return num_nodes++;
+                       });
+        return found;
+    }
+
+    DiveVector<CommandHierarchy::PendingNode> TakePendingChildren(uint64_t node_index) override
+    {
+        DiveVector<CommandHierarchy::PendingNode> pending_nodes;
+        if (node_index >= m_args.size())
+        {
+            return pending_nodes;
+        }
+        CreateArgNodes(m_args[node_index].args, CommandHierarchy::PendingNode::kExpandedNode,
+                       [&](std::string&& desc, uint64_t parent_index) {
+                           pending_nodes.push_back({NodeType::kGfxrVulkanCommandArgNode,
+                                                    std::move(desc), parent_index});
+                           return pending_nodes.size() - 1;
+                       });
+        m_args[node_index] = PendingArgs();
+        return pending_nodes;
+    }
+
+ private:
+    // The number of children is kept, since the UI asks for it whenever it lays out the node
+    struct PendingArgs
+    {
+        ArgValue args;
+        uint64_t num_children = 0;
+    };
+    DiveVector<PendingArgs> m_args;
+};
+
 // =================================================================================================
 // GfxrVulkanCommandHierarchyCreator
 // =================================================================================================
@@ -223,7 +398,7 @@ void GfxrVulkanCommandHierarchyCreator::OnCommand(
     std::vector<uint64_t>& render_pass_draw_call_counts)
 {
     const std::string& vulkan_cmd_name = vk_cmd_info.name;
-    const nlohmann::ordered_json& vulkan_cmd_args = vk_cmd_info.args;
+    ArgValue vulkan_cmd_args = vk_cmd_info.args.GetRoot();
     std::ostringstream vk_cmd_string_stream;
     vk_cmd_string_stream << vulkan_cmd_name;
     vk_cmd_string_stream << GetCommandSummary(vulkan_cmd_name, vulkan_cmd_args);
@@ -234,7 +409,7 @@ void GfxrVulkanCommandHierarchyCreator::OnCommand(
         uint64_t cmd_buffer_index =
             AddNode(NodeType::kGfxrVulkanBeginCommandBufferNode, vk_cmd_string_stream.str());
         m_cur_command_buffer_node_index = cmd_buffer_index;
-        GetArgs(vulkan_cmd_args, m_cur_command_buffer_node_index);
+        AddArgs(vulkan_cmd_args, m_cur_command_buffer_node_index);
         AddChild(CommandHierarchy::TopologyType::kAllEventTopology, m_cur_submit_node_index,
                  cmd_buffer_index);
     }
@@ -243,17 +418,17 @@ void GfxrVulkanCommandHierarchyCreator::OnCommand(
         uint64_t cmd_buffer_index =
             AddNode(NodeType::kGfxrVulkanEndCommandBufferNode, vk_cmd_string_stream.str());
 
-        GetArgs(vulkan_cmd_args, cmd_buffer_index);
+        AddArgs(vulkan_cmd_args, cmd_buffer_index);
         AddChild(CommandHierarchy::TopologyType::kAllEventTopology, m_cur_command_buffer_node_index,
                  cmd_buffer_index);
     }
     else if (vulkan_cmd_name.find("BeginDebugUtilsLabelEXT") != std::string::npos)
     {
-        std::string label_name = vulkan_cmd_args["pLabelInfo"]["pLabelName"];
+        std::string label_name(vulkan_cmd_args.Find("pLabelInfo").Find("pLabelName").GetString());
 
         uint64_t begin_debug_utils_label_cmd_index =
             AddNode(NodeType::kGfxrBeginDebugUtilsLabelCommandNode, label_name.c_str());
-        GetArgs(vulkan_cmd_args, begin_debug_utils_label_cmd_index);
+        AddArgs(vulkan_cmd_args, begin_debug_utils_label_cmd_index);
         ConditionallyAddChild(begin_debug_utils_label_cmd_index);
         m_cur_parent_node_index_stack.push(begin_debug_utils_label_cmd_index);
     }
@@ -272,7 +447,7 @@ void GfxrVulkanCommandHierarchyCreator::OnCommand(
     {
         uint64_t vk_cmd_index =
             AddNode(NodeType::kGfxrVulkanDrawCommandNode, vk_cmd_string_stream.str());
-        GetArgs(vulkan_cmd_args, vk_cmd_index);
+        AddArgs(vulkan_cmd_args, vk_cmd_index);
         ConditionallyAddChild(vk_cmd_index);
     }
     else if (vulkan_cmd_name.find("vkCmdBeginRenderPass") != std::string::npos)
@@ -285,7 +460,7 @@ void GfxrVulkanCommandHierarchyCreator::OnCommand(
         vk_cmd_string_stream << ", Draw Call Count: " << draw_call_count;
         uint64_t vk_cmd_index =
             AddNode(NodeType::kGfxrVulkanBeginRenderPassCommandNode, vk_cmd_string_stream.str());
-        GetArgs(vulkan_cmd_args, vk_cmd_index);
+        AddArgs(vulkan_cmd_args, vk_cmd_index);
         ConditionallyAddChild(vk_cmd_index);
         m_cur_parent_node_index_stack.push(vk_cmd_index);
     }
@@ -293,7 +468,7 @@ void GfxrVulkanCommandHierarchyCreator::OnCommand(
     {
         uint64_t vk_cmd_index =
             AddNode(NodeType::kGfxrVulkanEndRenderPassCommandNode, vk_cmd_string_stream.str());
-        GetArgs(vulkan_cmd_args, vk_cmd_index);
+        AddArgs(vulkan_cmd_args, vk_cmd_index);
         ConditionallyAddChild(vk_cmd_index);
         if (!m_cur_parent_node_index_stack.empty())
         {
@@ -326,7 +501,7 @@ void GfxrVulkanCommandHierarchyCreator::OnCommand(
         }
 
         uint64_t vk_cmd_index = AddNode(node_type, vk_cmd_string_stream.str());
-        GetArgs(vulkan_cmd_args, vk_cmd_index);
+        AddArgs(vulkan_cmd_args, vk_cmd_index);
         ConditionallyAddChild(vk_cmd_index);
     }
 }
@@ -340,7 +515,7 @@ bool GfxrVulkanCommandHierarchyCreator::ProcessVkCmds(
 
     for (uint32_t i = 0; i < vkCmds.size(); ++i)
     {
-        DiveAnnotationProcessor::VulkanCommandInfo vk_cmd_info = vkCmds[i];
+        const DiveAnnotationProcessor::VulkanCommandInfo& vk_cmd_info = vkCmds[i];
         OnCommand(vk_cmd_info, draw_call_count, mutable_render_pass_draw_call_counts);
     }
 
@@ -397,6 +572,7 @@ bool GfxrVulkanCommandHierarchyCreator::CreateTrees(bool used_in_mixed_command_h
     if (!m_used_in_mixed_command_hierarchy)
     {
         m_command_hierarchy = CommandHierarchy();
+        m_args_source = std::make_unique<GfxrVulkanCommandArgsSource>();
 
         // Add a dummy root node for easier management
         uint64_t root_node_index = AddNode(NodeType::kRootNode, "");
@@ -409,6 +585,7 @@ bool GfxrVulkanCommandHierarchyCreator::CreateTrees(bool used_in_mixed_command_h
 
         // Convert the info in m_gfxr_node_children into GfxrVulkanCommandHierarchy's topologies
         CreateTopologies();
+        m_command_hierarchy.m_pending_children_source = std::move(m_args_source);
     }
 
     return true;
@@ -456,93 +633,29 @@ void GfxrVulkanCommandHierarchyCreator::AddChild(CommandHierarchy::TopologyType
     }
 }
 
-void GfxrVulkanCommandHierarchyCreator::GetArgs(const nlohmann::ordered_json& json_args,
+void GfxrVulkanCommandHierarchyCreator::GetArgs(const VulkanCommandArgs::Value& args,
                                                 uint64_t curr_index)
 {
-    // This block processes key-value pairs where keys represent field names
-    // and values can be objects, arrays, or primitives.
-    if (json_args.is_object())
-    {
-        for (auto const& [key, val] : json_args.items())
-        {
-            if (val.is_object())
-            {
-                // If the value is another object, create a new node for it
-                // and recursively process it.
-                uint64_t object_node_index =
-                    AddNode(NodeType::kGfxrVulkanCommandArgNode, key.c_str());
-                AddChild(CommandHierarchy::TopologyType::kAllEventTopology, curr_index,
-                         object_node_index);
+    CreateArgNodes(args, curr_index, [this](std::string&& desc, uint64_t parent_index) {
+        uint64_t arg_index = AddNode(NodeType::kGfxrVulkanCommandArgNode, std::move(desc));
+        AddChild(CommandHierarchy::TopologyType::kAllEventTopology, parent_index, arg_index);
+        return arg_index;
+    });
+}
 
-                GetArgs(val, object_node_index);
-            }
-            else if (val.is_array())
-            {
-                // If the value is an array, create a new node for the array
-                // and then iterate through its elements.
-                uint64_t array_node_index =
-                    AddNode(NodeType::kGfxrVulkanCommandArgNode, key.c_str());
-                AddChild(CommandHierarchy::TopologyType::kAllEventTopology, curr_index,
-                         array_node_index);
-                for (size_t i = 0; i < val.size(); ++i)
-                {
-                    const auto& element = val[i];
-                    if (element.is_object())
-                    {
-                        // If an array element is an object, recursively process it.
-                        GetArgs(element, array_node_index);
-                    }
-                    else if (element.is_array())
-                    {
-                        // If an array element is a nested array,
-                        // create a node for it and recursively process it.
-                        uint64_t nested_array_node_index = AddNode(
-                            NodeType::kGfxrVulkanCommandArgNode, "element_" + std::to_string(i));
-                        AddChild(CommandHierarchy::TopologyType::kAllEventTopology,
-                                 array_node_index, nested_array_node_index);
-                        GetArgs(element, nested_array_node_index);
-                    }
-                    else
-                    {
-                        // If an array element is a primitive,
-                        // create a node containing its string representation.
-                        uint64_t arg_index =
-                            AddNode(NodeType::kGfxrVulkanCommandArgNode, element.dump());
-                        AddChild(CommandHierarchy::TopologyType::kAllEventTopology,
-                                 array_node_index, arg_index);
-                    }
-                }
-            }
-            else
-            {
-                // If the value is a primitive,
-                // create a node containing the "key:value" pair.
-                uint64_t vk_cmd_arg_index =
-                    AddNode(NodeType::kGfxrVulkanCommandArgNode, key + ":" + val.dump());
-                AddChild(CommandHierarchy::TopologyType::kAllEventTopology, curr_index,
-                         vk_cmd_arg_index);
-            }
-        }
+//--------------------------------------------------------------------------------------------------
+void GfxrVulkanCommandHierarchyCreator::AddArgs(const VulkanCommandArgs::Value& args,
+                                                uint64_t curr_index)
+{
+    if (m_used_in_mixed_command_hierarchy)
+    {
+        // The mixed hierarchy merges the GFXR nodes into the PM4 topology in one pass, so the
+        // arguments are created right away
+        GetArgs(args, curr_index);
     }
-    // This block processes each element of an array.
-    else if (json_args.is_array())
+    else
     {
-        for (size_t i = 0; i < json_args.size(); ++i)
-        {
-            const auto& element = json_args[i];
-            if (element.is_object() || element.is_array())
-            {
-                // If an array element is an object or another array,
-                // recursively process it, and associate it with the current parent node.
-                GetArgs(element, curr_index);
-            }
-            else
-            {
-                // If an array element is a primitive, create a node for its string representation.
-                uint64_t arg_index = AddNode(NodeType::kGfxrVulkanCommandArgNode, element.dump());
-                AddChild(CommandHierarchy::TopologyType::kAllEventTopology, curr_index, arg_index);
-            }
-        }
+        m_args_source->SetArgs(curr_index, args);
     }
 }
 
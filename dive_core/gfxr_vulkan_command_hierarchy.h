@@ -19,6 +19,7 @@
 // UI.
 // =====================================================================================================================
 
+#include <memory>
 #include <stack>
 
 #include "dive_core/command_hierarchy.h"
@@ -27,6 +28,8 @@
 
 namespace Dive
 {
+class GfxrVulkanCommandArgsSource;
+
 class GfxrVulkanCommandHierarchyCreator
 {
  public:
@@ -59,9 +62,13 @@ class GfxrVulkanCommandHierarchyCreator
     void ClearCreatedDiveIndices() { m_dive_indices_to_local_indices_map.clear(); }
 
  private:
-    // Helper function to parse json representation of GFXR file into nodes and make calls to
+    // Helper function to parse the arguments of a GFXR command into nodes and make calls to
     // AddNode() and AddChild() in hiearachical order.
-    void GetArgs(const nlohmann::ordered_json& json_args, uint64_t curr_index);
+    void GetArgs(const VulkanCommandArgs::Value& args, uint64_t curr_index);
+
+    // Adds the argument nodes of a command. Outside of a mixed hierarchy, they are only created
+    // when the command is expanded, see CommandHierarchy::ExpandNode().
+    void AddArgs(const VulkanCommandArgs::Value& args, uint64_t curr_index);
 
     void CreateTopologies();
 
@@ -88,5 +95,7 @@ class GfxrVulkanCommandHierarchyCreator
     Topology m_topology[CommandHierarchy::kTopologyTypeCount];
     bool m_used_in_mixed_command_hierarchy = false;
     std::unordered_map<uint64_t, uint64_t> m_dive_indices_to_local_indices_map;
+    // Handed over to m_command_hierarchy once the trees are created
+    std::unique_ptr<GfxrVulkanCommandArgsSource> m_args_source;
 };
 }  // namespace Dive
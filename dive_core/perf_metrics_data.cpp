@@ -15,19 +15,25 @@
 
 #include <math.h>
 
+#include <algorithm>
 #include <array>
+#include <cassert>
 #include <cctype>
 #include <cerrno>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <limits>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -35,17 +41,15 @@
 #include "absl/base/no_destructor.h"
 #include "dive_core/available_metrics.h"
 #include "dive_core/command_hierarchy.h"
-#include "utils/string_utils.h"
+#include "dive_core/task_scheduler.h"
+#include "utils/csv_reader.h"
 
 namespace Dive
 {
 namespace
 {
 
-bool IsMetricsRecordDrawOrDispatch(const PerfMetricsRecord& record)
-{
-    return record.m_draw_type == 1 || record.m_draw_type == 3;
-}
+bool IsMetricsRecordDrawOrDispatch(uint8_t draw_type) { return draw_type == 1 || draw_type == 3; }
 
 // A wrapper type for uint64_t / size_t to reduce the chance of using the wrong index.
 template <typename ValueT, typename TagT = void>
@@ -118,28 +122,388 @@ class IndexWrapper
     ValueType m_value = kInvalid;
 };
 
+// Aligns the sequences a[0, n) and b[0, m) with the fewest insertions and deletions, using Myers'
+// O((n + m) * d) diff, where `equal(x, y)` compares a[x] and b[y]. Returns the index in `b` matched
+// to each element of `a`, or std::nullopt for unmatched elements. Gives up if the sequences need
+// more than `max_edits` insertions and deletions.
+template <typename EqualFn>
+std::optional<std::vector<std::optional<size_t>>> AlignSequences(size_t n, size_t m,
+                                                                  size_t max_edits, EqualFn equal)
+{
+    const ptrdiff_t size_a = static_cast<ptrdiff_t>(n);
+    const ptrdiff_t size_b = static_cast<ptrdiff_t>(m);
+    const ptrdiff_t max_d = static_cast<ptrdiff_t>(max_edits);
+    if (std::abs(size_a - size_b) > max_d)
+    {
+        return std::nullopt;
+    }
+
+    // frontier[offset + k] is the furthest x reached on diagonal k = x - y, or -1 if none.
+    const ptrdiff_t offset = max_d + 1;
+    std::vector<ptrdiff_t> frontier(2 * max_d + 3, -1);
+    // Start of the snake on diagonal k with d edits, and the diagonal of its last edit, given
+    // the frontier after d - 1 edits.
+    auto Step = [&](const std::vector<ptrdiff_t>& prev, ptrdiff_t d,
+                    ptrdiff_t k) -> std::pair<ptrdiff_t, ptrdiff_t> {
+        if (d == 0)
+        {
+            return {0, 0};
+        }
+        ptrdiff_t x = -1;
+        ptrdiff_t prev_k = 0;
+        // Insertion: one more element of `b`.
+        if (k < d && prev[offset + k + 1] >= 0 && prev[offset + k + 1] - k <= size_b)
+        {
+            x = prev[offset + k + 1];
+            prev_k = k + 1;
+        }
+        // Deletion: one more element of `a`.
+        if (k > -d && prev[offset + k - 1] >= 0 && prev[offset + k - 1] + 1 <= size_a &&
+            prev[offset + k - 1] + 1 > x)
+        {
+            x = prev[offset + k - 1] + 1;
+            prev_k = k - 1;
+        }
+        return {x, prev_k};
+    };
+
+    std::vector<std::vector<ptrdiff_t>> history;
+    for (ptrdiff_t d = 0; d <= max_d; ++d)
+    {
+        history.push_back(frontier);
+        for (ptrdiff_t k = -d; k <= d; k += 2)
+        {
+            ptrdiff_t x = Step(history.back(), d, k).first;
+            if (x < 0)
+            {
+                frontier[offset + k] = -1;
+                continue;
+            }
+            ptrdiff_t y = x - k;
+            while (x < size_a && y < size_b && equal(x, y))
+            {
+                ++x;
+                ++y;
+            }
+            frontier[offset + k] = x;
+            if (x != size_a || y != size_b)
+            {
+                continue;
+            }
+
+            // Walk the edits back, recording the matches of each snake.
+            std::vector<std::optional<size_t>> matches(n);
+            for (ptrdiff_t edit = d; edit >= 0; --edit)
+            {
+                auto [snake_start, prev_k] = Step(history[edit], edit, k);
+                for (; x > snake_start; --x, --y)
+                {
+                    matches[x - 1] = static_cast<size_t>(y - 1);
+                }
+                if (edit > 0)
+                {
+                    x = history[edit][offset + prev_k];
+                    y = x - prev_k;
+                    k = prev_k;
+                }
+            }
+            return matches;
+        }
+    }
+    return std::nullopt;
+}
+
+// Bounds the cost of aligning a frame, which is quadratic in the number of edits.
+constexpr size_t kMaxAlignmentEdits = 256;
+
+// Estimates the median of a stream with the P-square algorithm (Jain and Chlamtac, 1985), which
+// keeps 5 markers instead of the samples: the minimum, the quartiles and the maximum, with their
+// ranks.
+class StreamingMedian
+{
+ public:
+    // Starts from at least 5 sorted samples, with each marker on the sample of its rank.
+    void Init(std::span<const double> sorted_samples)
+    {
+        assert(sorted_samples.size() >= kMarkerCount);
+        const double last = static_cast<double>(sorted_samples.size() - 1);
+        for (size_t i = 0; i < kMarkerCount; ++i)
+        {
+            m_desired_positions[i] = 1.0 + last * kIncrements[i];
+            m_positions[i] = std::round(m_desired_positions[i]);
+            m_heights[i] = sorted_samples[static_cast<size_t>(m_positions[i]) - 1];
+        }
+    }
+
+    void Add(double value)
+    {
+        // Find the cell of the value, and extend the extreme markers to it
+        size_t cell = 0;
+        if (value < m_heights[0])
+        {
+            m_heights[0] = value;
+        }
+        else if (value >= m_heights[kMarkerCount - 1])
+        {
+            m_heights[kMarkerCount - 1] = value;
+            cell = kMarkerCount - 2;
+        }
+        else
+        {
+            while (value >= m_heights[cell + 1])
+            {
+                ++cell;
+            }
+        }
+        for (size_t i = cell + 1; i < kMarkerCount; ++i)
+        {
+            m_positions[i] += 1.0;
+        }
+        for (size_t i = 0; i < kMarkerCount; ++i)
+        {
+            m_desired_positions[i] += kIncrements[i];
+        }
+
+        // Move the middle markers by one rank when they are off, if there is room for it
+        for (size_t i = 1; i < kMarkerCount - 1; ++i)
+        {
+            double offset = m_desired_positions[i] - m_positions[i];
+            if ((offset >= 1.0 && m_positions[i + 1] - m_positions[i] > 1.0) ||
+                (offset <= -1.0 && m_positions[i - 1] - m_positions[i] < -1.0))
+            {
+                double step = offset > 0.0 ? 1.0 : -1.0;
+                double height = Parabolic(i, step);
+                if (m_heights[i - 1] < height && height < m_heights[i + 1])
+                {
+                    m_heights[i] = height;
+                }
+                else
+                {
+                    size_t neighbor = step > 0.0 ? i + 1 : i - 1;
+                    m_heights[i] += step * (m_heights[neighbor] - m_heights[i]) /
+                                    (m_positions[neighbor] - m_positions[i]);
+                }
+                m_positions[i] += step;
+            }
+        }
+    }
+
+    double Get() const { return m_heights[kMarkerCount / 2]; }
+
+ private:
+    static constexpr size_t kMarkerCount = 5;
+    // Quantile of each marker, which is also how far its desired rank moves per sample
+    static constexpr std::array<double, kMarkerCount> kIncrements = {0.0, 0.25, 0.5, 0.75, 1.0};
+
+    // Piecewise-parabolic prediction of the height of marker `i` moved by `step` ranks
+    double Parabolic(size_t i, double step) const
+    {
+        const auto& n = m_positions;
+        const auto& q = m_heights;
+        return q[i] + step / (n[i + 1] - n[i - 1]) *
+                          ((n[i] - n[i - 1] + step) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+                           (n[i + 1] - n[i] - step) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+    }
+
+    std::array<double, kMarkerCount> m_heights = {};
+    std::array<double, kMarkerCount> m_positions = {};
+    std::array<double, kMarkerCount> m_desired_positions = {};
+};
+
+// Accumulates the distribution of one metric for every draw of the frame pattern, one frame at a
+// time: mean and variance with Welford's method, and the median. The first samples of each draw
+// are kept, so that the median of short captures is exact; past that, it is estimated with
+// StreamingMedian, so memory doesn't grow with the number of frames.
+class PatternStatsAccumulator
+{
+ public:
+    static constexpr size_t kMaxExactMedianSamples = 64;
+
+    PatternStatsAccumulator(size_t pattern_size, size_t max_sample_count)
+        : m_stats(pattern_size),
+          m_m2(pattern_size, 0.0),
+          m_exact_sample_count(std::min(max_sample_count, kMaxExactMedianSamples))
+    {
+        m_samples.resize(pattern_size * m_exact_sample_count);
+        if (max_sample_count > m_exact_sample_count)
+        {
+            m_medians.resize(pattern_size);
+        }
+    }
+
+    void Add(size_t pattern_index, double value)
+    {
+        PerfMetricsStats& stats = m_stats[pattern_index];
+        if (stats.m_sample_count < m_exact_sample_count)
+        {
+            m_samples[pattern_index * m_exact_sample_count + stats.m_sample_count] = value;
+        }
+        else
+        {
+            assert(!m_medians.empty());
+            if (stats.m_sample_count == m_exact_sample_count)
+            {
+                std::span<double> samples(m_samples.data() + pattern_index * m_exact_sample_count,
+                                          m_exact_sample_count);
+                std::sort(samples.begin(), samples.end());
+                m_medians[pattern_index].Init(samples);
+            }
+            m_medians[pattern_index].Add(value);
+        }
+        ++stats.m_sample_count;
+        if (stats.m_sample_count == 1)
+        {
+            stats.m_min = value;
+            stats.m_max = value;
+        }
+        stats.m_min = std::min(stats.m_min, value);
+        stats.m_max = std::max(stats.m_max, value);
+        double delta = value - stats.m_mean;
+        stats.m_mean += delta / stats.m_sample_count;
+        m_m2[pattern_index] += delta * (value - stats.m_mean);
+    }
+
+    std::vector<PerfMetricsStats> Finish()
+    {
+        for (size_t i = 0; i < m_stats.size(); ++i)
+        {
+            PerfMetricsStats& stats = m_stats[i];
+            const size_t count = stats.m_sample_count;
+            if (count == 0)
+            {
+                continue;
+            }
+            if (count > 1)
+            {
+                stats.m_stddev = std::sqrt(m_m2[i] / static_cast<double>(count - 1));
+            }
+            double outlier_distance = PerfMetricsStats::kOutlierStddevs * stats.m_stddev;
+            stats.m_has_outliers = stats.m_stddev > 0.0 &&
+                                   (stats.m_max - stats.m_mean > outlier_distance ||
+                                    stats.m_mean - stats.m_min > outlier_distance);
+
+            if (count > m_exact_sample_count)
+            {
+                stats.m_median = m_medians[i].Get();
+                continue;
+            }
+            auto begin = m_samples.begin() + i * m_exact_sample_count;
+            auto middle = begin + count / 2;
+            std::nth_element(begin, middle, begin + count);
+            stats.m_median = *middle;
+            if (count % 2 == 0)
+            {
+                stats.m_median = (stats.m_median + *std::max_element(begin, middle)) / 2.0;
+            }
+        }
+        return std::move(m_stats);
+    }
+
+ private:
+    std::vector<PerfMetricsStats> m_stats;
+    std::vector<double> m_m2;
+    // The first m_exact_sample_count samples of each draw
+    std::vector<double> m_samples;
+    std::vector<StreamingMedian> m_medians;
+    size_t m_exact_sample_count;
+};
+
 }  // namespace
 
 namespace
 {
 
+// Whether all the metrics are known and of a supported type.
+bool AreMetricsSupported(const std::vector<const MetricInfo*>& metric_infos)
+{
+    for (const MetricInfo* info : metric_infos)
+    {
+        if (info == nullptr)
+        {
+            std::cerr << "Found unknown metric." << std::endl;
+            return false;
+        }
+        switch (info->m_metric_type)
+        {
+            case MetricType::kCount:
+            case MetricType::kPercent:
+                break;
+            default:
+                std::cerr << "Unknown metric type: " << static_cast<int>(info->m_metric_type)
+                          << std::endl;
+                // kUnknown or other types are not supported.
+                return false;
+        }
+    }
+    return true;
+}
+
+constexpr std::array<char, 8> kPerfMetricsBinaryMagic = {'D', 'I', 'V', 'E', 'P', 'M', 'D', '\0'};
+constexpr uint32_t kPerfMetricsBinaryVersion = 1;
+constexpr size_t kPerfMetricsBinaryAlignment = 8;
+
+struct PerfMetricsBinaryHeader
+{
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t metric_count;
+    uint64_t record_count;
+};
+static_assert(sizeof(PerfMetricsBinaryHeader) % kPerfMetricsBinaryAlignment == 0);
+
+size_t AlignBinarySection(size_t size)
+{
+    return (size + kPerfMetricsBinaryAlignment - 1) & ~(kPerfMetricsBinaryAlignment - 1);
+}
+
+template <typename T>
+void WriteBinaryColumn(std::ostream& stream, const std::vector<T>& column)
+{
+    static constexpr char kPadding[kPerfMetricsBinaryAlignment] = {};
+    size_t size = column.size() * sizeof(T);
+    stream.write(reinterpret_cast<const char*>(column.data()), size);
+    stream.write(kPadding, AlignBinarySection(size) - size);
+}
+
+// Copies `count` elements at `offset` in `data` into `column`, then moves `offset` to the next
+// section. Returns false if the data is too short.
+template <typename T>
+bool ReadBinaryColumn(std::string_view data, size_t& offset, size_t count, std::vector<T>& column)
+{
+    size_t available = data.size() - offset;
+    if (count > available / sizeof(T))
+    {
+        return false;
+    }
+    size_t size = count * sizeof(T);
+    column.resize(count);
+    std::memcpy(column.data(), data.data() + offset, size);
+    offset = std::min(offset + AlignBinarySection(size), data.size());
+    return true;
+}
+
+// Data lines are parsed in parallel once there is at least this much per thread.
+constexpr size_t kMinCsvChunkSize = 4 * 1024 * 1024;
+
 struct ParseHeadersResult
 {
     std::vector<std::string> metric_names;
     std::vector<const MetricInfo*> metric_infos;
 };
 
-std::optional<ParseHeadersResult> ParseHeaders(const std::string& line,
+std::optional<ParseHeadersResult> ParseHeaders(std::span<const std::string_view> fields,
                                                const AvailableMetrics& available_metrics)
 {
+    if (fields.size() < kFixedPerfMetricsDataHeaderCount)
+    {
+        return std::nullopt;  // Not enough columns
+    }
+
     std::vector<const MetricInfo*> metric_infos;
     std::vector<std::string> metric_names;
-
-    std::stringstream header_ss(line);
-    std::string header_field;
-    int column_index = 0;
-    while (StringUtils::GetTrimmedField(header_ss, header_field, ','))
+    for (size_t column_index = 0; column_index < fields.size(); ++column_index)
     {
+        std::string_view header_field = fields[column_index];
         if (column_index < kFixedPerfMetricsDataHeaderCount)
         {
             if (header_field != kFixedHeaders[column_index])
@@ -147,20 +511,15 @@ std::optional<ParseHeadersResult> ParseHeaders(const std::string& line,
         }
         else
         {
-            metric_names.push_back(header_field);
-            metric_infos.push_back(available_metrics.GetMetricInfo(header_field));
+            metric_names.emplace_back(header_field);
+            metric_infos.push_back(available_metrics.GetMetricInfo(metric_names.back()));
         }
-        column_index++;
-    }
-    if (column_index < kFixedPerfMetricsDataHeaderCount)
-    {
-        return std::nullopt;  // Not enough columns
     }
 
     return ParseHeadersResult{std::move(metric_names), std::move(metric_infos)};
 }
 
-std::optional<PerfMetricsRecord> ParseRecordFixedFields(const std::vector<std::string>& fields)
+std::optional<PerfMetricsRecord> ParseRecordFixedFields(std::span<const std::string_view> fields)
 {
     if (fields.size() < kFixedPerfMetricsDataHeaderCount)
     {
@@ -168,27 +527,29 @@ std::optional<PerfMetricsRecord> ParseRecordFixedFields(const std::vector<std::s
     }
 
     PerfMetricsRecord record{};
-    if (!StringUtils::SafeConvertFromString(fields[0], record.m_context_id) ||
-        !StringUtils::SafeConvertFromString(fields[1], record.m_process_id) ||
-        !StringUtils::SafeConvertFromString(fields[2], record.m_frame_id) ||
-        !StringUtils::SafeConvertFromString(fields[3], record.m_cmd_buffer_id) ||
-        !StringUtils::SafeConvertFromString(fields[4], record.m_draw_id) ||
-        !StringUtils::SafeConvertFromString(fields[5], record.m_draw_type) ||
-        !StringUtils::SafeConvertFromString(fields[6], record.m_draw_label) ||
-        !StringUtils::SafeConvertFromString(fields[7], record.m_program_id) ||
-        !StringUtils::SafeConvertFromString(fields[8], record.m_lrz_state))
+    if (!ParseCsvNumber(fields[0], record.m_context_id) ||
+        !ParseCsvNumber(fields[1], record.m_process_id) ||
+        !ParseCsvNumber(fields[2], record.m_frame_id) ||
+        !ParseCsvNumber(fields[3], record.m_cmd_buffer_id) ||
+        !ParseCsvNumber(fields[4], record.m_draw_id) ||
+        !ParseCsvNumber(fields[5], record.m_draw_type) ||
+        !ParseCsvNumber(fields[6], record.m_draw_label) ||
+        !ParseCsvNumber(fields[7], record.m_program_id) ||
+        !ParseCsvNumber(fields[8], record.m_lrz_state))
     {
         return std::nullopt;  // Parsing failed
     }
     return record;
 }
 
-bool ParseMetrics(const std::vector<std::string>& fields,
-                  const std::vector<const MetricInfo*>& metric_infos, PerfMetricsRecord& record)
+bool ParseMetrics(std::span<const std::string_view> fields,
+                  const std::vector<const MetricInfo*>& metric_infos,
+                  std::vector<double>& metric_values)
 {
+    metric_values.clear();
     for (size_t i = 0; i < metric_infos.size(); ++i)
     {
-        const std::string& value_str = fields[kFixedPerfMetricsDataHeaderCount + i];
+        std::string_view value_str = fields[kFixedPerfMetricsDataHeaderCount + i];
         const MetricInfo* info = metric_infos[i];
         if (info == nullptr)
         {
@@ -198,36 +559,66 @@ bool ParseMetrics(const std::vector<std::string>& fields,
         }
 
         double value = NAN;
-        if (!StringUtils::SafeConvertFromString(value_str, value))
+        if (!ParseCsvNumber(value_str, value))
         {
             return false;
         }
-        record.m_metric_values.emplace_back(value);
+        metric_values.emplace_back(value);
     }
     return true;
 }
 
+// Parses the data lines in `chunk` into `records`, skipping malformed lines.
+void ParseRecords(std::string_view chunk,
+                  const std::vector<const MetricInfo*>& metric_infos,
+                  PerfMetricsColumns& records)
+{
+    CsvReader reader(chunk);
+    std::vector<std::string_view> fields;
+    std::vector<double> metric_values;
+    metric_values.reserve(metric_infos.size());
+    while (reader.ReadRecord(fields))
+    {
+        if (fields.size() != kFixedPerfMetricsDataHeaderCount + metric_infos.size())
+        {
+            continue;  // Skip malformed lines
+        }
+
+        auto record = ParseRecordFixedFields(fields);
+        if (!record.has_value())
+        {
+            continue;  // Skip malformed lines
+        }
+
+        if (ParseMetrics(fields, metric_infos, metric_values))
+        {
+            records.AddRecord(*record, metric_values);
+        }
+    }
+}
+
 }  // namespace
 
 std::unique_ptr<PerfMetricsData> PerfMetricsData::LoadFromCsv(
-    const std::filesystem::path& file_path, const AvailableMetrics& available_metrics)
+    const std::filesystem::path& file_path, const AvailableMetrics& available_metrics,
+    size_t thread_count)
 {
-    std::vector<PerfMetricsRecord> records;
-
-    std::ifstream file(file_path);
-    if (!file.is_open())
+    MappedFile file;
+    if (!file.Open(file_path))
     {
         std::cerr << "Failed to open file: " << file_path << std::endl;
         return nullptr;
     }
+    std::string_view contents = file.GetContents();
 
-    std::string line;
     // Read header line
-    if (!StringUtils::GetTrimmedLine(file, line) || line.empty())
+    CsvReader header_reader(contents);
+    std::vector<std::string_view> header_fields;
+    if (!header_reader.ReadRecord(header_fields))
     {
         return nullptr;
     }
-    auto headers_opt = ParseHeaders(line, available_metrics);
+    auto headers_opt = ParseHeaders(header_fields, available_metrics);
     if (!headers_opt.has_value())
     {
         return nullptr;
@@ -236,61 +627,245 @@ std::unique_ptr<PerfMetricsData> PerfMetricsData::LoadFromCsv(
     auto& metric_names = headers_opt->metric_names;
     auto& metric_infos = headers_opt->metric_infos;
 
-    for (size_t i = 0; i < metric_infos.size(); ++i)
+    if (!AreMetricsSupported(metric_infos))
     {
-        const MetricInfo* info = metric_infos[i];
-        if (info == nullptr)
-        {
-            std::cerr << "Found unknown metric." << std::endl;
-            return nullptr;
-        }
-        switch (info->m_metric_type)
-        {
-            case MetricType::kCount:
-            case MetricType::kPercent:
-                break;
-            default:
-                std::cerr << "Unknown metric type: " << static_cast<int>(info->m_metric_type)
-                          << std::endl;
-                // kUnknown or other types are not supported.
-                return nullptr;
-        }
+        return nullptr;
+    }
+
+    // Read data lines, in chunks split on line boundaries when the file is large enough
+    std::string_view data = contents.substr(header_reader.GetOffset());
+    TaskScheduler& scheduler = TaskScheduler::GetDefault();
+    if (thread_count == 0)
+    {
+        thread_count = scheduler.GetWorkerCount() + 1;
     }
-    // Read data lines
-    while (StringUtils::GetTrimmedLine(file, line))
+    size_t chunk_count = std::clamp<size_t>(data.size() / kMinCsvChunkSize, 1, thread_count);
+    std::vector<std::string_view> chunks = SplitCsvChunks(data, chunk_count);
+    std::vector<PerfMetricsColumns> chunk_records(chunks.size(),
+                                                  PerfMetricsColumns(metric_names.size()));
     {
-        std::stringstream ss(line);
-        std::string field;
-        std::vector<std::string> fields;
-        while (StringUtils::GetTrimmedField(ss, field, ','))
+        TaskGroup group(scheduler);
+        for (size_t i = 1; i < chunks.size(); ++i)
         {
-            fields.push_back(field);
+            group.Run([&, i]() { ParseRecords(chunks[i], metric_infos, chunk_records[i]); });
         }
+        ParseRecords(chunks[0], metric_infos, chunk_records[0]);
+        group.Wait();
+    }
 
-        if (fields.size() != kFixedPerfMetricsDataHeaderCount + metric_names.size())
-        {
-            continue;  // Skip malformed lines
-        }
+    PerfMetricsColumns records = std::move(chunk_records[0]);
+    for (size_t i = 1; i < chunk_records.size(); ++i)
+    {
+        records.Append(chunk_records[i]);
+    }
 
-        auto record = ParseRecordFixedFields(fields);
-        if (!record.has_value())
-        {
-            continue;  // Skip malformed lines
-        }
+    return std::unique_ptr<PerfMetricsData>(
+        new PerfMetricsData(std::move(metric_names), std::move(metric_infos), std::move(records)));
+}
 
-        if (ParseMetrics(fields, metric_infos, *record))
-        {
-            records.push_back(*std::move(record));
-        }
+std::unique_ptr<PerfMetricsData> PerfMetricsData::LoadFromBinary(
+    const std::filesystem::path& file_path, const AvailableMetrics& available_metrics)
+{
+    MappedFile file;
+    if (!file.Open(file_path))
+    {
+        std::cerr << "Failed to open file: " << file_path << std::endl;
+        return nullptr;
+    }
+    std::string_view data = file.GetContents();
+
+    PerfMetricsBinaryHeader header{};
+    if (data.size() < sizeof(header))
+    {
+        std::cerr << "Truncated perf metrics file: " << file_path << std::endl;
+        return nullptr;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != kPerfMetricsBinaryMagic || header.version != kPerfMetricsBinaryVersion)
+    {
+        std::cerr << "Unsupported perf metrics file: " << file_path << std::endl;
+        return nullptr;
+    }
+    size_t offset = sizeof(header);
+
+    std::vector<uint32_t> metric_ids;
+    if (!ReadBinaryColumn(data, offset, header.metric_count, metric_ids))
+    {
+        std::cerr << "Truncated perf metrics file: " << file_path << std::endl;
+        return nullptr;
+    }
+    std::vector<std::string> metric_names;
+    std::vector<const MetricInfo*> metric_infos;
+    for (uint32_t metric_id : metric_ids)
+    {
+        const MetricInfo* info = available_metrics.GetMetricInfoById(metric_id);
+        metric_infos.push_back(info);
+        metric_names.push_back(info ? info->m_key : std::string());
+    }
+    if (!AreMetricsSupported(metric_infos))
+    {
+        return nullptr;
+    }
+
+    PerfMetricsColumns records(metric_ids.size());
+    size_t record_count = header.record_count;
+    bool complete = ReadBinaryColumn(data, offset, record_count, records.m_context_id) &&
+                    ReadBinaryColumn(data, offset, record_count, records.m_process_id) &&
+                    ReadBinaryColumn(data, offset, record_count, records.m_frame_id) &&
+                    ReadBinaryColumn(data, offset, record_count, records.m_cmd_buffer_id) &&
+                    ReadBinaryColumn(data, offset, record_count, records.m_draw_id) &&
+                    ReadBinaryColumn(data, offset, record_count, records.m_draw_type) &&
+                    ReadBinaryColumn(data, offset, record_count, records.m_draw_label) &&
+                    ReadBinaryColumn(data, offset, record_count, records.m_program_id) &&
+                    ReadBinaryColumn(data, offset, record_count, records.m_lrz_state);
+    for (auto& column : records.m_metric_values)
+    {
+        complete = complete && ReadBinaryColumn(data, offset, record_count, column);
+    }
+    if (!complete)
+    {
+        std::cerr << "Truncated perf metrics file: " << file_path << std::endl;
+        return nullptr;
     }
 
     return std::unique_ptr<PerfMetricsData>(
         new PerfMetricsData(std::move(metric_names), std::move(metric_infos), std::move(records)));
 }
 
+bool PerfMetricsData::WriteBinary(const std::filesystem::path& file_path) const
+{
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "Failed to open file: " << file_path << std::endl;
+        return false;
+    }
+
+    PerfMetricsBinaryHeader header{};
+    header.magic = kPerfMetricsBinaryMagic;
+    header.version = kPerfMetricsBinaryVersion;
+    header.metric_count = static_cast<uint32_t>(m_metric_infos.size());
+    header.record_count = m_records.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<uint32_t> metric_ids;
+    for (const MetricInfo* info : m_metric_infos)
+    {
+        assert(info != nullptr);
+        metric_ids.push_back(info->m_metric_id);
+    }
+    WriteBinaryColumn(file, metric_ids);
+
+    WriteBinaryColumn(file, m_records.m_context_id);
+    WriteBinaryColumn(file, m_records.m_process_id);
+    WriteBinaryColumn(file, m_records.m_frame_id);
+    WriteBinaryColumn(file, m_records.m_cmd_buffer_id);
+    WriteBinaryColumn(file, m_records.m_draw_id);
+    WriteBinaryColumn(file, m_records.m_draw_type);
+    WriteBinaryColumn(file, m_records.m_draw_label);
+    WriteBinaryColumn(file, m_records.m_program_id);
+    WriteBinaryColumn(file, m_records.m_lrz_state);
+    for (const auto& column : m_records.m_metric_values)
+    {
+        WriteBinaryColumn(file, column);
+    }
+
+    if (!file)
+    {
+        std::cerr << "Failed to write file: " << file_path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+PerfMetricsColumns::PerfMetricsColumns(size_t metric_count) : m_metric_values(metric_count) {}
+
+void PerfMetricsColumns::Reserve(size_t record_count)
+{
+    m_context_id.reserve(record_count);
+    m_process_id.reserve(record_count);
+    m_frame_id.reserve(record_count);
+    m_cmd_buffer_id.reserve(record_count);
+    m_draw_id.reserve(record_count);
+    m_draw_label.reserve(record_count);
+    m_program_id.reserve(record_count);
+    m_draw_type.reserve(record_count);
+    m_lrz_state.reserve(record_count);
+    for (auto& column : m_metric_values)
+    {
+        column.reserve(record_count);
+    }
+}
+
+void PerfMetricsColumns::AddRecord(const PerfMetricsRecord& fields,
+                                   std::span<const double> metric_values)
+{
+    assert(metric_values.size() == m_metric_values.size());
+    m_context_id.push_back(fields.m_context_id);
+    m_process_id.push_back(fields.m_process_id);
+    m_frame_id.push_back(fields.m_frame_id);
+    m_cmd_buffer_id.push_back(fields.m_cmd_buffer_id);
+    m_draw_id.push_back(fields.m_draw_id);
+    m_draw_label.push_back(fields.m_draw_label);
+    m_program_id.push_back(fields.m_program_id);
+    m_draw_type.push_back(fields.m_draw_type);
+    m_lrz_state.push_back(fields.m_lrz_state);
+    for (size_t i = 0; i < m_metric_values.size(); ++i)
+    {
+        m_metric_values[i].push_back(metric_values[i]);
+    }
+}
+
+void PerfMetricsColumns::Append(const PerfMetricsColumns& other)
+{
+    assert(other.m_metric_values.size() == m_metric_values.size());
+    auto AppendColumn = [](auto& column, const auto& other_column) {
+        column.insert(column.end(), other_column.begin(), other_column.end());
+    };
+    AppendColumn(m_context_id, other.m_context_id);
+    AppendColumn(m_process_id, other.m_process_id);
+    AppendColumn(m_frame_id, other.m_frame_id);
+    AppendColumn(m_cmd_buffer_id, other.m_cmd_buffer_id);
+    AppendColumn(m_draw_id, other.m_draw_id);
+    AppendColumn(m_draw_label, other.m_draw_label);
+    AppendColumn(m_program_id, other.m_program_id);
+    AppendColumn(m_draw_type, other.m_draw_type);
+    AppendColumn(m_lrz_state, other.m_lrz_state);
+    for (size_t i = 0; i < m_metric_values.size(); ++i)
+    {
+        AppendColumn(m_metric_values[i], other.m_metric_values[i]);
+    }
+}
+
+PerfMetricsRecord PerfMetricsColumns::GetFixedFields(size_t record_index) const
+{
+    PerfMetricsRecord record{};
+    record.m_context_id = m_context_id[record_index];
+    record.m_process_id = m_process_id[record_index];
+    record.m_frame_id = m_frame_id[record_index];
+    record.m_cmd_buffer_id = m_cmd_buffer_id[record_index];
+    record.m_draw_id = m_draw_id[record_index];
+    record.m_draw_label = m_draw_label[record_index];
+    record.m_program_id = m_program_id[record_index];
+    record.m_draw_type = m_draw_type[record_index];
+    record.m_lrz_state = m_lrz_state[record_index];
+    return record;
+}
+
+PerfMetricsRecord PerfMetricsColumns::GetRecord(size_t record_index) const
+{
+    PerfMetricsRecord record = GetFixedFields(record_index);
+    record.m_metric_values.reserve(m_metric_values.size());
+    for (const auto& column : m_metric_values)
+    {
+        record.m_metric_values.push_back(column[record_index]);
+    }
+    return record;
+}
+
 PerfMetricsData::PerfMetricsData(std::vector<std::string> metric_names,
                                  std::vector<const MetricInfo*> metric_infos,
-                                 std::vector<PerfMetricsRecord> records)
+                                 PerfMetricsColumns records)
     : m_metric_names(std::move(metric_names)),
       m_metric_infos(std::move(metric_infos)),
       m_records(std::move(records))
@@ -313,6 +888,15 @@ class PerfMetricsDataProvider::Correlator
     // RecordIndex is index into raw metric data.
     using RecordIndex = IndexWrapper<size_t, RecordTag>;
 
+    // A frame aligned to the pattern.
+    struct AlignedFrame
+    {
+        RecordIndex m_start;
+        // Record of each draw of the pattern, or invalid where the frame lacks it. Empty when the
+        // frame matches the pattern exactly, so that record `m_start + i` is MetricIndex(i).
+        std::vector<RecordIndex> m_records;
+    };
+
     void Reset()
     {
         m_draw_to_node.clear();
@@ -321,16 +905,23 @@ class PerfMetricsDataProvider::Correlator
         m_draw_to_metric.clear();
         m_metric_to_draw.clear();
 
-        m_record_to_metric.clear();
+        m_aligned_frames.clear();
+        m_template_frame_start = RecordIndex();
+        m_skipped_frame_count = 0;
     }
 
     void AnalyzeCommands(const CommandHierarchy&);
 
-    void AnalyzeRecords(const std::vector<PerfMetricsRecord>&);
+    void AnalyzeRecords(const PerfMetricsColumns&);
 
     size_t GetPatternSize() const { return m_metric_to_draw.size(); }
 
-    MetricIndex MatchOf(RecordIndex index) const { return index.Into(m_record_to_metric); }
+    // Frames that could be aligned to the pattern, including the template frame.
+    const std::vector<AlignedFrame>& GetAlignedFrames() const { return m_aligned_frames; }
+    // First record of the frame the pattern was taken from.
+    RecordIndex GetTemplateFrameStart() const { return m_template_frame_start; }
+    // Frames too different from the pattern to be aligned.
+    size_t GetSkippedFrameCount() const { return m_skipped_frame_count; }
 
     NodeIndex GetNodeFromDraw(DrawIndex index) const { return index.Into(m_draw_to_node); }
     DrawIndex GetDrawFromNode(NodeIndex index) const { return index.Into(m_node_to_draw); }
@@ -361,13 +952,16 @@ class PerfMetricsDataProvider::Correlator
                              ArrayMap<DrawIndex, NodeIndex>& out_draw_to_node,
                              HashMap<NodeIndex, DrawIndex>& out_node_to_draw);
 
-    struct DrawSignatures
-    {
-        const PerfMetricsRecord* m_begin;
-        const PerfMetricsRecord* m_end;
-    };
-    static bool MatchDrawSignatures(const DrawSignatures&, const PerfMetricsRecord* begin,
-                                    const PerfMetricsRecord* end);
+    // Whether the records [start, end) have the same command buffer and draw IDs as the records
+    // [signature_start, signature_end).
+    static bool MatchDrawSignatures(const PerfMetricsColumns& records, size_t signature_start,
+                                    size_t signature_end, size_t start, size_t end);
+
+    // Aligns the records [start, end) to the template frame by their command buffer and draw IDs.
+    // Returns std::nullopt if the frame is too different from the template.
+    static std::optional<AlignedFrame> AlignFrame(const PerfMetricsColumns& records,
+                                                  size_t template_start, size_t template_size,
+                                                  size_t start, size_t end);
 
     bool CorrelationEnabled() const
     {
@@ -385,7 +979,9 @@ class PerfMetricsDataProvider::Correlator
     ArrayMap<DrawIndex, MetricIndex> m_draw_to_metric;
     ArrayMap<MetricIndex, DrawIndex> m_metric_to_draw;
 
-    ArrayMap<RecordIndex, MetricIndex> m_record_to_metric;
+    std::vector<AlignedFrame> m_aligned_frames;
+    RecordIndex m_template_frame_start;
+    size_t m_skipped_frame_count = 0;
 };
 
 void PerfMetricsDataProvider::Correlator::ExtractDraws(
@@ -483,70 +1079,116 @@ void PerfMetricsDataProvider::Correlator::AnalyzeCommands(const CommandHierarchy
     ExtractDraws(command_hierarchy, m_draw_to_node, m_node_to_draw);
 }
 
-bool PerfMetricsDataProvider::Correlator::MatchDrawSignatures(const DrawSignatures& signatures,
-                                                              const PerfMetricsRecord* begin,
-                                                              const PerfMetricsRecord* end)
+bool PerfMetricsDataProvider::Correlator::MatchDrawSignatures(const PerfMetricsColumns& records,
+                                                              size_t signature_start,
+                                                              size_t signature_end, size_t start,
+                                                              size_t end)
 {
-    const ptrdiff_t size = (signatures.m_end - signatures.m_begin);
-    if (size != end - begin)
+    if (signature_end - signature_start != end - start)
     {
         return false;
     }
-    const PerfMetricsRecord* at = begin;
-    const PerfMetricsRecord* signatures_at = signatures.m_begin;
-    for (; at != end; ++at, ++signatures_at)
+    const auto& cmd_buffer_ids = records.GetCmdBufferIds();
+    const auto& draw_ids = records.GetDrawIds();
+    return std::equal(cmd_buffer_ids.begin() + start, cmd_buffer_ids.begin() + end,
+                      cmd_buffer_ids.begin() + signature_start) &&
+           std::equal(draw_ids.begin() + start, draw_ids.begin() + end,
+                      draw_ids.begin() + signature_start);
+}
+
+std::optional<PerfMetricsDataProvider::Correlator::AlignedFrame>
+PerfMetricsDataProvider::Correlator::AlignFrame(const PerfMetricsColumns& records,
+                                                size_t template_start, size_t template_size,
+                                                size_t start, size_t end)
+{
+    if (MatchDrawSignatures(records, template_start, template_start + template_size, start, end))
     {
-        if (at->m_cmd_buffer_id != signatures_at->m_cmd_buffer_id)
-        {
-            return false;
-        }
-        if (at->m_draw_id != signatures_at->m_draw_id)
+        return AlignedFrame{RecordIndex(start), {}};
+    }
+
+    // Tolerate a few stray or missing draws, but not frames that are mostly different, such as the
+    // partial frames at either end of the capture.
+    const size_t max_edits = std::min(template_size / 4, kMaxAlignmentEdits);
+    const auto& cmd_buffer_ids = records.GetCmdBufferIds();
+    const auto& draw_ids = records.GetDrawIds();
+    auto matches =
+        AlignSequences(template_size, end - start, max_edits, [&](size_t x, size_t y) {
+            return cmd_buffer_ids[template_start + x] == cmd_buffer_ids[start + y] &&
+                   draw_ids[template_start + x] == draw_ids[start + y];
+        });
+    if (!matches.has_value())
+    {
+        return std::nullopt;
+    }
+
+    AlignedFrame frame{RecordIndex(start), std::vector<RecordIndex>(template_size)};
+    for (size_t i = 0; i < template_size; ++i)
+    {
+        if ((*matches)[i].has_value())
         {
-            return false;
+            frame.m_records[i] = RecordIndex(start + *(*matches)[i]);
         }
     }
-    return true;
+    return frame;
 }
 
-void PerfMetricsDataProvider::Correlator::AnalyzeRecords(
-    const std::vector<PerfMetricsRecord>& records)
+void PerfMetricsDataProvider::Correlator::AnalyzeRecords(const PerfMetricsColumns& records)
 {
-    m_record_to_metric.clear();
+    m_aligned_frames.clear();
+    m_template_frame_start = RecordIndex();
+    m_skipped_frame_count = 0;
 
     if (records.empty())
     {
         return;
     }
-    size_t template_frame_start = 0;
-    size_t template_frame_size = 0;
-
-    // Find the frame with the max number of draw calls, and use that as template.
-    {
+    const auto& frame_ids = records.GetFrameIds();
+    auto ForEachFrame = [&](auto&& emit_frame) {
         size_t frame_start = 0;
-        auto emit_frame = [&](size_t start, size_t end) {
-            if (end - start > template_frame_size)
-            {
-                template_frame_start = start;
-                template_frame_size = end - start;
-            }
-        };
         for (size_t i = 0; i < records.size(); ++i)
         {
-            if (records[frame_start].m_frame_id != records[i].m_frame_id)
+            if (frame_ids[frame_start] != frame_ids[i])
             {
                 emit_frame(frame_start, i);
                 frame_start = i;
             }
         }
         emit_frame(frame_start, records.size());
+    };
+
+    // Use the first frame of the most common size as template, preferring larger frames on ties.
+    // Unlike the largest frame, this is not thrown off by a frame with a stray draw.
+    size_t template_frame_start = 0;
+    size_t template_frame_size = 0;
+    {
+        std::unordered_map<size_t, size_t> frame_size_counts;
+        ForEachFrame([&](size_t start, size_t end) { ++frame_size_counts[end - start]; });
+        size_t template_count = 0;
+        for (const auto& [size, count] : frame_size_counts)
+        {
+            if (count > template_count || (count == template_count && size > template_frame_size))
+            {
+                template_frame_size = size;
+                template_count = count;
+            }
+        }
+        bool found = false;
+        ForEachFrame([&](size_t start, size_t end) {
+            if (!found && end - start == template_frame_size)
+            {
+                template_frame_start = start;
+                found = true;
+            }
+        });
     }
 
+    const auto& draw_types = records.GetDrawTypes();
     ArrayMap<DrawIndex, MetricIndex> draw_to_metric;
     ArrayMap<MetricIndex, DrawIndex> metric_to_draw;
     metric_to_draw.resize(template_frame_size);
     for (size_t i = 0; i < template_frame_size; ++i)
     {
-        if (IsMetricsRecordDrawOrDispatch(records[template_frame_start + i]))
+        if (IsMetricsRecordDrawOrDispatch(draw_types[template_frame_start + i]))
         {
             metric_to_draw[i] = DrawIndex(draw_to_metric.size());
             draw_to_metric.push_back(MetricIndex(i));
@@ -558,38 +1200,22 @@ void PerfMetricsDataProvider::Correlator::AnalyzeRecords(
         std::cerr << "Mismatch draw calls in performance counter data." << std::endl;
     }
 
-    const DrawSignatures signature = {
-        records.data() + template_frame_start,
-        records.data() + template_frame_start + template_frame_size,
-    };
-
-    ArrayMap<RecordIndex, MetricIndex> record_to_metric(records.size());
-    {
-        size_t frame_start = 0;
-        auto emit_frame = [&](size_t start, size_t end) {
-            if (!MatchDrawSignatures(signature, records.data() + start, records.data() + end))
-            {
-                // Bad data?
-                return;
-            }
-            const size_t frame_size = end - start;
-            for (int i = 0; i < frame_size; ++i)
-            {
-                record_to_metric[start + i] = MetricIndex(i);
-            }
-        };
-        for (size_t i = 0; i < records.size(); ++i)
+    std::vector<AlignedFrame> aligned_frames;
+    size_t skipped_frame_count = 0;
+    ForEachFrame([&](size_t start, size_t end) {
+        auto frame = AlignFrame(records, template_frame_start, template_frame_size, start, end);
+        if (!frame.has_value())
         {
-            if (records[frame_start].m_frame_id != records[i].m_frame_id)
-            {
-                emit_frame(frame_start, i);
-                frame_start = i;
-            }
+            // Bad data?
+            ++skipped_frame_count;
+            return;
         }
-        emit_frame(frame_start, records.size());
-    }
+        aligned_frames.push_back(std::move(*frame));
+    });
 
-    m_record_to_metric = std::move(record_to_metric);
+    m_aligned_frames = std::move(aligned_frames);
+    m_template_frame_start = RecordIndex(template_frame_start);
+    m_skipped_frame_count = skipped_frame_count;
     m_draw_to_metric = std::move(draw_to_metric);
     m_metric_to_draw = std::move(metric_to_draw);
 }
@@ -621,7 +1247,8 @@ void PerfMetricsDataProvider::Update(std::unique_ptr<PerfMetricsData> data)
     }
 
     m_raw_data = std::move(data);
-    m_computed_records.clear();
+    m_computed_records = PerfMetricsColumns();
+    m_computed_stats.clear();
     m_correlator->Reset();
 }
 
@@ -641,72 +1268,65 @@ void PerfMetricsDataProvider::Analyze(const CommandHierarchy* command_hierarchy)
     m_correlator->AnalyzeRecords(records);
 
     const size_t pattern_size = m_correlator->GetPatternSize();
-    m_computed_records.resize(pattern_size);
-
-    // This map will store intermediate sums and counts for averaging.
-    // Key: {cmd_buffer_id, draw_id}
-    // Value: {vector of metric sums, count of records}
-    struct MetricSumWithRecordCount
+    const auto& frames = m_correlator->GetAlignedFrames();
+    m_computed_records = PerfMetricsColumns(num_metrics);
+    m_computed_stats.clear();
+    if (pattern_size == 0 || frames.empty())
     {
-        std::vector<double> m_metric_sums;
-        uint32_t m_record_count = 0;
-    };
-
-    std::vector<MetricSumWithRecordCount> sums_and_counts;
-    sums_and_counts.resize(pattern_size);
+        return;
+    }
 
-    size_t skipped = 0;
-    for (size_t record_index = 0; record_index < records.size(); ++record_index)
+    if (size_t skipped = m_correlator->GetSkippedFrameCount(); skipped)
     {
-        auto pattern_index = m_correlator->MatchOf(Correlator::RecordIndex(record_index));
-        if (!pattern_index)
-        {
-            ++skipped;
-            continue;
-        }
-        auto& record = records[record_index];
-        auto& draw_call_data = sums_and_counts[*pattern_index];
-        if (draw_call_data.m_record_count == 0)
-        {
-            draw_call_data.m_metric_sums.resize(num_metrics);
-
-            m_computed_records[*pattern_index] = record;
-        }
-
-        if (record.m_metric_values.size() == num_metrics)
-        {
-            for (size_t i = 0; i < num_metrics; ++i)
-            {
-                draw_call_data.m_metric_sums[i] += record.m_metric_values[i];
-            }
-            draw_call_data.m_record_count++;
-        }
+        std::cerr << "Skipping " << skipped << " frames that don't align with the others."
+                  << std::endl;
     }
-    if (skipped)
+
+    // The fixed fields come from the template frame. frame_id for aggregated data is meaningless.
+    const size_t template_frame_start = *m_correlator->GetTemplateFrameStart();
+    const std::vector<double> zeros(num_metrics, 0.0);
+    m_computed_records.Reserve(pattern_size);
+    for (size_t i = 0; i < pattern_size; ++i)
     {
-        std::cerr << "Skipping " << skipped << " metrics." << std::endl;
+        PerfMetricsRecord fields = records.GetFixedFields(template_frame_start + i);
+        fields.m_frame_id = 0;
+        m_computed_records.AddRecord(fields, zeros);
     }
 
-    // Now, build the final m_computed_records vector with averaged records in order.
-    for (size_t draw_index = 0; draw_index < pattern_size; ++draw_index)
+    // One pass over each metric column, frame by frame. Frames that match the pattern exactly lay
+    // out their draws like it, so their values are read from a contiguous run of the column.
+    m_computed_stats.reserve(num_metrics);
+    for (size_t metric_index = 0; metric_index < num_metrics; ++metric_index)
     {
-        PerfMetricsRecord& averaged_record = m_computed_records[draw_index];
-        averaged_record.m_metric_values.clear();
-        // frame_id for aggregated data is meaningless.
-        averaged_record.m_frame_id = 0;
-
-        const auto count = sums_and_counts[draw_index].m_record_count;
-        auto& sums = sums_and_counts[draw_index].m_metric_sums;
-        if (count == 0 || sums.empty())
+        const double* column = records.GetMetricColumn(metric_index).data();
+        PatternStatsAccumulator accumulator(pattern_size, frames.size());
+        for (const auto& frame : frames)
         {
-            continue;
+            if (frame.m_records.empty())
+            {
+                const double* values = column + *frame.m_start;
+                for (size_t i = 0; i < pattern_size; ++i)
+                {
+                    accumulator.Add(i, values[i]);
+                }
+                continue;
+            }
+            for (size_t i = 0; i < pattern_size; ++i)
+            {
+                if (frame.m_records[i].has_value())
+                {
+                    accumulator.Add(i, column[*frame.m_records[i]]);
+                }
+            }
         }
 
-        averaged_record.m_metric_values.reserve(num_metrics);
-        for (size_t i = 0; i < num_metrics; ++i)
+        std::vector<PerfMetricsStats> stats = accumulator.Finish();
+        std::vector<double>& means = m_computed_records.GetMutableMetricColumn(metric_index);
+        for (size_t i = 0; i < pattern_size; ++i)
         {
-            averaged_record.m_metric_values.emplace_back(sums[i] / count);
+            means[i] = stats[i].m_mean;
         }
+        m_computed_stats.push_back(std::move(stats));
     }
 }
 
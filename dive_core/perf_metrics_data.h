@@ -19,6 +19,7 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <tuple>
@@ -112,14 +113,121 @@ struct PerfMetricsRecord
     std::vector<double> m_metric_values;
 };
 
+// Performance metrics records stored column-major: each fixed field and each metric is one
+// contiguous column with an entry per record. Captures have hundreds of metrics for tens of
+// thousands of draws over many frames, so this avoids an allocation per record and lets the
+// aggregation of a metric walk a single array.
+class PerfMetricsColumns
+{
+ public:
+    PerfMetricsColumns() = default;
+    explicit PerfMetricsColumns(size_t metric_count);
+
+    size_t size() const { return m_frame_id.size(); }
+    bool empty() const { return m_frame_id.empty(); }
+    size_t GetMetricCount() const { return m_metric_values.size(); }
+
+    void Reserve(size_t record_count);
+
+    // Appends a record made of the fixed fields of `fields` and `metric_values`, which must hold
+    // GetMetricCount() values. `fields.m_metric_values` is ignored.
+    void AddRecord(const PerfMetricsRecord& fields, std::span<const double> metric_values);
+    // Appends all the records of `other`, which must have the same metric count.
+    void Append(const PerfMetricsColumns& other);
+
+    // Copies the fixed fields of a record, leaving m_metric_values empty.
+    PerfMetricsRecord GetFixedFields(size_t record_index) const;
+    // Copies a whole record.
+    PerfMetricsRecord GetRecord(size_t record_index) const;
+
+    // Fixed-field columns.
+    const std::vector<uint64_t>& GetContextIds() const { return m_context_id; }
+    const std::vector<uint64_t>& GetProcessIds() const { return m_process_id; }
+    const std::vector<uint64_t>& GetFrameIds() const { return m_frame_id; }
+    const std::vector<uint64_t>& GetCmdBufferIds() const { return m_cmd_buffer_id; }
+    const std::vector<uint32_t>& GetDrawIds() const { return m_draw_id; }
+    const std::vector<uint32_t>& GetDrawLabels() const { return m_draw_label; }
+    const std::vector<uint64_t>& GetProgramIds() const { return m_program_id; }
+    const std::vector<uint8_t>& GetDrawTypes() const { return m_draw_type; }
+    const std::vector<uint8_t>& GetLRZStates() const { return m_lrz_state; }
+
+    // Values of one metric, one per record.
+    const std::vector<double>& GetMetricColumn(size_t metric_index) const
+    {
+        return m_metric_values[metric_index];
+    }
+    std::vector<double>& GetMutableMetricColumn(size_t metric_index)
+    {
+        return m_metric_values[metric_index];
+    }
+    double GetMetricValue(size_t record_index, size_t metric_index) const
+    {
+        return m_metric_values[metric_index][record_index];
+    }
+
+    void SetFrameId(size_t record_index, uint64_t frame_id) { m_frame_id[record_index] = frame_id; }
+
+ private:
+    // Reads and writes the columns of the binary format directly.
+    friend class PerfMetricsData;
+
+    std::vector<uint64_t> m_context_id;
+    std::vector<uint64_t> m_process_id;
+    std::vector<uint64_t> m_frame_id;
+    std::vector<uint64_t> m_cmd_buffer_id;
+    std::vector<uint32_t> m_draw_id;
+    std::vector<uint32_t> m_draw_label;
+    std::vector<uint64_t> m_program_id;
+    std::vector<uint8_t> m_draw_type;
+    std::vector<uint8_t> m_lrz_state;
+    std::vector<std::vector<double>> m_metric_values;
+};
+
+// Distribution of one metric of one computed record over the frames that contain its draw.
+struct PerfMetricsStats
+{
+    // A sample further than this many standard deviations from the mean is an outlier.
+    static constexpr double kOutlierStddevs = 3.0;
+
+    uint32_t m_sample_count = 0;
+    double m_mean = 0.0;
+    // Exact up to 64 samples, estimated beyond that
+    double m_median = 0.0;
+    double m_min = 0.0;
+    double m_max = 0.0;
+    double m_stddev = 0.0;
+    // Whether min or max is an outlier. Needs at least 11 samples, below which no sample can be
+    // 3 standard deviations away from the mean.
+    bool m_has_outliers = false;
+};
+
 class PerfMetricsData
 {
  public:
-    // Load performance metrics data from a CSV file
+    // Load performance metrics data from a CSV file. The file is memory-mapped, and large files are
+    // parsed in up to `thread_count` chunks on the default TaskScheduler; 0 uses one chunk per
+    // thread of the scheduler.
     [[nodiscard]] static std::unique_ptr<PerfMetricsData> LoadFromCsv(
+        const std::filesystem::path& file_path, const AvailableMetrics& available_metrics,
+        size_t thread_count = 0);
+
+    // Load performance metrics data from a memory-mapped binary file written by WriteBinary().
+    //
+    // The binary format is little-endian and column-major, so loading is a copy of each column:
+    //   header:     char[8] magic "DIVEPMD", uint32 version, uint32 metric count,
+    //               uint64 record count
+    //   metric ids: uint32 MetricInfo::m_metric_id per metric, as listed in AvailableMetrics
+    //   columns:    one array per fixed field, in kFixedHeaders order, using the PerfMetricsRecord
+    //               field types, followed by one double array per metric
+    // Every section starts on an 8-byte boundary.
+    [[nodiscard]] static std::unique_ptr<PerfMetricsData> LoadFromBinary(
         const std::filesystem::path& file_path, const AvailableMetrics& available_metrics);
+
+    // Write the records in the binary format read by LoadFromBinary()
+    bool WriteBinary(const std::filesystem::path& file_path) const;
+
     // Get all performance metrics records
-    const std::vector<PerfMetricsRecord>& GetRecords() const { return m_records; }
+    const PerfMetricsColumns& GetRecords() const { return m_records; }
 
     // Get the names of the performance metrics
     const std::vector<std::string>& GetMetricNames() const { return m_metric_names; }
@@ -129,12 +237,12 @@ class PerfMetricsData
 
     PerfMetricsData(std::vector<std::string> metric_names,
                     std::vector<const MetricInfo*> metric_infos,
-                    std::vector<PerfMetricsRecord> records);
+                    PerfMetricsColumns records);
 
  private:
     std::vector<std::string> m_metric_names;
     std::vector<const MetricInfo*> m_metric_infos;
-    std::vector<PerfMetricsRecord> m_records;
+    PerfMetricsColumns m_records;
 };
 
 class PerfMetricsDataProvider
@@ -164,7 +272,16 @@ class PerfMetricsDataProvider
 
     // Get the all of the metrics for a frame. The metrics are computed average of the input
     // dataset, ordered by command buffer appearance and then draw ID appearance order.
-    const std::vector<PerfMetricsRecord>& GetComputedRecords() const { return m_computed_records; }
+    //
+    // Frames are aligned to the most common frame layout by their command buffer and draw IDs, so
+    // a frame with a few extra or missing draws still contributes to the draws it shares.
+    const PerfMetricsColumns& GetComputedRecords() const { return m_computed_records; }
+
+    // Get the distribution behind a value of GetComputedRecords().
+    const PerfMetricsStats& GetComputedStats(size_t record_index, size_t metric_index) const
+    {
+        return m_computed_stats[metric_index][record_index];
+    }
 
     // Returns the header for the record.
     const std::vector<std::string> GetRecordHeader() const;
@@ -183,7 +300,9 @@ class PerfMetricsDataProvider
     std::unique_ptr<Correlator> m_correlator;
 
     std::unique_ptr<PerfMetricsData> m_raw_data;
-    std::vector<PerfMetricsRecord> m_computed_records;  // calculated based on the |m_raw_data|
+    PerfMetricsColumns m_computed_records;  // calculated based on the |m_raw_data|
+    // Indexed by metric, then computed record
+    std::vector<std::vector<PerfMetricsStats>> m_computed_stats;
 
     std::unique_ptr<AvailableMetrics> m_owned_desc;
 };
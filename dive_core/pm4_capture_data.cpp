@@ -824,6 +824,7 @@ CaptureData::LoadResult Pm4CaptureData::LoadAdrenoRdFile(FileReader& capture_fil
     uint32_t cur_size = UINT32_MAX;
     bool is_new_submit = false;
     bool skip_commands = false;
+    m_gpu_id = 0;
     while (capture_file.Read((char*)&block_info, sizeof(block_info)) > 0)
     {
         // Read and discard any trailing 0xffffffff padding from previous block
@@ -887,13 +888,14 @@ CaptureData::LoadResult Pm4CaptureData::LoadAdrenoRdFile(FileReader& capture_fil
                 uint32_t gpu_id = 0;
                 capture_file.Read(reinterpret_cast<char*>(&gpu_id), block_info.m_data_size);
                 SetGPUID(gpu_id);
+                m_gpu_id = gpu_id;
             }
             break;
             case RD_CHIP_ID:
             {
-                // If it wasn't set already by a RD_GPU_ID
+                // If it wasn't set already by a RD_GPU_ID of this capture
                 // Or if it was an invalid gpu_id, which leads to a kGPUVariantNone
-                if ((GetGPUID() == 0) || (GetGPUVariantType() == kGPUVariantNone))
+                if ((m_gpu_id == 0) || (GetGPUVariantType() == kGPUVariantNone))
                 {
                     DIVE_ASSERT(block_info.m_data_size == 8);
                     fd_dev_id dev_id{};
@@ -906,6 +908,7 @@ CaptureData::LoadResult Pm4CaptureData::LoadAdrenoRdFile(FileReader& capture_fil
                     if (info.chip != 0)
                     {
                         SetGPUID(info.chip * 100);
+                        m_gpu_id = info.chip * 100;
                     }
                 }
             }
@@ -290,6 +290,9 @@ class Pm4CaptureData : public CaptureData
     inline uint32_t GetNumText() const { return (uint32_t)m_text.size(); }
     inline const TextInfo& GetText(uint32_t index) const { return m_text[index]; }
     const DiveVector<SubmitInfo>& GetSubmits() const;
+    // GPU ID recorded in an Adreno capture, or 0 if it has none. Loading the capture also makes it
+    // the process-wide GPU ID, see SetGPUID().
+    uint32_t GetGPUID() const { return m_gpu_id; }
 
     Pm4CaptureData& operator=(Pm4CaptureData&&) = default;
 
@@ -330,6 +333,7 @@ class Pm4CaptureData : public CaptureData
     MemoryManager m_memory;
     ProgressTracker* m_progress_tracker = nullptr;
     CaptureDataHeader m_data_header;
+    uint32_t m_gpu_id = 0;
 };
 
 }  // namespace Dive
@@ -16,10 +16,17 @@
 
 #include "shader_disassembly.h"
 
+#include <algorithm>
+#include <cstdio>
 #include <mutex>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include "dive_core/common/memory_manager_base.h"
+#include "dive_core/shader_disassembly_cache.h"
+#include "dive_core/task_scheduler.h"
 #include "pm4_info.h"
 
 #ifdef _MSC_VER
@@ -46,9 +53,23 @@ bool Disassemble(const uint8_t* shader_memory, uint64_t shader_address, size_t s
     return false;
 }
 
-//--------------------------------------------------------------------------------------------------
-std::string DisassembleA3XX(const uint8_t* data, size_t max_size, struct shader_stats* stats,
-                            enum debug_t debug)
+namespace
+{
+
+#if !defined(_MSC_VER) && defined(__GLIBC__)
+ssize_t AppendToString(void* cookie, const char* data, size_t size)
+{
+    static_cast<std::string*>(cookie)->append(data, size);
+    return static_cast<ssize_t>(size);
+}
+#endif
+
+// Appends the output of the disassembler to `output`.
+//
+// With glibc the disassembler writes straight into `output` through a custom stream. Elsewhere its
+// output goes through a temporary file or a memory stream, and is then copied.
+void DisassembleA3XX(const uint8_t* data, size_t max_size, struct shader_stats* stats,
+                     enum debug_t debug, std::string& output)
 {
 #ifdef _MSC_VER
     FILE* disasm_file = NULL;
@@ -58,6 +79,11 @@ std::string DisassembleA3XX(const uint8_t* data, size_t max_size, struct shader_
         DIVE_ASSERT(err == 0);
     }
     DIVE_ASSERT(disasm_file != NULL);
+#elif defined(__GLIBC__)
+    cookie_io_functions_t functions = {};
+    functions.write = AppendToString;
+    FILE* disasm_file = fopencookie(&output, "w", functions);
+    DIVE_ASSERT(disasm_file != NULL);
 #else
     char* disasm_buf = nullptr;
     size_t disasm_buf_size = 0;
@@ -72,25 +98,80 @@ std::string DisassembleA3XX(const uint8_t* data, size_t max_size, struct shader_
     DIVE_ASSERT(res != -1);
 #ifdef _MSC_VER
     rewind(disasm_file);
-    std::string disasm_output;
     char buffer[1024];
     size_t bytes_read;
     while ((bytes_read = fread(buffer, 1, sizeof(buffer), disasm_file)) > 0)
     {
-        disasm_output.append(buffer, bytes_read);
+        output.append(buffer, bytes_read);
     }
     fclose(disasm_file);
-    return disasm_output;
+#elif defined(__GLIBC__)
+    // Flushes the remaining output into `output`.
+    fclose(disasm_file);
 #else
     fflush(disasm_file);
-    disasm_buf[disasm_buf_size] = '\0';
-    std::string disasm(disasm_buf);
+    output.append(disasm_buf, disasm_buf_size);
     fclose(disasm_file);
     free(disasm_buf);
-    return disasm;
 #endif
 }
 
+}  // namespace
+
+//--------------------------------------------------------------------------------------------------
+void ParseRawDisassembly(std::string_view disasm, DisassembledShader& shader)
+{
+    unsigned opc_cat = 0;
+    unsigned n = 0;
+    unsigned cycles = 0;
+    uint32_t dword0 = 0, dword1 = 0;
+    int prefix_len = 0;
+    std::string line;
+    while (!disasm.empty())
+    {
+        const size_t line_end = std::min(disasm.find('\n'), disasm.size());
+        // sscanf needs a null-terminated string. `line` keeps its capacity across lines.
+        line.assign(disasm.substr(0, line_end));
+        disasm.remove_prefix(std::min(line_end + 1, disasm.size()));
+
+        prefix_len = static_cast<int>(line.length());
+#ifdef _MSC_VER
+        sscanf_s(line.c_str(), " :%d:%04d:%04d[%08xx_%08xx] %n", &opc_cat, &n, &cycles, &dword1,
+                 &dword0, &prefix_len);
+#else
+        sscanf(line.c_str(),
+               " :%d:%04d:%04d[%08xx_%08xx] %n",
+               &opc_cat,
+               &n,
+               &cycles,
+               &dword1,
+               &dword0,
+               &prefix_len);
+#endif
+        DIVE_ASSERT(0 <= prefix_len && prefix_len <= line.length());
+        std::string_view instr = std::string_view(line).substr(prefix_len);
+
+        // The disassembler emits the instructions in order, so a line either continues the last
+        // instruction or starts new ones.
+        const size_t count = shader.m_instructions_raw.size();
+        if (n >= count)
+        {
+            shader.m_instruction_offsets.resize(
+                n + 1, static_cast<uint32_t>(shader.m_instructions_text.size()));
+            shader.m_instructions_raw.resize(n + 1);
+        }
+        else if (shader.m_instructions_text.size() > shader.m_instruction_offsets.back())
+        {
+            shader.m_instructions_text += '\n';
+        }
+        shader.m_instructions_text += instr;
+        shader.m_instructions_raw.back() = (static_cast<uint64_t>(dword1) << 32) | dword0;
+    }
+    // Terminates the last instruction.
+    const size_t text_size = shader.m_instructions_text.size();
+    shader.m_instruction_offsets.push_back(static_cast<uint32_t>(text_size));
+}
+
 //--------------------------------------------------------------------------------------------------
 Disassembly::Disassembly(const IMemoryManager& mem_manager, uint32_t submit_index, uint64_t address,
                          ILog* log)
@@ -103,7 +184,6 @@ Disassembly::Disassembly(const IMemoryManager& mem_manager, uint32_t submit_inde
 void Disassembly::Disassemble() const
 {
     std::call_once(m_disassembled_flag, [&]() {
-        DisassembledData disassembled_data;
         uint64_t max_size = m_mem_manager.GetMaxContiguousSize(m_submit_index, m_address);
 
         // The disassembler does not early-out when it encounters an "end" instruction (at least not
@@ -113,55 +193,42 @@ void Disassembly::Disassemble() const
         uint64_t kMaxSizeLimit = 64 * 1024;
         if (max_size > kMaxSizeLimit) max_size = kMaxSizeLimit;
 
-        uint8_t* data_ptr = new uint8_t[max_size];
+        std::vector<uint8_t> data(max_size);
         DIVE_VERIFY(
-            m_mem_manager.RetrieveMemoryData(data_ptr, m_submit_index, m_address, max_size));
+            m_mem_manager.RetrieveMemoryData(data.data(), m_submit_index, m_address, max_size));
 
-        struct shader_stats stats = {};
-        std::string disasm = DisassembleA3XX(data_ptr, max_size, &stats, PRINT_RAW);
-        std::istringstream disasm_istr(disasm);
-        unsigned opc_cat = 0;
-        unsigned n = 0;
-        unsigned cycles = 0;
-        uint32_t dword0 = 0, dword1 = 0;
-        int prefix_len = 0;
-        for (std::string line; std::getline(disasm_istr, line);)
+        // Identical shaders are common, both within a capture and across captures of the same app.
+        ShaderDisassemblyCache& cache = ShaderDisassemblyCache::GetDefault();
+        const ShaderDisassemblyKey key = ShaderDisassemblyCache::ComputeKey(data, GetGPUID());
+        m_disassembled_data = cache.Find(key);
+        if (m_disassembled_data)
         {
-            prefix_len = static_cast<int>(line.length());
-#ifdef _MSC_VER
-            sscanf_s(line.c_str(), " :%d:%04d:%04d[%08xx_%08xx] %n", &opc_cat, &n, &cycles, &dword1,
-                     &dword0, &prefix_len);
-#else
-            sscanf(line.c_str(),
-                   " :%d:%04d:%04d[%08xx_%08xx] %n",
-                   &opc_cat,
-                   &n,
-                   &cycles,
-                   &dword1,
-                   &dword0,
-                   &prefix_len);
-#endif
-            DIVE_ASSERT(0 <= prefix_len && prefix_len <= line.length());
-            std::string_view instr = std::string_view(line).substr(prefix_len);
-            if (n >= disassembled_data.m_instructions_text.size())
-            {
-                disassembled_data.m_instructions_text.resize(n + 1);
-                disassembled_data.m_instructions_raw.resize(n + 1);
-            }
-            if (disassembled_data.m_instructions_text[n].size() > 0)
-            {
-                disassembled_data.m_instructions_text[n] += "\n";
-            }
-            disassembled_data.m_instructions_text[n] += instr;
-
-            disassembled_data.m_instructions_raw[n] =
-                (static_cast<uint64_t>(dword1) << 32) | dword0;
+            return;
         }
-        disassembled_data.m_gpr_count = (stats.fullreg + 3) / 4;
-        disassembled_data.m_listing = DisassembleA3XX(data_ptr, max_size, &stats, PRINT_STATS);
-        delete[] data_ptr;
-        m_disassembled_data = disassembled_data;
+
+        auto disassembled_data = std::make_shared<DisassembledShader>();
+
+        // The raw output is only needed while it is parsed, so each thread reuses its buffer.
+        thread_local std::string raw_disasm;
+        raw_disasm.clear();
+        struct shader_stats stats = {};
+        DisassembleA3XX(data.data(), max_size, &stats, PRINT_RAW, raw_disasm);
+        ParseRawDisassembly(raw_disasm, *disassembled_data);
+        disassembled_data->m_gpr_count = (stats.fullreg + 3) / 4;
+        DisassembleA3XX(data.data(), max_size, &stats, PRINT_STATS, disassembled_data->m_listing);
+
+        cache.Insert(key, disassembled_data);
+        m_disassembled_data = std::move(disassembled_data);
     });
 }
 
+//--------------------------------------------------------------------------------------------------
+void QueueDisassembly(TaskGroup& group, const std::deque<Disassembly>& shaders)
+{
+    for (const Disassembly& shader : shaders)
+    {
+        group.Run([&shader]() { shader.EagerEval(); });
+    }
+}
+
 }  // namespace Dive
@@ -16,10 +16,13 @@
 
 #pragma once
 
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "dive_core/common/common.h"
@@ -28,6 +31,7 @@
 namespace Dive
 {
 class IMemoryManager;
+class TaskGroup;
 
 class ShaderInstruction
 {
@@ -56,43 +60,53 @@ class ShaderInstruction
     uint64_t m_address{};
 };
 
+// Result of disassembling a shader. Shared between the Disassembly objects of identical shaders
+// through ShaderDisassemblyCache, so it is immutable once created.
+struct DisassembledShader
+{
+    size_t GetNumInstructions() const { return m_instructions_raw.size(); }
+    std::string_view GetInstructionText(size_t index) const
+    {
+        return std::string_view(m_instructions_text)
+            .substr(m_instruction_offsets[index],
+                    m_instruction_offsets[index + 1] - m_instruction_offsets[index]);
+    }
+
+    std::string m_listing;
+    // Text of all the instructions, back to back. The text of instruction i is
+    // [m_instruction_offsets[i], m_instruction_offsets[i + 1]).
+    std::string m_instructions_text;
+    std::vector<uint32_t> m_instruction_offsets;
+    std::vector<uint64_t> m_instructions_raw;
+    uint32_t m_gpr_count{};
+};
+
 class Disassembly
 {
  public:
     Disassembly(const IMemoryManager& mem_manager, uint32_t submit_index, uint64_t address,
                 ILog* log = nullptr);
 
-    std::string GetListing() const { return GetData().m_listing; }
+    const std::string& GetListing() const { return GetData().m_listing; }
     uint64_t GetShaderAddr() const { return m_address; }
-    size_t GetNumInstructions() const { return GetData().m_instructions_text.size(); }
-    const std::string& GetInstructionText(uint32_t index) const
+    size_t GetNumInstructions() const { return GetData().GetNumInstructions(); }
+    std::string_view GetInstructionText(uint32_t index) const
     {
-        return GetData().m_instructions_text[index];
+        return GetData().GetInstructionText(index);
     }
     uint64_t GetInstructionRaw(uint32_t index) const { return GetData().m_instructions_raw[index]; }
-    uint64_t GetShaderSize() const
-    {
-        return sizeof(uint64_t) * GetData().m_instructions_text.size();
-    }
+    uint64_t GetShaderSize() const { return sizeof(uint64_t) * GetData().GetNumInstructions(); }
     uint32_t GetGPRCount() const { return GetData().m_gpr_count; }
 
     void EagerEval() const { Disassemble(); }
 
  private:
-    struct DisassembledData
-    {
-        std::string m_listing;
-        std::vector<std::string> m_instructions_text;
-        std::vector<uint64_t> m_instructions_raw;
-        uint32_t m_gpr_count{};
-    };
-
     void Disassemble() const;
 
-    const DisassembledData& GetData() const
+    const DisassembledShader& GetData() const
     {
         Disassemble();
-        return m_disassembled_data;
+        return *m_disassembled_data;
     }
 
     [[maybe_unused]] const IMemoryManager& m_mem_manager;
@@ -101,9 +115,17 @@ class Disassembly
     [[maybe_unused]] ILog* m_log;
 
     mutable std::once_flag m_disassembled_flag;
-    mutable DisassembledData m_disassembled_data;
+    mutable std::shared_ptr<const DisassembledShader> m_disassembled_data;
 };
 
+// Splits the PRINT_RAW output of the disassembler into the instructions of `shader`. Lines without
+// an instruction prefix, such as labels, belong to the current instruction.
+void ParseRawDisassembly(std::string_view disasm, DisassembledShader& shader);
+
+// Queues the disassembly of `shaders` on `group`, so that they are disassembled in parallel rather
+// than one by one when first accessed. The shaders must outlive the group's tasks.
+void QueueDisassembly(TaskGroup& group, const std::deque<Disassembly>& shaders);
+
 bool Disassemble(const uint8_t* shader_memory, uint64_t shader_address, size_t shader_size,
                  std::vector<ShaderInstruction>* instructions,
                  std::function<std::string(uint64_t index)> on_emit, std::string& output,
@@ -0,0 +1,357 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include "dive_core/shader_disassembly_cache.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "absl/base/no_destructor.h"
+#include "absl/strings/str_format.h"
+
+namespace Dive
+{
+
+namespace
+{
+
+constexpr char kEntryMagic[8] = {'D', 'I', 'V', 'E', 'S', 'H', 'D', 'R'};
+// Bump when the layout of an entry or the output of the disassembler changes.
+constexpr uint32_t kEntryVersion = 2;
+constexpr uint32_t kByteOrderMark = 0x01020304;
+// Rough per-entry cost of the containers, on top of the text.
+constexpr size_t kEntryOverhead = 128;
+
+size_t EstimateMemoryUsage(const DisassembledShader& shader)
+{
+    return kEntryOverhead + shader.m_listing.size() + shader.m_instructions_text.size() +
+           shader.m_instruction_offsets.size() * sizeof(uint32_t) +
+           shader.m_instructions_raw.size() * sizeof(uint64_t);
+}
+
+std::filesystem::path GetEntryPath(const std::filesystem::path& directory,
+                                   const ShaderDisassemblyKey& key)
+{
+    return directory /
+           absl::StrFormat("%016x-%x-%x.shader", key.m_hash, key.m_gpu_id, key.m_size);
+}
+
+class EntryWriter
+{
+ public:
+    template<typename T> void Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    void WriteString(std::string_view value)
+    {
+        Write(static_cast<uint64_t>(value.size()));
+        m_buffer.append(value);
+    }
+
+    const std::string& GetBuffer() const { return m_buffer; }
+
+ private:
+    std::string m_buffer;
+};
+
+class EntryReader
+{
+ public:
+    explicit EntryReader(const std::string& buffer)
+        : m_data(buffer.data()), m_end(buffer.data() + buffer.size())
+    {
+    }
+
+    bool AtEnd() const { return m_data == m_end; }
+
+    template<typename T> bool Read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (static_cast<size_t>(m_end - m_data) < sizeof(T))
+        {
+            return false;
+        }
+        std::memcpy(&value, m_data, sizeof(T));
+        m_data += sizeof(T);
+        return true;
+    }
+    bool ReadString(std::string& value)
+    {
+        uint64_t size = 0;
+        if (!Read(size) || static_cast<uint64_t>(m_end - m_data) < size)
+        {
+            return false;
+        }
+        value.assign(m_data, size);
+        m_data += size;
+        return true;
+    }
+    // Reads an element count, rejecting counts that cannot fit in the remaining data so that a
+    // corrupt entry does not cause huge allocations.
+    bool ReadCount(uint64_t& count, size_t min_element_size)
+    {
+        return Read(count) && count <= static_cast<size_t>(m_end - m_data) / min_element_size;
+    }
+
+ private:
+    const char* m_data;
+    const char* m_end;
+};
+
+void WriteEntry(const std::filesystem::path& path, const ShaderDisassemblyKey& key,
+                const DisassembledShader& shader)
+{
+    EntryWriter writer;
+    writer.Write(kEntryMagic);
+    writer.Write(kEntryVersion);
+    writer.Write(kByteOrderMark);
+    writer.Write(key.m_hash);
+    writer.Write(key.m_size);
+    writer.Write(key.m_gpu_id);
+    writer.Write(shader.m_gpr_count);
+    writer.WriteString(shader.m_listing);
+    writer.WriteString(shader.m_instructions_text);
+    writer.Write(static_cast<uint64_t>(shader.m_instructions_raw.size()));
+    for (uint32_t offset : shader.m_instruction_offsets)
+    {
+        writer.Write(offset);
+    }
+    for (uint64_t raw : shader.m_instructions_raw)
+    {
+        writer.Write(raw);
+    }
+
+    // Several threads or processes may write the same entry: write to a unique file, and rename it
+    // so that readers see either no entry or a complete one.
+    std::filesystem::path temp_path = path;
+    temp_path += absl::StrFormat(".%016x.tmp", std::random_device()());
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        file.write(writer.GetBuffer().data(),
+                   static_cast<std::streamsize>(writer.GetBuffer().size()));
+        if (!file)
+        {
+            file.close();
+            std::error_code error;
+            std::filesystem::remove(temp_path, error);
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temp_path, error);
+    }
+}
+
+std::shared_ptr<const DisassembledShader> ReadEntry(const std::filesystem::path& path,
+                                                    const ShaderDisassemblyKey& key)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return nullptr;
+    }
+    std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EntryReader reader(buffer);
+
+    char magic[sizeof(kEntryMagic)] = {};
+    uint32_t version = 0;
+    uint32_t byte_order_mark = 0;
+    ShaderDisassemblyKey entry_key;
+    if (!reader.Read(magic) || std::memcmp(magic, kEntryMagic, sizeof(magic)) != 0 ||
+        !reader.Read(version) || version != kEntryVersion || !reader.Read(byte_order_mark) ||
+        byte_order_mark != kByteOrderMark || !reader.Read(entry_key.m_hash) ||
+        !reader.Read(entry_key.m_size) || !reader.Read(entry_key.m_gpu_id) || entry_key != key)
+    {
+        return nullptr;
+    }
+
+    auto shader = std::make_shared<DisassembledShader>();
+    uint64_t instruction_count = 0;
+    if (!reader.Read(shader->m_gpr_count) || !reader.ReadString(shader->m_listing) ||
+        !reader.ReadString(shader->m_instructions_text) ||
+        !reader.ReadCount(instruction_count, sizeof(uint32_t) + sizeof(uint64_t)))
+    {
+        return nullptr;
+    }
+    // The offsets must delimit the text, since they are used without checks.
+    shader->m_instruction_offsets.resize(instruction_count + 1);
+    uint32_t previous_offset = 0;
+    for (uint32_t& offset : shader->m_instruction_offsets)
+    {
+        if (!reader.Read(offset) || offset < previous_offset)
+        {
+            return nullptr;
+        }
+        previous_offset = offset;
+    }
+    if (previous_offset != shader->m_instructions_text.size())
+    {
+        return nullptr;
+    }
+    shader->m_instructions_raw.resize(instruction_count);
+    for (uint64_t& raw : shader->m_instructions_raw)
+    {
+        if (!reader.Read(raw))
+        {
+            return nullptr;
+        }
+    }
+    if (!reader.AtEnd())
+    {
+        return nullptr;
+    }
+    return shader;
+}
+
+}  // namespace
+
+//--------------------------------------------------------------------------------------------------
+ShaderDisassemblyCache::ShaderDisassemblyCache(size_t memory_budget)
+    : m_memory_budget(memory_budget)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+ShaderDisassemblyCache& ShaderDisassemblyCache::GetDefault()
+{
+    static absl::NoDestructor<ShaderDisassemblyCache> cache;
+    static const bool initialized = [] {
+        if (const char* directory = std::getenv(kDirectoryEnvironmentVariable))
+        {
+            cache->SetDirectory(directory);
+        }
+        return true;
+    }();
+    (void)initialized;
+    return *cache;
+}
+
+//--------------------------------------------------------------------------------------------------
+ShaderDisassemblyKey ShaderDisassemblyCache::ComputeKey(std::span<const uint8_t> shader,
+                                                        uint32_t gpu_id)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (uint8_t byte : shader)
+    {
+        hash = (hash ^ byte) * 0x100000001b3ull;
+    }
+    return ShaderDisassemblyKey{.m_hash = hash, .m_size = shader.size(), .m_gpu_id = gpu_id};
+}
+
+//--------------------------------------------------------------------------------------------------
+void ShaderDisassemblyCache::SetDirectory(std::filesystem::path directory)
+{
+    if (!directory.empty())
+    {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_directory = std::move(directory);
+}
+
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<const DisassembledShader> ShaderDisassemblyCache::Find(
+    const ShaderDisassemblyKey& key)
+{
+    std::filesystem::path directory;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (auto it = m_entries.find(key); it != m_entries.end())
+        {
+            m_lru.splice(m_lru.begin(), m_lru, it->second.m_lru_position);
+            return it->second.m_shader;
+        }
+        directory = m_directory;
+    }
+    if (directory.empty())
+    {
+        return nullptr;
+    }
+
+    // The entry is read without holding the lock, since it can take a while.
+    std::shared_ptr<const DisassembledShader> shader = ReadEntry(GetEntryPath(directory, key), key);
+    if (shader)
+    {
+        InsertInMemory(key, shader);
+    }
+    return shader;
+}
+
+//--------------------------------------------------------------------------------------------------
+void ShaderDisassemblyCache::Insert(const ShaderDisassemblyKey& key,
+                                    std::shared_ptr<const DisassembledShader> shader)
+{
+    std::filesystem::path directory;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        directory = m_directory;
+    }
+    if (!directory.empty())
+    {
+        WriteEntry(GetEntryPath(directory, key), key, *shader);
+    }
+    InsertInMemory(key, std::move(shader));
+}
+
+//--------------------------------------------------------------------------------------------------
+size_t ShaderDisassemblyCache::GetMemoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_memory_usage;
+}
+
+//--------------------------------------------------------------------------------------------------
+void ShaderDisassemblyCache::InsertInMemory(const ShaderDisassemblyKey& key,
+                                            std::shared_ptr<const DisassembledShader> shader)
+{
+    const size_t memory_usage = EstimateMemoryUsage(*shader);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_entries.find(key) != m_entries.end())
+    {
+        // Disassembled concurrently by another thread.
+        return;
+    }
+    while (!m_lru.empty() && m_memory_usage + memory_usage > m_memory_budget)
+    {
+        auto it = m_entries.find(m_lru.back());
+        m_memory_usage -= it->second.m_memory_usage;
+        m_entries.erase(it);
+        m_lru.pop_back();
+    }
+    if (memory_usage > m_memory_budget)
+    {
+        return;
+    }
+    m_lru.push_front(key);
+    m_entries.emplace(key, Entry{std::move(shader), memory_usage, m_lru.begin()});
+    m_memory_usage += memory_usage;
+}
+
+}  // namespace Dive
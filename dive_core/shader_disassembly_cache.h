@@ -0,0 +1,114 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+// The shader disassembly cache maps the bytes of a shader and the GPU it was disassembled for to
+// the disassembly, so that a shader seen in several captures, or several times in one capture, is
+// only disassembled once.
+//
+// Entries are kept in memory for the lifetime of the process, within a memory budget, and can also
+// be persisted in a directory so that they are shared between runs. Like the GFXR capture index,
+// the directory is a cache: a missing, stale or corrupt entry is simply disassembled again. Entries
+// are written in the native byte order of the host.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+
+#include "dive_core/shader_disassembly.h"
+
+namespace Dive
+{
+
+// Identifies the content of a shader.
+struct ShaderDisassemblyKey
+{
+    // FNV-1a of the shader bytes, which is stable across runs and platforms.
+    uint64_t m_hash = 0;
+    uint64_t m_size = 0;
+    uint32_t m_gpu_id = 0;
+
+    bool operator==(const ShaderDisassemblyKey&) const = default;
+};
+
+class ShaderDisassemblyCache
+{
+ public:
+    static constexpr size_t kDefaultMemoryBudget = 256 * 1024 * 1024;
+    // Environment variable that GetDefault() reads the cache directory from.
+    static constexpr char kDirectoryEnvironmentVariable[] = "DIVE_SHADER_CACHE_DIR";
+
+    explicit ShaderDisassemblyCache(size_t memory_budget = kDefaultMemoryBudget);
+
+    ShaderDisassemblyCache(const ShaderDisassemblyCache&) = delete;
+    ShaderDisassemblyCache& operator=(const ShaderDisassemblyCache&) = delete;
+
+    // Cache shared by all the captures loaded in the process. Its directory is initially taken from
+    // the DIVE_SHADER_CACHE_DIR environment variable, if set.
+    static ShaderDisassemblyCache& GetDefault();
+
+    static ShaderDisassemblyKey ComputeKey(std::span<const uint8_t> shader, uint32_t gpu_id);
+
+    // Persists entries in `directory`, which is created if needed. An empty path only keeps the
+    // entries in memory.
+    void SetDirectory(std::filesystem::path directory);
+
+    // Returns the disassembly of the shader identified by `key`, or nullptr if it is not cached.
+    std::shared_ptr<const DisassembledShader> Find(const ShaderDisassemblyKey& key);
+
+    // Adds the disassembly of the shader identified by `key`, and writes it to the directory.
+    void Insert(const ShaderDisassemblyKey& key, std::shared_ptr<const DisassembledShader> shader);
+
+    // Approximate memory used by the entries in memory.
+    size_t GetMemoryUsage() const;
+
+ private:
+    struct KeyHash
+    {
+        size_t operator()(const ShaderDisassemblyKey& key) const
+        {
+            return static_cast<size_t>(key.m_hash);
+        }
+    };
+
+    struct Entry
+    {
+        std::shared_ptr<const DisassembledShader> m_shader;
+        size_t m_memory_usage = 0;
+        // Position in m_lru.
+        std::list<ShaderDisassemblyKey>::iterator m_lru_position;
+    };
+
+    // Adds the entry in memory, evicting the least recently used ones to stay within the budget.
+    void InsertInMemory(const ShaderDisassemblyKey& key,
+                        std::shared_ptr<const DisassembledShader> shader);
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<ShaderDisassemblyKey, Entry, KeyHash> m_entries;
+    // Most recently used first.
+    std::list<ShaderDisassemblyKey> m_lru;
+    size_t m_memory_usage = 0;
+    size_t m_memory_budget;
+    std::filesystem::path m_directory;
+};
+
+}  // namespace Dive
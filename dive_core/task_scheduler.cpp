@@ -0,0 +1,242 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include "dive_core/task_scheduler.h"
+
+#include <utility>
+
+#include "absl/base/no_destructor.h"
+
+namespace Dive
+{
+namespace
+{
+
+// Scheduler and worker the current thread belongs to, if any.
+thread_local const TaskScheduler* t_scheduler = nullptr;
+thread_local size_t t_worker_index = 0;
+
+}  // namespace
+
+TaskScheduler::TaskScheduler(unsigned int worker_count)
+{
+    worker_count = (worker_count > 0 ? worker_count : GetDefaultWorkerCount());
+    m_workers.reserve(worker_count);
+    for (unsigned int i = 0; i < worker_count; ++i)
+    {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    // Start the threads once all the deques exist, since workers steal from each other.
+    for (size_t i = 0; i < m_workers.size(); ++i)
+    {
+        m_workers[i]->m_thread = std::thread([this, i]() { WorkerImpl(i); });
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_stopping = true;
+    }
+    m_wake_condition.notify_all();
+    for (auto& worker : m_workers)
+    {
+        worker->m_thread.join();
+    }
+}
+
+TaskScheduler& TaskScheduler::GetDefault()
+{
+    static absl::NoDestructor<TaskScheduler> scheduler;
+    return *scheduler;
+}
+
+unsigned int TaskScheduler::GetDefaultWorkerCount()
+{
+    unsigned int count = std::thread::hardware_concurrency();
+    return (count > 1 ? count - 1 : 1);
+}
+
+void TaskScheduler::Submit(Task task)
+{
+    m_queued_count.fetch_add(1);
+    if (t_scheduler == this)
+    {
+        Worker& worker = *m_workers[t_worker_index];
+        std::lock_guard<std::mutex> lock(worker.m_mutex);
+        worker.m_tasks.push_back(std::move(task));
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(m_shared_mutex);
+        m_shared_tasks.push_back(std::move(task));
+    }
+
+    // Either a worker going to sleep sees the new task, or it is counted as sleeping here, in which
+    // case taking the lock makes sure it is waiting before it is notified.
+    if (m_sleeping_count.load() > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        }
+        m_wake_condition.notify_one();
+    }
+}
+
+bool TaskScheduler::TryGetTask(Task& task)
+{
+    auto TryPop = [&task](std::mutex& mutex, std::deque<Task>& tasks, bool from_back) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty())
+        {
+            return false;
+        }
+        if (from_back)
+        {
+            task = std::move(tasks.back());
+            tasks.pop_back();
+        }
+        else
+        {
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        return true;
+    };
+
+    const bool is_worker = (t_scheduler == this);
+    bool found = false;
+    if (is_worker)
+    {
+        Worker& worker = *m_workers[t_worker_index];
+        found = TryPop(worker.m_mutex, worker.m_tasks, true);
+    }
+    if (!found)
+    {
+        found = TryPop(m_shared_mutex, m_shared_tasks, false);
+    }
+    // Steal the oldest task of another worker, which is likely to be the largest.
+    const size_t first_victim = (is_worker ? t_worker_index + 1 : 0);
+    for (size_t i = 0; !found && i < m_workers.size(); ++i)
+    {
+        size_t victim = (first_victim + i) % m_workers.size();
+        if (is_worker && victim == t_worker_index)
+        {
+            continue;
+        }
+        Worker& worker = *m_workers[victim];
+        found = TryPop(worker.m_mutex, worker.m_tasks, false);
+    }
+
+    if (found)
+    {
+        m_queued_count.fetch_sub(1);
+    }
+    return found;
+}
+
+void TaskScheduler::RunTask(Task& task)
+{
+    TaskGroup* group = task.m_group;
+    if (!group->Cancelled())
+    {
+        task.m_func();
+    }
+    // Release what the task captured before the group can be destroyed.
+    task.m_func = nullptr;
+    group->FinishTask();
+}
+
+void TaskScheduler::WorkerImpl(size_t worker_index)
+{
+    t_scheduler = this;
+    t_worker_index = worker_index;
+    while (true)
+    {
+        Task task;
+        if (TryGetTask(task))
+        {
+            RunTask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_sleeping_count.fetch_add(1);
+        m_wake_condition.wait(lock, [this] { return m_stopping || m_queued_count.load() > 0; });
+        m_sleeping_count.fetch_sub(1);
+        // Queued tasks are drained before stopping.
+        if (m_stopping && m_queued_count.load() == 0)
+        {
+            return;
+        }
+    }
+}
+
+TaskGroup::TaskGroup(TaskScheduler& scheduler, Context context)
+    : m_scheduler(scheduler), m_context(std::move(context))
+{
+}
+
+TaskGroup::~TaskGroup() { Wait(); }
+
+void TaskGroup::Run(std::function<void()> func)
+{
+    m_pending_count.fetch_add(1);
+    m_scheduler.Submit(TaskScheduler::Task{std::move(func), this});
+}
+
+bool TaskGroup::Wait()
+{
+    // Help rather than block while there is queued work, which may include tasks of this group.
+    while (m_pending_count.load() > 0)
+    {
+        TaskScheduler::Task task;
+        if (!m_scheduler.TryGetTask(task))
+        {
+            break;
+        }
+        TaskScheduler::RunTask(task);
+    }
+
+    // The remaining tasks are running on workers. Always synchronize through m_mutex, so that the
+    // last FinishTask() is done with the group before it can be destroyed.
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done_condition.wait(lock, [this] { return m_pending_count.load() == 0; });
+    return !Cancelled();
+}
+
+void TaskGroup::FinishTask()
+{
+    // While other tasks are pending, Wait() can't return, so the count can drop without the lock.
+    size_t pending_count = m_pending_count.load();
+    while (pending_count > 1)
+    {
+        if (m_pending_count.compare_exchange_weak(pending_count, pending_count - 1))
+        {
+            return;
+        }
+    }
+
+    // Likely the last task: drop the count under the lock that Wait() checks it with.
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_pending_count.fetch_sub(1) == 1)
+    {
+        m_done_condition.notify_all();
+    }
+}
+
+}  // namespace Dive
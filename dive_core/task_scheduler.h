@@ -0,0 +1,183 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "dive/types/context.h"
+
+namespace Dive
+{
+
+class TaskGroup;
+
+// Work-stealing task scheduler.
+//
+// Each worker owns a deque of tasks: it pushes and pops its own tasks at the back, so nested tasks
+// run depth-first while their data is still in cache, and idle workers steal from the front of the
+// other deques. Tasks submitted from outside the scheduler go to a shared queue.
+//
+// Tasks are submitted through a TaskGroup, which tracks their completion:
+//
+//     TaskGroup group(TaskScheduler::GetDefault(), context);
+//     for (const Item& item : items)
+//     {
+//         group.Run([&item]() { Process(item); });
+//     }
+//     if (!group.Wait())
+//     {
+//         return absl::CancelledError();
+//     }
+class TaskScheduler
+{
+ public:
+    // `worker_count` of 0 uses one worker per hardware thread, minus one for the calling thread.
+    explicit TaskScheduler(unsigned int worker_count = 0);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    // Scheduler shared by the tools and the UI. It is never destroyed, so that detached work can't
+    // outlive it.
+    static TaskScheduler& GetDefault();
+
+    static unsigned int GetDefaultWorkerCount();
+
+    unsigned int GetWorkerCount() const { return static_cast<unsigned int>(m_workers.size()); }
+
+ private:
+    friend class TaskGroup;
+
+    struct Task
+    {
+        std::function<void()> m_func;
+        TaskGroup* m_group = nullptr;
+    };
+
+    struct Worker
+    {
+        std::mutex m_mutex;
+        std::deque<Task> m_tasks;
+        std::thread m_thread;
+    };
+
+    void Submit(Task task);
+
+    // Pops a task from the current worker's deque, the shared queue or another worker's deque.
+    bool TryGetTask(Task& task);
+
+    static void RunTask(Task& task);
+
+    void WorkerImpl(size_t worker_index);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    std::mutex m_shared_mutex;
+    std::deque<Task> m_shared_tasks;
+
+    // Upper bound on the number of queued tasks. Counted before a task is queued and after it is
+    // dequeued, so that workers don't go to sleep while a task is on its way.
+    std::atomic<size_t> m_queued_count = 0;
+
+    // Guards sleeping and waking workers.
+    std::mutex m_sleep_mutex;
+    std::atomic<size_t> m_sleeping_count = 0;
+    std::condition_variable m_wake_condition;
+    bool m_stopping = false;
+};
+
+// Set of tasks that can be waited on together. Tasks are skipped once `context` is cancelled.
+class TaskGroup
+{
+ public:
+    explicit TaskGroup(TaskScheduler& scheduler, Context context = Context::Background());
+    // Waits for the tasks still running.
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // Queues `func`. Can be called from tasks of the group.
+    void Run(std::function<void()> func);
+
+    // Runs queued tasks on the calling thread until all the tasks of the group are done. Returns
+    // false if the context was cancelled, in which case some tasks may not have run.
+    bool Wait();
+
+    bool Cancelled() const { return m_context.Cancelled(); }
+
+ private:
+    friend class TaskScheduler;
+
+    void FinishTask();
+
+    TaskScheduler& m_scheduler;
+    Context m_context;
+
+    std::atomic<size_t> m_pending_count = 0;
+    std::mutex m_mutex;
+    std::condition_variable m_done_condition;
+};
+
+// Calls `func(chunk_begin, chunk_end)` over consecutive chunks of [begin, end) of at least
+// `min_chunk_size` elements, in parallel. Returns false if the context was cancelled, in which
+// case some chunks may not have been processed.
+template <typename Func>
+bool ParallelFor(TaskScheduler& scheduler, const Context& context, size_t begin, size_t end,
+                 size_t min_chunk_size, Func func)
+{
+    if (begin >= end)
+    {
+        return !context.Cancelled();
+    }
+    // A few chunks per thread, so that threads that finish early can steal the remaining ones.
+    constexpr size_t kChunksPerThread = 4;
+    const size_t count = end - begin;
+    const size_t max_chunk_count = (scheduler.GetWorkerCount() + 1) * kChunksPerThread;
+    const size_t chunk_count =
+        std::clamp<size_t>(count / std::max<size_t>(min_chunk_size, 1), 1, max_chunk_count);
+    if (chunk_count == 1)
+    {
+        if (context.Cancelled())
+        {
+            return false;
+        }
+        func(begin, end);
+        return !context.Cancelled();
+    }
+
+    const size_t chunk_size = (count + chunk_count - 1) / chunk_count;
+    TaskGroup group(scheduler, context);
+    for (size_t chunk_begin = begin; chunk_begin < end; chunk_begin += chunk_size)
+    {
+        const size_t chunk_end = std::min(chunk_begin + chunk_size, end);
+        group.Run([&func, chunk_begin, chunk_end]() { func(chunk_begin, chunk_end); });
+    }
+    return group.Wait();
+}
+
+}  // namespace Dive
@@ -0,0 +1,122 @@
+/*
+Copyright 2026 Google Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "gfxr_ext/decode/dive_prefetch_file_processor.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "generated/generated_vulkan_dive_consumer.h"
+#include "gfxr_ext/decode/dive_annotation_processor.h"
+#include "gfxr_ext/decode/dive_block_data.h"
+#include "gfxr_ext/decode/dive_file_processor.h"
+#include "gtest/gtest.h"
+#include "third_party/gfxreconstruct/framework/generated/generated_vulkan_decoder.h"
+
+namespace Dive
+{
+namespace
+{
+
+// The capture is LZ4-compressed, so prefetched blocks are decompressed by the workers.
+constexpr const char* kTestFile = TEST_DATA_DIR
+    "/com.google.bigwheels.project_sample_01_triangle.debug_"
+    "trim_trigger_20250718T132545.gfxr";
+
+// What decoding a capture produces, to compare prefetching with the serial path.
+struct DecodedCapture
+{
+    std::vector<uint64_t> block_offsets;
+    std::vector<uint64_t> frame_first_blocks;
+    // Name and JSON arguments of each command, in submit order.
+    std::vector<std::string> commands;
+};
+
+DecodedCapture DecodeCapture(size_t worker_count, size_t depth)
+{
+    DecodedCapture decoded;
+    gfxrecon::decode::DiveFileProcessor file_processor;
+    if (!file_processor.Initialize(kTestFile))
+    {
+        ADD_FAILURE() << "Can't open " << kTestFile;
+        return decoded;
+    }
+    auto block_data = std::make_shared<gfxrecon::decode::DiveBlockData>();
+    file_processor.SetDiveBlockData(block_data);
+    file_processor.SetBlockPrefetch(worker_count, depth);
+
+    gfxrecon::decode::VulkanExportDiveConsumer dive_consumer;
+    gfxrecon::decode::VulkanDecoder decoder;
+    decoder.AddConsumer(&dive_consumer);
+    file_processor.AddDecoder(&decoder);
+    DiveAnnotationProcessor annotation_processor;
+    file_processor.SetAnnotationProcessor(&annotation_processor);
+    dive_consumer.Initialize(&annotation_processor);
+
+    bool more_frames = true;
+    while (more_frames)
+    {
+        decoded.frame_first_blocks.push_back(file_processor.GetCurrentBlockIndex());
+        more_frames = file_processor.ProcessNextFrame();
+    }
+    EXPECT_EQ(file_processor.GetErrorState(), gfxrecon::decode::kErrorNone);
+
+    decoded.block_offsets = block_data->GetOriginalBlockOffsets();
+    auto command_buffers = annotation_processor.TakeVkCommandsCache();
+    auto add_commands =
+        [&](const std::vector<DiveAnnotationProcessor::VulkanCommandInfo>& commands) {
+            for (const auto& command : commands)
+            {
+                decoded.commands.push_back(command.name + command.args.ToJson().dump());
+            }
+        };
+    for (const auto& submit : annotation_processor.TakeSubmits())
+    {
+        add_commands(submit->none_cmd_vk_commands);
+        for (uint64_t handle : submit->vk_command_buffer_handles)
+        {
+            add_commands(command_buffers[handle]);
+        }
+        decoded.commands.push_back(submit->name);
+    }
+    return decoded;
+}
+
+TEST(DivePrefetchFileProcessorTest, MatchesSerialDecoding)
+{
+    DecodedCapture serial = DecodeCapture(/*worker_count=*/0, /*depth=*/0);
+    ASSERT_FALSE(serial.block_offsets.empty());
+    ASSERT_FALSE(serial.commands.empty());
+
+    // Worker counts and depths. A depth of 1 reads a single block ahead, while a deep queue reads
+    // ahead until prefetching pauses.
+    constexpr std::pair<size_t, size_t> kPrefetchSettings[] = {{1, 1}, {4, 4}, {4, 1024}};
+    for (auto [worker_count, depth] : kPrefetchSettings)
+    {
+        SCOPED_TRACE(testing::Message() << worker_count << " workers, depth " << depth);
+        DecodedCapture prefetched = DecodeCapture(worker_count, depth);
+        EXPECT_EQ(prefetched.block_offsets, serial.block_offsets);
+        EXPECT_EQ(prefetched.frame_first_blocks, serial.frame_first_blocks);
+        EXPECT_EQ(prefetched.commands, serial.commands);
+    }
+}
+
+}  // namespace
+}  // namespace Dive
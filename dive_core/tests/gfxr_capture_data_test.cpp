@@ -16,16 +16,28 @@ limitations under the License.
 
 #include "dive_core/gfxr_capture_data.h"
 
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/functional/any_invocable.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "dive_core/gfxr_capture_index.h"
+#include "generated/generated_vulkan_dive_consumer.h"
+#include "gfxr_ext/decode/dive_annotation_processor.h"
 #include "gfxr_ext/decode/dive_block_data.h"
+#include "gfxr_ext/decode/dive_file_processor.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "third_party/gfxreconstruct/framework/format/format_util.h"
+#include "third_party/gfxreconstruct/framework/generated/generated_vulkan_decoder.h"
 
 namespace Dive
 {
@@ -130,10 +142,11 @@ TEST(GfxrCaptureDataTest, LastBlockIsProperlySized)
                                            "trim_trigger_20250718T132545.gfxr"),
               CaptureData::LoadResult::kSuccess);
 
-    const DiveOriginalBlock* last_block = nullptr;
+    // The visited blocks only live for the duration of the visit.
+    std::optional<DiveOriginalBlock> last_block;
     LambdaBlockVisitor find_last_original_block(
         [&last_block](const DiveOriginalBlock& block) {
-            last_block = &block;
+            last_block = block;
             return true;
         },
         [](const DiveModificationBlock& /*block*/) {
@@ -142,7 +155,7 @@ TEST(GfxrCaptureDataTest, LastBlockIsProperlySized)
         });
     ASSERT_TRUE(capture_data.GetMutableGfxrData()->TraverseBlocks(find_last_original_block));
 
-    ASSERT_NE(last_block, nullptr);
+    ASSERT_TRUE(last_block.has_value());
     ASSERT_EQ(last_block->size_, sizeof(gfxrecon::format::Marker));
 }
 
@@ -179,5 +192,384 @@ TEST(GfxrCaptureDataTest, AllLoadedBlocksAreValid)
     ASSERT_TRUE(capture_data.GetMutableGfxrData()->TraverseBlocks(block_validator));
 }
 
+// Copies the test capture to a temporary directory, since loading it with the index enabled writes
+// the index next to it.
+std::string CopyTestCaptureToTempDir(const std::string& name)
+{
+    std::filesystem::path dir = std::filesystem::path(testing::TempDir()) / name;
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::filesystem::path capture = dir / "capture.gfxr";
+    std::filesystem::copy_file(TEST_DATA_DIR
+                               "/com.google.bigwheels.project_sample_01_triangle.debug_"
+                               "trim_trigger_20250718T132545.gfxr",
+                               capture);
+    return capture.string();
+}
+
+TEST(GfxrCaptureDataTest, CaptureIndexReproducesDecodedData)
+{
+    std::string capture = CopyTestCaptureToTempDir("CaptureIndexReproducesDecodedData");
+
+    GfxrCaptureData decoded;
+    decoded.SetCaptureIndexEnabled(true);
+    ASSERT_EQ(decoded.LoadCaptureFile(capture), CaptureData::LoadResult::kSuccess);
+    ASSERT_TRUE(std::filesystem::exists(GetGfxrCaptureIndexPath(capture)));
+
+    GfxrCaptureData indexed;
+    indexed.SetCaptureIndexEnabled(true);
+    ASSERT_EQ(indexed.LoadCaptureFile(capture), CaptureData::LoadResult::kSuccess);
+
+    EXPECT_EQ(indexed.GetMutableGfxrData()->GetOriginalBlockOffsets(),
+              decoded.GetMutableGfxrData()->GetOriginalBlockOffsets());
+    EXPECT_EQ(CountBlocks(*indexed.GetMutableGfxrData()),
+              (DiveBlockDataCounts{.original_count = 231, .modified_count = 0}));
+
+    ASSERT_EQ(indexed.GetGfxrSubmits().size(), decoded.GetGfxrSubmits().size());
+    for (size_t i = 0; i < decoded.GetGfxrSubmits().size(); ++i)
+    {
+        const auto& expected = *decoded.GetGfxrSubmits()[i];
+        const auto& actual = *indexed.GetGfxrSubmits()[i];
+        EXPECT_EQ(actual.name, expected.name);
+        ASSERT_EQ(actual.vk_command_buffer_handles, expected.vk_command_buffer_handles);
+        for (uint64_t handle : expected.vk_command_buffer_handles)
+        {
+            const auto& expected_commands = decoded.GetGfxrCommandBuffers(handle);
+            const auto& actual_commands = indexed.GetGfxrCommandBuffers(handle);
+            ASSERT_EQ(actual_commands.size(), expected_commands.size());
+            for (size_t j = 0; j < expected_commands.size(); ++j)
+            {
+                EXPECT_EQ(actual_commands[j].name, expected_commands[j].name);
+                EXPECT_EQ(actual_commands[j].index, expected_commands[j].index);
+                EXPECT_EQ(actual_commands[j].args.ToJson(), expected_commands[j].args.ToJson());
+            }
+            EXPECT_EQ(indexed.GetDrawCallCounts(handle).render_pass_draw_call_counts,
+                      decoded.GetDrawCallCounts(handle).render_pass_draw_call_counts);
+        }
+    }
+}
+
+TEST(GfxrCaptureDataTest, CaptureIndexIsRejectedForAnotherCapture)
+{
+    std::string capture = CopyTestCaptureToTempDir("CaptureIndexIsRejectedForAnotherCapture");
+
+    GfxrCaptureData capture_data;
+    capture_data.SetCaptureIndexEnabled(true);
+    ASSERT_EQ(capture_data.LoadCaptureFile(capture), CaptureData::LoadResult::kSuccess);
+
+    absl::StatusOr<GfxrCaptureIndexKey> key = ComputeGfxrCaptureIndexKey(capture);
+    ASSERT_TRUE(key.ok()) << key.status();
+    std::string index = GetGfxrCaptureIndexPath(capture);
+    EXPECT_TRUE(LoadGfxrCaptureIndex(index, *key).ok());
+
+    GfxrCaptureIndexKey other_key = *key;
+    ++other_key.fingerprint;
+    EXPECT_TRUE(absl::IsFailedPrecondition(LoadGfxrCaptureIndex(index, other_key).status()));
+
+    // A truncated index is corrupt rather than silently shorter.
+    std::filesystem::resize_file(index, std::filesystem::file_size(index) - 1);
+    EXPECT_TRUE(absl::IsDataLoss(LoadGfxrCaptureIndex(index, *key).status()));
+
+    // The capture still loads, and the index is written again.
+    GfxrCaptureData reloaded;
+    reloaded.SetCaptureIndexEnabled(true);
+    ASSERT_EQ(reloaded.LoadCaptureFile(capture), CaptureData::LoadResult::kSuccess);
+    EXPECT_TRUE(LoadGfxrCaptureIndex(index, *key).ok());
+}
+
+TEST(GfxrCaptureDataTest, CaptureIndexIsRejectedAfterSameSizeEdit)
+{
+    // Larger than the first and last MiB, which were the only parts that used to be hashed.
+    constexpr size_t kCaptureSize = 8 << 20;
+    std::filesystem::path dir =
+        std::filesystem::path(testing::TempDir()) / "CaptureIndexIsRejectedAfterSameSizeEdit";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::string capture = (dir / "capture.gfxr").string();
+    {
+        std::ofstream file(capture, std::ios::binary);
+        file << std::string(kCaptureSize, 'a');
+    }
+
+    absl::StatusOr<GfxrCaptureIndexKey> key = ComputeGfxrCaptureIndexKey(capture);
+    ASSERT_TRUE(key.ok()) << key.status();
+    std::string index = GetGfxrCaptureIndexPath(capture);
+    ASSERT_TRUE(SaveGfxrCaptureIndex(index, *key, GfxrCaptureIndexData{}).ok());
+    std::filesystem::file_time_type original_time = std::filesystem::last_write_time(capture);
+
+    // Rewrite a span in the middle of the capture, keeping its size.
+    {
+        std::fstream file(capture, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(kCaptureSize / 2);
+        file << std::string(1 << 20, 'b');
+    }
+    ASSERT_EQ(std::filesystem::file_size(capture), kCaptureSize);
+    std::filesystem::last_write_time(capture, original_time + std::chrono::seconds(1));
+    absl::StatusOr<GfxrCaptureIndexKey> edited_key = ComputeGfxrCaptureIndexKey(capture);
+    ASSERT_TRUE(edited_key.ok()) << edited_key.status();
+    EXPECT_TRUE(absl::IsFailedPrecondition(LoadGfxrCaptureIndex(index, *edited_key).status()));
+
+    // The sampled content catches the edit even if the modification time is kept.
+    std::filesystem::last_write_time(capture, original_time);
+    edited_key = ComputeGfxrCaptureIndexKey(capture);
+    ASSERT_TRUE(edited_key.ok()) << edited_key.status();
+    EXPECT_EQ(edited_key->modification_time, key->modification_time);
+    EXPECT_NE(edited_key->fingerprint, key->fingerprint);
+    EXPECT_TRUE(absl::IsFailedPrecondition(LoadGfxrCaptureIndex(index, *edited_key).status()));
+}
+
+TEST(GfxrCaptureDataTest, PartialLoadOfWholeCaptureMatchesFullLoad)
+{
+    constexpr const char* kTestFile = TEST_DATA_DIR
+        "/com.google.bigwheels.project_sample_01_triangle.debug_"
+        "trim_trigger_20250718T132545.gfxr";
+    GfxrCaptureData full;
+    ASSERT_EQ(full.LoadCaptureFile(kTestFile), CaptureData::LoadResult::kSuccess);
+    GfxrCaptureData partial;
+    ASSERT_EQ(partial.LoadCaptureFile(kTestFile, GfxrCaptureRange{}),
+              CaptureData::LoadResult::kSuccess);
+
+    EXPECT_EQ(partial.GetFirstLoadedBlock(), 0u);
+    EXPECT_EQ(partial.GetLoadedBlockCount(), 231u);
+    EXPECT_FALSE(partial.GetFrameFirstBlocks().empty());
+    EXPECT_EQ(partial.GetFrameFirstBlocks(), full.GetFrameFirstBlocks());
+    EXPECT_EQ(partial.GetMutableGfxrData()->GetOriginalBlockOffsets(),
+              full.GetMutableGfxrData()->GetOriginalBlockOffsets());
+
+    ASSERT_EQ(partial.GetGfxrSubmits().size(), full.GetGfxrSubmits().size());
+    for (size_t i = 0; i < full.GetGfxrSubmits().size(); ++i)
+    {
+        const auto& expected = *full.GetGfxrSubmits()[i];
+        const auto& actual = *partial.GetGfxrSubmits()[i];
+        EXPECT_EQ(actual.name, expected.name);
+        ASSERT_EQ(actual.vk_command_buffer_handles, expected.vk_command_buffer_handles);
+        for (uint64_t handle : expected.vk_command_buffer_handles)
+        {
+            EXPECT_EQ(partial.GetGfxrCommandBuffers(handle).size(),
+                      full.GetGfxrCommandBuffers(handle).size());
+        }
+    }
+}
+
+TEST(GfxrCaptureDataTest, PartialLoadOutsideCaptureDecodesNothing)
+{
+    constexpr const char* kTestFile = TEST_DATA_DIR
+        "/com.google.bigwheels.project_sample_01_triangle.debug_"
+        "trim_trigger_20250718T132545.gfxr";
+    GfxrCaptureData capture_data;
+    ASSERT_EQ(capture_data.LoadCaptureFile(kTestFile, GfxrCaptureRange{.first_block = 1000}),
+              CaptureData::LoadResult::kSuccess);
+
+    EXPECT_EQ(capture_data.GetLoadedBlockCount(), 0u);
+    EXPECT_TRUE(capture_data.GetGfxrSubmits().empty());
+    // The capture can still be written.
+    EXPECT_EQ(CountBlocks(*capture_data.GetMutableGfxrData()),
+              (DiveBlockDataCounts{.original_count = 231, .modified_count = 0}));
+}
+
+// Keeps the function data of every decoded block, so that tests can tell which block each submit
+// and command comes from.
+class RecordingAnnotationProcessor : public DiveAnnotationProcessor
+{
+ public:
+    void WriteBlockEnd(const gfxrecon::util::DiveFunctionData& function_data) override
+    {
+        m_functions.push_back(function_data);
+        DiveAnnotationProcessor::WriteBlockEnd(function_data);
+    }
+
+    const std::vector<gfxrecon::util::DiveFunctionData>& GetFunctions() const
+    {
+        return m_functions;
+    }
+
+ private:
+    std::vector<gfxrecon::util::DiveFunctionData> m_functions;
+};
+
+// Decodes the whole capture, returning the function data of its blocks.
+std::vector<gfxrecon::util::DiveFunctionData> DecodeFunctions(const std::string& file_name)
+{
+    gfxrecon::decode::DiveFileProcessor file_processor;
+    if (!file_processor.Initialize(file_name))
+    {
+        ADD_FAILURE() << "Can't open " << file_name;
+        return {};
+    }
+    gfxrecon::decode::VulkanExportDiveConsumer dive_consumer;
+    gfxrecon::decode::VulkanDecoder decoder;
+    decoder.AddConsumer(&dive_consumer);
+    file_processor.AddDecoder(&decoder);
+    RecordingAnnotationProcessor annotation_processor;
+    file_processor.SetAnnotationProcessor(&annotation_processor);
+    dive_consumer.Initialize(&annotation_processor);
+    EXPECT_TRUE(file_processor.ProcessAllFrames());
+    return annotation_processor.GetFunctions();
+}
+
+// Expects `actual` to hold exactly the submits and commands of the blocks of `functions` in
+// [first_block, first_block + block_count).
+void ExpectDecodedBlocks(const GfxrCaptureData& actual,
+                         const std::vector<gfxrecon::util::DiveFunctionData>& functions,
+                         uint64_t first_block, uint64_t block_count)
+{
+    DiveAnnotationProcessor expected_processor;
+    for (const auto& function : functions)
+    {
+        if (function.GetBlockIndex() >= first_block &&
+            function.GetBlockIndex() - first_block < block_count)
+        {
+            expected_processor.WriteBlockEnd(function);
+        }
+    }
+    auto expected_submits = expected_processor.TakeSubmits();
+    auto expected_command_buffers = expected_processor.TakeVkCommandsCache();
+
+    // Record indices count from the first decoded block, so only names and arguments are compared.
+    auto expect_same_commands =
+        [](const std::vector<DiveAnnotationProcessor::VulkanCommandInfo>& actual_commands,
+           const std::vector<DiveAnnotationProcessor::VulkanCommandInfo>& expected_commands) {
+            ASSERT_EQ(actual_commands.size(), expected_commands.size());
+            for (size_t i = 0; i < expected_commands.size(); ++i)
+            {
+                EXPECT_EQ(actual_commands[i].name, expected_commands[i].name);
+                EXPECT_EQ(actual_commands[i].args.ToJson(), expected_commands[i].args.ToJson());
+            }
+        };
+
+    ASSERT_EQ(actual.GetGfxrSubmits().size(), expected_submits.size());
+    for (size_t i = 0; i < expected_submits.size(); ++i)
+    {
+        const auto& expected = *expected_submits[i];
+        const auto& submit = *actual.GetGfxrSubmits()[i];
+        EXPECT_EQ(submit.name, expected.name);
+        EXPECT_EQ(submit.vk_command_buffer_handles, expected.vk_command_buffer_handles);
+        expect_same_commands(submit.none_cmd_vk_commands, expected.none_cmd_vk_commands);
+        for (uint64_t handle : submit.vk_command_buffer_handles)
+        {
+            // Command buffers recorded before the range are submitted without their commands.
+            if (expected_command_buffers.count(handle) == 0)
+            {
+                EXPECT_TRUE(actual.GetGfxrCommandBuffers(handle).empty());
+            }
+        }
+    }
+    for (const auto& [handle, expected_commands] : expected_command_buffers)
+    {
+        SCOPED_TRACE(testing::Message() << "command buffer " << handle);
+        expect_same_commands(actual.GetGfxrCommandBuffers(handle), expected_commands);
+    }
+}
+
+TEST(GfxrCaptureDataTest, PartialLoadDecodesBlockRange)
+{
+    constexpr const char* kTestFile = TEST_DATA_DIR
+        "/com.google.bigwheels.project_sample_01_triangle.debug_"
+        "trim_trigger_20250718T132545.gfxr";
+    constexpr uint64_t kBlockCount = 231;
+    std::vector<gfxrecon::util::DiveFunctionData> functions = DecodeFunctions(kTestFile);
+    ASSERT_FALSE(functions.empty());
+
+    // The second half of the capture, then a range in the middle of it.
+    for (GfxrCaptureRange range : {GfxrCaptureRange{.first_block = 115},
+                                   GfxrCaptureRange{.first_block = 60, .last_block = 180}})
+    {
+        SCOPED_TRACE(testing::Message() << "blocks " << range.first_block << " to "
+                                        << range.last_block);
+        GfxrCaptureData partial;
+        ASSERT_EQ(partial.LoadCaptureFile(kTestFile, range), CaptureData::LoadResult::kSuccess);
+        uint64_t block_count = std::min(range.last_block, kBlockCount - 1) + 1 - range.first_block;
+        EXPECT_EQ(partial.GetFirstLoadedBlock(), range.first_block);
+        EXPECT_EQ(partial.GetLoadedBlockCount(), block_count);
+        ExpectDecodedBlocks(partial, functions, range.first_block, block_count);
+    }
+}
+
+TEST(GfxrCaptureDataTest, PartialLoadDecodesFrameRange)
+{
+    constexpr const char* kTestFile = TEST_DATA_DIR
+        "/com.google.bigwheels.project_sample_01_triangle.debug_"
+        "trim_trigger_20250718T132545.gfxr";
+    std::vector<gfxrecon::util::DiveFunctionData> functions = DecodeFunctions(kTestFile);
+    ASSERT_FALSE(functions.empty());
+
+    // The capture has a single frame, so the first frame is the whole capture.
+    GfxrCaptureData first_frame;
+    ASSERT_EQ(first_frame.LoadCaptureFile(kTestFile,
+                                          GfxrCaptureRange{.first_frame = 0, .last_frame = 0}),
+              CaptureData::LoadResult::kSuccess);
+    ASSERT_EQ(first_frame.GetFrameFirstBlocks(), std::vector<uint64_t>{0});
+    EXPECT_EQ(first_frame.GetFirstLoadedBlock(), 0u);
+    EXPECT_EQ(first_frame.GetLoadedBlockCount(), 231u);
+    ExpectDecodedBlocks(first_frame, functions, 0, 231);
+
+    // Blocks of the frame.
+    GfxrCaptureData blocks_of_frame;
+    ASSERT_EQ(blocks_of_frame.LoadCaptureFile(kTestFile, GfxrCaptureRange{.first_frame = 0,
+                                                                          .last_frame = 0,
+                                                                          .first_block = 115}),
+              CaptureData::LoadResult::kSuccess);
+    EXPECT_EQ(blocks_of_frame.GetFirstLoadedBlock(), 115u);
+    EXPECT_EQ(blocks_of_frame.GetLoadedBlockCount(), 231u - 115u);
+    ExpectDecodedBlocks(blocks_of_frame, functions, 115, 231 - 115);
+
+    // Past the last frame.
+    GfxrCaptureData second_frame;
+    ASSERT_EQ(second_frame.LoadCaptureFile(kTestFile, GfxrCaptureRange{.first_frame = 1}),
+              CaptureData::LoadResult::kSuccess);
+    EXPECT_EQ(second_frame.GetLoadedBlockCount(), 0u);
+    EXPECT_TRUE(second_frame.GetGfxrSubmits().empty());
+}
+
+TEST(GfxrCaptureDataTest, GetGfxrRangeBlocksOfFrames)
+{
+    // Three frames of 10, 5 and 15 blocks.
+    const std::vector<uint64_t> frame_first_blocks = {0, 10, 15};
+    constexpr uint64_t kBlockCount = 30;
+    auto range_blocks = [&](const GfxrCaptureRange& range) {
+        return GetGfxrRangeBlocks(frame_first_blocks, kBlockCount, range);
+    };
+    using Blocks = std::pair<uint64_t, uint64_t>;
+
+    EXPECT_EQ(range_blocks({}), (Blocks{0, 30}));
+    EXPECT_EQ(range_blocks({.first_frame = 1, .last_frame = 1}), (Blocks{10, 5}));
+    EXPECT_EQ(range_blocks({.first_frame = 1}), (Blocks{10, 20}));
+    EXPECT_EQ(range_blocks({.last_frame = 0}), (Blocks{0, 10}));
+    EXPECT_EQ(range_blocks({.first_frame = 2, .last_frame = 5}), (Blocks{15, 15}));
+    // Both ranges apply.
+    EXPECT_EQ(
+        range_blocks({.first_frame = 1, .last_frame = 2, .first_block = 12, .last_block = 20}),
+        (Blocks{12, 9}));
+    EXPECT_EQ(range_blocks({.first_frame = 0, .last_frame = 0, .first_block = 12}),
+              (Blocks{12, 0}));
+    EXPECT_EQ(range_blocks({.first_frame = 2, .last_block = 100}), (Blocks{15, 15}));
+    // Frames past the last one.
+    EXPECT_EQ(range_blocks({.first_frame = 3}), (Blocks{0, 0}));
+}
+
+TEST(GfxrCaptureDataTest, PartialLoadUsesCaptureIndex)
+{
+    std::string capture = CopyTestCaptureToTempDir("PartialLoadUsesCaptureIndex");
+
+    GfxrCaptureData decoded;
+    decoded.SetCaptureIndexEnabled(true);
+    ASSERT_EQ(decoded.LoadCaptureFile(capture), CaptureData::LoadResult::kSuccess);
+
+    absl::StatusOr<GfxrCaptureIndexKey> key = ComputeGfxrCaptureIndexKey(capture);
+    ASSERT_TRUE(key.ok()) << key.status();
+    absl::StatusOr<GfxrCaptureIndexData> blocks =
+        LoadGfxrCaptureIndexBlocks(GetGfxrCaptureIndexPath(capture), *key);
+    ASSERT_TRUE(blocks.ok()) << blocks.status();
+    EXPECT_EQ(blocks->frame_first_blocks, decoded.GetFrameFirstBlocks());
+    EXPECT_TRUE(blocks->submits.empty());
+
+    GfxrCaptureData partial;
+    partial.SetCaptureIndexEnabled(true);
+    ASSERT_EQ(partial.LoadCaptureFile(capture, GfxrCaptureRange{}),
+              CaptureData::LoadResult::kSuccess);
+    EXPECT_EQ(partial.GetFrameFirstBlocks(), decoded.GetFrameFirstBlocks());
+    EXPECT_EQ(partial.GetGfxrSubmits().size(), decoded.GetGfxrSubmits().size());
+}
+
 }  // namespace
 }  // namespace Dive
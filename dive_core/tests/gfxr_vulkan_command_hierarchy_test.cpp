@@ -0,0 +1,188 @@
+/*
+Copyright 2026 Google Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "dive_core/gfxr_vulkan_command_hierarchy.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "dive_core/command_hierarchy.h"
+#include "dive_core/gfxr_capture_data.h"
+#include "gtest/gtest.h"
+
+namespace Dive
+{
+namespace
+{
+
+constexpr const char* kTestFile = TEST_DATA_DIR
+    "/com.google.bigwheels.project_sample_01_triangle.debug_"
+    "trim_trigger_20250718T132545.gfxr";
+
+std::optional<uint64_t> FindNode(const CommandHierarchy& command_hierarchy, NodeType type)
+{
+    for (uint64_t node_index = 0; node_index < command_hierarchy.size(); ++node_index)
+    {
+        if (command_hierarchy.GetNodeType(node_index) == type)
+        {
+            return node_index;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<uint64_t> GetChildren(const Topology& topology, uint64_t node_index)
+{
+    std::vector<uint64_t> children;
+    for (uint64_t i = 0; i < topology.GetNumChildren(node_index); ++i)
+    {
+        children.push_back(topology.GetChildNodeIndex(node_index, i));
+    }
+    return children;
+}
+
+class GfxrVulkanCommandHierarchyTest : public testing::Test
+{
+ protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(capture_data_.LoadCaptureFile(kTestFile), CaptureData::LoadResult::kSuccess);
+        GfxrVulkanCommandHierarchyCreator creator(command_hierarchy_, capture_data_);
+        ASSERT_TRUE(creator.CreateTrees());
+    }
+
+    GfxrCaptureData capture_data_;
+    CommandHierarchy command_hierarchy_;
+};
+
+TEST_F(GfxrVulkanCommandHierarchyTest, ArgumentNodesArePending)
+{
+    EXPECT_EQ(FindNode(command_hierarchy_, NodeType::kGfxrVulkanCommandArgNode), std::nullopt);
+
+    std::optional<uint64_t> draw_node =
+        FindNode(command_hierarchy_, NodeType::kGfxrVulkanDrawCommandNode);
+    ASSERT_TRUE(draw_node.has_value());
+    EXPECT_GT(command_hierarchy_.GetNumPendingChildren(*draw_node), 0u);
+    EXPECT_EQ(command_hierarchy_.GetAllEventHierarchyTopology().GetNumChildren(*draw_node), 0u);
+}
+
+TEST_F(GfxrVulkanCommandHierarchyTest, ExpandNodeCreatesArgumentNodes)
+{
+    std::optional<uint64_t> draw_node =
+        FindNode(command_hierarchy_, NodeType::kGfxrVulkanDrawCommandNode);
+    ASSERT_TRUE(draw_node.has_value());
+    uint64_t num_pending_children = command_hierarchy_.GetNumPendingChildren(*draw_node);
+    uint64_t num_nodes = command_hierarchy_.size();
+
+    command_hierarchy_.ExpandNode(*draw_node);
+
+    const Topology& topology = command_hierarchy_.GetAllEventHierarchyTopology();
+    EXPECT_EQ(command_hierarchy_.GetNumPendingChildren(*draw_node), 0u);
+    ASSERT_EQ(topology.GetNumChildren(*draw_node), num_pending_children);
+    EXPECT_GE(command_hierarchy_.size(), num_nodes + num_pending_children);
+    for (uint64_t node_index = num_nodes; node_index < command_hierarchy_.size(); ++node_index)
+    {
+        EXPECT_EQ(command_hierarchy_.GetNodeType(node_index), NodeType::kGfxrVulkanCommandArgNode);
+        uint64_t parent_node_index = topology.GetParentNodeIndex(node_index);
+        EXPECT_EQ(topology.GetChildNodeIndex(parent_node_index, topology.GetChildIndex(node_index)),
+                  node_index);
+    }
+
+    // Expanding again does nothing
+    uint64_t num_expanded_nodes = command_hierarchy_.size();
+    command_hierarchy_.ExpandNode(*draw_node);
+    EXPECT_EQ(command_hierarchy_.size(), num_expanded_nodes);
+}
+
+TEST_F(GfxrVulkanCommandHierarchyTest, ArgumentNodesComeBeforeCommandChildren)
+{
+    std::optional<uint64_t> render_pass_node =
+        FindNode(command_hierarchy_, NodeType::kGfxrVulkanBeginRenderPassCommandNode);
+    ASSERT_TRUE(render_pass_node.has_value());
+    const Topology& topology = command_hierarchy_.GetAllEventHierarchyTopology();
+    std::vector<uint64_t> command_children = GetChildren(topology, *render_pass_node);
+    ASSERT_FALSE(command_children.empty());
+    uint64_t num_pending_children = command_hierarchy_.GetNumPendingChildren(*render_pass_node);
+    ASSERT_GT(num_pending_children, 0u);
+
+    command_hierarchy_.ExpandNode(*render_pass_node);
+
+    std::vector<uint64_t> children = GetChildren(topology, *render_pass_node);
+    ASSERT_EQ(children.size(), num_pending_children + command_children.size());
+    for (uint64_t i = 0; i < children.size(); ++i)
+    {
+        EXPECT_EQ(topology.GetParentNodeIndex(children[i]), *render_pass_node);
+        EXPECT_EQ(topology.GetChildIndex(children[i]), i);
+        if (i < num_pending_children)
+        {
+            EXPECT_EQ(command_hierarchy_.GetNodeType(children[i]),
+                      NodeType::kGfxrVulkanCommandArgNode);
+        }
+        else
+        {
+            EXPECT_EQ(children[i], command_children[i - num_pending_children]);
+        }
+    }
+}
+
+TEST_F(GfxrVulkanCommandHierarchyTest, PendingChildrenContain)
+{
+    std::optional<uint64_t> draw_node =
+        FindNode(command_hierarchy_, NodeType::kGfxrVulkanDrawCommandNode);
+    ASSERT_TRUE(draw_node.has_value());
+    EXPECT_TRUE(command_hierarchy_.PendingChildrenContain(*draw_node, "VERTEXcount"));
+    EXPECT_FALSE(command_hierarchy_.PendingChildrenContain(*draw_node, "no_such_argument"));
+
+    // Arguments nested below other arguments are searched too
+    std::optional<uint64_t> render_pass_node =
+        FindNode(command_hierarchy_, NodeType::kGfxrVulkanBeginRenderPassCommandNode);
+    ASSERT_TRUE(render_pass_node.has_value());
+    EXPECT_TRUE(command_hierarchy_.PendingChildrenContain(*render_pass_node, "extent"));
+
+    // Once expanded, the argument nodes are searched like any other node
+    uint64_t num_nodes = command_hierarchy_.size();
+    command_hierarchy_.ExpandNode(*draw_node);
+    EXPECT_FALSE(command_hierarchy_.PendingChildrenContain(*draw_node, "vertexCount"));
+    bool found = false;
+    for (uint64_t node_index = num_nodes; node_index < command_hierarchy_.size(); ++node_index)
+    {
+        found = found || std::string(command_hierarchy_.GetNodeDesc(node_index))
+                                 .find("vertexCount") != std::string::npos;
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST_F(GfxrVulkanCommandHierarchyTest, ClearPendingChildren)
+{
+    std::optional<uint64_t> draw_node =
+        FindNode(command_hierarchy_, NodeType::kGfxrVulkanDrawCommandNode);
+    ASSERT_TRUE(draw_node.has_value());
+    uint64_t num_nodes = command_hierarchy_.size();
+
+    command_hierarchy_.ClearPendingChildren();
+    // The capture data can now be replaced; expanding no longer reads it
+    capture_data_ = GfxrCaptureData();
+
+    EXPECT_EQ(command_hierarchy_.GetNumPendingChildren(*draw_node), 0u);
+    command_hierarchy_.ExpandNode(*draw_node);
+    EXPECT_EQ(command_hierarchy_.size(), num_nodes);
+    EXPECT_EQ(command_hierarchy_.GetAllEventHierarchyTopology().GetNumChildren(*draw_node), 0u);
+}
+
+}  // namespace
+}  // namespace Dive
@@ -16,6 +16,11 @@
 
 #include "dive_core/perf_metrics_data.h"
 
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <span>
+
 #include "dive_core/available_metrics.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -60,6 +65,16 @@ using ::testing::IsEmpty;
 using ::testing::SizeIs;
 using ::testing::VariantWith;
 
+std::vector<PerfMetricsRecord> ToRecords(const PerfMetricsColumns& columns)
+{
+    std::vector<PerfMetricsRecord> records;
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        records.push_back(columns.GetRecord(i));
+    }
+    return records;
+}
+
 MATCHER_P(PerfMetricsRecordEq, expected, "has the correct perf metrics record fields")
 {
     EXPECT_EQ(arg.m_context_id, expected.m_context_id);
@@ -84,7 +99,7 @@ TEST(PerfMetricsData, LoadFromCsv)
         TEST_DATA_DIR "/mock_perf_metrics_data.csv", *available_metrics);
     ASSERT_NE(perf_metrics_data, nullptr);
 
-    const auto& records = perf_metrics_data->GetRecords();
+    const auto records = ToRecords(perf_metrics_data->GetRecords());
     EXPECT_THAT(
         records,
         ElementsAre(
@@ -164,8 +179,8 @@ TEST(PerfMetricsData, LoadFromCsvMalformedRowSkipped)
     auto perf_metrics_data = PerfMetricsData::LoadFromCsv(
         TEST_DATA_DIR "/mock_perf_metrics_data_malformed.csv", *available_metrics);
     ASSERT_NE(perf_metrics_data, nullptr);
-    ASSERT_THAT(perf_metrics_data->GetRecords(), SizeIs(1));
-    EXPECT_THAT(perf_metrics_data->GetRecords(),
+    ASSERT_EQ(perf_metrics_data->GetRecords().size(), 1u);
+    EXPECT_THAT(ToRecords(perf_metrics_data->GetRecords()),
                 ElementsAre(AllOf(
                     PerfMetricsRecordEq(PerfMetricsRecord{2, 200, 2000, 20000, 2, 2, 2, 2, 2, {}}),
                     Field(&PerfMetricsRecord::m_metric_values,
@@ -205,6 +220,75 @@ TEST(PerfMetricsData, LoadFromCsvUnknownMeticTypeSkipped)
     ASSERT_EQ(perf_metrics_data, nullptr);
 }
 
+TEST(PerfMetricsData, LoadFromCsvInParallelKeepsRecordOrder)
+{
+    auto available_metrics =
+        AvailableMetrics::LoadFromCsv(TEST_DATA_DIR "/mock_available_metrics.csv");
+    ASSERT_NE(available_metrics, nullptr);
+
+    // Large enough to be split between threads.
+    std::filesystem::path file_path =
+        std::filesystem::temp_directory_path() / "perf_metrics_data_parallel_test.csv";
+    {
+        std::ofstream file(file_path);
+        file << "ContextID,ProcessID,FrameID,CmdBufferID,DrawID,DrawType,DrawLabel,ProgramID,"
+                "LRZState,COUNTER_A,COUNTER_B\n";
+        for (uint32_t i = 0; i < 500000; ++i)
+        {
+            file << "1,100," << i / 100 << ",10000," << i % 100 << ",4,1,1,1," << i << ","
+                 << (i % 1000) * 0.25 << "\n";
+        }
+    }
+
+    auto serial_data = PerfMetricsData::LoadFromCsv(file_path, *available_metrics, 1);
+    auto parallel_data = PerfMetricsData::LoadFromCsv(file_path, *available_metrics, 4);
+    std::filesystem::remove(file_path);
+    ASSERT_NE(serial_data, nullptr);
+    ASSERT_NE(parallel_data, nullptr);
+
+    const PerfMetricsColumns& serial = serial_data->GetRecords();
+    const PerfMetricsColumns& parallel = parallel_data->GetRecords();
+    ASSERT_EQ(serial.size(), 500000u);
+    ASSERT_EQ(parallel.size(), serial.size());
+    EXPECT_EQ(parallel.GetFrameIds(), serial.GetFrameIds());
+    EXPECT_EQ(parallel.GetDrawIds(), serial.GetDrawIds());
+    EXPECT_EQ(parallel.GetMetricColumn(0), serial.GetMetricColumn(0));
+    EXPECT_EQ(parallel.GetMetricColumn(1), serial.GetMetricColumn(1));
+    EXPECT_DOUBLE_EQ(parallel.GetMetricValue(499999, 1), 249.75);
+}
+
+TEST(PerfMetricsData, BinaryRoundTrip)
+{
+    auto available_metrics =
+        AvailableMetrics::LoadFromCsv(TEST_DATA_DIR "/mock_available_metrics.csv");
+    ASSERT_NE(available_metrics, nullptr);
+    auto csv_data = PerfMetricsData::LoadFromCsv(TEST_DATA_DIR "/mock_perf_metrics_data.csv",
+                                                 *available_metrics);
+    ASSERT_NE(csv_data, nullptr);
+
+    std::filesystem::path file_path =
+        std::filesystem::temp_directory_path() / "perf_metrics_data_round_trip_test.dpm";
+    ASSERT_TRUE(csv_data->WriteBinary(file_path));
+    auto binary_data = PerfMetricsData::LoadFromBinary(file_path, *available_metrics);
+    ASSERT_NE(binary_data, nullptr);
+
+    EXPECT_EQ(binary_data->GetMetricNames(), csv_data->GetMetricNames());
+    EXPECT_EQ(binary_data->GetMetricInfos(), csv_data->GetMetricInfos());
+    std::vector<PerfMetricsRecord> expected = ToRecords(csv_data->GetRecords());
+    std::vector<PerfMetricsRecord> actual = ToRecords(binary_data->GetRecords());
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i)
+    {
+        EXPECT_THAT(actual[i], PerfMetricsRecordEq(expected[i]));
+        EXPECT_EQ(actual[i].m_metric_values, expected[i].m_metric_values);
+    }
+
+    // A truncated file is rejected rather than partially loaded.
+    std::filesystem::resize_file(file_path, std::filesystem::file_size(file_path) - 8);
+    EXPECT_EQ(PerfMetricsData::LoadFromBinary(file_path, *available_metrics), nullptr);
+    std::filesystem::remove(file_path);
+}
+
 std::unique_ptr<PerfMetricsDataProvider> CreateTestMetricProvider()
 {
     auto available_metrics =
@@ -228,7 +312,7 @@ TEST(PerfMetricsDataProviderTest, GetComputedRecords)
     auto provider = CreateTestMetricProvider();
     ASSERT_NE(provider, nullptr);
     provider->Analyze(nullptr);
-    const auto& computed_records = provider->GetComputedRecords();
+    const auto computed_records = ToRecords(provider->GetComputedRecords());
     ASSERT_THAT(computed_records, SizeIs(7));
 
     PerfMetricsRecord expected_record1{1, 100, 0, 10000, 1, 1, 1, 4, 1};
@@ -260,6 +344,107 @@ TEST(PerfMetricsDataProviderTest, GetComputedRecords)
     EXPECT_THAT(computed_records[6].m_metric_values, ElementsAre(DoubleEq(2101), DoubleEq(2.101)));
 }
 
+TEST(PerfMetricsDataProviderTest, ComputedRecordsAreColumnMajor)
+{
+    auto provider = CreateTestMetricProvider();
+    ASSERT_NE(provider, nullptr);
+    provider->Analyze(nullptr);
+    const auto& computed_records = provider->GetComputedRecords();
+    ASSERT_EQ(computed_records.GetMetricCount(), 2u);
+    EXPECT_THAT(computed_records.GetDrawIds(), ElementsAre(1, 2, 3, 1, 2, 3, 1));
+    EXPECT_THAT(computed_records.GetMetricColumn(0),
+                ElementsAre(DoubleEq(1231), DoubleEq(1101), DoubleEq(1351), DoubleEq(1501),
+                            DoubleEq(1201), DoubleEq(1451), DoubleEq(2101)));
+    EXPECT_DOUBLE_EQ(computed_records.GetMetricValue(4, 1), 1.301);
+}
+
+TEST(PerfMetricsDataProviderTest, GetComputedStats)
+{
+    auto provider = CreateTestMetricProvider();
+    ASSERT_NE(provider, nullptr);
+    provider->Analyze(nullptr);
+    const PerfMetricsStats& stats = provider->GetComputedStats(0, 0);
+    EXPECT_EQ(stats.m_sample_count, 2u);
+    EXPECT_DOUBLE_EQ(stats.m_mean, 1231);
+    EXPECT_DOUBLE_EQ(stats.m_median, 1231);
+    EXPECT_DOUBLE_EQ(stats.m_min, 1230);
+    EXPECT_DOUBLE_EQ(stats.m_max, 1232);
+    EXPECT_DOUBLE_EQ(stats.m_stddev, std::sqrt(2.0));
+    EXPECT_FALSE(stats.m_has_outliers);
+}
+
+// Builds a provider over frames made of the given draw IDs, all in the same command buffer. The
+// single metric of each record is given by `value(frame_id, draw_id)`.
+template <typename ValueFn>
+std::unique_ptr<PerfMetricsDataProvider> CreateProviderFromFrames(
+    const std::vector<std::vector<uint32_t>>& frames, ValueFn value)
+{
+    PerfMetricsColumns records(1);
+    for (size_t frame_id = 0; frame_id < frames.size(); ++frame_id)
+    {
+        for (uint32_t draw_id : frames[frame_id])
+        {
+            PerfMetricsRecord fields{1, 100, frame_id, 10000, draw_id, 1, 1, 1, 1};
+            double metric_value = value(frame_id, draw_id);
+            records.AddRecord(fields, std::span<const double>(&metric_value, 1));
+        }
+    }
+    return PerfMetricsDataProvider::Create(std::make_unique<PerfMetricsData>(
+        std::vector<std::string>{"COUNTER_A"}, std::vector<const MetricInfo*>{nullptr},
+        std::move(records)));
+}
+
+TEST(PerfMetricsDataProviderTest, FramesWithExtraOrMissingDrawsAreAligned)
+{
+    // Draw 9 is only in frame 2, and draw 3 is missing from frame 3.
+    auto provider = CreateProviderFromFrames(
+        {{1, 2, 3, 4}, {1, 2, 3, 4}, {1, 2, 9, 3, 4}, {1, 2, 4}},
+        [](size_t frame_id, uint32_t draw_id) { return frame_id * 10.0 + draw_id; });
+    provider->Analyze(nullptr);
+
+    const auto& computed_records = provider->GetComputedRecords();
+    EXPECT_THAT(computed_records.GetDrawIds(), ElementsAre(1, 2, 3, 4));
+    EXPECT_THAT(computed_records.GetMetricColumn(0),
+                ElementsAre(DoubleEq(16), DoubleEq(17), DoubleEq(13), DoubleEq(19)));
+    EXPECT_EQ(provider->GetComputedStats(0, 0).m_sample_count, 4u);
+    EXPECT_EQ(provider->GetComputedStats(2, 0).m_sample_count, 3u);
+    EXPECT_DOUBLE_EQ(provider->GetComputedStats(2, 0).m_min, 3);
+    EXPECT_DOUBLE_EQ(provider->GetComputedStats(2, 0).m_max, 23);
+}
+
+TEST(PerfMetricsDataProviderTest, ComputedStatsFlagOutliers)
+{
+    std::vector<std::vector<uint32_t>> frames(12, std::vector<uint32_t>{1});
+    auto provider = CreateProviderFromFrames(
+        frames, [](size_t frame_id, uint32_t) { return frame_id == 5 ? 1000.0 : 10.0; });
+    provider->Analyze(nullptr);
+
+    const PerfMetricsStats& stats = provider->GetComputedStats(0, 0);
+    EXPECT_EQ(stats.m_sample_count, 12u);
+    EXPECT_DOUBLE_EQ(stats.m_mean, 92.5);
+    EXPECT_DOUBLE_EQ(stats.m_median, 10);
+    EXPECT_TRUE(stats.m_has_outliers);
+}
+
+TEST(PerfMetricsDataProviderTest, ComputedStatsOfManyFrames)
+{
+    // Past the samples that are kept, the median is estimated
+    std::vector<std::vector<uint32_t>> frames(1000, std::vector<uint32_t>{1, 2});
+    auto provider = CreateProviderFromFrames(frames, [](size_t frame_id, uint32_t draw_id) {
+        return draw_id == 1 ? static_cast<double>(frame_id * 37 % 101) : 5.0;
+    });
+    provider->Analyze(nullptr);
+
+    const PerfMetricsStats& stats = provider->GetComputedStats(0, 0);
+    EXPECT_EQ(stats.m_sample_count, 1000u);
+    EXPECT_NEAR(stats.m_mean, 50, 0.5);
+    EXPECT_NEAR(stats.m_median, 50, 1);
+    EXPECT_DOUBLE_EQ(stats.m_min, 0);
+    EXPECT_DOUBLE_EQ(stats.m_max, 100);
+    EXPECT_DOUBLE_EQ(provider->GetComputedStats(1, 0).m_median, 5);
+    EXPECT_DOUBLE_EQ(provider->GetComputedStats(1, 0).m_stddev, 0);
+}
+
 TEST(PerfMetricsDataProviderTest, GetRecordHeader)
 {
     auto provider = CreateTestMetricProvider();
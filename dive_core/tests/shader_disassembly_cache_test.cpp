@@ -0,0 +1,159 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include "dive_core/shader_disassembly_cache.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace Dive
+{
+namespace
+{
+
+std::shared_ptr<const DisassembledShader> MakeShader(const std::string& listing)
+{
+    auto shader = std::make_shared<DisassembledShader>();
+    shader->m_listing = listing;
+    shader->m_instructions_text = "mov.f32f32 r0.x, c0.xend";
+    shader->m_instruction_offsets = {0, 21, 24};
+    shader->m_instructions_raw = {0x2000000000000000ull, 0x0300000000000000ull};
+    shader->m_gpr_count = 3;
+    return shader;
+}
+
+class ShaderDisassemblyCacheTest : public testing::Test
+{
+ protected:
+    void SetUp() override
+    {
+        m_directory = std::filesystem::path(testing::TempDir()) /
+                      testing::UnitTest::GetInstance()->current_test_info()->name();
+        std::filesystem::remove_all(m_directory);
+    }
+    void TearDown() override { std::filesystem::remove_all(m_directory); }
+
+    std::filesystem::path m_directory;
+};
+
+TEST_F(ShaderDisassemblyCacheTest, KeyDependsOnContentAndGpu)
+{
+    const std::vector<uint8_t> shader = {1, 2, 3, 4, 5, 6, 7, 8};
+    std::vector<uint8_t> other = shader;
+    other.back() = 9;
+
+    const ShaderDisassemblyKey key = ShaderDisassemblyCache::ComputeKey(shader, 740);
+    EXPECT_EQ(key, ShaderDisassemblyCache::ComputeKey(shader, 740));
+    EXPECT_NE(key, ShaderDisassemblyCache::ComputeKey(other, 740));
+    EXPECT_NE(key, ShaderDisassemblyCache::ComputeKey(shader, 750));
+    EXPECT_NE(key, ShaderDisassemblyCache::ComputeKey(std::span(shader).first(4), 740));
+}
+
+TEST_F(ShaderDisassemblyCacheTest, FindsInsertedShader)
+{
+    ShaderDisassemblyCache cache;
+    const std::vector<uint8_t> bytes = {1, 2, 3, 4};
+    const ShaderDisassemblyKey key = ShaderDisassemblyCache::ComputeKey(bytes, 740);
+    EXPECT_EQ(cache.Find(key), nullptr);
+
+    auto shader = MakeShader("listing");
+    cache.Insert(key, shader);
+    EXPECT_EQ(cache.Find(key), shader);
+    EXPECT_GT(cache.GetMemoryUsage(), 0u);
+}
+
+TEST_F(ShaderDisassemblyCacheTest, EvictsLeastRecentlyUsed)
+{
+    const std::string listing(1000, 'x');
+    // Room for two entries but not three.
+    ShaderDisassemblyCache cache(2 * listing.size() + 1000);
+    const ShaderDisassemblyKey keys[] = {{1, 4, 740}, {2, 4, 740}, {3, 4, 740}};
+    cache.Insert(keys[0], MakeShader(listing));
+    cache.Insert(keys[1], MakeShader(listing));
+    // Makes keys[1] the least recently used.
+    EXPECT_NE(cache.Find(keys[0]), nullptr);
+    cache.Insert(keys[2], MakeShader(listing));
+
+    EXPECT_NE(cache.Find(keys[0]), nullptr);
+    EXPECT_EQ(cache.Find(keys[1]), nullptr);
+    EXPECT_NE(cache.Find(keys[2]), nullptr);
+    EXPECT_LE(cache.GetMemoryUsage(), 2 * listing.size() + 1000);
+}
+
+TEST_F(ShaderDisassemblyCacheTest, PersistsToDirectory)
+{
+    const ShaderDisassemblyKey key{0x0123456789abcdefull, 256, 740};
+    {
+        ShaderDisassemblyCache cache;
+        cache.SetDirectory(m_directory);
+        cache.Insert(key, MakeShader("persisted"));
+    }
+
+    ShaderDisassemblyCache cache;
+    cache.SetDirectory(m_directory);
+    std::shared_ptr<const DisassembledShader> shader = cache.Find(key);
+    ASSERT_NE(shader, nullptr);
+    const auto expected = MakeShader("persisted");
+    EXPECT_EQ(shader->m_listing, expected->m_listing);
+    EXPECT_EQ(shader->m_instructions_text, expected->m_instructions_text);
+    EXPECT_EQ(shader->m_instruction_offsets, expected->m_instruction_offsets);
+    EXPECT_EQ(shader->GetInstructionText(1), "end");
+    EXPECT_EQ(shader->m_instructions_raw, expected->m_instructions_raw);
+    EXPECT_EQ(shader->m_gpr_count, expected->m_gpr_count);
+
+    // Only the entry itself is left in the directory.
+    size_t file_count = 0;
+    for ([[maybe_unused]] const auto& file : std::filesystem::directory_iterator(m_directory))
+    {
+        ++file_count;
+    }
+    EXPECT_EQ(file_count, 1u);
+}
+
+TEST_F(ShaderDisassemblyCacheTest, IgnoresCorruptEntries)
+{
+    const ShaderDisassemblyKey key{42, 256, 740};
+    {
+        ShaderDisassemblyCache cache;
+        cache.SetDirectory(m_directory);
+        cache.Insert(key, MakeShader("listing"));
+    }
+    for (const auto& file : std::filesystem::directory_iterator(m_directory))
+    {
+        const uintmax_t size = std::filesystem::file_size(file.path());
+        std::filesystem::resize_file(file.path(), size - 3);
+    }
+
+    ShaderDisassemblyCache cache;
+    cache.SetDirectory(m_directory);
+    EXPECT_EQ(cache.Find(key), nullptr);
+
+    // Nor a file that is not an entry at all.
+    for (const auto& file : std::filesystem::directory_iterator(m_directory))
+    {
+        std::ofstream(file.path(), std::ios::binary | std::ios::trunc) << "not a cache entry";
+    }
+    EXPECT_EQ(cache.Find(key), nullptr);
+}
+
+}  // namespace
+}  // namespace Dive
@@ -0,0 +1,84 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include "dive_core/shader_disassembly.h"
+
+#include "gtest/gtest.h"
+
+namespace Dive
+{
+namespace
+{
+
+TEST(ParseRawDisassemblyTest, SplitsInstructions)
+{
+    DisassembledShader shader;
+    ParseRawDisassembly(":0:0000:0001[00000000x_00000000x] nop\n"
+                        ":1:0001:0002[20044001x_00000005x] mov.f32f32 r0.x, c1.y\n"
+                        ":0:0002:0003[03000000x_00000000x] end\n",
+                        shader);
+
+    ASSERT_EQ(shader.GetNumInstructions(), 3u);
+    EXPECT_EQ(shader.GetInstructionText(0), "nop");
+    EXPECT_EQ(shader.GetInstructionText(1), "mov.f32f32 r0.x, c1.y");
+    EXPECT_EQ(shader.GetInstructionText(2), "end");
+    EXPECT_EQ(shader.m_instructions_raw[1], 0x2004400100000005ull);
+    EXPECT_EQ(shader.m_instructions_raw[2], 0x0300000000000000ull);
+}
+
+TEST(ParseRawDisassemblyTest, ContinuationLinesJoinTheCurrentInstruction)
+{
+    DisassembledShader shader;
+    ParseRawDisassembly(":0:0000:0001[00000000x_00000000x] nop\n"
+                        ":1:0001:0002[20044001x_00000005x] mov.f32f32 r0.x, c1.y\n"
+                        ":1:0001:0002[20044001x_00000005x] (rpt1)\n"
+                        "end_of_block:\n"
+                        ":0:0002:0003[03000000x_00000000x] end",
+                        shader);
+
+    // A line that repeats the instruction index, or has no prefix at all, doesn't start a new
+    // instruction. The text of a line without a prefix is not kept.
+    ASSERT_EQ(shader.GetNumInstructions(), 3u);
+    EXPECT_EQ(shader.GetInstructionText(0), "nop");
+    EXPECT_EQ(shader.GetInstructionText(1), "mov.f32f32 r0.x, c1.y\n(rpt1)\n");
+    EXPECT_EQ(shader.GetInstructionText(2), "end");
+    EXPECT_EQ(shader.m_instructions_raw[1], 0x2004400100000005ull);
+}
+
+TEST(ParseRawDisassemblyTest, SkippedIndicesAreEmpty)
+{
+    DisassembledShader shader;
+    ParseRawDisassembly(":0:0000:0001[00000000x_00000000x] nop\n"
+                        ":0:0002:0003[03000000x_00000000x] end\n",
+                        shader);
+
+    ASSERT_EQ(shader.GetNumInstructions(), 3u);
+    EXPECT_EQ(shader.GetInstructionText(0), "nop");
+    EXPECT_EQ(shader.GetInstructionText(1), "");
+    EXPECT_EQ(shader.m_instructions_raw[1], 0u);
+    EXPECT_EQ(shader.GetInstructionText(2), "end");
+}
+
+TEST(ParseRawDisassemblyTest, EmptyInput)
+{
+    DisassembledShader shader;
+    ParseRawDisassembly("", shader);
+    EXPECT_EQ(shader.GetNumInstructions(), 0u);
+    EXPECT_EQ(shader.m_instruction_offsets.size(), 1u);
+}
+
+}  // namespace
+}  // namespace Dive
@@ -0,0 +1,234 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <latch>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "dive_core/task_scheduler.h"
+
+namespace Dive
+{
+namespace
+{
+
+// The pool trace_stats used before TaskScheduler: a single locked queue shared by all workers.
+class MutexThreadPool
+{
+ public:
+    explicit MutexThreadPool(unsigned int worker_count)
+    {
+        for (unsigned int i = 0; i < worker_count; ++i)
+        {
+            m_workers.emplace_back([this]() { WorkerImpl(); });
+        }
+    }
+
+    ~MutexThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_condition_variable.notify_all();
+        for (std::thread& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    void Run(std::function<void()>&& func)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back(std::move(func));
+        }
+        m_condition_variable.notify_one();
+    }
+
+ private:
+    void WorkerImpl()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition_variable.wait(lock, [this] { return !m_running || !m_tasks.empty(); });
+                if (!m_running)
+                {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    bool m_running = true;
+    std::mutex m_mutex;
+    std::deque<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::condition_variable m_condition_variable;
+};
+
+// Busy work standing in for a task of `cost` units, e.g. one shader to disassemble.
+uint64_t Work(uint64_t seed, uint64_t cost)
+{
+    for (uint64_t i = 0; i < cost * 64; ++i)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    return seed;
+}
+
+// Cost of task `i`: uniform, or with one task in 64 that is 64 times more expensive.
+uint64_t TaskCost(int64_t i, bool unbalanced)
+{
+    return (unbalanced && i % 64 == 0) ? 64 : 1;
+}
+
+void BM_MutexThreadPool(benchmark::State& state)
+{
+    const int64_t task_count = state.range(0);
+    const bool unbalanced = state.range(1) != 0;
+    MutexThreadPool pool(TaskScheduler::GetDefaultWorkerCount());
+    for (auto _ : state)
+    {
+        std::latch done(task_count);
+        for (int64_t i = 0; i < task_count; ++i)
+        {
+            pool.Run([&done, i, unbalanced]() {
+                benchmark::DoNotOptimize(Work(i, TaskCost(i, unbalanced)));
+                done.count_down();
+            });
+        }
+        done.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * task_count);
+}
+BENCHMARK(BM_MutexThreadPool)
+    ->ArgsProduct({{256, 4096, 65536}, {0, 1}})
+    ->ArgNames({"tasks", "unbalanced"})
+    ->UseRealTime();
+
+void BM_TaskScheduler(benchmark::State& state)
+{
+    const int64_t task_count = state.range(0);
+    const bool unbalanced = state.range(1) != 0;
+    TaskScheduler scheduler;
+    for (auto _ : state)
+    {
+        TaskGroup group(scheduler);
+        for (int64_t i = 0; i < task_count; ++i)
+        {
+            group.Run([i, unbalanced]() {
+                benchmark::DoNotOptimize(Work(i, TaskCost(i, unbalanced)));
+            });
+        }
+        group.Wait();
+    }
+    state.SetItemsProcessed(state.iterations() * task_count);
+}
+BENCHMARK(BM_TaskScheduler)
+    ->ArgsProduct({{256, 4096, 65536}, {0, 1}})
+    ->ArgNames({"tasks", "unbalanced"})
+    ->UseRealTime();
+
+// Tasks spawned from tasks, as when a parsing task hands off work it discovers. With the locked
+// queue every spawn contends with every worker; with work stealing it goes to the local deque.
+void BM_TaskSchedulerNested(benchmark::State& state)
+{
+    const int64_t task_count = state.range(0);
+    constexpr int64_t kFanOut = 16;
+    TaskScheduler scheduler;
+    for (auto _ : state)
+    {
+        TaskGroup group(scheduler);
+        for (int64_t i = 0; i < task_count / kFanOut; ++i)
+        {
+            group.Run([&group, i]() {
+                for (int64_t j = 0; j < kFanOut; ++j)
+                {
+                    group.Run([i, j]() { benchmark::DoNotOptimize(Work(i * kFanOut + j, 1)); });
+                }
+            });
+        }
+        group.Wait();
+    }
+    state.SetItemsProcessed(state.iterations() * task_count);
+}
+BENCHMARK(BM_TaskSchedulerNested)->Arg(4096)->Arg(65536)->ArgName("tasks")->UseRealTime();
+
+void BM_MutexThreadPoolNested(benchmark::State& state)
+{
+    const int64_t task_count = state.range(0);
+    constexpr int64_t kFanOut = 16;
+    MutexThreadPool pool(TaskScheduler::GetDefaultWorkerCount());
+    for (auto _ : state)
+    {
+        std::latch done(task_count);
+        for (int64_t i = 0; i < task_count / kFanOut; ++i)
+        {
+            pool.Run([&pool, &done, i]() {
+                for (int64_t j = 0; j < kFanOut; ++j)
+                {
+                    pool.Run([&done, i, j]() {
+                        benchmark::DoNotOptimize(Work(i * kFanOut + j, 1));
+                        done.count_down();
+                    });
+                }
+            });
+        }
+        done.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * task_count);
+}
+BENCHMARK(BM_MutexThreadPoolNested)->Arg(4096)->Arg(65536)->ArgName("tasks")->UseRealTime();
+
+void BM_ParallelFor(benchmark::State& state)
+{
+    std::vector<uint64_t> values(state.range(0), 1);
+    TaskScheduler scheduler;
+    for (auto _ : state)
+    {
+        std::atomic<uint64_t> sum = 0;
+        ParallelFor(scheduler, Context::Background(), 0, values.size(), 4096,
+                    [&](size_t begin, size_t end) {
+                        uint64_t partial = 0;
+                        for (size_t i = begin; i < end; ++i)
+                        {
+                            partial += values[i];
+                        }
+                        sum += partial;
+                    });
+        benchmark::DoNotOptimize(sum.load());
+    }
+    state.SetBytesProcessed(state.iterations() * values.size() * sizeof(uint64_t));
+}
+BENCHMARK(BM_ParallelFor)->Arg(1 << 16)->Arg(1 << 24)->ArgName("values")->UseRealTime();
+
+}  // namespace
+}  // namespace Dive
@@ -0,0 +1,118 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include "dive_core/task_scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace Dive
+{
+namespace
+{
+
+TEST(TaskSchedulerTest, GroupRunsAllTasks)
+{
+    TaskScheduler scheduler(3);
+    std::atomic<int> sum = 0;
+    TaskGroup group(scheduler);
+    for (int i = 1; i <= 1000; ++i)
+    {
+        group.Run([&sum, i]() { sum += i; });
+    }
+    EXPECT_TRUE(group.Wait());
+    EXPECT_EQ(sum.load(), 500500);
+}
+
+TEST(TaskSchedulerTest, NestedTasksAndGroups)
+{
+    TaskScheduler scheduler(2);
+    std::atomic<int> count = 0;
+    TaskGroup outer(scheduler);
+    for (int i = 0; i < 16; ++i)
+    {
+        outer.Run([&]() {
+            // Tasks can both spawn into their own group and wait on a group of their own.
+            outer.Run([&count]() { ++count; });
+            TaskGroup inner(scheduler);
+            for (int j = 0; j < 16; ++j)
+            {
+                inner.Run([&count]() { ++count; });
+            }
+            inner.Wait();
+        });
+    }
+    outer.Wait();
+    EXPECT_EQ(count.load(), 16 * 17);
+}
+
+TEST(TaskSchedulerTest, ParallelForCoversRangeOnce)
+{
+    TaskScheduler scheduler(4);
+    std::vector<int> visits(100003, 0);
+    EXPECT_TRUE(ParallelFor(scheduler, Context::Background(), 3, visits.size(), 1000,
+                            [&visits](size_t begin, size_t end) {
+                                for (size_t i = begin; i < end; ++i)
+                                {
+                                    ++visits[i];
+                                }
+                            }));
+    EXPECT_EQ(std::accumulate(visits.begin(), visits.begin() + 3, 0), 0);
+    EXPECT_EQ(std::accumulate(visits.begin() + 3, visits.end(), 0), 100000);
+    EXPECT_EQ(*std::max_element(visits.begin(), visits.end()), 1);
+}
+
+TEST(TaskSchedulerTest, ParallelForSmallRangeRunsInline)
+{
+    TaskScheduler scheduler(2);
+    std::vector<std::pair<size_t, size_t>> chunks;
+    EXPECT_TRUE(ParallelFor(scheduler, Context::Background(), 0, 10, 100,
+                            [&chunks](size_t begin, size_t end) {
+                                chunks.emplace_back(begin, end);
+                            }));
+    ASSERT_EQ(chunks.size(), 1u);
+    EXPECT_EQ(chunks[0].first, 0u);
+    EXPECT_EQ(chunks[0].second, 10u);
+}
+
+TEST(TaskSchedulerTest, CancelledTasksAreSkipped)
+{
+    TaskScheduler scheduler(1);
+    SimpleContext context = SimpleContext::Create();
+    std::atomic<int> count = 0;
+    TaskGroup group(scheduler, context);
+    for (int i = 0; i < 100; ++i)
+    {
+        group.Run([&]() {
+            if (++count == 10)
+            {
+                context->Cancel();
+            }
+        });
+    }
+    EXPECT_FALSE(group.Wait());
+    // The worker and the waiting thread may each have started a task before the cancellation.
+    EXPECT_GE(count.load(), 10);
+    EXPECT_LE(count.load(), 11);
+}
+
+}  // namespace
+}  // namespace Dive
@@ -0,0 +1,52 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace Dive::gfxr
+{
+
+// The part of a .gfxr file to look for dumpables in. Both ranges are inclusive and a DumpEntry is
+// only found if all of its calls are in both ranges. By default, the whole file is searched.
+//
+// Processing stops as soon as the end of either range is reached, so a small range at the start of
+// a large capture is fast. Blocks before the start of the ranges still have to be decoded.
+struct DumpRange
+{
+    // Frame numbers start at 0, like FileProcessor::GetCurrentFrameNumber().
+    uint64_t first_frame = 0;
+    uint64_t last_frame = std::numeric_limits<uint64_t>::max();
+    // Block indices, as written to the JSON file.
+    uint64_t first_block = 0;
+    uint64_t last_block = std::numeric_limits<uint64_t>::max();
+
+    bool Contains(uint64_t frame, uint64_t block_index) const
+    {
+        return frame >= first_frame && frame <= last_frame && block_index >= first_block &&
+               block_index <= last_block;
+    }
+
+    // Whether nothing after `frame` and `block_index` can be in the range.
+    bool IsPast(uint64_t frame, uint64_t block_index) const
+    {
+        return frame > last_frame || block_index > last_block;
+    }
+};
+
+}  // namespace Dive::gfxr
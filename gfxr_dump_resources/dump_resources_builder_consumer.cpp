@@ -23,11 +23,16 @@ namespace Dive::gfxr
 {
 
 DumpResourcesBuilderConsumer::DumpResourcesBuilderConsumer(
-    std::function<void(DumpEntry)> dump_found_callback)
-    : dump_found_callback_(std::move(dump_found_callback))
+    std::function<void(DumpEntry)> dump_found_callback, const DumpRange& range)
+    : dump_found_callback_(std::move(dump_found_callback)), range_(range)
 {
 }
 
+bool DumpResourcesBuilderConsumer::IsComplete(uint64_t block_index)
+{
+    return range_.IsPast(frame_number_, block_index);
+}
+
 void DumpResourcesBuilderConsumer::Process_vkBeginCommandBuffer(
     const gfxrecon::decode::ApiCallInfo& call_info, VkResult returnValue,
     gfxrecon::format::HandleId commandBuffer,
@@ -35,23 +40,29 @@ void DumpResourcesBuilderConsumer::Process_vkBeginCommandBuffer(
         pBeginInfo)
 {
     GFXRECON_LOG_DEBUG("Process_vkBeginCommandBuffer: commandBuffer=%lu", commandBuffer);
+    if (!range_.Contains(frame_number_, call_info.index))
+    {
+        // A dump can't start here, but a previous recording of the command buffer is over.
+        incomplete_dumps_.erase(commandBuffer);
+        return;
+    }
+
+    // The state machine is released by InvokeIfFound() once it's done; it must not be destroyed
+    // from its own callbacks.
     auto [it, inserted] = incomplete_dumps_.insert_or_assign(
-        commandBuffer, std::make_unique<StateMachine>(
-                           commandBuffer,
-                           [this, commandBuffer](DumpEntry dump_entry) {
-                               dump_found_callback_(std::move(dump_entry));
-                               incomplete_dumps_.erase(commandBuffer);
-                           },
-                           [this, commandBuffer] { incomplete_dumps_.erase(commandBuffer); }));
+        commandBuffer,
+        std::make_unique<StateMachine>(
+            commandBuffer,
+            [this](DumpEntry dump_entry) { dump_found_callback_(std::move(dump_entry)); }, [] {}));
     if (!inserted)
     {
         GFXRECON_LOG_DEBUG("Command buffer %lu never submitted! Discarding previous state...",
                            commandBuffer);
     }
 
-    StateMachine& state_machine = *it->second;
-    state_machine.state().Process_vkBeginCommandBuffer(call_info, returnValue, commandBuffer,
-                                                       pBeginInfo);
+    InvokeIfFound(commandBuffer, [&](gfxrecon::decode::VulkanConsumer& consumer) {
+        consumer.Process_vkBeginCommandBuffer(call_info, returnValue, commandBuffer, pBeginInfo);
+    });
 }
 
 void DumpResourcesBuilderConsumer::Process_vkCmdBeginRenderPass(
@@ -124,6 +135,23 @@ void DumpResourcesBuilderConsumer::Process_vkCmdEndRenderPass2KHR(
     });
 }
 
+void DumpResourcesBuilderConsumer::Process_vkFreeCommandBuffers(
+    const gfxrecon::decode::ApiCallInfo& call_info, gfxrecon::format::HandleId device,
+    gfxrecon::format::HandleId commandPool, uint32_t commandBufferCount,
+    gfxrecon::decode::HandlePointerDecoder<VkCommandBuffer>* pCommandBuffers)
+{
+    GFXRECON_LOG_DEBUG("Process_vkFreeCommandBuffers");
+    const gfxrecon::format::HandleId* command_buffer_ids = pCommandBuffers->GetPointer();
+    if (command_buffer_ids == nullptr)
+    {
+        return;
+    }
+    for (uint32_t i = 0; i < commandBufferCount; i++)
+    {
+        incomplete_dumps_.erase(command_buffer_ids[i]);
+    }
+}
+
 void DumpResourcesBuilderConsumer::Process_vkQueueSubmit(
     const gfxrecon::decode::ApiCallInfo& call_info, VkResult returnValue,
     gfxrecon::format::HandleId queue, uint32_t submitCount,
@@ -163,6 +191,10 @@ void DumpResourcesBuilderConsumer::InvokeIfFound(
 
     StateMachine& state_machine = *it->second;
     function(state_machine.state());
+    if (state_machine.done())
+    {
+        incomplete_dumps_.erase(it);
+    }
 }
 
 }  // namespace Dive::gfxr
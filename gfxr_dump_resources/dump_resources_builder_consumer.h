@@ -21,6 +21,7 @@
 #include <unordered_map>
 
 #include "dump_entry.h"
+#include "dump_range.h"
 #include "state_machine.h"
 #include "third_party/gfxreconstruct/framework/decode/api_decoder.h"
 #include "third_party/gfxreconstruct/framework/decode/struct_pointer_decoder.h"
@@ -38,8 +39,13 @@ class DumpResourcesBuilderConsumer : public gfxrecon::decode::VulkanConsumer
 {
  public:
     // `dump_found_callback` is run when a complete DumpEntry is found which is suitable for being
-    // used with `--dump-resources`.
-    DumpResourcesBuilderConsumer(std::function<void(DumpEntry)> dump_found_callback);
+    // used with `--dump-resources`. Only calls within `range` are considered.
+    DumpResourcesBuilderConsumer(std::function<void(DumpEntry)> dump_found_callback,
+                                 const DumpRange& range = {});
+
+    // Reports the consumer as complete once the end of the range has been reached, which stops
+    // FileProcessor.
+    bool IsComplete(uint64_t block_index) override;
 
     // Start tracking the command buffer. If the command buffer already has state (likely
     // QueueSubmit was not called), then the command buffer state is reset.
@@ -80,6 +86,12 @@ class DumpResourcesBuilderConsumer : public gfxrecon::decode::VulkanConsumer
         gfxrecon::decode::StructPointerDecoder<gfxrecon::decode::Decoded_VkSubpassEndInfo>*
             pSubpassEndInfo) override;
 
+    // Stop tracking the freed command buffers, since they can't be submitted anymore.
+    void Process_vkFreeCommandBuffers(
+        const gfxrecon::decode::ApiCallInfo& call_info, gfxrecon::format::HandleId device,
+        gfxrecon::format::HandleId commandPool, uint32_t commandBufferCount,
+        gfxrecon::decode::HandlePointerDecoder<VkCommandBuffer>* pCommandBuffers) override;
+
     void Process_vkQueueSubmit(
         const gfxrecon::decode::ApiCallInfo& call_info, VkResult returnValue,
         gfxrecon::format::HandleId queue, uint32_t submitCount,
@@ -92,15 +104,18 @@ class DumpResourcesBuilderConsumer : public gfxrecon::decode::VulkanConsumer
     // called.
     //
     // The argument to `function` is the current state of the state machine used for processing
-    // `command_buffer`.
+    // `command_buffer`. The state machine is released as soon as it's done.
     void InvokeIfFound(gfxrecon::format::HandleId command_buffer,
                        const std::function<void(gfxrecon::decode::VulkanConsumer&)>& function);
 
     // Function run when a complete dump entry has been formed. This is ready to be written to disk,
     // etc.
     std::function<void(DumpEntry)> dump_found_callback_;
+    // Part of the file to look for dumps in.
+    DumpRange range_;
     // Incomplete dumps for each command buffer. Each command buffer is tracked independently in
-    // case commands are interleaved. std::unique_ptr is used for pointer stability.
+    // case commands are interleaved. std::unique_ptr is used for pointer stability. Only command
+    // buffers that are being recorded or waiting to be submitted have an entry.
     std::unordered_map<gfxrecon::format::HandleId, std::unique_ptr<StateMachine>> incomplete_dumps_;
 };
 
@@ -16,142 +16,288 @@
 
 #include "gfxr_dump_resources.h"
 
-#include <fstream>
+#include <charconv>
+#include <cstdio>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "dump_entry.h"
 #include "dump_resources_builder_consumer.h"
-#include "third_party/gfxreconstruct/framework/decode/file_processor.h"
+#include "gfxr_ext/decode/dive_prefetch_file_processor.h"
 #include "third_party/gfxreconstruct/framework/generated/generated_vulkan_decoder.h"
 
 namespace Dive::gfxr
 {
 
+namespace
+{
+
+// Pending text is written once an array has this much.
+constexpr size_t kJsonFlushSize = 64 * 1024;
+
+void AppendNumber(std::string& text, uint64_t value)
+{
+    char digits[std::numeric_limits<uint64_t>::digits10 + 1];
+    auto [end, error] = std::to_chars(std::begin(digits), std::end(digits), value);
+    text.append(digits, end);
+}
+
+}  // namespace
+
 std::optional<std::vector<DumpEntry>> FindDumpableResources(const char* filename)
 {
-    gfxrecon::decode::FileProcessor file_processor;
-    if (!file_processor.Initialize(filename))
+    std::vector<DumpEntry> complete_dump_entries;
+    if (!FindDumpableResources(filename, DumpRange{},
+                               [&complete_dump_entries](DumpEntry dump_entry) {
+                                   complete_dump_entries.push_back(std::move(dump_entry));
+                               }))
     {
-        std::cerr << "Failed to open input:" << filename << '\n';
         return std::nullopt;
     }
+    return complete_dump_entries;
+}
 
-    std::vector<DumpEntry> complete_dump_entries;
+bool FindDumpableResources(const char* filename, const DumpRange& range,
+                           const std::function<void(DumpEntry)>& dump_found_callback)
+{
+    gfxrecon::decode::DivePrefetchFileProcessor file_processor;
+    if (!file_processor.Initialize(filename))
+    {
+        std::cerr << "Failed to open input:" << filename << '\n';
+        return false;
+    }
 
     gfxrecon::decode::VulkanDecoder vulkan_decoder;
-    DumpResourcesBuilderConsumer consumer([&complete_dump_entries](DumpEntry dump_entry) {
-        complete_dump_entries.push_back(std::move(dump_entry));
-    });
+    DumpResourcesBuilderConsumer consumer(dump_found_callback, range);
     vulkan_decoder.AddConsumer(&consumer);
     file_processor.AddDecoder(&vulkan_decoder);
+    // Decompress blocks on worker threads while this thread decodes.
+    file_processor.EnableBlockPrefetch();
 
+    // Stops early once the consumer reports the end of the range.
     file_processor.ProcessAllFrames();
 
-    return complete_dump_entries;
+    return true;
 }
 
 bool SaveAsJsonFile(const std::vector<DumpEntry>& dumpables, const char* filename)
 {
-    std::ofstream out(filename);
-    if (!out.good() || !out.is_open())
+    DumpEntryJsonWriter writer;
+    if (!writer.Open(filename))
+    {
+        return false;
+    }
+    for (const DumpEntry& dumpable : dumpables)
+    {
+        if (!writer.Append(dumpable))
+        {
+            return false;
+        }
+    }
+    return writer.Close();
+}
+
+DumpEntryJsonWriter::~DumpEntryJsonWriter() { RemoveTemporaryFiles(); }
+
+bool DumpEntryJsonWriter::Open(const char* filename)
+{
+    filename_ = filename;
+    dumpable_count_ = 0;
+
+    PendingArray& output = arrays_[kBeginCommandBuffer];
+    output.path = filename;
+    output.file = std::fopen(filename, "w");
+    if (output.file == nullptr)
     {
         std::cerr << "Failed to open output:" << filename << '\n';
         return false;
     }
 
-    out << "{\n";
+    static constexpr const char* kTemporarySuffixes[kArrayCount] = {nullptr, ".render_pass.tmp",
+                                                                    ".draw.tmp",
+                                                                    ".queue_submit.tmp"};
+    for (int array = kRenderPass; array < kArrayCount; ++array)
+    {
+        PendingArray& pending = arrays_[array];
+        pending.path = filename_ + kTemporarySuffixes[array];
+        pending.file = std::fopen(pending.path.c_str(), "w+b");
+        if (pending.file == nullptr)
+        {
+            std::cerr << "Failed to open temporary file:" << pending.path << '\n';
+            return false;
+        }
+    }
+
+    output.text += "{\n";
 
     // The DumpResourcesOptions object configures dump resource behavior. See
     // //third_party/gfxreconstruct/vulkan_dump_resources.md for all options.
-    out << "  \"DumpResourcesOptions\": {\n";
+    output.text += "  \"DumpResourcesOptions\": {\n";
     // XR apps using multiview have 1 VkImage with 2 layers to stores the left/right eyes. By
     // default, only the left eye is dumped since it's the first image layer is dumped. To get both
     // left and right eyes we need to dump all layers; DumpAllImageSubresources instructs GFXR to do
     // so.
-    out << "    \"DumpAllImageSubresources\": true\n";
-    out << "  },\n";
+    output.text += "    \"DumpAllImageSubresources\": true\n";
+    output.text += "  },\n";
+
+    output.text += "  \"BeginCommandBuffer\": [";
+    return true;
+}
+
+bool DumpEntryJsonWriter::Append(const DumpEntry& dumpable)
+{
+    if (dumpable_count_ != 0)
+    {
+        for (PendingArray& pending : arrays_)
+        {
+            pending.text += ',';
+        }
+    }
+    ++dumpable_count_;
 
-    out << "  \"BeginCommandBuffer\": [";
-    for (size_t i = 0; i < dumpables.size(); ++i)
+    AppendNumber(arrays_[kBeginCommandBuffer].text, dumpable.begin_command_buffer_block_index);
+
+    std::string& render_passes = arrays_[kRenderPass].text;
+    render_passes += '[';
+    for (size_t i = 0; i < dumpable.render_passes.size(); ++i)
     {
-        const DumpEntry& entry = dumpables[i];
+        const DumpRenderPass& render_pass = dumpable.render_passes[i];
         if (i != 0)
         {
-            out << ',';
+            render_passes += ',';
         }
-        out << entry.begin_command_buffer_block_index;
+        render_passes += '[';
+        AppendNumber(render_passes, render_pass.begin_block_index);
+        render_passes += ',';
+        AppendNumber(render_passes, render_pass.end_block_index);
+        render_passes += ']';
     }
-    out << "],\n";
+    render_passes += ']';
 
-    out << "  \"RenderPass\": [";
-    for (size_t i = 0; i < dumpables.size(); ++i)
+    std::string& draws = arrays_[kDraw].text;
+    draws += '[';
+    for (size_t i = 0; i < dumpable.draws.size(); ++i)
     {
-        const DumpEntry& entry = dumpables[i];
         if (i != 0)
         {
-            out << ',';
+            draws += ',';
         }
-        out << '[';
-        for (size_t ii = 0; ii < entry.render_passes.size(); ++ii)
+        AppendNumber(draws, dumpable.draws[i]);
+    }
+    draws += ']';
+
+    AppendNumber(arrays_[kQueueSubmit].text, dumpable.queue_submit_block_index);
+
+    for (int array = 0; array < kArrayCount; ++array)
+    {
+        if (!Flush(static_cast<Array>(array), /*force=*/false))
         {
-            const DumpRenderPass& render_pass = entry.render_passes[ii];
-            if (ii != 0)
-            {
-                out << ',';
-            }
-            out << "[" << render_pass.begin_block_index << ',' << render_pass.end_block_index
-                << ']';
+            return false;
         }
-        out << ']';
     }
-    out << "],\n";
+    return true;
+}
+
+bool DumpEntryJsonWriter::Close()
+{
+    static constexpr const char* kArrayNames[kArrayCount] = {"BeginCommandBuffer", "RenderPass",
+                                                             "Draw", "QueueSubmit"};
+    PendingArray& output = arrays_[kBeginCommandBuffer];
+    if (output.file == nullptr)
+    {
+        return false;
+    }
 
-    out << "  \"Draw\": [";
-    for (size_t i = 0; i < dumpables.size(); ++i)
+    std::vector<char> buffer(kJsonFlushSize);
+    for (int array = kRenderPass; array < kArrayCount; ++array)
     {
-        const DumpEntry& entry = dumpables[i];
-        if (i != 0)
+        PendingArray& pending = arrays_[array];
+        if (!Flush(static_cast<Array>(array), /*force=*/true) || std::fflush(pending.file) != 0)
         {
-            out << ',';
+            std::cerr << "Failed to write temporary file: " << pending.path << '\n';
+            return false;
         }
-        out << '[';
-        for (size_t ii = 0; ii < entry.draws.size(); ++ii)
+        std::rewind(pending.file);
+
+        output.text += "],\n  \"";
+        output.text += kArrayNames[array];
+        output.text += "\": [";
+        if (!Flush(kBeginCommandBuffer, /*force=*/true))
+        {
+            return false;
+        }
+
+        size_t size = 0;
+        while ((size = std::fread(buffer.data(), 1, buffer.size(), pending.file)) != 0)
         {
-            uint64_t draw = entry.draws[ii];
-            if (ii != 0)
+            if (std::fwrite(buffer.data(), 1, size, output.file) != size)
             {
-                out << ',';
+                std::cerr << "Failed to write output file: " << filename_ << '\n';
+                return false;
             }
-            out << draw;
         }
-        out << ']';
-    }
-    out << "],\n";
-
-    out << "  \"QueueSubmit\": [";
-    for (size_t i = 0; i < dumpables.size(); ++i)
-    {
-        const DumpEntry& entry = dumpables[i];
-        if (i != 0)
+        if (std::ferror(pending.file))
         {
-            out << ',';
+            std::cerr << "Failed to read temporary file: " << pending.path << '\n';
+            return false;
         }
-        out << entry.queue_submit_block_index;
     }
-    out << "]\n";
 
-    out << "}\n";
+    output.text += "]\n";
+    output.text += "}\n";
+    bool success = Flush(kBeginCommandBuffer, /*force=*/true);
+    if (std::fclose(output.file) != 0)
+    {
+        success = false;
+    }
+    output.file = nullptr;
+    if (!success)
+    {
+        std::cerr << "Failed to close output file: " << filename_ << '\n';
+    }
+    RemoveTemporaryFiles();
+    return success;
+}
 
-    out.close();
-    if (!out.good())
+bool DumpEntryJsonWriter::Flush(Array array, bool force)
+{
+    PendingArray& pending = arrays_[array];
+    if (pending.text.empty() || (!force && pending.text.size() < kJsonFlushSize))
+    {
+        return true;
+    }
+    if (std::fwrite(pending.text.data(), 1, pending.text.size(), pending.file) !=
+        pending.text.size())
     {
-        std::cerr << "Failed to close output file: " << filename << '\n';
+        std::cerr << "Failed to write: " << pending.path << '\n';
         return false;
     }
-
+    pending.text.clear();
     return true;
 }
 
+void DumpEntryJsonWriter::RemoveTemporaryFiles()
+{
+    for (int array = 0; array < kArrayCount; ++array)
+    {
+        PendingArray& pending = arrays_[array];
+        if (pending.file != nullptr)
+        {
+            std::fclose(pending.file);
+            pending.file = nullptr;
+        }
+        if (array != kBeginCommandBuffer && !pending.path.empty())
+        {
+            std::remove(pending.path.c_str());
+        }
+        pending.path.clear();
+        pending.text.clear();
+    }
+}
+
 }  // namespace Dive::gfxr
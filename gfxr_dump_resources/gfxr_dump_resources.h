@@ -16,10 +16,15 @@
 
 #pragma once
 
+#include <array>
+#include <cstdio>
+#include <functional>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "dump_entry.h"
+#include "dump_range.h"
 
 namespace Dive::gfxr
 {
@@ -29,9 +34,72 @@ namespace Dive::gfxr
 // Returns std::nullopt on error.
 std::optional<std::vector<DumpEntry>> FindDumpableResources(const char* filename);
 
+// Streaming version of FindDumpableResources(). Each DumpEntry found in `range` is passed to
+// `dump_found_callback` as soon as it's complete, in the order of the vkQueueSubmit calls, instead
+// of being collected. Only the command buffers being recorded are kept in memory.
+//
+// Returns false on error.
+bool FindDumpableResources(const char* filename, const DumpRange& range,
+                           const std::function<void(DumpEntry)>& dump_found_callback);
+
 // Serialize a list of complete dumpable to a JSON file.
 //
 // Returns false on error.
 bool SaveAsJsonFile(const std::vector<DumpEntry>& dumpables, const char* filename);
 
-}  // namespace Dive::gfxr
\ No newline at end of file
+// Writes complete dumpables to a JSON file one at a time, producing the same file as
+// SaveAsJsonFile().
+//
+// The file stores each field of the dumpables in its own array, so all but the first array are
+// spilled to temporary files next to the output and copied to it by Close(). Memory use doesn't
+// depend on the number of dumpables.
+class DumpEntryJsonWriter
+{
+ public:
+    DumpEntryJsonWriter() = default;
+    // Removes the temporary files. The output is incomplete unless Close() succeeded.
+    ~DumpEntryJsonWriter();
+
+    DumpEntryJsonWriter(const DumpEntryJsonWriter&) = delete;
+    DumpEntryJsonWriter& operator=(const DumpEntryJsonWriter&) = delete;
+
+    // Returns false on error.
+    bool Open(const char* filename);
+
+    // Returns false on error.
+    bool Append(const DumpEntry& dumpable);
+
+    // Writes the remaining arrays. Returns false on error.
+    bool Close();
+
+ private:
+    // The arrays of the JSON file, in order.
+    enum Array
+    {
+        kBeginCommandBuffer,
+        kRenderPass,
+        kDraw,
+        kQueueSubmit,
+        kArrayCount,
+    };
+
+    // Text waiting to be written to an array's file.
+    struct PendingArray
+    {
+        std::string path;
+        FILE* file = nullptr;
+        std::string text;
+    };
+
+    // Writes the pending text of `array` if there is enough of it, or all of it if `force`.
+    bool Flush(Array array, bool force);
+
+    // Closes and removes the temporary files.
+    void RemoveTemporaryFiles();
+
+    std::string filename_;
+    std::array<PendingArray, kArrayCount> arrays_;
+    size_t dumpable_count_ = 0;
+};
+
+}  // namespace Dive::gfxr
@@ -14,27 +14,40 @@
  limitations under the License.
 */
 
+#include <cstdint>
 #include <iostream>
-#include <optional>
+#include <limits>
 #include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
 #include "absl/flags/usage.h"
 #include "dump_entry.h"
+#include "dump_range.h"
 #include "gfxr_dump_resources.h"
 #include "third_party/gfxreconstruct/framework/util/logging.h"
 
 ABSL_FLAG(bool, last_draw_only, false,
           "If specified, only dump the final draw call for a render pass. This should speed up "
           "dumping while still providing a useful result.");
+ABSL_FLAG(uint64_t, first_frame, 0,
+          "Only look for dumpables recorded in this frame or later. Frames are numbered from 0.");
+ABSL_FLAG(uint64_t, last_frame, std::numeric_limits<uint64_t>::max(),
+          "Only look for dumpables submitted in this frame or earlier. Processing stops after this "
+          "frame.");
+ABSL_FLAG(uint64_t, first_block, 0,
+          "Only look for dumpables whose vkBeginCommandBuffer block index is at least this.");
+ABSL_FLAG(uint64_t, last_block, std::numeric_limits<uint64_t>::max(),
+          "Only look for dumpables whose vkQueueSubmit block index is at most this. Processing "
+          "stops after this block.");
 
 namespace
 {
 
 using Dive::gfxr::DumpEntry;
+using Dive::gfxr::DumpEntryJsonWriter;
+using Dive::gfxr::DumpRange;
 using Dive::gfxr::FindDumpableResources;
-using Dive::gfxr::SaveAsJsonFile;
 using gfxrecon::util::Log;
 
 }  // namespace
@@ -58,30 +71,45 @@ int main(int argc, char** argv)
     Log::Init(Log::kDebugSeverity);
 #endif
 
-    std::optional<std::vector<DumpEntry>> dumpables = FindDumpableResources(input_filename);
-    if (!dumpables.has_value())
+    DumpRange range;
+    range.first_frame = absl::GetFlag(FLAGS_first_frame);
+    range.last_frame = absl::GetFlag(FLAGS_last_frame);
+    range.first_block = absl::GetFlag(FLAGS_first_block);
+    range.last_block = absl::GetFlag(FLAGS_last_block);
+    const bool last_draw_only = absl::GetFlag(FLAGS_last_draw_only);
+
+    // Write each dumpable as soon as it's found so that large captures don't have to be held in
+    // memory.
+    DumpEntryJsonWriter writer;
+    if (!writer.Open(output_filename))
     {
-        std::cerr << "Failed to find resources in " << input_filename << '\n';
+        std::cerr << "Failed to serialize to " << output_filename << '\n';
         return 1;
     }
 
-    if (absl::GetFlag(FLAGS_last_draw_only))
-    {
-        // Only keep the final draw call. This should represent the image presented to the user.
-        // For validation purposes, this is typically fine and saves a lot of time (since each draw
-        // call can take 2-3 seconds to dump).
-        for (DumpEntry& dumpable : *dumpables)
-        {
-            std::vector<uint64_t>& draws = dumpable.draws;
-            if (draws.size() == 1)
+    bool write_failed = false;
+    bool found = FindDumpableResources(
+        input_filename, range, [&writer, &write_failed, last_draw_only](DumpEntry dumpable) {
+            if (last_draw_only)
             {
-                continue;
+                // Only keep the final draw call. This should represent the image presented to the
+                // user. For validation purposes, this is typically fine and saves a lot of time
+                // (since each draw call can take 2-3 seconds to dump).
+                std::vector<uint64_t>& draws = dumpable.draws;
+                if (draws.size() > 1)
+                {
+                    draws.erase(draws.begin(), draws.end() - 1);
+                }
             }
-            draws.erase(draws.begin(), draws.end() - 1);
-        }
+            write_failed = write_failed || !writer.Append(dumpable);
+        });
+    if (!found)
+    {
+        std::cerr << "Failed to find resources in " << input_filename << '\n';
+        return 1;
     }
 
-    if (!SaveAsJsonFile(*dumpables, output_filename))
+    if (write_failed || !writer.Close())
     {
         std::cerr << "Failed to serialize to " << output_filename << '\n';
         return 1;
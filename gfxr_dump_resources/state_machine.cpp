@@ -43,6 +43,7 @@ const gfxrecon::format::HandleId& StateMachine::command_buffer() { return comman
 
 void StateMachine::Done()
 {
+    done_ = true;
     if (dump_entry_.IsComplete())
     {
         GFXRECON_LOG_DEBUG("Accept! ID=%lu", command_buffer_);
@@ -74,6 +74,9 @@ class StateMachine
     // Get the current state machine state.
     gfxrecon::decode::VulkanConsumer& state();
 
+    // Whether `accept` or `reject` has been run. The state machine no longer needs to be fed calls.
+    bool done() const { return done_; }
+
  private:
     // States are friends to avoid certain methods being public unnecessarily.
     friend class LookingForDraw;
@@ -106,6 +109,9 @@ class StateMachine
 
     // Current state of the state machine
     gfxrecon::decode::VulkanConsumer* state_ = nullptr;
+
+    // Set by Done().
+    bool done_ = false;
 };
 
 }  // namespace Dive::gfxr
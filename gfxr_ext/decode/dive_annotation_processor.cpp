@@ -18,6 +18,7 @@
 
 #include <cstdint>
 #include <ostream>
+#include <utility>
 
 #include "decode/api_decoder.h"
 #include "util/logging.h"
@@ -52,7 +53,7 @@ void DiveAnnotationProcessor::WriteBlockEnd(const gfxrecon::util::DiveFunctionDa
     }
     else
     {
-        VulkanCommandInfo vkCmd(function_data);
+        VulkanCommandInfo vkCmd(function_data, args);
         if (args.count("commandBuffer") != 0)
         {
             uint64_t cmd_handle = args["commandBuffer"];
@@ -67,9 +68,10 @@ void DiveAnnotationProcessor::WriteBlockEnd(const gfxrecon::util::DiveFunctionDa
                 m_draw_call_counts_map[cmd_handle].render_pass_draw_call_counts.push_back(0);
             }
 
-            m_cmd_vk_commands_cache[cmd_handle].push_back(vkCmd);
+            bool is_draw = vkCmd.name.find("vkCmdDraw") != std::string::npos;
+            m_cmd_vk_commands_cache[cmd_handle].push_back(std::move(vkCmd));
 
-            if (vkCmd.name.find("vkCmdDraw") != std::string::npos)
+            if (is_draw)
             {
                 m_draw_call_counts_map[cmd_handle].begin_command_buffer_draw_call_count++;
                 if (!m_draw_call_counts_map[cmd_handle].render_pass_draw_call_counts.empty())
@@ -80,7 +82,7 @@ void DiveAnnotationProcessor::WriteBlockEnd(const gfxrecon::util::DiveFunctionDa
         }
         else
         {
-            m_none_cmd_vk_commands_per_submit_cache.push_back(vkCmd);
+            m_none_cmd_vk_commands_per_submit_cache.push_back(std::move(vkCmd));
         }
     }
 }
@@ -16,8 +16,10 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <utility>
 
 #include "decode/annotation_handler.h"
+#include "dive_vulkan_command_args.h"
 #include "util/defines.h"
 #include "util/platform.h"
 
@@ -32,11 +34,24 @@ class DiveAnnotationProcessor : public gfxrecon::decode::AnnotationHandler
     struct VulkanCommandInfo
     {
         explicit VulkanCommandInfo(const gfxrecon::util::DiveFunctionData& data)
-            : args(data.GetArgs()), name(data.GetFunctionName()), index(data.GetCmdBufferIndex())
+            : VulkanCommandInfo(data, data.GetArgs())
         {
         }
 
-        nlohmann::ordered_json args;
+        // Avoids another copy of the JSON arguments, since DiveFunctionData::GetArgs() returns
+        // them by value.
+        VulkanCommandInfo(const gfxrecon::util::DiveFunctionData& data,
+                          const nlohmann::ordered_json& json_args)
+            : args(json_args), name(data.GetFunctionName()), index(data.GetCmdBufferIndex())
+        {
+        }
+
+        VulkanCommandInfo(std::string cmd_name, uint32_t cmd_index, VulkanCommandArgs cmd_args)
+            : args(std::move(cmd_args)), name(std::move(cmd_name)), index(cmd_index)
+        {
+        }
+
+        VulkanCommandArgs args;
         std::string name = "";
         uint32_t index = 0;
     };
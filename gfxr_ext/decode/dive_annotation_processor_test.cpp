@@ -31,7 +31,7 @@ MATCHER_P3(VulkanCommandInfoEqual, expected_name, expected_index, expected_args,
 {
     EXPECT_EQ(arg.name, expected_name);
     EXPECT_EQ(arg.index, expected_index);
-    EXPECT_EQ(arg.args, expected_args);
+    EXPECT_EQ(arg.args.ToJson(), expected_args);
     return true;
 }
 
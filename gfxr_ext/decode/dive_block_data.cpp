@@ -17,15 +17,153 @@ limitations under the License.
 #include "dive_block_data.h"
 
 #include <algorithm>
+#include <cerrno>
 #include <cinttypes>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <iterator>
 #include <memory>
+#include <utility>
 
 #include "util/logging.h"
+#include "util/platform.h"
+#include "util/threadpool.h"
+
+// copy_file_range() is in glibc since 2.27 and in bionic since API level 34
+#if defined(__linux__) && (!defined(__ANDROID__) || __ANDROID_API__ >= 34)
+#include <unistd.h>
+#define DIVE_HAS_COPY_FILE_RANGE 1
+#else
+#define DIVE_HAS_COPY_FILE_RANGE 0
+#endif
 
 GFXRECON_BEGIN_NAMESPACE(gfxrecon)
 GFXRECON_BEGIN_NAMESPACE(decode)
 
+namespace
+{
+
+// Size of the parts of the original file read by DiveBlockData::WriteGFXRFiles()
+constexpr size_t kDiveBatchReadSize = 8 * 1024 * 1024;
+
+// A part of a new GFXR file: a range of the original file or a modification buffer
+struct DiveFileRange
+{
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    // Only set for modifications
+    const std::vector<char>* blob_ptr = nullptr;
+};
+
+// A visitor that lists the parts of a new GFXR file, merging adjacent original blocks into ranges
+class RangeListBlockVisitor : public BlockVisitor
+{
+ public:
+    bool Visit(const DiveOriginalBlock& block) override
+    {
+        if (block.size_ == 0)
+        {
+            return true;
+        }
+        if (!ranges_.empty() && ranges_.back().blob_ptr == nullptr &&
+            ranges_.back().offset + ranges_.back().size == block.offset_)
+        {
+            ranges_.back().size += block.size_;
+            return true;
+        }
+        ranges_.push_back({block.offset_, block.size_, nullptr});
+        return true;
+    }
+    bool Visit(const DiveModificationBlock& block) override
+    {
+        if (block.blob_ptr_->empty())
+        {
+            GFXRECON_LOG_ERROR("RangeListBlockVisitor encountered empty modification block");
+            return false;
+        }
+        ranges_.push_back({0, block.blob_ptr_->size(), block.blob_ptr_});
+        return true;
+    }
+
+    std::vector<DiveFileRange> TakeRanges() { return std::move(ranges_); }
+
+ private:
+    std::vector<DiveFileRange> ranges_;
+};
+
+// One of the files written by DiveBlockData::WriteGFXRFiles(), with how far it has been written
+struct DiveBatchOutput
+{
+    ~DiveBatchOutput()
+    {
+        if (file != nullptr)
+        {
+            util::platform::FileClose(file);
+        }
+    }
+
+    std::string path;
+    FILE* file = nullptr;
+    std::vector<DiveFileRange> ranges;
+    size_t next_range = 0;
+    // Bytes of ranges[next_range] already written
+    uint64_t next_range_written = 0;
+};
+
+// Writes the parts of output up to the end of data, which holds the original file from
+// data_offset. The ranges of the original file must come in file order. An empty data writes the
+// remaining modifications at the end of the file.
+bool WriteBatchOutput(DiveBatchOutput& output, const char* data, uint64_t data_offset,
+                      size_t data_size)
+{
+    uint64_t data_end = data_offset + data_size;
+    while (output.next_range < output.ranges.size())
+    {
+        const DiveFileRange& range = output.ranges[output.next_range];
+        if (range.blob_ptr != nullptr)
+        {
+            if (!util::platform::FileWrite(range.blob_ptr->data(), range.blob_ptr->size(),
+                                           output.file))
+            {
+                GFXRECON_LOG_ERROR("Writing modified block, could not write to %s",
+                                   output.path.c_str());
+                return false;
+            }
+            output.next_range++;
+            continue;
+        }
+
+        uint64_t start = range.offset + output.next_range_written;
+        if (start >= data_end)
+        {
+            // In a later part of the original file
+            return true;
+        }
+        if (start < data_offset)
+        {
+            GFXRECON_LOG_ERROR("Original blocks of %s are not in file order", output.path.c_str());
+            return false;
+        }
+        uint64_t end = std::min(range.offset + range.size, data_end);
+        if (!util::platform::FileWrite(data + (start - data_offset), end - start, output.file))
+        {
+            GFXRECON_LOG_ERROR("Could not write %" PRIu64 " bytes to %s", end - start,
+                               output.path.c_str());
+            return false;
+        }
+        output.next_range_written += end - start;
+        if (output.next_range_written == range.size)
+        {
+            output.next_range++;
+            output.next_range_written = 0;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
 bool TestBlockVisitor::Visit(const DiveOriginalBlock& block)
 {
     std::string descrip = "original, offset:" + std::to_string(block.offset_) +
@@ -55,24 +193,17 @@ bool WriterBlockVisitor::Visit(const DiveOriginalBlock& block)
         // Found empty block in original file, presumably a block in the asset file, no need to copy
         return true;
     }
-    if (!util::platform::FileSeek(original_file_ptr_, block.offset_, util::platform::FileSeekSet))
+    if (pending_size_ > 0 && pending_offset_ + pending_size_ == block.offset_)
     {
-        GFXRECON_LOG_ERROR("Could not seek block at offset %d in original file", block.offset_);
-        return false;
+        pending_size_ += block.size_;
+        return true;
     }
-    uint64_t bytes_left_to_copy = block.size_;
-    while (bytes_left_to_copy > 0)
+    if (!Flush())
     {
-        uint64_t bytes_to_copy = bytes_left_to_copy;
-        if (bytes_left_to_copy > kDiveBlockBufferSize)
-        {
-            bytes_to_copy = kDiveBlockBufferSize;
-        }
-        bytes_left_to_copy -= bytes_to_copy;
-
-        util::platform::FileRead(copy_buffer_, bytes_to_copy, original_file_ptr_);
-        util::platform::FileWrite(copy_buffer_, bytes_to_copy, new_file_ptr_);
+        return false;
     }
+    pending_offset_ = block.offset_;
+    pending_size_ = block.size_;
     return true;
 }
 
@@ -83,6 +214,11 @@ bool WriterBlockVisitor::Visit(const DiveModificationBlock& block)
         GFXRECON_LOG_ERROR("WriterBlockVisitor encountered empty modification block");
         return false;
     }
+    // Keep the blocks in order
+    if (!Flush())
+    {
+        return false;
+    }
     if (!util::platform::FileWrite(block.blob_ptr_->data(), block.blob_ptr_->size(), new_file_ptr_))
     {
         GFXRECON_LOG_ERROR("Writing modified block, could not write to new file");
@@ -91,6 +227,108 @@ bool WriterBlockVisitor::Visit(const DiveModificationBlock& block)
     return true;
 }
 
+bool WriterBlockVisitor::Flush()
+{
+    if (pending_size_ == 0)
+    {
+        return true;
+    }
+    uint64_t offset = pending_offset_;
+    uint64_t size = pending_size_;
+    pending_size_ = 0;
+
+    uint64_t copied = CopyRangeInKernel(offset, size);
+    if (copied == size)
+    {
+        return true;
+    }
+    return CopyRangeBuffered(offset + copied, size - copied);
+}
+
+uint64_t WriterBlockVisitor::CopyRangeInKernel(uint64_t offset, uint64_t size)
+{
+#if DIVE_HAS_COPY_FILE_RANGE
+    // The new file is written through both stdio and its descriptor, so drain the stdio buffer
+    // first and seek past the copied range after
+    if (util::platform::FileFlush(new_file_ptr_) != 0)
+    {
+        return 0;
+    }
+    int64_t new_file_offset = util::platform::FileTell(new_file_ptr_);
+    if (new_file_offset < 0)
+    {
+        return 0;
+    }
+    int original_fd = fileno(original_file_ptr_);
+    int new_fd = fileno(new_file_ptr_);
+    loff_t in_offset = static_cast<loff_t>(offset);
+    loff_t out_offset = static_cast<loff_t>(new_file_offset);
+    uint64_t copied = 0;
+    while (copied < size)
+    {
+        ssize_t result =
+            copy_file_range(original_fd, &in_offset, new_fd, &out_offset, size - copied, 0);
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result <= 0)
+        {
+            // Not supported between these files (e.g. ENOSYS, EXDEV or EINVAL), or the original
+            // file is shorter than expected, which the buffered copy reports
+            break;
+        }
+        copied += static_cast<uint64_t>(result);
+    }
+    if (copied > 0 &&
+        !util::platform::FileSeek(new_file_ptr_, out_offset, util::platform::FileSeekSet))
+    {
+        GFXRECON_LOG_ERROR("Could not seek to offset %" PRId64 " in new file",
+                           static_cast<int64_t>(out_offset));
+        return 0;
+    }
+    return copied;
+#else
+    return 0;
+#endif
+}
+
+bool WriterBlockVisitor::CopyRangeBuffered(uint64_t offset, uint64_t size)
+{
+    if (!util::platform::FileSeek(original_file_ptr_, offset, util::platform::FileSeekSet))
+    {
+        GFXRECON_LOG_ERROR("Could not seek block at offset %" PRIu64 " in original file", offset);
+        return false;
+    }
+    if (copy_buffer_.empty())
+    {
+        copy_buffer_.resize(kDiveBlockBufferSize);
+    }
+    uint64_t bytes_left_to_copy = size;
+    while (bytes_left_to_copy > 0)
+    {
+        size_t bytes_to_copy =
+            static_cast<size_t>(std::min<uint64_t>(bytes_left_to_copy, copy_buffer_.size()));
+        if (!util::platform::FileRead(copy_buffer_.data(), bytes_to_copy, original_file_ptr_))
+        {
+            GFXRECON_LOG_ERROR("Could not read %zu bytes from original file", bytes_to_copy);
+            return false;
+        }
+        if (!util::platform::FileWrite(copy_buffer_.data(), bytes_to_copy, new_file_ptr_))
+        {
+            GFXRECON_LOG_ERROR("Could not write %zu bytes to new file", bytes_to_copy);
+            return false;
+        }
+        bytes_left_to_copy -= bytes_to_copy;
+    }
+    return true;
+}
+
+void DiveBlockData::ReserveOriginalBlocks(size_t count)
+{
+    original_blocks_->offsets.reserve(count);
+}
+
 bool DiveBlockData::AddOriginalBlock(size_t index, uint64_t offset)
 {
     if (original_blocks_map_locked_)
@@ -99,14 +337,14 @@ bool DiveBlockData::AddOriginalBlock(size_t index, uint64_t offset)
         return false;
     }
 
-    if (index != original_blocks_map_.size())
+    if (index != original_blocks_->offsets.size())
     {
         GFXRECON_LOG_ERROR("Unexpected block id mismatch with index: %d, expected index: %d", index,
-                           original_blocks_map_.size());
+                           original_blocks_->offsets.size());
         return false;
     }
 
-    original_blocks_map_.emplace_back(std::make_shared<DiveOriginalBlock>(offset));
+    original_blocks_->offsets.push_back(offset);
 
     return true;
 }
@@ -118,56 +356,48 @@ bool DiveBlockData::FinalizeOriginalBlocksMapSizes(uint64_t file_size)
         return true;
     }
 
-    if (original_blocks_map_.empty())
+    const std::vector<uint64_t>& offsets = original_blocks_->offsets;
+    std::vector<uint64_t>& sizes = original_blocks_->sizes;
+    if (offsets.empty())
     {
         GFXRECON_LOG_ERROR("Original block map is empty");
         return false;
     }
 
     // Calculating block size for header (before block id 0)
-    original_header_block_.offset_ = 0;
-    original_header_block_.size_ = original_blocks_map_[0]->offset_;
+    original_blocks_->header.offset_ = 0;
+    original_blocks_->header.size_ = offsets[0];
 
     // Calculating block sizes
-    std::vector<uint64_t> block_sizes;
-    block_sizes.reserve(original_blocks_map_.size());
+    sizes.resize(offsets.size());
     uint64_t n_blocks_exceeding_buffer_size = 0;
-    for (size_t i = 0; i < original_blocks_map_.size() - 1; i++)
+    for (size_t i = 0; i < offsets.size(); i++)
     {
-        uint64_t current_block_start = original_blocks_map_[i]->offset_;
-        uint64_t current_block_end = original_blocks_map_[i + 1]->offset_;
+        uint64_t current_block_start = offsets[i];
+        uint64_t current_block_end = (i + 1 < offsets.size()) ? offsets[i + 1] : file_size;
         if (current_block_start > current_block_end)
         {
             GFXRECON_LOG_ERROR("Original block with id (%d) has invalid offsets (%d-%d)", i,
                                current_block_start, current_block_end);
+            sizes.clear();
             return false;
         }
         uint64_t size = current_block_end - current_block_start;
 
         // Gather block data for stats
-        block_sizes.push_back(size);
         if (size > kDiveBlockBufferSize)
         {
             n_blocks_exceeding_buffer_size++;
         }
 
-        original_blocks_map_[i]->size_ = size;
-    }
-
-    DiveOriginalBlock& last_block = *original_blocks_map_.back();
-    last_block.size_ = file_size - last_block.offset_;
-
-    // Gather last block data for stats
-    block_sizes.push_back(last_block.size_);
-    if (last_block.size_ > kDiveBlockBufferSize)
-    {
-        n_blocks_exceeding_buffer_size++;
+        sizes[i] = size;
     }
 
     // Report stats
-    assert(block_sizes.size() == original_blocks_map_.size());
-    std::sort(block_sizes.begin(), block_sizes.end());
-    uint64_t rough_median = block_sizes[block_sizes.size() / 2];
+    std::vector<uint64_t> block_sizes = sizes;
+    auto median = block_sizes.begin() + block_sizes.size() / 2;
+    std::nth_element(block_sizes.begin(), median, block_sizes.end());
+    uint64_t rough_median = *median;
     GFXRECON_LOG_INFO(
         "Approx median block size: %" PRIu64 " bytes, buffer size: %zu bytes, and %" PRIu64
         "/%zu blocks exceeded the buffer",
@@ -177,17 +407,58 @@ bool DiveBlockData::FinalizeOriginalBlocksMapSizes(uint64_t file_size)
     return true;
 }
 
-bool DiveBlockData::ModificationExists(uint32_t primary_id, int32_t secondary_id) const
+std::vector<uint64_t> DiveBlockData::GetOriginalBlockOffsets() const
 {
-    if (modifications_map_.count(primary_id) != 1)
-    {
-        return false;
-    }
-    if (modifications_map_.at(primary_id).count(secondary_id) != 1)
+    return original_blocks_->offsets;
+}
+
+size_t DiveBlockData::GetOriginalBlockCount() const { return original_blocks_->offsets.size(); }
+
+DiveBlockData DiveBlockData::CopyWithoutModifications() const
+{
+    GFXRECON_ASSERT(original_blocks_map_locked_);
+    DiveBlockData copy;
+    copy.original_blocks_ = original_blocks_;
+    copy.original_blocks_map_locked_ = original_blocks_map_locked_;
+    return copy;
+}
+
+bool DiveBlockData::ModificationLess(const Modification& a, const Modification& b)
+{
+    return a.position < b.position;
+}
+
+const DiveBlockData::Modification* DiveBlockData::FindModification(uint32_t primary_id,
+                                                                   int32_t secondary_id) const
+{
+    Modification key = {Modification::MakePosition(primary_id, secondary_id), nullptr};
+    for (const std::vector<Modification>* modifications :
+         {&modifications_, &pending_modifications_})
     {
-        return false;
+        auto it = std::lower_bound(modifications->begin(), modifications->end(), key,
+                                   ModificationLess);
+        if (it != modifications->end() && it->position == key.position)
+        {
+            return &*it;
+        }
     }
-    return true;
+    return nullptr;
+}
+
+void DiveBlockData::MergePendingModifications()
+{
+    size_t sorted_count = modifications_.size();
+    modifications_.insert(modifications_.end(),
+                          std::make_move_iterator(pending_modifications_.begin()),
+                          std::make_move_iterator(pending_modifications_.end()));
+    std::inplace_merge(modifications_.begin(), modifications_.begin() + sorted_count,
+                       modifications_.end(), ModificationLess);
+    pending_modifications_.clear();
+}
+
+bool DiveBlockData::ModificationExists(uint32_t primary_id, int32_t secondary_id) const
+{
+    return FindModification(primary_id, secondary_id) != nullptr;
 }
 
 bool DiveBlockData::AddModification(uint32_t primary_id, int32_t secondary_id,
@@ -208,82 +479,126 @@ bool DiveBlockData::AddModification(uint32_t primary_id, int32_t secondary_id,
         return false;
     }
 
-    if (primary_id >= original_blocks_map_.size())
+    if (primary_id >= original_blocks_->offsets.size())
     {
         GFXRECON_LOG_ERROR("Primary index (%d) is out of bounds, largest original block id: %d",
-                           primary_id, original_blocks_map_.size() - 1);
+                           primary_id, original_blocks_->offsets.size() - 1);
         return false;
     }
 
-    if (blob_ptr == nullptr)
+    // The only time an empty blob is used is to indicate a deletion modficiation of the original
+    // block
+    if (blob_ptr == nullptr && secondary_id != 0)
     {
-        if (secondary_id != 0)
-        {
-            GFXRECON_LOG_ERROR("Invalid blob provided for modification at: (%d, %d)", primary_id,
-                               secondary_id);
-            return false;
-        }
-        // The only time an empty blob is used is to indicate a deletion modficiation of the
-        // original block
-        modifications_map_[primary_id][secondary_id] = nullptr;
-        return true;
+        GFXRECON_LOG_ERROR("Invalid blob provided for modification at: (%d, %d)", primary_id,
+                           secondary_id);
+        return false;
     }
 
-    auto new_block_ptr = std::make_shared<DiveModificationBlock>(blob_ptr);
-
-    modifications_map_[primary_id][secondary_id] = std::move(new_block_ptr);
+    Modification modification = {Modification::MakePosition(primary_id, secondary_id),
+                                  std::move(blob_ptr)};
+    auto it = std::upper_bound(pending_modifications_.begin(), pending_modifications_.end(),
+                               modification, ModificationLess);
+    pending_modifications_.insert(it, std::move(modification));
+    if (pending_modifications_.size() >= kMaxPendingModifications)
+    {
+        MergePendingModifications();
+    }
 
     return true;
 }
 
 bool DiveBlockData::RemoveModification(uint32_t primary_id, int32_t secondary_id)
 {
-    if (!ModificationExists(primary_id, secondary_id))
+    const Modification* modification = FindModification(primary_id, secondary_id);
+    if (modification == nullptr)
     {
         GFXRECON_LOG_ERROR("No modified block at: (%d, %d), cannot remove", primary_id,
                            secondary_id);
         return false;
     }
 
-    modifications_map_[primary_id].erase(secondary_id);
+    std::vector<Modification>& modifications =
+        (!modifications_.empty() && modification >= &modifications_.front() &&
+         modification <= &modifications_.back())
+            ? modifications_
+            : pending_modifications_;
+    modifications.erase(modifications.begin() + (modification - modifications.data()));
     return true;
 }
 
+void DiveBlockData::ClearAllModifications()
+{
+    modifications_.clear();
+    pending_modifications_.clear();
+}
+
 bool DiveBlockData::TraverseBlocks(BlockVisitor& visitor) const
 {
-    // Go through block-by-block in order of primary_id
-    for (uint32_t primary_id = 0; primary_id < original_blocks_map_.size(); primary_id++)
+    // Merge the pending modifications into a sorted view of all the modifications
+    std::vector<const Modification*> modifications;
+    modifications.reserve(modifications_.size() + pending_modifications_.size());
+    auto sorted = modifications_.begin();
+    for (const Modification& pending : pending_modifications_)
     {
-        std::map<int32_t, std::shared_ptr<IDiveBlock>> blocks_to_write = {};
-        if (modifications_map_.count(primary_id) > 0)
+        for (; sorted != modifications_.end() && ModificationLess(*sorted, pending); ++sorted)
         {
-            // Copy all the modifications relating to the original block with primary_id
-            blocks_to_write = modifications_map_.at(primary_id);
-        }
-
-        // If there is no modification of the original block, insert a pointer to the original block
-        // into the map of blocks ordered by secondary_id
-        if (blocks_to_write.count(0) == 0)
-        {
-            blocks_to_write[0] = original_blocks_map_.at(primary_id);
+            modifications.push_back(&*sorted);
         }
+        modifications.push_back(&pending);
+    }
+    for (; sorted != modifications_.end(); ++sorted)
+    {
+        modifications.push_back(&*sorted);
+    }
 
-        // For a given primary_id, go through block-by-block in order of secondary_id
-        for (auto it = blocks_to_write.begin(); it != blocks_to_write.end(); ++it)
+    // Go through block-by-block in order of primary_id, and for a given primary_id, in order of
+    // secondary_id, with the original block at secondary_id 0 unless it was modified
+    size_t next_modification = 0;
+    const OriginalBlocks& originals = *original_blocks_;
+    for (uint32_t primary_id = 0; primary_id < originals.offsets.size(); primary_id++)
+    {
+        bool original_block_replaced = false;
+        bool original_block_visited = false;
+        for (; next_modification < modifications.size() &&
+               modifications[next_modification]->primary_id() == primary_id;
+             next_modification++)
         {
-            int32_t secondary_id = it->first;
-            std::shared_ptr<IDiveBlock> current_modification_ptr = it->second;
-
-            if (current_modification_ptr == nullptr)
+            const Modification& modification = *modifications[next_modification];
+            if (modification.secondary_id() > 0 && !original_block_replaced &&
+                !original_block_visited)
             {
-                GFXRECON_LOG_INFO("Original block (%d) was marked for deletion", primary_id);
-                continue;
+                if (!visitor.Visit(DiveOriginalBlock{originals.offsets[primary_id],
+                                                     originals.sizes[primary_id]}))
+                {
+                    GFXRECON_LOG_ERROR("Couldn't write block with ids (%d, 0)", primary_id);
+                    return false;
+                }
+                original_block_visited = true;
             }
-
-            if (!current_modification_ptr->Accept(visitor))
+            if (modification.secondary_id() == 0)
+            {
+                original_block_replaced = true;
+                if (modification.blob_ptr == nullptr)
+                {
+                    GFXRECON_LOG_INFO("Original block (%d) was marked for deletion", primary_id);
+                    continue;
+                }
+            }
+            if (!visitor.Visit(DiveModificationBlock{modification.blob_ptr.get()}))
             {
                 GFXRECON_LOG_ERROR("Couldn't write block with ids (%d, %d)", primary_id,
-                                   secondary_id);
+                                   modification.secondary_id());
+                return false;
+            }
+        }
+
+        if (!original_block_replaced && !original_block_visited)
+        {
+            if (!visitor.Visit(DiveOriginalBlock{originals.offsets[primary_id],
+                                                 originals.sizes[primary_id]}))
+            {
+                GFXRECON_LOG_ERROR("Couldn't write block with ids (%d, 0)", primary_id);
                 return false;
             }
         }
@@ -307,6 +622,8 @@ bool DiveBlockData::WriteGFXRFile(const std::string& original_file_path,
         GFXRECON_LOG_ERROR("Failed to open file %s", original_file_path.c_str());
         return false;
     }
+    // Closes the files on the error paths; they are closed explicitly on success.
+    std::unique_ptr<FILE, int (*)(FILE*)> original_file(original_fd, util::platform::FileClose);
 
     FILE* new_fd = nullptr;
     result = util::platform::FileOpen(&new_fd, new_file_path.c_str(), "wb");
@@ -315,29 +632,30 @@ bool DiveBlockData::WriteGFXRFile(const std::string& original_file_path,
         GFXRECON_LOG_ERROR("Failed to open file %s", new_file_path.c_str());
         return false;
     }
+    std::unique_ptr<FILE, int (*)(FILE*)> new_file(new_fd, util::platform::FileClose);
 
     WriterBlockVisitor writer = {original_fd, new_fd};
 
     // Copy the original header
-    if (!original_header_block_.Accept(writer))
+    if (!writer.Visit(original_blocks_->header))
     {
         GFXRECON_LOG_ERROR("Could not copy header");
         return false;
     }
 
-    if (!TraverseBlocks(writer))
+    if (!TraverseBlocks(writer) || !writer.Flush())
     {
         GFXRECON_LOG_ERROR("Could not copy blocks in order");
         return false;
     }
 
-    if (util::platform::FileClose(original_fd))
+    if (util::platform::FileClose(original_file.release()))
     {
         GFXRECON_LOG_ERROR("Failed to close file %s", original_file_path.c_str());
         return false;
     }
 
-    if (util::platform::FileClose(new_fd))
+    if (util::platform::FileClose(new_file.release()))
     {
         GFXRECON_LOG_ERROR("Failed to close file %s", new_file_path.c_str());
         return false;
@@ -347,5 +665,132 @@ bool DiveBlockData::WriteGFXRFile(const std::string& original_file_path,
     return true;
 }
 
+bool DiveBlockData::WriteGFXRFiles(const std::string& original_file_path,
+                                   const std::vector<const DiveBlockData*>& variants,
+                                   const std::vector<std::string>& new_file_paths,
+                                   size_t thread_count)
+{
+    if (variants.size() != new_file_paths.size())
+    {
+        GFXRECON_LOG_ERROR("Got %zu variants for %zu new files", variants.size(),
+                           new_file_paths.size());
+        return false;
+    }
+    if (variants.empty())
+    {
+        return true;
+    }
+    for (const DiveBlockData* variant : variants)
+    {
+        if (!variant->original_blocks_map_locked_ ||
+            variant->original_blocks_ != variants.front()->original_blocks_)
+        {
+            GFXRECON_LOG_ERROR("Variants must be copies of the same locked DiveBlockData");
+            return false;
+        }
+    }
+
+    // List the parts of each new file
+    std::vector<DiveBatchOutput> outputs(variants.size());
+    for (size_t i = 0; i < variants.size(); i++)
+    {
+        RangeListBlockVisitor range_list;
+        if (!range_list.Visit(variants[i]->original_blocks_->header) ||
+            !variants[i]->TraverseBlocks(range_list))
+        {
+            GFXRECON_LOG_ERROR("Could not list blocks for %s", new_file_paths[i].c_str());
+            return false;
+        }
+        outputs[i].path = new_file_paths[i];
+        outputs[i].ranges = range_list.TakeRanges();
+    }
+
+    FILE* original_fd = nullptr;
+    int result = util::platform::FileOpen(&original_fd, original_file_path.c_str(), "rb");
+    if (result || original_fd == nullptr)
+    {
+        GFXRECON_LOG_ERROR("Failed to open file %s", original_file_path.c_str());
+        return false;
+    }
+    std::unique_ptr<FILE, int (*)(FILE*)> original_file(original_fd, util::platform::FileClose);
+
+    for (DiveBatchOutput& output : outputs)
+    {
+        result = util::platform::FileOpen(&output.file, output.path.c_str(), "wb");
+        if (result || output.file == nullptr)
+        {
+            GFXRECON_LOG_ERROR("Failed to open file %s", output.path.c_str());
+            return false;
+        }
+    }
+
+    // Read the original file once, writing each part to all the new files in parallel while the
+    // next part is read
+    util::ThreadPool pool(std::clamp<size_t>(thread_count, 1, outputs.size()));
+    std::vector<char> buffers[2] = {std::vector<char>(kDiveBatchReadSize),
+                                    std::vector<char>(kDiveBatchReadSize)};
+    size_t current = 0;
+    uint64_t data_offset = 0;
+    size_t data_size =
+        util::platform::FileReadBytes(buffers[current].data(), kDiveBatchReadSize, original_fd);
+    bool writes_succeeded = true;
+    while (writes_succeeded)
+    {
+        std::vector<std::future<bool>> writes;
+        writes.reserve(outputs.size());
+        for (DiveBatchOutput& output : outputs)
+        {
+            writes.push_back(pool.post(WriteBatchOutput, std::ref(output),
+                                       buffers[current].data(), data_offset, data_size));
+        }
+
+        size_t next_data_size = 0;
+        if (data_size > 0)
+        {
+            next_data_size = util::platform::FileReadBytes(buffers[1 - current].data(),
+                                                           kDiveBatchReadSize, original_fd);
+        }
+
+        for (std::future<bool>& write : writes)
+        {
+            writes_succeeded = write.get() && writes_succeeded;
+        }
+        if (data_size == 0)
+        {
+            break;
+        }
+        data_offset += data_size;
+        data_size = next_data_size;
+        current = 1 - current;
+    }
+    if (!writes_succeeded)
+    {
+        return false;
+    }
+    if (ferror(original_fd))
+    {
+        GFXRECON_LOG_ERROR("Could not read %s", original_file_path.c_str());
+        return false;
+    }
+
+    for (DiveBatchOutput& output : outputs)
+    {
+        if (output.next_range != output.ranges.size())
+        {
+            GFXRECON_LOG_ERROR("Original file %s ended before %s was complete",
+                               original_file_path.c_str(), output.path.c_str());
+            return false;
+        }
+        FILE* file = std::exchange(output.file, nullptr);
+        if (util::platform::FileClose(file))
+        {
+            GFXRECON_LOG_ERROR("Failed to close file %s", output.path.c_str());
+            return false;
+        }
+        GFXRECON_LOG_INFO("Wrote new gfxr file: %s", output.path.c_str());
+    }
+    return true;
+}
+
 GFXRECON_END_NAMESPACE(decode)
 GFXRECON_END_NAMESPACE(gfxrecon)
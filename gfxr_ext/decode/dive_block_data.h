@@ -22,22 +22,35 @@ limitations under the License.
 #ifndef GFXRECON_DECODE_DIVE_BLOCK_DATA_H
 #define GFXRECON_DECODE_DIVE_BLOCK_DATA_H
 
-#include <map>
+#include <cstdint>
+#include <cstdio>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "util/defines.h"
 
-static constexpr size_t kDiveBlockBufferSize = 4096;
+// Size of the buffer used to copy original blocks when the kernel can't copy them directly
+static constexpr size_t kDiveBlockBufferSize = 1024 * 1024;
 
 GFXRECON_BEGIN_NAMESPACE(gfxrecon)
 GFXRECON_BEGIN_NAMESPACE(decode)
 
-class DiveOriginalBlock;
-class DiveModificationBlock;
+// A block of the original GFXR file, given to a BlockVisitor during traversal
+struct DiveOriginalBlock
+{
+    uint64_t offset_ = 0;
+    uint64_t size_ = 0;
+};
+
+// A gfxr-encoded block with data stored in a buffer, given to a BlockVisitor during traversal
+// blob_ptr_ is expected to point at a non-empty vector at the time of traversal
+struct DiveModificationBlock
+{
+    const std::vector<char>* blob_ptr_ = nullptr;
+};
 
-// Abstract class representing a visitor for IDiveBlock objects
+// Abstract class representing a visitor for the blocks of a DiveBlockData
 class BlockVisitor
 {
  public:
@@ -57,7 +70,12 @@ class TestBlockVisitor : public BlockVisitor
     std::vector<std::string> traversed_;
 };
 
-// A visitor that writes out a IDiveBlock into a provided file new_file_ptr_
+// A visitor that writes out the visited blocks into a provided file new_file_ptr_
+//
+// Runs of original blocks that are adjacent in the original file are merged and copied as a single
+// range, with copy_file_range() where available, so an unmodified stretch of the file costs a few
+// system calls rather than a seek and a read and write per 4 KiB. Flush() must be called after the
+// last block is visited to copy the final range.
 class WriterBlockVisitor : public BlockVisitor
 {
  public:
@@ -69,90 +87,126 @@ class WriterBlockVisitor : public BlockVisitor
     bool Visit(const DiveOriginalBlock& block) override;
     bool Visit(const DiveModificationBlock& block) override;
 
+    // Copy the pending range of original blocks to the new file
+    bool Flush();
+
  private:
+    // Copies size bytes at offset in the original file with copy_file_range(), returns the number
+    // of bytes copied, which is less than size if the kernel can't copy between the two files
+    uint64_t CopyRangeInKernel(uint64_t offset, uint64_t size);
+    bool CopyRangeBuffered(uint64_t offset, uint64_t size);
+
     FILE* original_file_ptr_ = nullptr;
     FILE* new_file_ptr_ = nullptr;
-    char copy_buffer_[kDiveBlockBufferSize] = {};
-};
-
-// Abstract class representing a single binary block encoded in .gfxr format
-class IDiveBlock
-{
- public:
-    IDiveBlock() {}
-    virtual ~IDiveBlock() {}
-    virtual bool Accept(BlockVisitor& visitor) const = 0;
-};
 
-// Representing a gfxr-encoded block with data stored in the original file
-class DiveOriginalBlock : public IDiveBlock
-{
- public:
-    DiveOriginalBlock() {}
-    DiveOriginalBlock(uint64_t offset) : offset_(offset) {}
-    ~DiveOriginalBlock() override {}
-    bool Accept(BlockVisitor& visitor) const override { return visitor.Visit(*this); }
+    // Range of the original file that is still to be copied
+    uint64_t pending_offset_ = 0;
+    uint64_t pending_size_ = 0;
 
-    uint64_t offset_ = 0;
-    uint64_t size_ = 0;
-};
-
-// Representing a gfxr-encoded block with data stored in a buffer
-// If blob_ptr is undefined, that is interpreted as an empty block
-// blob_ptr_ is expected to point at a non-empty vector at the time of traversal
-class DiveModificationBlock : public IDiveBlock
-{
- public:
-    DiveModificationBlock() {}
-    DiveModificationBlock(std::shared_ptr<std::vector<char>> blob_ptr) : blob_ptr_(blob_ptr) {}
-    ~DiveModificationBlock() override {}
-    bool Accept(BlockVisitor& visitor) const override { return visitor.Visit(*this); }
-
-    std::shared_ptr<std::vector<char>> blob_ptr_ = nullptr;
+    // Allocated on first use, most ranges are copied by the kernel
+    std::vector<char> copy_buffer_;
 };
 
+// Metadata of an original GFXR file and of the modifications made to it
+//
+// The original blocks are kept as arrays of offsets and sizes and the modifications in a flat
+// vector sorted by (primary_id, secondary_id), so that TraverseBlocks() walks both sequentially,
+// without per-block heap objects. Modifications are first inserted into a short sorted vector which
+// is merged into the main one when it fills up, so adding many edits stays cheap.
 class DiveBlockData
 {
  public:
     // Add info for the next block in the original GFXR file
+    void ReserveOriginalBlocks(size_t count);
     bool AddOriginalBlock(size_t index, uint64_t offset);
 
     // Calculate block sizes, drop the file-end block and lock the map
     bool FinalizeOriginalBlocksMapSizes(uint64_t file_size);
     bool IsOriginalBlocksMapLocked() const { return original_blocks_map_locked_; }
 
+    // Offsets of the blocks in the original GFXR file, e.g. to save them in an index
+    std::vector<uint64_t> GetOriginalBlockOffsets() const;
+    size_t GetOriginalBlockCount() const;
+
+    // A DiveBlockData for the same original file without any modification, e.g. to prepare several
+    // variants of the file. The original blocks are shared, so the map must be locked.
+    DiveBlockData CopyWithoutModifications() const;
+
     // Add or edit modifications
     bool ModificationExists(uint32_t primary_id, int32_t secondary_id) const;
     bool AddModification(uint32_t primary_id, int32_t secondary_id,
                          std::shared_ptr<std::vector<char>> blob_ptr);
     bool RemoveModification(uint32_t primary_id, int32_t secondary_id);
-    void ClearAllModifications() { modifications_map_.clear(); }
+    void ClearAllModifications();
 
     // Write modified GFXR file at the specified path
     bool TraverseBlocks(BlockVisitor& visitor) const;
     bool WriteGFXRFile(const std::string& original_file_path,
                        const std::string& new_file_path) const;
 
+    // Write one modified GFXR file per variant, variants[i] to new_file_paths[i], with a single
+    // sequential read of the original file. The variants must all be copies of the same
+    // DiveBlockData (see CopyWithoutModifications()). The files are written by up to thread_count
+    // threads while the next part of the original file is read.
+    static bool WriteGFXRFiles(const std::string& original_file_path,
+                               const std::vector<const DiveBlockData*>& variants,
+                               const std::vector<std::string>& new_file_paths,
+                               size_t thread_count);
+
  private:
-    // Info for the blocks in the original GFXR file
-    std::vector<std::shared_ptr<DiveOriginalBlock>>
-        original_blocks_map_;  // Starting block index of 0
-    DiveOriginalBlock original_header_block_;
+    struct Modification
+    {
+        // The primary_id in the high bits and the secondary_id, offset to be unsigned, in the low
+        // bits, so that modifications are ordered by comparing a single integer
+        uint64_t position = 0;
+        std::shared_ptr<std::vector<char>> blob_ptr;
+
+        static uint64_t MakePosition(uint32_t primary_id, int32_t secondary_id)
+        {
+            return (static_cast<uint64_t>(primary_id) << 32) |
+                   (static_cast<uint32_t>(secondary_id) ^ 0x80000000u);
+        }
+        uint32_t primary_id() const { return static_cast<uint32_t>(position >> 32); }
+        int32_t secondary_id() const
+        {
+            return static_cast<int32_t>(static_cast<uint32_t>(position) ^ 0x80000000u);
+        }
+    };
+
+    // Pending modifications are merged into modifications_ when there are this many
+    static constexpr size_t kMaxPendingModifications = 512;
+
+    static bool ModificationLess(const Modification& a, const Modification& b);
+    const Modification* FindModification(uint32_t primary_id, int32_t secondary_id) const;
+    void MergePendingModifications();
+
+    // Info for the blocks in the original GFXR file, indexed by block id (starting at 0). Once
+    // locked, it is shared with the copies made by CopyWithoutModifications().
+    struct OriginalBlocks
+    {
+        std::vector<uint64_t> offsets;
+        std::vector<uint64_t> sizes;
+        DiveOriginalBlock header;
+    };
+    std::shared_ptr<OriginalBlocks> original_blocks_ = std::make_shared<OriginalBlocks>();
     bool original_blocks_map_locked_ = false;
 
     // Info for modifications
     //
-    // The first key (uint32_t) is the primary_id which is the original_id. Valid values:
-    // [0...original_blocks_map_.size()-1]
+    // The primary_id is the original block id. Valid values:
+    // [0...original_blocks_->offsets.size()-1]
     //
-    // The second key (int32_t) is the secondary_id which represents the position of
-    // this modified block relative to the primary_id block, with negative values coming before the
-    // original block and positive values after. A secondary_id of 0 represents a modification
-    // overwriting the original block, and only these modifications are allowed to have a value of
-    // nullptr.
+    // The secondary_id represents the position of this modified block relative to the primary_id
+    // block, with negative values coming before the original block and positive values after. A
+    // secondary_id of 0 represents a modification overwriting the original block, and only these
+    // modifications are allowed to have a blob_ptr of nullptr, which deletes the original block.
     //
-    // Each modification has an unique pair of primary_id and secondary_id.
-    std::map<uint32_t, std::map<int32_t, std::shared_ptr<IDiveBlock>>> modifications_map_;
+    // Each modification has an unique pair of primary_id and secondary_id, and is either in
+    // modifications_ or in pending_modifications_, which are both sorted by position. New
+    // modifications go to the short pending_modifications_, so adding one doesn't move all of
+    // modifications_.
+    std::vector<Modification> modifications_;
+    std::vector<Modification> pending_modifications_;
 };
 
 GFXRECON_END_NAMESPACE(decode)
@@ -0,0 +1,131 @@
+/*
+Copyright 2026 Google Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "dive_block_data.h"
+#include "util/logging.h"
+
+namespace gfxrecon::decode
+{
+namespace
+{
+
+constexpr uint64_t kBlockSize = 64;
+constexpr size_t kEditCount = 100'000;
+
+// Counts the visited blocks, so the traversal isn't optimized away
+class CountingBlockVisitor : public BlockVisitor
+{
+ public:
+    bool Visit(const DiveOriginalBlock& block) override
+    {
+        bytes_ += block.size_;
+        return true;
+    }
+    bool Visit(const DiveModificationBlock& block) override
+    {
+        bytes_ += block.blob_ptr_->size();
+        return true;
+    }
+
+    uint64_t bytes() const { return bytes_; }
+
+ private:
+    uint64_t bytes_ = 0;
+};
+
+// A capture with `block_count` blocks of kBlockSize bytes
+std::unique_ptr<DiveBlockData> CreateBlockData(size_t block_count)
+{
+    auto block_data = std::make_unique<DiveBlockData>();
+    block_data->ReserveOriginalBlocks(block_count);
+    for (size_t i = 0; i < block_count; i++)
+    {
+        block_data->AddOriginalBlock(i, kBlockSize * (i + 1));
+    }
+    block_data->FinalizeOriginalBlocksMapSizes(kBlockSize * (block_count + 1));
+    return block_data;
+}
+
+// Applies kEditCount random what-if edits: deletions, replacements and insertions around random
+// blocks, as a tool bisecting a capture would
+void ApplyEdits(DiveBlockData& block_data, size_t block_count)
+{
+    auto blob = std::make_shared<std::vector<char>>(kBlockSize);
+    std::mt19937 random(1234);
+    std::uniform_int_distribution<uint32_t> block_id(0, static_cast<uint32_t>(block_count - 1));
+    std::uniform_int_distribution<int32_t> edit(-2, 2);
+    size_t applied = 0;
+    while (applied < kEditCount)
+    {
+        uint32_t primary_id = block_id(random);
+        int32_t secondary_id = edit(random);
+        if (block_data.ModificationExists(primary_id, secondary_id))
+        {
+            continue;
+        }
+        bool deletion = secondary_id == 0 && (random() & 1);
+        block_data.AddModification(primary_id, secondary_id, deletion ? nullptr : blob);
+        applied++;
+    }
+}
+
+void BM_ApplyEdits(benchmark::State& state)
+{
+    size_t block_count = static_cast<size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::unique_ptr<DiveBlockData> block_data = CreateBlockData(block_count);
+        state.ResumeTiming();
+
+        ApplyEdits(*block_data, block_count);
+
+        state.PauseTiming();
+        block_data.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * kEditCount);
+}
+BENCHMARK(BM_ApplyEdits)->Arg(1'000'000)->Arg(4'000'000)->Unit(benchmark::kMillisecond);
+
+void BM_TraverseEditedBlocks(benchmark::State& state)
+{
+    // The deletions are logged at the info level, which would dominate the traversal
+    util::Log::Init(util::Log::kErrorSeverity);
+
+    size_t block_count = static_cast<size_t>(state.range(0));
+    std::unique_ptr<DiveBlockData> block_data = CreateBlockData(block_count);
+    ApplyEdits(*block_data, block_count);
+    for (auto _ : state)
+    {
+        CountingBlockVisitor visitor;
+        block_data->TraverseBlocks(visitor);
+        benchmark::DoNotOptimize(visitor.bytes());
+    }
+    state.SetItemsProcessed(state.iterations() * (block_count + kEditCount));
+
+    util::Log::Release();
+}
+BENCHMARK(BM_TraverseEditedBlocks)->Arg(1'000'000)->Arg(4'000'000)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace gfxrecon::decode
@@ -18,6 +18,10 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <iterator>
+#include <map>
+
 namespace gfxrecon::decode
 {
 namespace
@@ -294,5 +298,144 @@ TEST_F(DiveBlockDataTestFixture, TraverseBlocks_OrderSecondary)
     EXPECT_EQ(GetExampleString(o[2]), traversed_strings[6]);
 }
 
+// Enough modifications to be merged into the sorted ones several times
+TEST_F(DiveBlockDataTestFixture, TraverseBlocks_ManyModificationsInOrder)
+{
+    // Records the visited blocks, with the modifications identified by their buffer
+    class RecordingBlockVisitor : public BlockVisitor
+    {
+     public:
+        bool Visit(const DiveOriginalBlock& /*block*/) override
+        {
+            visited.push_back(nullptr);
+            return true;
+        }
+        bool Visit(const DiveModificationBlock& block) override
+        {
+            visited.push_back(block.blob_ptr_);
+            return true;
+        }
+
+        std::vector<const std::vector<char>*> visited;
+    };
+
+    LockExampleOriginals();
+
+    // Add modifications around block 1 in descending order of secondary_id
+    constexpr int32_t kCount = 3000;
+    std::map<int32_t, std::shared_ptr<std::vector<char>>> added;
+    for (int32_t secondary_id = kCount; secondary_id >= -kCount; secondary_id--)
+    {
+        auto blob = CreateModifiedBuffer("x");
+        EXPECT_TRUE(d.AddModification(1, secondary_id, blob));
+        added[secondary_id] = blob;
+    }
+    // Remove some of them, and delete the original block 2
+    for (int32_t secondary_id = -kCount; secondary_id <= kCount; secondary_id += 7)
+    {
+        EXPECT_TRUE(d.RemoveModification(1, secondary_id));
+        EXPECT_FALSE(d.ModificationExists(1, secondary_id));
+        added.erase(secondary_id);
+    }
+    EXPECT_TRUE(d.AddModification(2, 0, nullptr));
+
+    std::vector<const std::vector<char>*> expected = {nullptr};
+    for (const auto& [secondary_id, blob] : added)
+    {
+        expected.push_back(blob.get());
+    }
+    if (added.count(0) == 0)
+    {
+        // Original block 1, since its replacement was removed
+        expected.insert(expected.begin() + 1 + std::distance(added.begin(), added.lower_bound(0)),
+                        nullptr);
+    }
+
+    RecordingBlockVisitor visitor;
+    EXPECT_TRUE(d.TraverseBlocks(visitor));
+    EXPECT_EQ(expected, visitor.visited);
+}
+
+TEST_F(DiveBlockDataTestFixture, WriteGFXRFile_CopiesRangesInOrder)
+{
+    // Every byte of the original file holds its offset, so copied ranges are easy to check
+    std::string original_path = testing::TempDir() + "dive_block_data_original.gfxr";
+    std::string new_path = testing::TempDir() + "dive_block_data_new.gfxr";
+    std::string original;
+    for (uint32_t i = 0; i < file_size; i++)
+    {
+        original.push_back(static_cast<char>(i));
+    }
+    std::ofstream(original_path, std::ios::binary) << original;
+
+    LockExampleOriginals();
+    PopulateExampleModifications();
+    EXPECT_TRUE(d.AddModification(0, 1, m[2]));
+    EXPECT_TRUE(d.AddModification(1, 0, nullptr));
+    EXPECT_TRUE(d.AddModification(2, 1, m[3]));
+    EXPECT_TRUE(d.WriteGFXRFile(original_path, new_path));
+
+    std::ifstream new_file(new_path, std::ios::binary);
+    std::string written((std::istreambuf_iterator<char>(new_file)),
+                        std::istreambuf_iterator<char>());
+
+    // Header and block 0, modification, block 2 and modification
+    std::string expected = original.substr(0, 110) + "12" + original.substr(200, 50) + "123";
+    EXPECT_EQ(expected, written);
+}
+
+TEST_F(DiveBlockDataTestFixture, WriteGFXRFiles_WritesEachVariant)
+{
+    std::string original_path = testing::TempDir() + "dive_block_data_batch_original.gfxr";
+    std::string original;
+    for (uint32_t i = 0; i < file_size; i++)
+    {
+        original.push_back(static_cast<char>(i));
+    }
+    std::ofstream(original_path, std::ios::binary) << original;
+
+    LockExampleOriginals();
+    PopulateExampleModifications();
+    DiveBlockData unmodified = d.CopyWithoutModifications();
+    DiveBlockData deleted = d.CopyWithoutModifications();
+    EXPECT_TRUE(deleted.AddModification(1, 0, nullptr));
+    DiveBlockData inserted = d.CopyWithoutModifications();
+    EXPECT_TRUE(inserted.AddModification(0, -1, m[1]));
+    EXPECT_TRUE(inserted.AddModification(2, 0, m[4]));
+    EXPECT_TRUE(inserted.AddModification(2, 1, m[5]));
+
+    std::vector<std::string> new_paths = {
+        testing::TempDir() + "dive_block_data_batch_unmodified.gfxr",
+        testing::TempDir() + "dive_block_data_batch_deleted.gfxr",
+        testing::TempDir() + "dive_block_data_batch_inserted.gfxr",
+    };
+    EXPECT_TRUE(
+        DiveBlockData::WriteGFXRFiles(original_path, {&unmodified, &deleted, &inserted}, new_paths,
+                                      /*thread_count=*/2));
+
+    std::vector<std::string> expected = {
+        original,
+        original.substr(0, 110) + original.substr(200, 50),
+        original.substr(0, 100) + "1" + original.substr(100, 100) + "1234" + "12345",
+    };
+    for (size_t i = 0; i < new_paths.size(); i++)
+    {
+        std::ifstream new_file(new_paths[i], std::ios::binary);
+        std::string written((std::istreambuf_iterator<char>(new_file)),
+                            std::istreambuf_iterator<char>());
+        EXPECT_EQ(expected[i], written) << new_paths[i];
+    }
+}
+
+TEST_F(DiveBlockDataTestFixture, WriteGFXRFiles_OtherOriginal_Fail)
+{
+    LockExampleOriginals();
+    DiveBlockData other;
+    other.AddOriginalBlock(0, 100);
+    other.FinalizeOriginalBlocksMapSizes(file_size);
+    EXPECT_FALSE(DiveBlockData::WriteGFXRFiles(
+        "unused.gfxr", {&d, &other}, {"unused_0.gfxr", "unused_1.gfxr"}, /*thread_count=*/1));
+}
+
 }  // namespace
 }  // namespace gfxrecon::decode
@@ -18,7 +18,9 @@ limitations under the License.
 
 #include "dive_file_processor.h"
 
+#include <cinttypes>
 #include <fstream>
+#include <utility>
 
 #include "capture_service/constants.h"
 #include "dive/utils/renderdoc_files.h"
@@ -44,6 +46,10 @@ bool ShouldCreateRenderDocCapture()
 
 }  // namespace
 
+DiveFileProcessor::DiveFileProcessor(uint64_t block_limit) : DivePrefetchFileProcessor(block_limit)
+{
+}
+
 void DiveFileProcessor::SetLoopSingleFrameCount(uint64_t loop_single_frame_count)
 {
     loop_single_frame_count_ = loop_single_frame_count;
@@ -51,6 +57,11 @@ void DiveFileProcessor::SetLoopSingleFrameCount(uint64_t loop_single_frame_count
                       loop_single_frame_count);
 }
 
+void DiveFileProcessor::SetLoopEarlyStop(std::function<bool()> should_stop)
+{
+    loop_early_stop_ = std::move(should_stop);
+}
+
 void DiveFileProcessor::SetDiveBlockData(std::shared_ptr<DiveBlockData> p_block_data)
 {
     dive_block_data_ = p_block_data;
@@ -59,6 +70,26 @@ void DiveFileProcessor::SetDiveBlockData(std::shared_ptr<DiveBlockData> p_block_
     run_without_decoders_ = true;
 }
 
+bool DiveFileProcessor::SeekToBlock(uint64_t block_index, uint64_t offset, uint64_t frame_number)
+{
+    if (file_stack_.size() != 1 || block_index_ != 0)
+    {
+        GFXRECON_LOG_ERROR("Can only seek to a block before processing starts");
+        return false;
+    }
+
+    std::shared_ptr<FileInputStream> gfxr_file = file_stack_.back().active_file;
+    if (!SeekActiveFile(gfxr_file, static_cast<int64_t>(offset), util::platform::FileSeekSet))
+    {
+        GFXRECON_LOG_ERROR("Failed to seek to block %" PRIu64 " at offset %" PRIu64, block_index,
+                           offset);
+        return false;
+    }
+    block_index_ = block_index;
+    current_frame_number_ = frame_number;
+    return true;
+}
+
 bool DiveFileProcessor::WriteFile(const std::string& name, const std::string& content)
 {
     std::string new_file_path = absolute_path_ + "/" + name;
@@ -114,7 +145,9 @@ bool DiveFileProcessor::ProcessFrameDelimiter(const FrameEndMarkerArgs& end_fram
     // Reaching the Frame End marker means that we've completed one loop. current_frame_number_
     // will be incremented by 1 each loop, but that is handled by FileProcessor after we return.
     uint64_t loops_done = current_frame_number_ + 1;
-    if (finite_looping && (loops_done >= loop_single_frame_count_))
+    // Only a finite loop count is cut short; infinite looping goes on until the app is stopped.
+    bool stop_early = finite_looping && loop_early_stop_ && loop_early_stop_();
+    if (stop_early || (finite_looping && (loops_done >= loop_single_frame_count_)))
     {
         if (ShouldCreateRenderDocCapture())
         {
@@ -136,7 +169,7 @@ bool DiveFileProcessor::ProcessFrameDelimiter(const FrameEndMarkerArgs& end_fram
             }
         }
 
-        GFXRECON_LOG_INFO("Looped %d frames, terminating replay asap", loop_single_frame_count_);
+        GFXRECON_LOG_INFO("Looped %" PRIu64 " frames, terminating replay asap", loops_done);
         // The act of not seeking should cause replay to hit EOF and stop (assuming there is only
         // one frame in the capture file)
         return is_frame_delimiter;
@@ -218,7 +251,8 @@ void DiveFileProcessor::StoreBlockInfo()
 
     int64_t offset = gfxr_file->FileTell();
     GFXRECON_ASSERT(offset > 0);
-    dive_block_data_->AddOriginalBlock(block_index_, static_cast<uint64_t>(offset));
+    // Blocks may be read ahead of block_index_ when they are prefetched.
+    dive_block_data_->AddOriginalBlock(GetReadBlockIndex(), static_cast<uint64_t>(offset));
 }
 
 GFXRECON_END_NAMESPACE(decode)
@@ -16,27 +16,43 @@ limitations under the License.
 
 // Implementing a custom file processor is necessary to support these changes:
 // - Loop a single frame for N times, or infinitely
+// - Stop looping early once a condition is met, e.g. the GPU times have converged
 
 // NOLINT(build/header_guard)
 #ifndef GFXRECON_DECODE_DIVE_FILE_PROCESSOR_H
 #define GFXRECON_DECODE_DIVE_FILE_PROCESSOR_H
 
+#include <functional>
 #include <memory>
 
 #include "decode/block_parser.h"
-#include "decode/file_processor.h"
 #include "dive_block_data.h"
+#include "dive_prefetch_file_processor.h"
 
 GFXRECON_BEGIN_NAMESPACE(gfxrecon)
 GFXRECON_BEGIN_NAMESPACE(decode)
 
-class DiveFileProcessor : public FileProcessor
+class DiveFileProcessor : public DivePrefetchFileProcessor
 {
  public:
+    DiveFileProcessor() = default;
+    // Stops processing after block `block_limit`, see FileProcessor. 0 means no limit.
+    explicit DiveFileProcessor(uint64_t block_limit);
+
     void SetLoopSingleFrameCount(uint64_t loop_single_frame_count);
 
+    // `should_stop` is called at the end of each loop of the single frame when the loop count is
+    // finite; looping stops as if the loop count had been reached once it returns true.
+    void SetLoopEarlyStop(std::function<bool()> should_stop);
+
     void SetDiveBlockData(std::shared_ptr<DiveBlockData> p_block_data);
 
+    // Starts processing at block `block_index`, which is at `offset` in the capture file and in
+    // frame `frame_number`. The offset must come from a previous pass over the same file, e.g.
+    // DiveBlockData::GetOriginalBlockOffsets(). Must be called after Initialize() and before any
+    // block is processed.
+    bool SeekToBlock(uint64_t block_index, uint64_t offset, uint64_t frame_number);
+
     // Writes content to a new file that is put in the same dir as the capture file,
     // overwriting existing file if present
     bool WriteFile(const std::string& name, const std::string& content);
@@ -54,6 +70,7 @@ class DiveFileProcessor : public FileProcessor
     // Application will terminate after the single frame has been looped loop_single_frame_count_
     // times. If 0, application will loop infinitely.
     uint64_t loop_single_frame_count_{1};
+    std::function<bool()> loop_early_stop_;
 
     // Capture file offset of the marker that indicates the end of resources setup.
     int64_t state_end_marker_file_offset_{0};
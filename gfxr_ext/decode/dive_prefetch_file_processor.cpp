@@ -0,0 +1,227 @@
+/*
+Copyright 2026 Google Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "dive_prefetch_file_processor.h"
+
+#include <algorithm>
+#include <future>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "format/format_util.h"
+#include "util/heap_buffer.h"
+#include "util/logging.h"
+
+GFXRECON_BEGIN_NAMESPACE(gfxrecon)
+GFXRECON_BEGIN_NAMESPACE(decode)
+
+namespace
+{
+
+// Blocks read ahead per worker; enough to keep the workers busy while the decoder catches up.
+constexpr size_t kPrefetchDepthPerWorker = 4;
+constexpr size_t kMinPrefetchDepth = 16;
+
+}  // namespace
+
+// A block read ahead of the decoders. Compressed blocks are parsed by a worker with a parser of
+// their own, whose local storage holds the decompressed data.
+struct DivePrefetchFileProcessor::PrefetchedBlock
+{
+    // Owns the block data. It is only touched on the decoding thread, since its storage comes
+    // from the (single-threaded) buffer pool of the input stream.
+    BlockBuffer block_buffer;
+
+    // Only set for blocks parsed by a worker.
+    util::HeapBufferPool::PoolPtr pool;
+    std::unique_ptr<BlockParser> parser;
+    // Non-owning view of block_buffer given to the parser.
+    BlockBuffer parser_view;
+    std::optional<ParsedBlock> parsed_block;
+    BlockIOError error{kErrorNone};
+    std::string error_message;
+    std::future<void> parsed;
+};
+
+DivePrefetchFileProcessor::DivePrefetchFileProcessor() = default;
+
+DivePrefetchFileProcessor::DivePrefetchFileProcessor(uint64_t block_limit)
+    : FileProcessor(block_limit)
+{
+}
+
+DivePrefetchFileProcessor::~DivePrefetchFileProcessor()
+{
+    // Wait for the workers before releasing the blocks they parse.
+    prefetch_pool_.reset();
+}
+
+void DivePrefetchFileProcessor::SetBlockPrefetch(size_t worker_count, size_t depth)
+{
+    GFXRECON_ASSERT(prefetched_blocks_.empty());
+    prefetch_pool_.reset();
+    prefetch_depth_ = 0;
+    if (worker_count == 0 || depth == 0)
+    {
+        return;
+    }
+    prefetch_pool_ = std::make_unique<util::ThreadPool>(worker_count);
+    prefetch_depth_ = depth;
+}
+
+void DivePrefetchFileProcessor::EnableBlockPrefetch()
+{
+    // Leave a hardware thread for decoding.
+    size_t worker_count = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    if (worker_count == 0)
+    {
+        return;
+    }
+    SetBlockPrefetch(worker_count,
+                     std::max(kMinPrefetchDepth, worker_count * kPrefetchDepthPerWorker));
+}
+
+bool DivePrefetchFileProcessor::GetBlockBuffer(BlockParser& parser, BlockBuffer& block_buffer)
+{
+    // The previous block has been decoded.
+    current_block_.reset();
+
+    if (prefetch_pool_ == nullptr)
+    {
+        return FileProcessor::GetBlockBuffer(parser, block_buffer);
+    }
+
+    if (prefetched_blocks_.empty())
+    {
+        // The block that paused prefetching, if any, has been processed.
+        prefetch_paused_ = false;
+        if (prefetch_read_failed_)
+        {
+            prefetch_read_failed_ = false;
+            return false;
+        }
+        // Commands executed from another file are counted as they are processed, so the end of
+        // their range is only known then.
+        if (file_stack_.size() != 1)
+        {
+            return FileProcessor::GetBlockBuffer(parser, block_buffer);
+        }
+    }
+
+    PrefetchBlocks(parser);
+    if (prefetched_blocks_.empty())
+    {
+        // End of file, or an error that ReadBlockBuffer() has reported.
+        return false;
+    }
+
+    current_block_ = std::move(prefetched_blocks_.front());
+    prefetched_blocks_.pop_front();
+    if (current_block_->parsed.valid())
+    {
+        current_block_->parsed.wait();
+    }
+    block_buffer = std::move(current_block_->block_buffer);
+    return true;
+}
+
+ParsedBlock DivePrefetchFileProcessor::ParseBlock(BlockParser& parser, BlockBuffer& block_buffer)
+{
+    if (current_block_ == nullptr || !current_block_->parsed_block.has_value())
+    {
+        return FileProcessor::ParseBlock(parser, block_buffer);
+    }
+
+    // Report errors on the decoding thread, in block order.
+    if (current_block_->error != kErrorNone)
+    {
+        HandleBlockReadError(current_block_->error, current_block_->error_message.c_str());
+    }
+    ParsedBlock parsed_block = std::move(*current_block_->parsed_block);
+    current_block_->parsed_block.reset();
+    return parsed_block;
+}
+
+void DivePrefetchFileProcessor::PrefetchBlocks(BlockParser& parser)
+{
+    while (!prefetch_paused_ && prefetched_blocks_.size() < prefetch_depth_)
+    {
+        uint64_t block_index = GetReadBlockIndex();
+        auto block = std::make_unique<PrefetchedBlock>();
+        if (!ReadBlockBuffer(parser, block->block_buffer))
+        {
+            // Return the failure once the blocks read before it are processed.
+            prefetch_paused_ = true;
+            prefetch_read_failed_ = !prefetched_blocks_.empty();
+            return;
+        }
+        prefetch_paused_ = PausesPrefetch(block->block_buffer);
+
+        if (format::IsBlockCompressed(block->block_buffer.Header().type) &&
+            block->block_buffer.IsValid())
+        {
+            PrefetchedBlock* target = block.get();
+            target->pool = util::HeapBufferPool::Create();
+            target->parser = std::make_unique<BlockParser>(
+                [target](BlockIOError error, const char* message) {
+                    // Keep the first error, as FileProcessor does.
+                    if (target->error == kErrorNone)
+                    {
+                        target->error = error;
+                        target->error_message = message;
+                    }
+                },
+                target->pool, compressor_.get());
+            target->parser->SetDecompressionPolicy(BlockParser::DecompressionPolicy::kAlways);
+            target->parser->SetBlockIndex(block_index);
+            target->parser->SetFrameNumber(current_frame_number_);
+            target->parser_view = BlockBuffer(target->block_buffer.MakeNonOwnedData());
+            target->parsed = prefetch_pool_->post([target]() {
+                target->parsed_block = target->parser->ParseBlock(target->parser_view);
+            });
+        }
+        prefetched_blocks_.push_back(std::move(block));
+    }
+}
+
+bool DivePrefetchFileProcessor::PausesPrefetch(const BlockBuffer& block_buffer) const
+{
+    // Frame delimiters end ProcessNextFrame(), which checks the input stream before continuing.
+    if (block_buffer.IsFrameDelimiter(*this))
+    {
+        return true;
+    }
+    switch (format::RemoveCompressedBlockBit(block_buffer.Header().type))
+    {
+        case format::BlockType::kFrameMarkerBlock:
+        case format::BlockType::kStateMarkerBlock:
+            return true;
+        case format::BlockType::kMetaDataBlock:
+        {
+            format::MetaDataId meta_data_id = 0;
+            return block_buffer.ReadAt(meta_data_id, sizeof(format::BlockHeader)) &&
+                   format::GetMetaDataType(meta_data_id) ==
+                       format::MetaDataType::kExecuteBlocksFromFile;
+        }
+        default:
+            return false;
+    }
+}
+
+GFXRECON_END_NAMESPACE(decode)
+GFXRECON_END_NAMESPACE(gfxrecon)
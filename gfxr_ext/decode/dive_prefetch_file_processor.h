@@ -0,0 +1,91 @@
+/*
+Copyright 2026 Google Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+// A file processor that reads blocks ahead of the decoders and parses and decompresses the
+// compressed ones on a pool of worker threads. The blocks are still decoded in file order on the
+// thread calling ProcessAllFrames(), which then only has to decode.
+//
+// Prefetching pauses after blocks that can change where or whether the next block is read (frame
+// delimiters, frame and state markers, which may loop back, and blocks that execute commands from
+// another file), and is not used while commands are executed from another file.
+
+// NOLINT(build/header_guard)
+#ifndef GFXRECON_DECODE_DIVE_PREFETCH_FILE_PROCESSOR_H
+#define GFXRECON_DECODE_DIVE_PREFETCH_FILE_PROCESSOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+#include "decode/block_parser.h"
+#include "decode/file_processor.h"
+#include "util/threadpool.h"
+
+GFXRECON_BEGIN_NAMESPACE(gfxrecon)
+GFXRECON_BEGIN_NAMESPACE(decode)
+
+class DivePrefetchFileProcessor : public FileProcessor
+{
+ public:
+    DivePrefetchFileProcessor();
+    // Stops processing after block `block_limit`, see FileProcessor.
+    explicit DivePrefetchFileProcessor(uint64_t block_limit);
+    ~DivePrefetchFileProcessor() override;
+
+    // Decompresses blocks on `worker_count` threads, keeping up to `depth` blocks read ahead of
+    // the decoders. 0 workers disables prefetching, which is the default. Must be called before
+    // processing starts.
+    void SetBlockPrefetch(size_t worker_count, size_t depth);
+
+    // Enables prefetching with one worker per spare hardware thread.
+    void EnableBlockPrefetch();
+
+ protected:
+    bool GetBlockBuffer(BlockParser& parser, BlockBuffer& block_buffer) override;
+
+    ParsedBlock ParseBlock(BlockParser& parser, BlockBuffer& block_buffer) override;
+
+    // Index of the next block that will be read from the file. It is ahead of block_index_ by the
+    // number of prefetched blocks.
+    uint64_t GetReadBlockIndex() const { return block_index_ + prefetched_blocks_.size(); }
+
+ private:
+    struct PrefetchedBlock;
+
+    // Reads blocks until the queue is full, prefetching is paused, or a read fails.
+    void PrefetchBlocks(BlockParser& parser);
+
+    // Whether no block should be read after `block_buffer` until it has been processed.
+    bool PausesPrefetch(const BlockBuffer& block_buffer) const;
+
+    std::unique_ptr<util::ThreadPool> prefetch_pool_;
+    size_t prefetch_depth_{0};
+
+    std::deque<std::unique_ptr<PrefetchedBlock>> prefetched_blocks_;
+    // The block being decoded. It owns the decompressed data of the ParsedBlock returned by
+    // ParseBlock(), so it is only released when the next block is requested.
+    std::unique_ptr<PrefetchedBlock> current_block_;
+
+    bool prefetch_paused_{false};
+    // Reading failed after the queued blocks; the failure is returned once they are processed.
+    bool prefetch_read_failed_{false};
+};
+
+GFXRECON_END_NAMESPACE(decode)
+GFXRECON_END_NAMESPACE(gfxrecon)
+
+#endif  // GFXRECON_DECODE_DIVE_PREFETCH_FILE_PROCESSOR_H
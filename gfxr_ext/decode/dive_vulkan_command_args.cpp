@@ -0,0 +1,620 @@
+/*
+ Copyright 2026 Google LLC
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include "dive_vulkan_command_args.h"
+
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace
+{
+
+// Most string values are enum names, which are shared by many commands. Flag combinations make
+// the set of names open-ended, so the table is bounded anyway.
+constexpr uint32_t kMaxInternedStrings = 1u << 16;
+
+// Returns true if `value` looks like a Vulkan enum name or a combination of flags, e.g.
+// "VK_SHADER_STAGE_VERTEX_BIT|VK_SHADER_STAGE_FRAGMENT_BIT". Other strings come from the app
+// (object names, entry points, application names) and are not worth sharing between captures.
+bool IsEnumName(std::string_view value)
+{
+    if (value.substr(0, 3) != "VK_")
+    {
+        return false;
+    }
+    for (char c : value)
+    {
+        if (!(c >= 'A' && c <= 'Z') && !(c >= '0' && c <= '9') && c != '_' && c != '|' && c != ' ')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Interned strings shared by the arguments of the commands of a capture. Vulkan structs only have a
+// few thousand distinct member names, and only enum names are interned as string values, so the
+// tables stay small.
+class InternTable
+{
+ public:
+    // Returns the id of `name`, adding it if needed, or nullopt if there are already `max_size`
+    // strings.
+    std::optional<uint32_t> Intern(std::string_view name, uint32_t max_size)
+    {
+        if (std::optional<uint32_t> id = Find(name))
+        {
+            return id;
+        }
+        std::unique_lock lock(m_mutex);
+        if (auto it = m_ids.find(name); it != m_ids.end())
+        {
+            return it->second;
+        }
+        if (m_names.size() >= max_size)
+        {
+            return std::nullopt;
+        }
+        uint32_t id = static_cast<uint32_t>(m_names.size());
+        // Deque elements are never moved, so the map can refer to them.
+        const std::string& stored_name = m_names.emplace_back(name);
+        m_ids.emplace(stored_name, id);
+        return id;
+    }
+
+    std::optional<uint32_t> Find(std::string_view name) const
+    {
+        std::shared_lock lock(m_mutex);
+        if (auto it = m_ids.find(name); it != m_ids.end())
+        {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    std::string_view GetName(uint32_t id) const
+    {
+        std::shared_lock lock(m_mutex);
+        return id < m_names.size() ? std::string_view(m_names[id]) : std::string_view();
+    }
+
+    std::vector<std::string> GetNames() const
+    {
+        std::shared_lock lock(m_mutex);
+        return std::vector<std::string>(m_names.begin(), m_names.end());
+    }
+
+ private:
+    mutable std::shared_mutex m_mutex;
+    std::deque<std::string> m_names;
+    std::unordered_map<std::string_view, uint32_t> m_ids;
+};
+
+}  // namespace
+
+class VulkanCommandArgs::Tables
+{
+ public:
+    InternTable keys;
+    InternTable strings;
+};
+
+namespace
+{
+
+// The tables that new arguments are interned in.
+std::mutex g_tables_mutex;
+std::shared_ptr<VulkanCommandArgs::Tables>& GetCurrentTablesLocked()
+{
+    static auto* tables = new std::shared_ptr<VulkanCommandArgs::Tables>(
+        std::make_shared<VulkanCommandArgs::Tables>());
+    return *tables;
+}
+
+std::shared_ptr<VulkanCommandArgs::Tables> GetCurrentTables()
+{
+    std::lock_guard lock(g_tables_mutex);
+    return GetCurrentTablesLocked();
+}
+
+}  // namespace
+
+//--------------------------------------------------------------------------------------------------
+VulkanCommandArgs::VulkanCommandArgs(const nlohmann::ordered_json& json)
+    : m_tables(GetCurrentTables())
+{
+    Append(json, kNoKey);
+    m_fields.shrink_to_fit();
+    m_strings.shrink_to_fit();
+}
+
+//--------------------------------------------------------------------------------------------------
+void VulkanCommandArgs::Append(const nlohmann::ordered_json& json, uint32_t key)
+{
+    size_t index = m_fields.size();
+    m_fields.push_back(Field{.key = key, .type = 0, .size = 0, .value = 0});
+    Type type = Type::kNull;
+    switch (json.type())
+    {
+        case nlohmann::ordered_json::value_t::boolean:
+            type = Type::kBool;
+            m_fields[index].value = json.get<bool>() ? 1 : 0;
+            break;
+        case nlohmann::ordered_json::value_t::number_integer:
+            type = Type::kInt;
+            m_fields[index].value = static_cast<uint64_t>(json.get<int64_t>());
+            break;
+        case nlohmann::ordered_json::value_t::number_unsigned:
+            type = Type::kUint;
+            m_fields[index].value = json.get<uint64_t>();
+            break;
+        case nlohmann::ordered_json::value_t::number_float:
+        {
+            type = Type::kDouble;
+            double value = json.get<double>();
+            std::memcpy(&m_fields[index].value, &value, sizeof(value));
+            break;
+        }
+        case nlohmann::ordered_json::value_t::string:
+        {
+            type = Type::kString;
+            const auto& value = json.get_ref<const std::string&>();
+            std::optional<uint32_t> id;
+            if (IsEnumName(value))
+            {
+                id = m_tables->strings.Intern(value, kMaxInternedStrings);
+            }
+            if (id)
+            {
+                m_fields[index].value = *id;
+            }
+            else
+            {
+                // Keep the string with the command, so it is freed with the capture.
+                m_fields[index].value = m_strings.size();
+                m_fields[index].size = static_cast<uint32_t>(value.size());
+                m_strings.append(value);
+                type = Type::kLocalString;
+            }
+            break;
+        }
+        case nlohmann::ordered_json::value_t::object:
+            type = Type::kObject;
+            for (const auto& [child_key, child] : json.items())
+            {
+                std::optional<uint32_t> id = m_tables->keys.Intern(child_key, kNoKey);
+                Append(child, id.value_or(kNoKey));
+            }
+            m_fields[index].value = json.size();
+            m_fields[index].size = static_cast<uint32_t>(m_fields.size() - index - 1);
+            break;
+        case nlohmann::ordered_json::value_t::array:
+            type = Type::kArray;
+            for (const auto& child : json)
+            {
+                Append(child, kNoKey);
+            }
+            m_fields[index].value = json.size();
+            m_fields[index].size = static_cast<uint32_t>(m_fields.size() - index - 1);
+            break;
+        default:
+            break;
+    }
+    m_fields[index].type = static_cast<uint32_t>(type);
+}
+
+//--------------------------------------------------------------------------------------------------
+VulkanCommandArgs::Value VulkanCommandArgs::GetRoot() const
+{
+    if (m_fields.empty())
+    {
+        return Value();
+    }
+    return Value(this, 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+size_t VulkanCommandArgs::GetMemoryUsage() const
+{
+    return m_fields.capacity() * sizeof(Field) + m_strings.capacity();
+}
+
+//--------------------------------------------------------------------------------------------------
+void VulkanCommandArgs::ResetSharedTables()
+{
+    std::lock_guard lock(g_tables_mutex);
+    GetCurrentTablesLocked() = std::make_shared<Tables>();
+}
+
+//--------------------------------------------------------------------------------------------------
+VulkanCommandArgs::SharedTables VulkanCommandArgs::GetSharedTables()
+{
+    std::shared_ptr<Tables> tables = GetCurrentTables();
+    return SharedTables{.keys = tables->keys.GetNames(), .strings = tables->strings.GetNames()};
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<VulkanCommandArgs::IdRemap> VulkanCommandArgs::InternSharedTables(
+    const SharedTables& tables)
+{
+    IdRemap remap;
+    remap.tables = GetCurrentTables();
+    remap.keys.reserve(tables.keys.size());
+    for (const std::string& key : tables.keys)
+    {
+        std::optional<uint32_t> id = remap.tables->keys.Intern(key, kNoKey);
+        if (!id)
+        {
+            return std::nullopt;
+        }
+        remap.keys.push_back(*id);
+    }
+    remap.strings.reserve(tables.strings.size());
+    for (const std::string& string : tables.strings)
+    {
+        std::optional<uint32_t> id = remap.tables->strings.Intern(string, kMaxInternedStrings);
+        if (!id)
+        {
+            return std::nullopt;
+        }
+        remap.strings.push_back(*id);
+    }
+    return remap;
+}
+
+//--------------------------------------------------------------------------------------------------
+uint32_t VulkanCommandArgs::SavedTables::Add(std::string_view name, std::vector<std::string>& names,
+                                             std::unordered_map<std::string, uint32_t>& ids)
+{
+    auto [it, inserted] = ids.try_emplace(std::string(name), static_cast<uint32_t>(names.size()));
+    if (inserted)
+    {
+        names.emplace_back(name);
+    }
+    return it->second;
+}
+
+//--------------------------------------------------------------------------------------------------
+void VulkanCommandArgs::Save(std::string& out, SavedTables& tables) const
+{
+    // Ids are saved as indices in `tables`, which only hold the names used by saved arguments.
+    std::vector<Field> fields = m_fields;
+    for (Field& field : fields)
+    {
+        if (field.key != kNoKey)
+        {
+            field.key = SavedTables::Add(m_tables->keys.GetName(field.key), tables.m_tables.keys,
+                                         tables.m_key_ids);
+        }
+        if (static_cast<Type>(field.type) == Type::kString)
+        {
+            field.value = SavedTables::Add(
+                m_tables->strings.GetName(static_cast<uint32_t>(field.value)),
+                tables.m_tables.strings, tables.m_string_ids);
+        }
+    }
+
+    uint32_t num_fields = static_cast<uint32_t>(fields.size());
+    uint32_t strings_size = static_cast<uint32_t>(m_strings.size());
+    out.append(reinterpret_cast<const char*>(&num_fields), sizeof(num_fields));
+    out.append(reinterpret_cast<const char*>(&strings_size), sizeof(strings_size));
+    out.append(reinterpret_cast<const char*>(fields.data()), fields.size() * sizeof(Field));
+    out.append(m_strings);
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<VulkanCommandArgs> VulkanCommandArgs::Load(const char*& data, const char* end,
+                                                         const IdRemap& remap)
+{
+    uint32_t num_fields = 0;
+    uint32_t strings_size = 0;
+    if (end - data < static_cast<ptrdiff_t>(sizeof(num_fields) + sizeof(strings_size)))
+    {
+        return std::nullopt;
+    }
+    std::memcpy(&num_fields, data, sizeof(num_fields));
+    std::memcpy(&strings_size, data + sizeof(num_fields), sizeof(strings_size));
+    const char* fields_data = data + sizeof(num_fields) + sizeof(strings_size);
+    uint64_t fields_size = uint64_t{num_fields} * sizeof(Field);
+    if (static_cast<uint64_t>(end - fields_data) < fields_size + strings_size)
+    {
+        return std::nullopt;
+    }
+
+    if (num_fields != 0 && remap.tables == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    VulkanCommandArgs args;
+    args.m_tables = remap.tables;
+    args.m_fields.resize(num_fields);
+    if (num_fields != 0)
+    {
+        std::memcpy(args.m_fields.data(), fields_data, fields_size);
+    }
+    args.m_strings.assign(fields_data + fields_size, strings_size);
+    for (size_t i = 0; i < args.m_fields.size(); ++i)
+    {
+        Field& field = args.m_fields[i];
+        if (field.key != kNoKey)
+        {
+            if (field.key >= remap.keys.size())
+            {
+                return std::nullopt;
+            }
+            field.key = remap.keys[field.key];
+        }
+        switch (static_cast<Type>(field.type))
+        {
+            case Type::kString:
+                if (field.value >= remap.strings.size())
+                {
+                    return std::nullopt;
+                }
+                field.value = remap.strings[field.value];
+                break;
+            case Type::kLocalString:
+                if (field.value + field.size > strings_size)
+                {
+                    return std::nullopt;
+                }
+                break;
+            case Type::kObject:
+            case Type::kArray:
+                // Checked by IsWellFormed() below.
+                break;
+            case Type::kNull:
+            case Type::kBool:
+            case Type::kInt:
+            case Type::kUint:
+            case Type::kDouble:
+                break;
+            default:
+                return std::nullopt;
+        }
+    }
+    if (!args.IsWellFormed())
+    {
+        return std::nullopt;
+    }
+    data = fields_data + fields_size + strings_size;
+    return args;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool VulkanCommandArgs::IsWellFormed() const
+{
+    if (m_fields.empty())
+    {
+        return true;
+    }
+
+    // The objects and arrays that contain the current field, with the index of their end and the
+    // number of children that are still expected. Values only walk `value` children by skipping
+    // over `size` descendants, so both have to agree for them to stay within the fields.
+    struct Parent
+    {
+        uint64_t end;
+        uint64_t remaining_children;
+    };
+    std::vector<Parent> parents;
+    for (size_t i = 0; i < m_fields.size(); ++i)
+    {
+        const Field& field = m_fields[i];
+        uint64_t parent_end = m_fields.size();
+        if (i != 0)
+        {
+            // Only the root can be outside of any object or array.
+            if (parents.empty() || parents.back().remaining_children == 0)
+            {
+                return false;
+            }
+            --parents.back().remaining_children;
+            parent_end = parents.back().end;
+        }
+
+        Type type = static_cast<Type>(field.type);
+        bool is_container = type == Type::kObject || type == Type::kArray;
+        uint64_t end = i + 1;
+        if (is_container)
+        {
+            end += field.size;
+        }
+        if (end > parent_end || (i == 0 && end != m_fields.size()))
+        {
+            return false;
+        }
+        if (is_container)
+        {
+            // Each child takes at least one field.
+            if (field.value > field.size)
+            {
+                return false;
+            }
+            parents.push_back(Parent{.end = end, .remaining_children = field.value});
+        }
+
+        while (!parents.empty() && parents.back().end == i + 1)
+        {
+            if (parents.back().remaining_children != 0)
+            {
+                return false;
+            }
+            parents.pop_back();
+        }
+    }
+    return parents.empty();
+}
+
+//--------------------------------------------------------------------------------------------------
+VulkanCommandArgs::Type VulkanCommandArgs::Value::GetType() const
+{
+    return static_cast<Type>(m_args->m_fields[m_index].type);
+}
+
+//--------------------------------------------------------------------------------------------------
+std::string_view VulkanCommandArgs::Value::GetKey() const
+{
+    if (!IsValid() || m_args->m_fields[m_index].key == kNoKey)
+    {
+        return {};
+    }
+    return m_args->m_tables->keys.GetName(m_args->m_fields[m_index].key);
+}
+
+//--------------------------------------------------------------------------------------------------
+size_t VulkanCommandArgs::Value::Size() const
+{
+    if (!IsObject() && !IsArray())
+    {
+        return 0;
+    }
+    return m_args->m_fields[m_index].value;
+}
+
+//--------------------------------------------------------------------------------------------------
+uint32_t VulkanCommandArgs::Value::GetEnd() const
+{
+    const Field& field = m_args->m_fields[m_index];
+    if (IsObject() || IsArray())
+    {
+        return m_index + 1 + field.size;
+    }
+    return m_index + 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+VulkanCommandArgs::Value VulkanCommandArgs::Value::Find(std::string_view key) const
+{
+    if (!IsObject())
+    {
+        return Value();
+    }
+    std::optional<uint32_t> id = m_args->m_tables->keys.Find(key);
+    if (!id)
+    {
+        return Value();
+    }
+    size_t count = Size();
+    uint32_t child = m_index + 1;
+    for (size_t i = 0; i < count; ++i)
+    {
+        Value value(m_args, child);
+        if (m_args->m_fields[child].key == *id)
+        {
+            return value;
+        }
+        child = value.GetEnd();
+    }
+    return Value();
+}
+
+//--------------------------------------------------------------------------------------------------
+VulkanCommandArgs::Value VulkanCommandArgs::Value::At(size_t index) const
+{
+    if (index >= Size())
+    {
+        return Value();
+    }
+    uint32_t child = m_index + 1;
+    for (size_t i = 0; i < index; ++i)
+    {
+        child = Value(m_args, child).GetEnd();
+    }
+    return Value(m_args, child);
+}
+
+//--------------------------------------------------------------------------------------------------
+std::string_view VulkanCommandArgs::Value::GetString() const
+{
+    if (!IsString())
+    {
+        return {};
+    }
+    const Field& field = m_args->m_fields[m_index];
+    if (GetType() == Type::kLocalString)
+    {
+        return std::string_view(m_args->m_strings).substr(field.value, field.size);
+    }
+    return m_args->m_tables->strings.GetName(static_cast<uint32_t>(field.value));
+}
+
+//--------------------------------------------------------------------------------------------------
+uint64_t VulkanCommandArgs::Value::GetUint64() const
+{
+    if (!IsValid())
+    {
+        return 0;
+    }
+    switch (GetType())
+    {
+        case Type::kBool:
+        case Type::kInt:
+        case Type::kUint:
+            return m_args->m_fields[m_index].value;
+        default:
+            return 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+std::string VulkanCommandArgs::Value::Dump() const { return ToJson().dump(); }
+
+//--------------------------------------------------------------------------------------------------
+nlohmann::ordered_json VulkanCommandArgs::Value::ToJson() const
+{
+    if (!IsValid())
+    {
+        return nullptr;
+    }
+    const Field& field = m_args->m_fields[m_index];
+    switch (GetType())
+    {
+        case Type::kNull:
+            return nullptr;
+        case Type::kBool:
+            return field.value != 0;
+        case Type::kInt:
+            return static_cast<int64_t>(field.value);
+        case Type::kUint:
+            return field.value;
+        case Type::kDouble:
+        {
+            double value;
+            std::memcpy(&value, &field.value, sizeof(value));
+            return value;
+        }
+        case Type::kString:
+        case Type::kLocalString:
+            return std::string(GetString());
+        case Type::kObject:
+        {
+            nlohmann::ordered_json json = nlohmann::ordered_json::object();
+            ForEachChild(
+                [&](const Value& child) { json[std::string(child.GetKey())] = child.ToJson(); });
+            return json;
+        }
+        case Type::kArray:
+        {
+            nlohmann::ordered_json json = nlohmann::ordered_json::array();
+            ForEachChild([&](const Value& child) { json.push_back(child.ToJson()); });
+            return json;
+        }
+    }
+    return nullptr;
+}
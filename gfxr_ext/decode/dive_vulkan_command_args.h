@@ -0,0 +1,216 @@
+/*
+ Copyright 2026 Google LLC
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+// VulkanCommandArgs is a compact, read-only copy of the JSON arguments that GFXR decodes for a
+// Vulkan command. A capture holds one per command, so keeping them as nlohmann::ordered_json trees
+// costs about a hundred bytes per value. Instead, the tree is flattened in pre-order into one
+// array of 16-byte fields, and object keys and enum names are interned in tables shared by the
+// commands of a capture. Other strings, such as object names set by the app, are stored with the
+// command. Each VulkanCommandArgs keeps its tables alive, so they are freed with the capture. The
+// arguments are walked in place with Value, and ToJson() rebuilds the JSON of a single command
+// when it is needed.
+class VulkanCommandArgs
+{
+ public:
+    enum class Type : uint8_t
+    {
+        kNull,
+        kBool,
+        kInt,
+        kUint,
+        kDouble,
+        kString,
+        // A string stored with the command rather than in the shared string table.
+        kLocalString,
+        kObject,
+        kArray,
+    };
+
+    // A read-only view of one value. Views are invalidated when their VulkanCommandArgs is
+    // destroyed or moved.
+    class Value
+    {
+     public:
+        // A view of no value, returned by Find() for missing keys.
+        Value() = default;
+
+        bool IsValid() const { return m_args != nullptr; }
+        Type GetType() const;
+        bool IsObject() const { return IsValid() && GetType() == Type::kObject; }
+        bool IsArray() const { return IsValid() && GetType() == Type::kArray; }
+        bool IsString() const
+        {
+            return IsValid() && (GetType() == Type::kString || GetType() == Type::kLocalString);
+        }
+        bool IsPrimitive() const { return IsValid() && !IsObject() && !IsArray(); }
+
+        // Key of this value inside its parent object, empty for array elements.
+        std::string_view GetKey() const;
+
+        // Number of members of an object or elements of an array, 0 otherwise.
+        size_t Size() const;
+        bool Empty() const { return Size() == 0; }
+
+        // Returns the member `key` of an object, or an invalid Value.
+        Value Find(std::string_view key) const;
+        bool Contains(std::string_view key) const { return Find(key).IsValid(); }
+
+        // Returns the `index`th member or element. `index` must be lower than Size().
+        Value At(size_t index) const;
+
+        // Calls `callback(Value)` for each member of an object or element of an array.
+        template<typename Callback> void ForEachChild(Callback&& callback) const
+        {
+            if (!IsObject() && !IsArray())
+            {
+                return;
+            }
+            size_t count = Size();
+            uint32_t child = m_index + 1;
+            for (size_t i = 0; i < count; ++i)
+            {
+                Value value(m_args, child);
+                callback(value);
+                child = value.GetEnd();
+            }
+        }
+
+        // Typed accessors; they return the default value if the type does not match.
+        std::string_view GetString() const;
+        uint64_t GetUint64() const;
+
+        // Same text as nlohmann::json::dump() of the value.
+        std::string Dump() const;
+
+        // Converts this value and its children back to JSON.
+        nlohmann::ordered_json ToJson() const;
+
+     private:
+        friend class VulkanCommandArgs;
+        Value(const VulkanCommandArgs* args, uint32_t index) : m_args(args), m_index(index) {}
+
+        // Index of the first field after this value and its children.
+        uint32_t GetEnd() const;
+
+        const VulkanCommandArgs* m_args = nullptr;
+        uint32_t m_index = 0;
+    };
+
+    VulkanCommandArgs() = default;
+
+    // Flattens `json`. Interning in the shared tables is thread-safe.
+    explicit VulkanCommandArgs(const nlohmann::ordered_json& json);
+
+    // Starts new shared tables for the arguments created or loaded from now on, e.g. when another
+    // capture is loaded. Existing arguments keep referring to the tables they were interned in,
+    // which are freed along with the last of them.
+    static void ResetSharedTables();
+
+    // The root value, or an invalid Value if there are no arguments.
+    Value GetRoot() const;
+
+    // Rebuilds the JSON arguments.
+    nlohmann::ordered_json ToJson() const { return GetRoot().ToJson(); }
+
+    // Approximate heap memory used by these arguments, excluding the shared tables.
+    size_t GetMemoryUsage() const;
+
+    // Saving and loading, e.g. for the GFXR capture index. Fields refer to the shared tables by
+    // id, so the keys and strings that the saved arguments use are saved along with them, and the
+    // ids are remapped when they are loaded in another process.
+    struct SharedTables
+    {
+        std::vector<std::string> keys;
+        std::vector<std::string> strings;
+    };
+    class Tables;
+    struct IdRemap
+    {
+        std::vector<uint32_t> keys;
+        std::vector<uint32_t> strings;
+        // The tables that the ids are remapped to.
+        std::shared_ptr<Tables> tables;
+    };
+
+    // Collects the keys and strings that saved arguments refer to, so that only those are saved
+    // rather than the shared tables, which may also hold the names of other captures.
+    class SavedTables
+    {
+     public:
+        // The ids in the saved fields are indices in these tables.
+        const SharedTables& GetTables() const { return m_tables; }
+
+     private:
+        friend class VulkanCommandArgs;
+        static uint32_t Add(std::string_view name, std::vector<std::string>& names,
+                            std::unordered_map<std::string, uint32_t>& ids);
+
+        SharedTables m_tables;
+        std::unordered_map<std::string, uint32_t> m_key_ids;
+        std::unordered_map<std::string, uint32_t> m_string_ids;
+    };
+
+    // Returns the shared tables; they cover every VulkanCommandArgs created since the last reset.
+    static SharedTables GetSharedTables();
+
+    // Interns saved tables in the shared tables of this process. Returns nullopt if they are full.
+    static std::optional<IdRemap> InternSharedTables(const SharedTables& tables);
+
+    // Appends the binary form of the arguments to `out`, and adds the keys and strings they refer
+    // to to `tables`.
+    void Save(std::string& out, SavedTables& tables) const;
+
+    // Loads arguments saved by Save() at `data`, and advances `data` past them. Returns nullopt if
+    // the data is truncated, is not a well-formed tree, or refers to ids missing from `remap`.
+    static std::optional<VulkanCommandArgs> Load(const char*& data, const char* end,
+                                                 const IdRemap& remap);
+
+ private:
+    struct Field
+    {
+        // Interned key, or kNoKey for array elements and the root.
+        uint32_t key : 24;
+        uint32_t type : 8;
+        // For objects and arrays: number of fields of the descendants, to skip over them.
+        // For local strings: length in m_strings.
+        uint32_t size;
+        // Bool, integer or double bits; id in the string table for strings, or offset in
+        // m_strings for local strings; number of children for objects and arrays.
+        uint64_t value;
+    };
+    static_assert(sizeof(Field) == 16);
+
+    static constexpr uint32_t kNoKey = (1u << 24) - 1;
+
+    void Append(const nlohmann::ordered_json& json, uint32_t key);
+
+    // Returns true if the fields form a single tree in which each object or array has exactly
+    // `value` children within its `size` descendants.
+    bool IsWellFormed() const;
+
+    std::vector<Field> m_fields;
+    std::string m_strings;
+    std::shared_ptr<Tables> m_tables;
+};
@@ -0,0 +1,250 @@
+/*
+ Copyright 2026 Google LLC
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ http://www.apache.org/licenses/LICENSE-2.0
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include "dive_vulkan_command_args.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <optional>
+#include <string>
+
+namespace
+{
+
+nlohmann::ordered_json CreateBeginRenderPassArgs()
+{
+    return {{"commandBuffer", 1001u},
+            {"pRenderPassBegin",
+             {{"sType", "VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO"},
+              {"renderPass", 42u},
+              {"renderArea", {{"offset", {{"x", 0}, {"y", -4}}}, {"extent", {{"width", 1920u}}}}},
+              {"clearValueCount", 2u},
+              {"pClearValues", {{{"color", {0.25, 0.5, 1.0, 1.0}}}, nullptr}},
+              {"flags", true}}},
+            {"contents", "VK_SUBPASS_CONTENTS_INLINE"}};
+}
+
+TEST(VulkanCommandArgsTest, RoundTripsToJson)
+{
+    nlohmann::ordered_json json = CreateBeginRenderPassArgs();
+    VulkanCommandArgs args(json);
+    EXPECT_EQ(args.ToJson(), json);
+    // Key order is preserved.
+    EXPECT_EQ(args.ToJson().dump(), json.dump());
+}
+
+TEST(VulkanCommandArgsTest, EmptyArgs)
+{
+    VulkanCommandArgs args;
+    EXPECT_FALSE(args.GetRoot().IsValid());
+    EXPECT_TRUE(args.ToJson().is_null());
+
+    VulkanCommandArgs empty_object(nlohmann::ordered_json::object());
+    EXPECT_TRUE(empty_object.GetRoot().IsObject());
+    EXPECT_TRUE(empty_object.GetRoot().Empty());
+    EXPECT_EQ(empty_object.ToJson(), nlohmann::ordered_json::object());
+}
+
+TEST(VulkanCommandArgsTest, FindsMembersAndElements)
+{
+    VulkanCommandArgs args(CreateBeginRenderPassArgs());
+    VulkanCommandArgs::Value root = args.GetRoot();
+    ASSERT_TRUE(root.IsObject());
+    EXPECT_EQ(root.Size(), 3u);
+
+    EXPECT_EQ(root.Find("commandBuffer").GetUint64(), 1001u);
+    EXPECT_EQ(root.Find("contents").GetString(), "VK_SUBPASS_CONTENTS_INLINE");
+    EXPECT_FALSE(root.Find("missing").IsValid());
+    EXPECT_FALSE(root.Find("commandBuffer").Find("x").IsValid());
+
+    VulkanCommandArgs::Value begin = root.Find("pRenderPassBegin");
+    EXPECT_EQ(begin.GetKey(), "pRenderPassBegin");
+    // Members after a nested object are found by skipping over it.
+    EXPECT_EQ(begin.Find("clearValueCount").GetUint64(), 2u);
+    EXPECT_EQ(begin.Find("renderArea").Find("offset").Find("y").Dump(), "-4");
+
+    VulkanCommandArgs::Value clear_values = begin.Find("pClearValues");
+    ASSERT_TRUE(clear_values.IsArray());
+    ASSERT_EQ(clear_values.Size(), 2u);
+    EXPECT_EQ(clear_values.At(0).Find("color").At(1).Dump(), "0.5");
+    EXPECT_EQ(clear_values.At(1).Dump(), "null");
+    EXPECT_FALSE(clear_values.At(2).IsValid());
+    EXPECT_EQ(clear_values.At(1).GetKey(), "");
+}
+
+TEST(VulkanCommandArgsTest, DumpMatchesJson)
+{
+    nlohmann::ordered_json json = CreateBeginRenderPassArgs();
+    VulkanCommandArgs args(json);
+    std::vector<std::string> dumped;
+    args.GetRoot().Find("pRenderPassBegin").ForEachChild([&](const VulkanCommandArgs::Value& val) {
+        dumped.push_back(std::string(val.GetKey()) + ":" + val.Dump());
+    });
+    std::vector<std::string> expected;
+    for (const auto& [key, val] : json["pRenderPassBegin"].items())
+    {
+        expected.push_back(key + ":" + val.dump());
+    }
+    EXPECT_EQ(dumped, expected);
+}
+
+TEST(VulkanCommandArgsTest, SharesKeysBetweenCommands)
+{
+    VulkanCommandArgs first({{"commandBuffer", 1u}, {"firstSet", 0u}});
+    VulkanCommandArgs second({{"firstSet", 3u}, {"commandBuffer", 2u}});
+    EXPECT_EQ(first.GetRoot().Find("firstSet").GetUint64(), 0u);
+    EXPECT_EQ(second.GetRoot().Find("firstSet").GetUint64(), 3u);
+    EXPECT_EQ(second.GetRoot().At(1).GetKey(), "commandBuffer");
+}
+
+TEST(VulkanCommandArgsTest, OnlySharesEnumNames)
+{
+    VulkanCommandArgs args({{"objectType", "VK_OBJECT_TYPE_IMAGE"},
+                            {"stageFlags", "VK_SHADER_STAGE_VERTEX_BIT|VK_SHADER_STAGE_ALL"},
+                            {"pObjectName", "OnlySharesEnumNames shadow map"},
+                            {"pName", "main"}});
+    VulkanCommandArgs::Value root = args.GetRoot();
+    EXPECT_EQ(root.Find("objectType").GetType(), VulkanCommandArgs::Type::kString);
+    EXPECT_EQ(root.Find("stageFlags").GetType(), VulkanCommandArgs::Type::kString);
+    EXPECT_EQ(root.Find("pObjectName").GetType(), VulkanCommandArgs::Type::kLocalString);
+    EXPECT_EQ(root.Find("pObjectName").GetString(), "OnlySharesEnumNames shadow map");
+    EXPECT_EQ(root.Find("pName").GetType(), VulkanCommandArgs::Type::kLocalString);
+
+    std::vector<std::string> strings = VulkanCommandArgs::GetSharedTables().strings;
+    EXPECT_THAT(strings, ::testing::Contains("VK_OBJECT_TYPE_IMAGE"));
+    EXPECT_THAT(strings, ::testing::Not(::testing::Contains("OnlySharesEnumNames shadow map")));
+}
+
+TEST(VulkanCommandArgsTest, SavesAndLoads)
+{
+    nlohmann::ordered_json json = CreateBeginRenderPassArgs();
+    VulkanCommandArgs args(json);
+    std::string saved;
+    VulkanCommandArgs::SavedTables tables;
+    args.Save(saved, tables);
+    VulkanCommandArgs().Save(saved, tables);
+
+    std::optional<VulkanCommandArgs::IdRemap> remap =
+        VulkanCommandArgs::InternSharedTables(tables.GetTables());
+    ASSERT_TRUE(remap.has_value());
+
+    const char* data = saved.data();
+    const char* end = saved.data() + saved.size();
+    std::optional<VulkanCommandArgs> loaded = VulkanCommandArgs::Load(data, end, *remap);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->ToJson().dump(), json.dump());
+    std::optional<VulkanCommandArgs> loaded_empty = VulkanCommandArgs::Load(data, end, *remap);
+    ASSERT_TRUE(loaded_empty.has_value());
+    EXPECT_FALSE(loaded_empty->GetRoot().IsValid());
+    EXPECT_EQ(data, end);
+
+    // Truncated data and unknown ids are rejected.
+    data = saved.data();
+    EXPECT_FALSE(VulkanCommandArgs::Load(data, saved.data() + 20, *remap).has_value());
+    data = saved.data();
+    EXPECT_FALSE(VulkanCommandArgs::Load(data, end, VulkanCommandArgs::IdRemap{}).has_value());
+}
+
+TEST(VulkanCommandArgsTest, SavesOnlyReferencedNames)
+{
+    VulkanCommandArgs unsaved({{"unsavedKey", "VK_UNSAVED_NAME"}, {"sharedKey", 1u}});
+    VulkanCommandArgs first({{"sharedKey", 2u}, {"firstKey", "VK_FIRST_NAME"}});
+    VulkanCommandArgs second(
+        nlohmann::ordered_json{{"secondKey", {{"sharedKey", "VK_FIRST_NAME"}}}});
+
+    std::string saved;
+    VulkanCommandArgs::SavedTables tables;
+    first.Save(saved, tables);
+    second.Save(saved, tables);
+    // Names are numbered in the order they are first saved, whatever their shared ids.
+    EXPECT_THAT(tables.GetTables().keys,
+                ::testing::ElementsAre("sharedKey", "firstKey", "secondKey"));
+    EXPECT_THAT(tables.GetTables().strings, ::testing::ElementsAre("VK_FIRST_NAME"));
+
+    std::optional<VulkanCommandArgs::IdRemap> remap =
+        VulkanCommandArgs::InternSharedTables(tables.GetTables());
+    ASSERT_TRUE(remap.has_value());
+    const char* data = saved.data();
+    const char* end = saved.data() + saved.size();
+    std::optional<VulkanCommandArgs> loaded_first = VulkanCommandArgs::Load(data, end, *remap);
+    std::optional<VulkanCommandArgs> loaded_second = VulkanCommandArgs::Load(data, end, *remap);
+    ASSERT_TRUE(loaded_first.has_value());
+    ASSERT_TRUE(loaded_second.has_value());
+    EXPECT_EQ(loaded_first->ToJson(), first.ToJson());
+    EXPECT_EQ(loaded_second->ToJson(), second.ToJson());
+}
+
+TEST(VulkanCommandArgsTest, RejectsMalformedTrees)
+{
+    // Fields: the root object, the array and its two elements.
+    std::string saved;
+    VulkanCommandArgs::SavedTables tables;
+    VulkanCommandArgs(nlohmann::ordered_json{{"RejectsMalformedTrees", {1u, 2u}}})
+        .Save(saved, tables);
+    std::optional<VulkanCommandArgs::IdRemap> remap =
+        VulkanCommandArgs::InternSharedTables(tables.GetTables());
+    ASSERT_TRUE(remap.has_value());
+
+    // Returns `saved` with the size and number of children of field `index` replaced.
+    auto patch = [&](size_t index, uint32_t size, uint64_t children) {
+        constexpr size_t kHeaderSize = 8;
+        constexpr size_t kFieldSize = 16;
+        std::string patched = saved;
+        char* field = patched.data() + kHeaderSize + index * kFieldSize;
+        std::memcpy(field + 4, &size, sizeof(size));
+        std::memcpy(field + 8, &children, sizeof(children));
+        return patched;
+    };
+    auto load = [&](const std::string& data) {
+        const char* begin = data.data();
+        return VulkanCommandArgs::Load(begin, data.data() + data.size(), *remap).has_value();
+    };
+
+    EXPECT_TRUE(load(patch(1, 2, 2)));
+    // More children than the descendants can hold.
+    EXPECT_FALSE(load(patch(1, 2, 3)));
+    EXPECT_FALSE(load(patch(0, 3, 4)));
+    // Fewer children than the descendants hold.
+    EXPECT_FALSE(load(patch(1, 2, 1)));
+    // Children that don't fit in their parent.
+    EXPECT_FALSE(load(patch(1, 1, 1)));
+    EXPECT_FALSE(load(patch(0, 2, 1)));
+    // Descendants past the last field.
+    EXPECT_FALSE(load(patch(1, 3, 2)));
+    EXPECT_FALSE(load(patch(0, 4, 1)));
+}
+
+TEST(VulkanCommandArgsTest, ResetSharedTables)
+{
+    VulkanCommandArgs before(
+        nlohmann::ordered_json{{"ResetSharedTablesBefore", "VK_RESET_SHARED_TABLES_BEFORE"}});
+    VulkanCommandArgs::ResetSharedTables();
+    VulkanCommandArgs after(
+        nlohmann::ordered_json{{"ResetSharedTablesAfter", "VK_RESET_SHARED_TABLES_AFTER"}});
+
+    VulkanCommandArgs::SharedTables tables = VulkanCommandArgs::GetSharedTables();
+    EXPECT_THAT(tables.keys, ::testing::ElementsAre("ResetSharedTablesAfter"));
+    EXPECT_THAT(tables.strings, ::testing::ElementsAre("VK_RESET_SHARED_TABLES_AFTER"));
+
+    // Arguments created before the reset still refer to their own tables.
+    EXPECT_EQ(before.GetRoot().Find("ResetSharedTablesBefore").GetString(),
+              "VK_RESET_SHARED_TABLES_BEFORE");
+    EXPECT_EQ(before.GetRoot().At(0).GetKey(), "ResetSharedTablesBefore");
+    EXPECT_EQ(after.GetRoot().Find("ResetSharedTablesAfter").GetString(),
+              "VK_RESET_SHARED_TABLES_AFTER");
+    EXPECT_FALSE(after.GetRoot().Find("ResetSharedTablesBefore").IsValid());
+}
+
+}  // namespace
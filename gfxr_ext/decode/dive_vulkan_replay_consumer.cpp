@@ -481,12 +481,23 @@ void DiveVulkanReplayConsumer::Process_vkQueueSubmit(
     {
         if (submit_status.contains_frame_boundary)
         {
-            GFXRECON_LOG_INFO(gpu_time_.GetStatsString().c_str());
-            gpu_time_stats_csv_str_ = gpu_time_.GetStatsCSVString();
+            UpdateGPUTimeStats();
         }
     }
 }
 
+void DiveVulkanReplayConsumer::UpdateGPUTimeStats()
+{
+    GFXRECON_LOG_INFO(gpu_time_.GetStatsString().c_str());
+    gpu_time_stats_csv_str_ = gpu_time_.GetStatsCSVString();
+    if (!gpu_time_.IsEnabled())
+    {
+        return;
+    }
+    gpu_time_distribution_csv_str_ = gpu_time_.GetDistributionCSVString();
+    gpu_time_converged_ = gpu_time_.HasConverged();
+}
+
 void DiveVulkanReplayConsumer::Process_vkQueuePresentKHR(
     const ApiCallInfo& call_info, VkResult returnValue, format::HandleId queue,
     StructPointerDecoder<Decoded_VkPresentInfoKHR>* pPresentInfo)
@@ -503,8 +514,7 @@ void DiveVulkanReplayConsumer::Process_vkQueuePresentKHR(
     }
     else
     {
-        GFXRECON_LOG_INFO(gpu_time_.GetStatsString().c_str());
-        gpu_time_stats_csv_str_ = gpu_time_.GetStatsCSVString();
+        UpdateGPUTimeStats();
     }
 
     /********************************************************************************************/
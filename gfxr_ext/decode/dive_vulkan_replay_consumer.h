@@ -228,7 +228,21 @@ class DiveVulkanReplayConsumer : public VulkanReplayConsumer
         return gpu_time_stats_csv_header_str_ + gpu_time_stats_csv_str_;
     }
 
+    // Per-frame distributions of the GPU times over the looped frames, see
+    // Dive::GPUTime::GetDistributionCSVString().
+    std::string GetGPUTimeDistributionCSVStr() const
+    {
+        return gpu_time_distribution_csv_header_str_ + gpu_time_distribution_csv_str_;
+    }
+
+    // Whether the GPU times have converged as of the last frame, so that looping can stop early.
+    // Always false unless GPU time is enabled.
+    bool HasGPUTimeConverged() const { return gpu_time_converged_; }
+
  private:
+    // Updates the GPU time stats after a frame has completed.
+    void UpdateGPUTimeStats();
+
     // Keeps the fences status after setup phase
     enum class FenceStatus
     {
@@ -259,6 +273,11 @@ class DiveVulkanReplayConsumer : public VulkanReplayConsumer
     Dive::GPUTime gpu_time_;
     std::string gpu_time_stats_csv_header_str_ = "Type,Id,Mean [ms],Median [ms]\n";
     std::string gpu_time_stats_csv_str_ = "";
+    std::string gpu_time_distribution_csv_header_str_ =
+        "Type,Id,Warm-up Frames,Frames,Mean [ms],Median [ms],Stddev [ms],Min [ms],Max [ms],"
+        "95% CI [ms],Histogram\n";
+    std::string gpu_time_distribution_csv_str_ = "";
+    bool gpu_time_converged_ = false;
     VkDevice device_ = VK_NULL_HANDLE;
     // Cache all vk function pointers
     PFN_vkResetQueryPool pfn_vkResetQueryPool_ = nullptr;
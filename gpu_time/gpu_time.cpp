@@ -277,6 +277,52 @@ size_t GPUTime::FrameMetrics::GetCmdRenderPassCount(size_t index) const
     return m_cmd_renderpass_count_vec[index];
 }
 
+TimingDistribution GPUTime::FrameMetrics::GetFrameTimeDistribution() const
+{
+    return ComputeTimingDistribution(m_frame_time);
+}
+
+TimingDistribution GPUTime::FrameMetrics::GetFrameCmdTimeDistribution(size_t index) const
+{
+    if (index >= m_cmd_time_vec.size())
+    {
+        return ComputeTimingDistribution({});
+    }
+    return ComputeTimingDistribution(m_cmd_time_vec[index]);
+}
+
+TimingDistribution GPUTime::FrameMetrics::GetFrameRenderPassTimeDistribution(size_t index) const
+{
+    if (index >= m_renderpass_time_vec.size())
+    {
+        return ComputeTimingDistribution({});
+    }
+    return ComputeTimingDistribution(m_renderpass_time_vec[index]);
+}
+
+bool GPUTime::FrameMetrics::HasConverged(const TimingConvergenceCriteria& criteria) const
+{
+    if (!HasTimingConverged(m_frame_time, criteria))
+    {
+        return false;
+    }
+    for (const auto& c : m_cmd_time_vec)
+    {
+        if (!HasTimingConverged(c, criteria))
+        {
+            return false;
+        }
+    }
+    for (const auto& r : m_renderpass_time_vec)
+    {
+        if (!HasTimingConverged(r, criteria))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 std::string GPUTime::GetStatsString() const
 {
     auto PopulateStatsString = [](std::stringstream& ss, const Stats& stats, int nLevel) {
@@ -345,6 +391,44 @@ std::string GPUTime::GetStatsCSVString() const
     return ss.str();
 }
 
+std::string GPUTime::GetDistributionCSVString() const
+{
+    auto PopulateDistributionRow = [](std::stringstream& ss, const char* type, size_t id,
+                                      const TimingDistribution& distribution) {
+        ss << type << "," << id << "," << distribution.warm_up_count << ","
+           << distribution.sample_count << "," << distribution.average << ","
+           << distribution.median << "," << distribution.stddev << "," << distribution.min << ","
+           << distribution.max << "," << distribution.ci95 << ",";
+        for (size_t i = 0; i < distribution.histogram.size(); ++i)
+        {
+            ss << (i == 0 ? "" : " ") << distribution.histogram[i];
+        }
+        ss << "\n";
+    };
+
+    absl::MutexLock lock(&m_mutex);
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    PopulateDistributionRow(ss, "Frame", 0, m_metrics.GetFrameTimeDistribution());
+
+    size_t rp_index = 0;
+    size_t cmd_count = m_metrics.GetFrameCmdCount();
+    for (size_t cmd_index = 0; cmd_index < cmd_count; ++cmd_index)
+    {
+        PopulateDistributionRow(ss, "CommandBuffer", cmd_index,
+                                m_metrics.GetFrameCmdTimeDistribution(cmd_index));
+
+        size_t rp_count = m_metrics.GetCmdRenderPassCount(cmd_index);
+        for (size_t j = 0; j < rp_count; ++j)
+        {
+            PopulateDistributionRow(ss, "RenderPass", rp_index,
+                                    m_metrics.GetFrameRenderPassTimeDistribution(rp_index));
+            rp_index++;
+        }
+    }
+    return ss.str();
+}
+
 GPUTime::GpuTimeStatus GPUTime::OnCreateDevice(VkDevice device,
                                                const VkAllocationCallbacks* allocator_ptr,
                                                float timestamp_period,
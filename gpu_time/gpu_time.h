@@ -29,6 +29,7 @@ limitations under the License.
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
 #include "frame_boundary_detector.h"
+#include "timing_distribution.h"
 
 namespace Dive
 {
@@ -169,6 +170,45 @@ class GPUTime
     // Gives a CSV format string representing the GPU timing data for objects in the current frame
     // Type, id, mean [ms], median [ms]
     std::string GetStatsCSVString() const ABSL_LOCKS_EXCLUDED(m_mutex);
+
+    // Distributions of the times over the frames recorded so far, excluding the warm-up frames
+    TimingDistribution GetFrameTimeDistribution() const ABSL_LOCKS_EXCLUDED(m_mutex)
+    {
+        absl::MutexLock lock(&m_mutex);
+        return m_metrics.GetFrameTimeDistribution();
+    }
+    TimingDistribution GetFrameCmdTimeDistribution(size_t index) const
+        ABSL_LOCKS_EXCLUDED(m_mutex)
+    {
+        absl::MutexLock lock(&m_mutex);
+        return m_metrics.GetFrameCmdTimeDistribution(index);
+    }
+    TimingDistribution GetFrameRenderPassTimeDistribution(size_t index) const
+        ABSL_LOCKS_EXCLUDED(m_mutex)
+    {
+        absl::MutexLock lock(&m_mutex);
+        return m_metrics.GetFrameRenderPassTimeDistribution(index);
+    }
+    // Gives a CSV format string with the distribution of the GPU time of the objects in the current
+    // frame:
+    // Type, id, warm-up frames, frames, mean [ms], median [ms], stddev [ms], min [ms], max [ms],
+    // 95% CI [ms], histogram
+    // where the histogram is the space-separated frame counts of equal-width bins from min to max.
+    std::string GetDistributionCSVString() const ABSL_LOCKS_EXCLUDED(m_mutex);
+
+    void SetConvergenceCriteria(const TimingConvergenceCriteria& criteria)
+        ABSL_LOCKS_EXCLUDED(m_mutex)
+    {
+        absl::MutexLock lock(&m_mutex);
+        m_convergence_criteria = criteria;
+    }
+    // Whether the steady-state times of the frame and of all its command buffers and render passes
+    // meet the convergence criteria, in which case looping the frame further adds little.
+    bool HasConverged() const ABSL_LOCKS_EXCLUDED(m_mutex)
+    {
+        absl::MutexLock lock(&m_mutex);
+        return m_metrics.HasConverged(m_convergence_criteria);
+    }
     void ClearFrameCache() ABSL_LOCKS_EXCLUDED(m_mutex);
 
  private:
@@ -186,6 +226,10 @@ class GPUTime
         size_t GetFrameCmdCount() const;
         size_t GetFrameRenderPassCount() const;
         size_t GetCmdRenderPassCount(size_t index) const;
+        TimingDistribution GetFrameTimeDistribution() const;
+        TimingDistribution GetFrameCmdTimeDistribution(size_t index) const;
+        TimingDistribution GetFrameRenderPassTimeDistribution(size_t index) const;
+        bool HasConverged(const TimingConvergenceCriteria& criteria) const;
 
      private:
         Stats GetStatistics(const std::deque<double>& data) const;
@@ -264,6 +308,7 @@ class GPUTime
     uint64_t m_timestamps_with_availability[TimeStampSlotAllocator::kTotalSlots *
                                             2] ABSL_GUARDED_BY(m_mutex) = {};
     FrameMetrics m_metrics ABSL_GUARDED_BY(m_mutex);
+    TimingConvergenceCriteria m_convergence_criteria ABSL_GUARDED_BY(m_mutex);
     std::set<VkQueue> m_queues ABSL_GUARDED_BY(m_mutex);
     std::unordered_map<VkCommandBuffer, CommandBufferInfo> m_cmds ABSL_GUARDED_BY(m_mutex);
     std::vector<VkCommandBuffer> m_frame_cmds ABSL_GUARDED_BY(m_mutex);
@@ -414,6 +414,52 @@ TEST(GPUTimeTest, MultipleFramesUpdateMetricsCorrectly)
     ASSERT_NO_FATAL_FAILURE(DestroyGPUTime(gpu_time));
 }
 
+// Test that looping the same frame converges, and that the distribution covers every frame.
+TEST(GPUTimeTest, LoopedFrameConverges)
+{
+    GPUTime gpu_time;
+    gpu_time.SetEnable(true);
+    gpu_time.SetConvergenceCriteria(
+        TimingConvergenceCriteria{.min_sample_count = 5, .max_relative_ci95 = 0.01});
+    ASSERT_NO_FATAL_FAILURE(CreateGPUTime(gpu_time, kMockTimestampPeriod));
+
+    VkCommandBufferAllocateInfo alloc_info = {};
+    alloc_info.commandPool = MOCK_COMMAND_POOL;
+    alloc_info.commandBufferCount = 1;
+    VkCommandBuffer cmd = MOCK_COMMAND_BUFFER_1;
+    ASSERT_TRUE(gpu_time.OnAllocateCommandBuffers(&alloc_info, &cmd).success);
+
+    VkDebugUtilsLabelEXT label = {};
+    label.pLabelName = GPUTime::kVulkanVrFrameDelimiterString;
+    ASSERT_TRUE(gpu_time.OnCmdInsertDebugUtilsLabelEXT(cmd, &label).success);
+
+    VkSubmitInfo submit_info = {};
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &cmd;
+
+    for (int i = 0; i < 5; ++i)
+    {
+        EXPECT_FALSE(gpu_time.HasConverged());
+        ASSERT_TRUE(gpu_time
+                        .OnQueueSubmit(1, &submit_info, MockDeviceWaitIdle, MockResetQueryPool,
+                                       MockGetQueryPoolResults)
+                        .gpu_time_status.success);
+    }
+    // Our mock provides a constant 10ms duration, so the confidence interval is empty.
+    EXPECT_TRUE(gpu_time.HasConverged());
+
+    TimingDistribution distribution = gpu_time.GetFrameTimeDistribution();
+    EXPECT_EQ(distribution.sample_count, 5u);
+    EXPECT_DOUBLE_EQ(distribution.average, 10.0);
+    EXPECT_EQ(gpu_time.GetDistributionCSVString(),
+              "Frame,0,0,5,10.000,10.000,0.000,10.000,10.000,0.000,"
+              "5 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n"
+              "CommandBuffer,0,0,5,10.000,10.000,0.000,10.000,10.000,0.000,"
+              "5 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n");
+
+    ASSERT_NO_FATAL_FAILURE(DestroyGPUTime(gpu_time));
+}
+
 TEST(GPUTimeTest, BeginCommandBufferForUnknownCmdDoesNotCrash)
 {
     GPUTime gpu_time;
@@ -0,0 +1,177 @@
+/*
+Copyright 2026 Google Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "timing_distribution.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Dive
+{
+
+namespace
+{
+
+constexpr size_t kMserBatchSize = 5;
+// With fewer batches, the last ones alone always look steadier than the whole series.
+constexpr size_t kMinMserBatchCount = 4;
+// z-score of the two-sided 95% confidence interval of a normal distribution.
+constexpr double kZ95 = 1.96;
+
+struct SteadyState
+{
+    size_t warm_up_count = 0;
+    size_t sample_count = 0;
+    double average = 0.0;
+    double stddev = 0.0;
+    double ci95 = 0.0;
+};
+
+SteadyState ComputeSteadyState(const std::deque<double>& samples)
+{
+    SteadyState state;
+    state.warm_up_count = FindWarmUpCount(samples);
+    state.sample_count = samples.size() - state.warm_up_count;
+    if (state.sample_count == 0)
+    {
+        return state;
+    }
+
+    double sum = 0.0;
+    for (size_t i = state.warm_up_count; i < samples.size(); ++i)
+    {
+        sum += samples[i];
+    }
+    state.average = sum / state.sample_count;
+
+    if (state.sample_count < 2)
+    {
+        return state;
+    }
+    double variance = 0.0;
+    for (size_t i = state.warm_up_count; i < samples.size(); ++i)
+    {
+        variance += (samples[i] - state.average) * (samples[i] - state.average);
+    }
+    variance /= (state.sample_count - 1);
+    state.stddev = std::sqrt(variance);
+    state.ci95 = kZ95 * state.stddev / std::sqrt(static_cast<double>(state.sample_count));
+    return state;
+}
+
+}  // namespace
+
+size_t FindWarmUpCount(const std::deque<double>& samples)
+{
+    size_t batch_count = samples.size() / kMserBatchSize;
+    if (batch_count < kMinMserBatchCount)
+    {
+        return 0;
+    }
+
+    std::vector<double> batch_means(batch_count, 0.0);
+    for (size_t i = 0; i < batch_count * kMserBatchSize; ++i)
+    {
+        batch_means[i / kMserBatchSize] += samples[i] / kMserBatchSize;
+    }
+
+    // Walk the truncation point backwards, updating the mean and the sum of squared deviations of
+    // the batches after it with Welford's method, which keeps a steady series exactly at 0.
+    size_t count = 0;
+    double mean = 0.0;
+    double squared_error = 0.0;
+    auto AddBatch = [&](double batch_mean) {
+        ++count;
+        double delta = batch_mean - mean;
+        mean += delta / count;
+        squared_error += delta * (batch_mean - mean);
+    };
+    for (size_t i = batch_count; i-- > batch_count / 2 + 1;)
+    {
+        AddBatch(batch_means[i]);
+    }
+    size_t best_truncation = 0;
+    double best_mser = std::numeric_limits<double>::max();
+    for (size_t d = batch_count / 2 + 1; d-- > 0;)
+    {
+        AddBatch(batch_means[d]);
+        double mser = squared_error / (static_cast<double>(count) * count);
+        // Prefer the earliest truncation on ties, so that a steady series keeps all its samples.
+        if (mser <= best_mser)
+        {
+            best_mser = mser;
+            best_truncation = d;
+        }
+    }
+    return best_truncation * kMserBatchSize;
+}
+
+TimingDistribution ComputeTimingDistribution(const std::deque<double>& samples,
+                                             size_t histogram_bin_count)
+{
+    TimingDistribution distribution;
+    SteadyState state = ComputeSteadyState(samples);
+    distribution.warm_up_count = state.warm_up_count;
+    distribution.sample_count = state.sample_count;
+    distribution.histogram.assign(histogram_bin_count, 0);
+    if (state.sample_count == 0)
+    {
+        return distribution;
+    }
+    distribution.average = state.average;
+    distribution.stddev = state.stddev;
+    distribution.ci95 = state.ci95;
+
+    std::vector<double> sorted(samples.begin() + state.warm_up_count, samples.end());
+    std::sort(sorted.begin(), sorted.end());
+    distribution.min = sorted.front();
+    distribution.max = sorted.back();
+    size_t size = sorted.size();
+    distribution.median = (size % 2 == 0) ? (sorted[size / 2 - 1] + sorted[size / 2]) / 2.0
+                                          : sorted[size / 2];
+
+    if (histogram_bin_count == 0)
+    {
+        return distribution;
+    }
+    double range = distribution.max - distribution.min;
+    for (double sample : sorted)
+    {
+        size_t bin = 0;
+        if (range > 0.0)
+        {
+            bin = static_cast<size_t>((sample - distribution.min) / range * histogram_bin_count);
+            // The maximum falls on the upper edge of the last bin.
+            bin = std::min(bin, histogram_bin_count - 1);
+        }
+        ++distribution.histogram[bin];
+    }
+    return distribution;
+}
+
+bool HasTimingConverged(const std::deque<double>& samples,
+                        const TimingConvergenceCriteria& criteria)
+{
+    SteadyState state = ComputeSteadyState(samples);
+    if (state.sample_count < std::max<size_t>(criteria.min_sample_count, 2))
+    {
+        return false;
+    }
+    return state.ci95 <= criteria.max_relative_ci95 * std::abs(state.average);
+}
+
+}  // namespace Dive
@@ -0,0 +1,76 @@
+/*
+Copyright 2026 Google Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace Dive
+{
+
+// Distribution of the GPU time of one object (frame, command buffer or render pass) over the
+// iterations of a looping replay. The first iterations are usually slower while caches, clocks and
+// driver state warm up, so they are detected and left out of the statistics.
+struct TimingDistribution
+{
+    static constexpr size_t kDefaultHistogramBinCount = 16;
+
+    // Leading iterations left out as warm-up, see FindWarmUpCount().
+    size_t warm_up_count = 0;
+    // Steady-state iterations the statistics are computed from.
+    size_t sample_count = 0;
+
+    // Statistics of the steady-state iterations, in ms.
+    double average = 0.0;
+    double median = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double stddev = 0.0;
+    // Half-width of the 95% confidence interval of the average.
+    double ci95 = 0.0;
+
+    // Number of steady-state iterations in each of the equal-width bins that span [min, max].
+    std::vector<uint32_t> histogram;
+};
+
+// When the steady-state average is known precisely enough to stop looping.
+struct TimingConvergenceCriteria
+{
+    // Steady-state iterations needed before convergence is considered.
+    size_t min_sample_count = 30;
+    // Largest 95% confidence interval half-width, relative to the average.
+    double max_relative_ci95 = 0.01;
+};
+
+// Returns the number of leading samples that belong to the warm-up, using the MSER-5 rule: the
+// samples are averaged in batches of 5, and the warm-up ends at the batch that minimizes the
+// standard error of the batches after it. At most half of the samples are considered warm-up.
+size_t FindWarmUpCount(const std::deque<double>& samples);
+
+// Computes the steady-state distribution of `samples`, in ms.
+TimingDistribution ComputeTimingDistribution(
+    const std::deque<double>& samples,
+    size_t histogram_bin_count = TimingDistribution::kDefaultHistogramBinCount);
+
+// Whether the steady-state average of `samples` meets `criteria`. Cheaper than computing the whole
+// distribution, since it is checked after every iteration.
+bool HasTimingConverged(const std::deque<double>& samples,
+                        const TimingConvergenceCriteria& criteria);
+
+}  // namespace Dive
@@ -0,0 +1,124 @@
+/*
+Copyright 2026 Google Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "timing_distribution.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <deque>
+
+namespace Dive
+{
+namespace
+{
+
+using ::testing::ElementsAre;
+
+// Alternates between `low` and `high` for `count` samples.
+std::deque<double> Alternating(double low, double high, size_t count)
+{
+    std::deque<double> samples;
+    for (size_t i = 0; i < count; ++i)
+    {
+        samples.push_back(i % 2 == 0 ? low : high);
+    }
+    return samples;
+}
+
+TEST(TimingDistributionTest, EmptySamplesGiveEmptyDistribution)
+{
+    TimingDistribution distribution = ComputeTimingDistribution({}, 4);
+    EXPECT_EQ(distribution.warm_up_count, 0u);
+    EXPECT_EQ(distribution.sample_count, 0u);
+    EXPECT_DOUBLE_EQ(distribution.average, 0.0);
+    EXPECT_THAT(distribution.histogram, ElementsAre(0, 0, 0, 0));
+}
+
+TEST(TimingDistributionTest, SteadySamplesHaveNoWarmUp)
+{
+    EXPECT_EQ(FindWarmUpCount(std::deque<double>(100, 2.0)), 0u);
+    EXPECT_EQ(FindWarmUpCount(Alternating(1.0, 3.0, 100)), 0u);
+}
+
+TEST(TimingDistributionTest, TooFewSamplesHaveNoWarmUp)
+{
+    std::deque<double> samples = {9.0, 9.0, 9.0, 9.0, 9.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+    EXPECT_EQ(FindWarmUpCount(samples), 0u);
+}
+
+TEST(TimingDistributionTest, SlowLeadingSamplesAreWarmUp)
+{
+    std::deque<double> samples = Alternating(1.0, 3.0, 100);
+    for (size_t i = 0; i < 10; ++i)
+    {
+        samples.push_front(20.0);
+    }
+
+    EXPECT_EQ(FindWarmUpCount(samples), 10u);
+
+    TimingDistribution distribution = ComputeTimingDistribution(samples, 4);
+    EXPECT_EQ(distribution.warm_up_count, 10u);
+    EXPECT_EQ(distribution.sample_count, 100u);
+    EXPECT_DOUBLE_EQ(distribution.average, 2.0);
+    EXPECT_DOUBLE_EQ(distribution.median, 2.0);
+    EXPECT_DOUBLE_EQ(distribution.min, 1.0);
+    EXPECT_DOUBLE_EQ(distribution.max, 3.0);
+    EXPECT_THAT(distribution.histogram, ElementsAre(50, 0, 0, 50));
+}
+
+TEST(TimingDistributionTest, StatisticsOfSteadyState)
+{
+    // 10, 20 and 30 repeated: stddev = sqrt(((10^2 + 0 + 10^2) * 10) / 29)
+    std::deque<double> samples;
+    for (size_t i = 0; i < 30; ++i)
+    {
+        samples.push_back(10.0 * (i % 3 + 1));
+    }
+
+    TimingDistribution distribution = ComputeTimingDistribution(samples, 3);
+    EXPECT_EQ(distribution.warm_up_count, 0u);
+    EXPECT_EQ(distribution.sample_count, 30u);
+    EXPECT_DOUBLE_EQ(distribution.average, 20.0);
+    EXPECT_DOUBLE_EQ(distribution.median, 20.0);
+    EXPECT_DOUBLE_EQ(distribution.stddev, std::sqrt(2000.0 / 29.0));
+    EXPECT_DOUBLE_EQ(distribution.ci95, 1.96 * std::sqrt(2000.0 / 29.0) / std::sqrt(30.0));
+    EXPECT_THAT(distribution.histogram, ElementsAre(10, 10, 10));
+}
+
+TEST(TimingDistributionTest, ConstantSamplesFillFirstBin)
+{
+    TimingDistribution distribution = ComputeTimingDistribution(std::deque<double>(7, 5.0), 2);
+    EXPECT_DOUBLE_EQ(distribution.stddev, 0.0);
+    EXPECT_THAT(distribution.histogram, ElementsAre(7, 0));
+}
+
+TEST(TimingDistributionTest, ConvergesOnceConfidenceIntervalIsNarrow)
+{
+    TimingConvergenceCriteria criteria{.min_sample_count = 30, .max_relative_ci95 = 0.05};
+
+    // Not enough samples, even though they are all equal.
+    EXPECT_FALSE(HasTimingConverged(std::deque<double>(29, 1.0), criteria));
+    EXPECT_TRUE(HasTimingConverged(std::deque<double>(30, 1.0), criteria));
+
+    // stddev ~= 1, so the relative half-width is ~1.96 / sqrt(n) / 2.
+    EXPECT_FALSE(HasTimingConverged(Alternating(1.0, 3.0, 100), criteria));
+    EXPECT_TRUE(HasTimingConverged(Alternating(1.0, 3.0, 1000), criteria));
+}
+
+}  // namespace
+}  // namespace Dive
@@ -16,7 +16,16 @@
 
 #include "data_core_wrapper.h"
 
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <string_view>
+
 #include "absl/log/check.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
 #include "dive_core/capture_data.h"
 #include "dive_core/data_core.h"
 #include "gfxr_ext/decode/dive_block_data.h"
@@ -24,6 +33,114 @@
 namespace Dive::HostCli
 {
 
+namespace
+{
+
+absl::StatusOr<std::shared_ptr<std::vector<char>>> ReadBlockFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return absl::NotFoundError(absl::StrFormat("Could not open block file: %s", path));
+    }
+    auto blob = std::make_shared<std::vector<char>>(std::istreambuf_iterator<char>(file),
+                                                    std::istreambuf_iterator<char>());
+    if (blob->empty())
+    {
+        return absl::InvalidArgumentError(absl::StrFormat("Block file is empty: %s", path));
+    }
+    return blob;
+}
+
+absl::StatusOr<GfxrVariant> ParseGfxrVariant(std::string_view line)
+{
+    std::vector<std::string_view> fields = absl::StrSplit(line, ' ', absl::SkipWhitespace());
+    if (fields.size() < 2)
+    {
+        return absl::InvalidArgumentError(
+            absl::StrFormat("Expected a name and an output path: %s", line));
+    }
+
+    GfxrVariant variant;
+    variant.name = fields[0];
+    variant.output_gfxr_file_path = fields[1];
+    for (size_t i = 2; i < fields.size(); ++i)
+    {
+        std::string_view operation = fields[i];
+        if (absl::ConsumePrefix(&operation, "remove="))
+        {
+            for (std::string_view id : absl::StrSplit(operation, ','))
+            {
+                int block_id = 0;
+                if (!absl::SimpleAtoi(id, &block_id))
+                {
+                    return absl::InvalidArgumentError(
+                        absl::StrFormat("Invalid block id in %s: %s", variant.name, id));
+                }
+                variant.removed_block_ids.push_back(block_id);
+            }
+        }
+        else if (absl::ConsumePrefix(&operation, "modify="))
+        {
+            // The file path may contain ':', so split only the ids off
+            std::vector<std::string_view> parts =
+                absl::StrSplit(operation, absl::MaxSplits(':', 2));
+            GfxrVariant::Modification modification;
+            if (parts.size() != 3 || !absl::SimpleAtoi(parts[0], &modification.primary_id) ||
+                !absl::SimpleAtoi(parts[1], &modification.secondary_id))
+            {
+                return absl::InvalidArgumentError(absl::StrFormat(
+                    "Expected modify=<primary>:<secondary>:<file> in %s: %s", variant.name,
+                    fields[i]));
+            }
+            absl::StatusOr<std::shared_ptr<std::vector<char>>> blob = ReadBlockFile(parts[2]);
+            if (!blob.ok())
+            {
+                return blob.status();
+            }
+            modification.blob = *std::move(blob);
+            variant.modifications.push_back(std::move(modification));
+        }
+        else
+        {
+            return absl::InvalidArgumentError(
+                absl::StrFormat("Unknown operation in %s: %s", variant.name, fields[i]));
+        }
+    }
+    return variant;
+}
+
+}  // namespace
+
+absl::StatusOr<std::vector<GfxrVariant>> ParseGfxrVariantsFile(
+    const std::filesystem::path& variants_file_path)
+{
+    std::ifstream file(variants_file_path);
+    if (!file.is_open())
+    {
+        return absl::NotFoundError(
+            absl::StrFormat("Could not open variants file: %s", variants_file_path));
+    }
+
+    std::vector<GfxrVariant> variants;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::string_view content = absl::StripAsciiWhitespace(line);
+        if (content.empty() || content.front() == '#')
+        {
+            continue;
+        }
+        absl::StatusOr<GfxrVariant> variant = ParseGfxrVariant(content);
+        if (!variant.ok())
+        {
+            return variant.status();
+        }
+        variants.push_back(*std::move(variant));
+    }
+    return variants;
+}
+
 DataCoreWrapper::DataCoreWrapper()
 {
     // Initialize DataCore
@@ -46,6 +163,17 @@ absl::Status DataCoreWrapper::LoadGfxrFile(const std::filesystem::path& original
         return absl::UnknownError(
             absl::StrFormat("Could not load GFXR file: %s", original_gfxr_file_path));
     }
+    m_gfxr_file_path = std::filesystem::weakly_canonical(original_gfxr_file_path);
+    return absl::OkStatus();
+}
+
+absl::Status DataCoreWrapper::CheckNotLoadedGfxrFile(const std::filesystem::path& output_path) const
+{
+    if (std::filesystem::weakly_canonical(output_path) == m_gfxr_file_path)
+    {
+        return absl::InvalidArgumentError(
+            absl::StrFormat("Output would overwrite the loaded GFXR file: %s", output_path));
+    }
     return absl::OkStatus();
 }
 
@@ -56,6 +184,10 @@ absl::Status DataCoreWrapper::WriteNewGfxrFile(const std::filesystem::path& new_
     {
         return absl::FailedPreconditionError("Must load original GFXR first");
     }
+    if (absl::Status status = CheckNotLoadedGfxrFile(new_gfxr_file_path); !status.ok())
+    {
+        return status;
+    }
 
     if (!m_data_core->GetMutableGfxrCaptureData().WriteModifiedGfxrFile(
             new_gfxr_file_path.string().c_str()))
@@ -92,4 +224,75 @@ absl::Status DataCoreWrapper::RemoveGfxrBlocks(std::span<const int> block_ids)
     return absl::OkStatus();
 }
 
+absl::Status DataCoreWrapper::WriteGfxrVariants(std::span<const GfxrVariant> variants)
+{
+    CHECK(m_data_core != nullptr) << "data core is null";
+    if (!IsGfxrLoaded())
+    {
+        return absl::FailedPreconditionError("Must load original GFXR first");
+    }
+    if (variants.empty())
+    {
+        return absl::InvalidArgumentError("No variants to write");
+    }
+
+    std::shared_ptr<gfxrecon::decode::DiveBlockData> dive_block_data =
+        m_data_core->GetMutableGfxrCaptureData().GetMutableGfxrData();
+
+    std::vector<gfxrecon::decode::DiveBlockData> variant_block_data;
+    variant_block_data.reserve(variants.size());
+    std::vector<std::string> output_paths;
+    std::set<std::filesystem::path> unique_output_paths;
+    for (const GfxrVariant& variant : variants)
+    {
+        std::filesystem::path output_path =
+            std::filesystem::weakly_canonical(variant.output_gfxr_file_path);
+        if (!unique_output_paths.insert(output_path).second)
+        {
+            return absl::InvalidArgumentError(absl::StrFormat(
+                "Variant %s writes to the same file as another variant: %s", variant.name,
+                variant.output_gfxr_file_path));
+        }
+        if (absl::Status status = CheckNotLoadedGfxrFile(output_path); !status.ok())
+        {
+            return status;
+        }
+        output_paths.push_back(variant.output_gfxr_file_path.string());
+
+        gfxrecon::decode::DiveBlockData& block_data =
+            variant_block_data.emplace_back(dive_block_data->CopyWithoutModifications());
+        for (int id : variant.removed_block_ids)
+        {
+            if (!block_data.AddModification(/*primary_id=*/id, /*secondary_id=*/0,
+                                            /*blob_ptr=*/nullptr))
+            {
+                return absl::InvalidArgumentError(
+                    absl::StrFormat("Variant %s could not delete block id: %d", variant.name, id));
+            }
+        }
+        for (const GfxrVariant::Modification& modification : variant.modifications)
+        {
+            if (!block_data.AddModification(modification.primary_id, modification.secondary_id,
+                                            modification.blob))
+            {
+                return absl::InvalidArgumentError(
+                    absl::StrFormat("Variant %s could not modify block: (%d, %d)", variant.name,
+                                    modification.primary_id, modification.secondary_id));
+            }
+        }
+    }
+
+    std::vector<const gfxrecon::decode::DiveBlockData*> variant_pointers;
+    for (const gfxrecon::decode::DiveBlockData& block_data : variant_block_data)
+    {
+        variant_pointers.push_back(&block_data);
+    }
+    if (!m_data_core->GetMutableGfxrCaptureData().WriteModifiedGfxrFiles(variant_pointers,
+                                                                         output_paths))
+    {
+        return absl::InternalError("Could not write GFXR variants");
+    }
+    return absl::OkStatus();
+}
+
 }  // namespace Dive::HostCli
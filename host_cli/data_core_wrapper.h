@@ -16,16 +16,49 @@
 
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <span>
+#include <string>
+#include <vector>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "dive_core/capture_data.h"
 #include "dive_core/data_core.h"
 
 namespace Dive::HostCli
 {
 
+// A what-if variant of the loaded GFXR file, written by DataCoreWrapper::WriteGfxrVariants()
+struct GfxrVariant
+{
+    // A block inserted at, or replacing the original block at, (primary_id, secondary_id), see
+    // gfxrecon::decode::DiveBlockData
+    struct Modification
+    {
+        uint32_t primary_id = 0;
+        int32_t secondary_id = 0;
+        std::shared_ptr<std::vector<char>> blob;
+    };
+
+    std::string name;
+    std::filesystem::path output_gfxr_file_path;
+    std::vector<int> removed_block_ids;
+    std::vector<Modification> modifications;
+};
+
+// Parses a file that lists variants, one per line:
+//
+//   <name> <output .gfxr path> [remove=<id>[,<id>...]] [modify=<primary>:<secondary>:<file>]...
+//
+// where remove omits original blocks, and modify inserts the gfxr-encoded block held in <file> at
+// (<primary>, <secondary>), replacing the original block if <secondary> is 0. Empty lines and
+// lines starting with '#' are ignored.
+absl::StatusOr<std::vector<GfxrVariant>> ParseGfxrVariantsFile(
+    const std::filesystem::path& variants_file_path);
+
 // Initializes DataCore and provides access to it, also stores relevant info for operations
 class DataCoreWrapper
 {
@@ -37,8 +70,18 @@ class DataCoreWrapper
     absl::Status WriteNewGfxrFile(const std::filesystem::path& new_gfxr_file_path);
     absl::Status RemoveGfxrBlocks(std::span<const int> block_ids);
 
+    // Writes all the variants, each made of the original GFXR file and only its own modifications,
+    // with a single read of the original file
+    absl::Status WriteGfxrVariants(std::span<const GfxrVariant> variants);
+
  private:
+    // Returns an error if `output_path` is the loaded GFXR file, which is still read while the
+    // output is written.
+    absl::Status CheckNotLoadedGfxrFile(const std::filesystem::path& output_path) const;
+
     std::unique_ptr<Dive::DataCore> m_data_core = nullptr;
+    // Canonical path of the loaded GFXR file.
+    std::filesystem::path m_gfxr_file_path;
 };
 
 }  // namespace Dive::HostCli
@@ -18,6 +18,11 @@
 
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
 namespace Dive::HostCli
 {
 namespace
@@ -30,8 +35,111 @@ TEST(DataCoreWrapperTest, CheckInitialization)
     ASSERT_EQ(data_core_wrapper.IsGfxrLoaded(), false);
 }
 
-// TODO : Write more tests if it's possible to hook up actual files from tests/ or with a mock
-// DataCore
+constexpr const char* kTestCapture = TEST_DATA_DIR
+    "/com.google.bigwheels.project_sample_01_triangle.debug_trim_trigger_20250718T132545.gfxr";
+
+std::string ReadFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+TEST(DataCoreWrapperTest, ParseGfxrVariantsFile)
+{
+    std::filesystem::path dir = testing::TempDir();
+    std::filesystem::path block_path = dir / "parse_variants_block.bin";
+    std::ofstream(block_path, std::ios::binary) << "block";
+    std::filesystem::path variants_path = dir / "parse_variants.txt";
+    std::ofstream(variants_path) << "# name output operations\n"
+                                 << "\n"
+                                 << "no_op no_op.gfxr\n"
+                                 << "edit edit.gfxr remove=3,5 modify=7:-1:" << block_path.string()
+                                 << "\n";
+
+    absl::StatusOr<std::vector<GfxrVariant>> variants = ParseGfxrVariantsFile(variants_path);
+    ASSERT_TRUE(variants.ok()) << variants.status();
+    ASSERT_EQ(variants->size(), 2);
+    EXPECT_EQ((*variants)[0].name, "no_op");
+    EXPECT_EQ((*variants)[0].output_gfxr_file_path, "no_op.gfxr");
+    EXPECT_TRUE((*variants)[0].removed_block_ids.empty());
+    EXPECT_TRUE((*variants)[0].modifications.empty());
+    EXPECT_EQ((*variants)[1].name, "edit");
+    EXPECT_EQ((*variants)[1].removed_block_ids, (std::vector<int>{3, 5}));
+    ASSERT_EQ((*variants)[1].modifications.size(), 1);
+    EXPECT_EQ((*variants)[1].modifications[0].primary_id, 7);
+    EXPECT_EQ((*variants)[1].modifications[0].secondary_id, -1);
+    EXPECT_EQ(std::string((*variants)[1].modifications[0].blob->begin(),
+                          (*variants)[1].modifications[0].blob->end()),
+              "block");
+}
+
+TEST(DataCoreWrapperTest, ParseGfxrVariantsFileRejectsUnknownOperation)
+{
+    std::filesystem::path variants_path =
+        std::filesystem::path(testing::TempDir()) / "parse_variants_invalid.txt";
+    std::ofstream(variants_path) << "edit edit.gfxr delete=3\n";
+
+    EXPECT_FALSE(ParseGfxrVariantsFile(variants_path).ok());
+}
+
+TEST(DataCoreWrapperTest, WriteGfxrVariants)
+{
+    DataCoreWrapper data_core_wrapper;
+    ASSERT_TRUE(data_core_wrapper.LoadGfxrFile(kTestCapture).ok());
+
+    std::filesystem::path dir = testing::TempDir();
+    std::vector<GfxrVariant> variants(2);
+    variants[0].name = "no_op";
+    variants[0].output_gfxr_file_path = dir / "variant_no_op.gfxr";
+    variants[1].name = "delete_blocks";
+    variants[1].output_gfxr_file_path = dir / "variant_delete_blocks.gfxr";
+    variants[1].removed_block_ids = {220, 223};
+    ASSERT_TRUE(data_core_wrapper.WriteGfxrVariants(variants).ok());
+
+    EXPECT_EQ(ReadFile(variants[0].output_gfxr_file_path), ReadFile(kTestCapture));
+    EXPECT_EQ(ReadFile(variants[1].output_gfxr_file_path),
+              ReadFile(TEST_DATA_DIR
+                       "/golden/com.google.bigwheels.project_sample_01_triangle.debug_trim_"
+                       "trigger_20250718T132545_delete_blocks_220_223.gfxr"));
+}
+
+TEST(DataCoreWrapperTest, WriteGfxrVariantsRejectsSameOutput)
+{
+    DataCoreWrapper data_core_wrapper;
+    ASSERT_TRUE(data_core_wrapper.LoadGfxrFile(kTestCapture).ok());
+
+    std::vector<GfxrVariant> variants(2);
+    variants[0].name = "first";
+    variants[0].output_gfxr_file_path =
+        std::filesystem::path(testing::TempDir()) / "variant_same.gfxr";
+    variants[1].name = "second";
+    variants[1].output_gfxr_file_path = variants[0].output_gfxr_file_path;
+    EXPECT_EQ(data_core_wrapper.WriteGfxrVariants(variants).code(),
+              absl::StatusCode::kInvalidArgument);
+}
+
+TEST(DataCoreWrapperTest, WriteGfxrVariantsRejectsLoadedFileAsOutput)
+{
+    std::filesystem::path dir =
+        std::filesystem::path(testing::TempDir()) / "WriteGfxrVariantsRejectsLoadedFileAsOutput";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::filesystem::path capture = dir / "capture.gfxr";
+    std::filesystem::copy_file(kTestCapture, capture);
+
+    DataCoreWrapper data_core_wrapper;
+    ASSERT_TRUE(data_core_wrapper.LoadGfxrFile(capture).ok());
+
+    std::vector<GfxrVariant> variants(1);
+    variants[0].name = "in_place";
+    // A different spelling of the same path.
+    variants[0].output_gfxr_file_path = dir / "." / "capture.gfxr";
+    EXPECT_EQ(data_core_wrapper.WriteGfxrVariants(variants).code(),
+              absl::StatusCode::kInvalidArgument);
+    EXPECT_EQ(data_core_wrapper.WriteNewGfxrFile(capture).code(),
+              absl::StatusCode::kInvalidArgument);
+    EXPECT_EQ(ReadFile(capture), ReadFile(kTestCapture));
+}
 
 }  // namespace
 }  // namespace Dive::HostCli
\ No newline at end of file
@@ -19,12 +19,14 @@
 
 #include <filesystem>
 #include <string>
+#include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
 #include "absl/flags/usage.h"
 #include "absl/flags/usage_config.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "data_core_wrapper.h"
@@ -44,12 +46,18 @@ ABSL_FLAG(std::string, output_gfxr_path, "",
 ABSL_FLAG(std::vector<std::string>, delete_gfxr_blocks, {},
           "If specified, the blocks with these ids will be omitted from the modified .gfxr file. "
           "Example: --delete_gfxr_blocks=1,2");
+ABSL_FLAG(std::string, gfxr_variants_file, "",
+          "If specified, a new .gfxr file is generated from the original file (--input_file_path) "
+          "for each variant listed in this file, with a single read of the original file. Each "
+          "line is: <name> <output .gfxr path> [remove=<id>,...] "
+          "[modify=<primary_id>:<secondary_id>:<file with a gfxr-encoded block>]...");
 
 struct ValidatedFlags
 {
     bool input_gfxr_file = false;
     bool output_gfxr_file = false;
     std::vector<int> delete_block_ids;
+    bool gfxr_variants_file = false;
 };
 
 absl::StatusOr<ValidatedFlags> ValidateFlags()
@@ -108,6 +116,23 @@ absl::StatusOr<ValidatedFlags> ValidateFlags()
         }
     }
 
+    if (!absl::GetFlag(FLAGS_gfxr_variants_file).empty())
+    {
+        if (!valid_flags.input_gfxr_file)
+        {
+            return absl::InvalidArgumentError(
+                "if --gfxr_variants_file is specified, then --input_file_path must also be "
+                "specified for a .gfxr file");
+        }
+        if (valid_flags.output_gfxr_file || !valid_flags.delete_block_ids.empty())
+        {
+            return absl::InvalidArgumentError(
+                "--gfxr_variants_file cannot be combined with --output_gfxr_path or "
+                "--delete_gfxr_blocks, list the modifications in the variants instead");
+        }
+        valid_flags.gfxr_variants_file = true;
+    }
+
     return valid_flags;
 }
 
@@ -140,6 +165,23 @@ int main(int argc, char** argv)
             return 1;
         }
 
+        if (valid_flags->gfxr_variants_file)
+        {
+            absl::StatusOr<std::vector<Dive::HostCli::GfxrVariant>> variants =
+                Dive::HostCli::ParseGfxrVariantsFile(absl::GetFlag(FLAGS_gfxr_variants_file));
+            if (!variants.ok())
+            {
+                std::cout << variants.status() << std::endl;
+                return 1;
+            }
+            if (absl::Status res = data_core.WriteGfxrVariants(*variants); !res.ok())
+            {
+                std::cout << res << std::endl;
+                return 1;
+            }
+            return 0;
+        }
+
         if (!valid_flags->delete_block_ids.empty())
         {
             if (absl::Status res = data_core.RemoveGfxrBlocks(valid_flags->delete_block_ids);
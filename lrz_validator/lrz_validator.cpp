@@ -0,0 +1,165 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include "lrz_validator.h"
+
+#include <algorithm>
+#include <iomanip>
+
+#include "dive_core/task_scheduler.h"
+
+namespace Dive
+{
+
+namespace
+{
+
+// Small captures are validated on the calling thread.
+constexpr size_t kMinEventsPerChunk = 16384;
+
+const char* GetCompareOpString(VkCompareOp op)
+{
+    switch (op)
+    {
+        case VK_COMPARE_OP_NEVER:
+            return "Never";
+        case VK_COMPARE_OP_LESS:
+            return "Less";
+        case VK_COMPARE_OP_EQUAL:
+            return "Equal";
+        case VK_COMPARE_OP_LESS_OR_EQUAL:
+            return "Less or Equal";
+        case VK_COMPARE_OP_GREATER:
+            return "Greater";
+        case VK_COMPARE_OP_NOT_EQUAL:
+            return "Not Equal";
+        case VK_COMPARE_OP_GREATER_OR_EQUAL:
+            return "Greater or Equal";
+        case VK_COMPARE_OP_ALWAYS:
+            return "Always";
+        default:
+            return "Invalid";
+    }
+}
+
+// Whether the event is one of the draws that are validated: LRZ only matters for draws in direct
+// or binning mode.
+uint8_t IsValidatedDraw(const EventInfo& info)
+{
+    return (info.m_type == Util::EventType::kDraw) &&
+           (info.m_render_mode == RenderModeType::kDirect ||
+            info.m_render_mode == RenderModeType::kBinningVis ||
+            info.m_render_mode == RenderModeType::kBinningDirect);
+}
+
+}  // namespace
+
+//--------------------------------------------------------------------------------------------------
+bool LrzValidator::Validate(const Dive::Context& context, const Dive::CaptureMetadata& meta_data,
+                            LrzValidationResults& results)
+{
+    results = LrzValidationResults();
+
+    const EventStateInfo& event_state = meta_data.m_event_state;
+    const size_t event_count = std::min<size_t>(meta_data.m_event_info.size(), event_state.size());
+    const bool* depth_test_enabled = event_state.DepthTestEnabledPtr();
+    const bool* depth_write_enabled = event_state.DepthWriteEnabledPtr();
+    const bool* lrz_enabled = event_state.LRZEnabledPtr();
+    const VkCompareOp* depth_compare_op = event_state.DepthCompareOpPtr();
+
+    // Whether each event is validated, and its flags if so.
+    std::vector<uint8_t> validated(event_count);
+    std::vector<uint8_t> flags(event_count);
+    auto validate_events = [&](size_t begin, size_t end) {
+        // The event type and render mode are not part of the event state.
+        for (size_t i = begin; i < end; ++i)
+        {
+            validated[i] = IsValidatedDraw(meta_data.m_event_info[i]);
+        }
+        // The rules themselves are branch-free over the state columns, so that the compiler can
+        // vectorize them.
+        for (size_t i = begin; i < end; ++i)
+        {
+            const uint8_t depth_test = depth_test_enabled[i];
+            const uint8_t lrz = lrz_enabled[i];
+            const VkCompareOp op = depth_compare_op[i];
+            const uint8_t penalty = depth_test & (lrz ^ 1) & (op != VK_COMPARE_OP_NEVER) &
+                                    (op != VK_COMPARE_OP_ALWAYS);
+            flags[i] = static_cast<uint8_t>(
+                validated[i] * (depth_test * LrzValidationResults::kDepthTestEnabled |
+                                depth_write_enabled[i] * LrzValidationResults::kDepthWriteEnabled |
+                                lrz * LrzValidationResults::kLrzEnabled |
+                                penalty * LrzValidationResults::kLrzPenalty));
+        }
+    };
+    if (!ParallelFor(TaskScheduler::GetDefault(), context, 0, event_count, kMinEventsPerChunk,
+                     validate_events))
+    {
+        return false;
+    }
+
+    // Compacts the validated draws into the results table.
+    const size_t draw_count = std::count(validated.begin(), validated.end(), 1);
+    results.m_event_ids.reserve(draw_count);
+    results.m_flags.reserve(draw_count);
+    results.m_depth_compare_ops.reserve(draw_count);
+    for (size_t i = 0; i < event_count; ++i)
+    {
+        if (validated[i])
+        {
+            results.m_event_ids.push_back(static_cast<uint32_t>(i));
+            results.m_flags.push_back(flags[i]);
+            results.m_depth_compare_ops.push_back(depth_compare_op[i]);
+            results.m_num_penalties += (flags[i] & LrzValidationResults::kLrzPenalty) != 0;
+        }
+    }
+    return !context.Cancelled();
+}
+
+//--------------------------------------------------------------------------------------------------
+void LrzValidator::PrintResults(const Dive::CaptureMetadata& meta_data,
+                                const LrzValidationResults& results, std::ostream& ostream)
+{
+    // Pads the columns so that they are easier to read
+    constexpr int kDrawStringWidth = 64;
+    constexpr int kDepthFuncWidth = 16;
+
+    const std::ios_base::fmtflags ostream_flags = ostream.flags();
+    ostream << std::left;
+    for (size_t row = 0; row < results.GetNumDraws(); ++row)
+    {
+        const uint8_t flags = results.m_flags[row];
+        const bool depth_test_enabled = (flags & LrzValidationResults::kDepthTestEnabled) != 0;
+        const bool depth_write_enabled = (flags & LrzValidationResults::kDepthWriteEnabled) != 0;
+        ostream << std::setw(kDrawStringWidth)
+                << meta_data.m_event_info[results.m_event_ids[row]].m_str << "\t";
+        ostream << "DepthTest:" << (depth_test_enabled ? "Enabled\t" : "Disabled\t");
+        ostream << "DepthWrite:" << (depth_write_enabled ? "Enabled\t" : "Disabled\t");
+        ostream << "DepthFunc:" << std::setw(kDepthFuncWidth)
+                << GetCompareOpString(results.m_depth_compare_ops[row]) << "\t";
+        const bool lrz_enabled = depth_test_enabled &&
+                                 (flags & LrzValidationResults::kLrzEnabled) != 0;
+        ostream << (lrz_enabled ? "LRZ:Enabled\t" : "LRZ:Disabled\t");
+        if (flags & LrzValidationResults::kLrzPenalty)
+        {
+            ostream << "[WARNING!] LRZ is disabled with performance penalties!";
+        }
+        ostream << "\n";
+    }
+    ostream.flags(ostream_flags);
+}
+
+}  // namespace Dive
@@ -0,0 +1,71 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "dive/types/context.h"
+#include "dive_core/data_core.h"
+
+namespace Dive
+{
+
+// Result of the LRZ validation, with one row per draw in direct or binning mode, in event order.
+struct LrzValidationResults
+{
+    enum Flags : uint8_t
+    {
+        kDepthTestEnabled = 1 << 0,
+        kDepthWriteEnabled = 1 << 1,
+        kLrzEnabled = 1 << 2,
+        // LRZ is disabled while the depth test is enabled with a depth func other than NEVER or
+        // ALWAYS, which costs performance.
+        kLrzPenalty = 1 << 3,
+    };
+
+    size_t GetNumDraws() const { return m_event_ids.size(); }
+    bool Passed() const { return m_num_penalties == 0; }
+
+    std::vector<uint32_t> m_event_ids;
+    std::vector<uint8_t> m_flags;
+    std::vector<VkCompareOp> m_depth_compare_ops;
+    size_t m_num_penalties = 0;
+};
+
+class LrzValidator
+{
+ public:
+    LrzValidator() = default;
+    ~LrzValidator() = default;
+
+    // Validates the LRZ state of the draws in the metadata. The rules are evaluated over the
+    // columns of the event state, in parallel for large captures. Returns false if the context was
+    // cancelled.
+    bool Validate(const Dive::Context& context, const Dive::CaptureMetadata& meta_data,
+                  LrzValidationResults& results);
+
+    // Prints one line per validated draw to the output stream
+    void PrintResults(const Dive::CaptureMetadata& meta_data, const LrzValidationResults& results,
+                      std::ostream& ostream);
+};
+
+}  // namespace Dive
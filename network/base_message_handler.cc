@@ -27,9 +27,15 @@ limitations under the License.
 namespace Network
 {
 
-void BaseMessageHandler::OnConnect() { LOG(INFO) << "BaseMessageHandler: onConnect()"; }
+void BaseMessageHandler::OnConnect(uint64_t client_id)
+{
+    LOG(INFO) << "BaseMessageHandler: onConnect(), client " << client_id;
+}
 
-void BaseMessageHandler::OnDisconnect() { LOG(INFO) << "BaseMessageHandler: onDisconnect()"; }
+void BaseMessageHandler::OnDisconnect(uint64_t client_id)
+{
+    LOG(INFO) << "BaseMessageHandler: onDisconnect(), client " << client_id;
+}
 
 void BaseMessageHandler::HandleMessage(std::unique_ptr<Network::ISerializable> message,
                                        Network::SocketConnection* client_conn)
@@ -80,6 +86,18 @@ void BaseMessageHandler::HandleMessage(std::unique_ptr<Network::ISerializable> m
             }
             return;
         }
+        case Network::MessageType::STREAM_FILE_REQUEST:
+        {
+            LOG(INFO) << "Message received: StreamFileRequest";
+            auto* request = static_cast<Network::StreamFileRequest*>(message.get());
+
+            if (absl::Status status = Network::StreamFile(request, client_conn); !status.ok())
+            {
+                LOG(ERROR) << "StreamFile failed: " << status.message();
+                return;
+            }
+            return;
+        }
         case Network::MessageType::FILE_SIZE_REQUEST:
         {
             LOG(INFO) << "Message received: FileSizeRequest";
@@ -16,6 +16,7 @@ limitations under the License.
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 
 #include "message_handler.h"
@@ -25,11 +26,14 @@ limitations under the License.
 namespace Network
 {
 
+// Handles the messages shared by all servers (ping, handshake and file transfers). It keeps no
+// state, so it is safe to call from several threads as IMessageHandler requires; subclasses adding
+// state must guard it themselves.
 class BaseMessageHandler : public Network::IMessageHandler
 {
  public:
-    void OnConnect() override;
-    void OnDisconnect() override;
+    void OnConnect(uint64_t client_id) override;
+    void OnDisconnect(uint64_t client_id) override;
     void HandleMessage(std::unique_ptr<Network::ISerializable> message,
                        Network::SocketConnection* client_conn) override;
 };
@@ -17,6 +17,7 @@ limitations under the License.
 #pragma once
 
 #include <cstdint>
+#include <string>
 
 namespace Network
 {
@@ -0,0 +1,92 @@
+/*
+Copyright 2026 Google Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "live_state.h"
+
+#include <utility>
+
+namespace Network
+{
+
+void LiveStateMirror::ApplyPSOsDelta(LivePSOsDelta delta)
+{
+    if (delta.full_snapshot)
+    {
+        m_psos.clear();
+    }
+    // Removals are applied first: a handle can be destroyed and then reused by a new PSO within
+    // the same delta.
+    for (uint64_t handle : delta.removed)
+    {
+        m_psos.erase(handle);
+    }
+    for (auto& pso : delta.upserted)
+    {
+        uint64_t handle = pso.pipeline_handle;
+        m_psos[handle] = std::move(pso);
+    }
+    m_pso_generation = delta.generation;
+}
+
+void LiveStateMirror::ApplyRenderPassesDelta(LiveRenderPassesDelta delta)
+{
+    if (delta.full_snapshot)
+    {
+        m_render_passes.clear();
+    }
+    for (uint64_t handle : delta.removed)
+    {
+        m_render_passes.erase(handle);
+    }
+    for (auto& rp : delta.upserted)
+    {
+        uint64_t handle = rp.render_pass_handle;
+        m_render_passes[handle] = std::move(rp);
+    }
+    m_render_pass_generation = delta.generation;
+}
+
+std::vector<PSOInfo> LiveStateMirror::GetPSOs() const
+{
+    std::vector<PSOInfo> result;
+    result.reserve(m_psos.size());
+    for (const auto& [handle, pso] : m_psos)
+    {
+        result.push_back(pso);
+    }
+    return result;
+}
+
+std::vector<RenderPassInfo> LiveStateMirror::GetRenderPasses() const
+{
+    std::vector<RenderPassInfo> result;
+    result.reserve(m_render_passes.size());
+    for (const auto& [handle, rp] : m_render_passes)
+    {
+        result.push_back(rp);
+    }
+    return result;
+}
+
+void LiveStateMirror::Reset()
+{
+    m_pso_generation = 0;
+    m_psos.clear();
+    m_render_pass_generation = 0;
+    m_render_passes.clear();
+}
+
+}  // namespace Network
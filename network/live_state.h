@@ -0,0 +1,80 @@
+/*
+Copyright 2026 Google Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "drawcall_filter_config.h"
+
+namespace Network
+{
+
+// Changes to the live PSOs of the runtime layer since a given generation.
+struct LivePSOsDelta
+{
+    // Generation of the live PSO list after applying this delta.
+    uint64_t generation = 0;
+    // If true, `upserted` is the complete list and everything known before must be dropped.
+    bool full_snapshot = false;
+    // PSOs created or renamed since the requested generation.
+    std::vector<PSOInfo> upserted;
+    // Handles of the PSOs destroyed since the requested generation.
+    std::vector<uint64_t> removed;
+};
+
+// Changes to the live render passes of the runtime layer since a given generation.
+struct LiveRenderPassesDelta
+{
+    // Generation of the live render pass list after applying this delta.
+    uint64_t generation = 0;
+    // If true, `upserted` is the complete list and everything known before must be dropped.
+    bool full_snapshot = false;
+    // Render passes created or renamed since the requested generation.
+    std::vector<RenderPassInfo> upserted;
+    // Handles of the render passes destroyed since the requested generation.
+    std::vector<uint64_t> removed;
+};
+
+// Host-side copy of the live PSOs and render passes of the runtime layer. It is kept up to date
+// by applying the deltas returned for its current generations, so that polling only transfers
+// what changed. A mirror is only valid for one connection to one layer instance.
+class LiveStateMirror
+{
+ public:
+    uint64_t GetPSOGeneration() const { return m_pso_generation; }
+    uint64_t GetRenderPassGeneration() const { return m_render_pass_generation; }
+
+    void ApplyPSOsDelta(LivePSOsDelta delta);
+    void ApplyRenderPassesDelta(LiveRenderPassesDelta delta);
+
+    // Returns the live objects, ordered by handle.
+    std::vector<PSOInfo> GetPSOs() const;
+    std::vector<RenderPassInfo> GetRenderPasses() const;
+
+    // Forgets everything, so that the next update is a full snapshot.
+    void Reset();
+
+ private:
+    uint64_t m_pso_generation = 0;
+    std::map<uint64_t, PSOInfo> m_psos;
+    uint64_t m_render_pass_generation = 0;
+    std::map<uint64_t, RenderPassInfo> m_render_passes;
+};
+
+}  // namespace Network
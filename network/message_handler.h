@@ -16,6 +16,7 @@ limitations under the License.
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 
 #include "serializable.h"
@@ -24,20 +25,28 @@ limitations under the License.
 namespace Network
 {
 
+// Handles the messages of the clients of a UnixDomainServer.
+//
+// Thread safety: the server serves several clients at once and calls the handler from several
+// threads. HandleMessage() runs concurrently for different clients, while the messages of one
+// client are handled one at a time and in order. OnConnect() and OnDisconnect() may run
+// concurrently with HandleMessage() for other clients. Implementations must guard any state shared
+// between clients.
 class IMessageHandler
 {
  public:
     virtual ~IMessageHandler() = default;
 
-    // Callback for when a new client connects.
-    virtual void OnConnect() = 0;
+    // Callback for when a new client connects. `client_id` is unique for the lifetime of the
+    // server, and matches UnixDomainServer::PushChannel::GetClientId().
+    virtual void OnConnect(uint64_t client_id) = 0;
 
     // Processes a message received from the client.
     virtual void HandleMessage(std::unique_ptr<ISerializable> message,
                                SocketConnection* client_conn) = 0;
 
-    // Callback for when a client disconnects.
-    virtual void OnDisconnect() = 0;
+    // Callback for when a client disconnects. No message of the client is handled afterwards.
+    virtual void OnDisconnect(uint64_t client_id) = 0;
 };
 
 }  // namespace Network
\ No newline at end of file
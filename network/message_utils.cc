@@ -16,13 +16,28 @@ limitations under the License.
 
 #include "message_utils.h"
 
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <thread>
 
 #include "dive/common/status.h"
 
 namespace Network
 {
 
+namespace
+{
+
+// Largest amount of file data sent in one StreamFileChunk.
+constexpr size_t kStreamFileChunkSize = 1024 * 1024;
+
+// How often a file being streamed is checked for new data once everything has been sent.
+constexpr auto kStreamFilePollInterval = std::chrono::milliseconds(20);
+
+}  // namespace
+
 absl::Status SendPong(Network::SocketConnection* client_conn)
 {
     Network::PongMessage response;
@@ -77,6 +92,86 @@ absl::Status DownloadFile(Network::DownloadFileRequest* request,
     return client_conn->SendFile(file_path);
 }
 
+absl::Status StreamFile(Network::StreamFileRequest* request, Network::SocketConnection* client_conn)
+{
+    const std::string& file_path = request->GetFilePath();
+    const auto idle_timeout = std::chrono::milliseconds(request->GetIdleTimeoutMs());
+    uint64_t offset = request->GetOffset();
+
+    Network::StreamFileEnd end;
+    std::ifstream file;
+    auto last_progress = std::chrono::steady_clock::now();
+    while (true)
+    {
+        if (!file.is_open())
+        {
+            // The file may not have been created yet.
+            file.open(file_path, std::ios::binary);
+        }
+        uint64_t file_size = 0;
+        if (file.is_open())
+        {
+            // Reaching the end sets eof/fail; clear them to pick up appended data.
+            file.clear();
+            file.seekg(0, std::ios::end);
+            file_size = static_cast<uint64_t>(file.tellg());
+            if (file_size < offset)
+            {
+                end.SetErrorReason("File was truncated while being streamed");
+                break;
+            }
+        }
+
+        Buffer data;
+        if (file_size > offset)
+        {
+            data.resize(std::min<uint64_t>(file_size - offset, kStreamFileChunkSize));
+            file.seekg(static_cast<std::streamoff>(offset));
+            file.read(reinterpret_cast<char*>(data.data()),
+                      static_cast<std::streamsize>(data.size()));
+            data.resize(static_cast<size_t>(file.gcount()));
+        }
+        if (!data.empty())
+        {
+            Network::StreamFileChunk chunk;
+            chunk.SetOffset(offset);
+            offset += data.size();
+            chunk.SetData(std::move(data));
+            if (auto status = Network::SendSocketMessage(client_conn, chunk); !status.ok())
+            {
+                return Dive::StatusWithContext(status, "StreamFile");
+            }
+            last_progress = std::chrono::steady_clock::now();
+            continue;
+        }
+
+        if (std::chrono::steady_clock::now() - last_progress >= idle_timeout)
+        {
+            if (file.is_open())
+            {
+                end.SetFound(true);
+            }
+            else
+            {
+                end.SetErrorReason("File was not created before the idle timeout");
+            }
+            break;
+        }
+        std::this_thread::sleep_for(kStreamFilePollInterval);
+    }
+
+    end.SetFileSize(offset);
+    if (auto status = Network::SendSocketMessage(client_conn, end); !status.ok())
+    {
+        return Dive::StatusWithContext(status, "StreamFile");
+    }
+    if (!end.GetFound())
+    {
+        return Dive::NotFoundError(end.GetErrorReason());
+    }
+    return Dive::OkStatus();
+}
+
 absl::Status GetFileSize(Network::FileSizeRequest* request, Network::SocketConnection* client_conn)
 {
     Network::FileSizeResponse response;
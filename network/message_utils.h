@@ -29,6 +29,11 @@ absl::Status Handshake(Network::HandshakeRequest* request, Network::SocketConnec
 absl::Status DownloadFile(Network::DownloadFileRequest* request,
                           Network::SocketConnection* client_conn);
 
+// Streams a file that may still be growing until it stops growing for the requested idle timeout.
+// Blocks the calling handler thread for the whole stream.
+absl::Status StreamFile(Network::StreamFileRequest* request,
+                        Network::SocketConnection* client_conn);
+
 absl::Status GetFileSize(Network::FileSizeRequest* request, Network::SocketConnection* client_conn);
 
 absl::Status RemoveFile(Network::RemoveFileRequest* request,
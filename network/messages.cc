@@ -16,12 +16,32 @@ limitations under the License.
 
 #include "messages.h"
 
+#include <string_view>
+#include <unordered_map>
+
 #include "absl/strings/str_cat.h"
 #include "dive/common/macros.h"
 #include "dive/common/status.h"
 
 constexpr uint32_t kMaxPayloadSize = 16 * 1024 * 1024;
 
+namespace
+{
+
+// Every serialized element takes at least one byte, so a count larger than the remaining payload
+// is malformed. Checking it up front avoids huge allocations for corrupt messages.
+absl::Status CheckElementCount(const Network::Buffer& src, size_t offset, uint32_t count)
+{
+    if (count > src.size() - offset)
+    {
+        return Dive::InvalidArgumentError(
+            absl::StrCat("Element count ", count, " exceeds the remaining payload size."));
+    }
+    return Dive::OkStatus();
+}
+
+}  // namespace
+
 namespace Network
 {
 
@@ -174,6 +194,74 @@ absl::Status DownloadFileResponse::Deserialize(const Buffer& src)
     return Dive::OkStatus();
 }
 
+absl::Status StreamFileRequest::Serialize(Buffer& dest) const
+{
+    dest.clear();
+    WriteStringToBuffer(m_file_path, dest);
+    WriteUint64ToBuffer(m_offset, dest);
+    WriteUint32ToBuffer(m_idle_timeout_ms, dest);
+    return Dive::OkStatus();
+}
+
+absl::Status StreamFileRequest::Deserialize(const Buffer& src)
+{
+    size_t offset = 0;
+    ASSIGN_OR_RETURN(m_file_path, ReadStringFromBuffer(src, offset));
+    ASSIGN_OR_RETURN(m_offset, ReadUint64FromBuffer(src, offset));
+    ASSIGN_OR_RETURN(m_idle_timeout_ms, ReadUint32FromBuffer(src, offset));
+    if (offset != src.size())
+    {
+        return Dive::InvalidArgumentError("StreamFileRequest has unexpected trailing data.");
+    }
+    return Dive::OkStatus();
+}
+
+absl::Status StreamFileChunk::Serialize(Buffer& dest) const
+{
+    dest.clear();
+    dest.reserve(sizeof(uint64_t) + sizeof(uint32_t) + m_data.size());
+    WriteUint64ToBuffer(m_offset, dest);
+    WriteUint32ToBuffer(static_cast<uint32_t>(m_data.size()), dest);
+    dest.insert(dest.end(), m_data.begin(), m_data.end());
+    return Dive::OkStatus();
+}
+
+absl::Status StreamFileChunk::Deserialize(const Buffer& src)
+{
+    size_t offset = 0;
+    ASSIGN_OR_RETURN(m_offset, ReadUint64FromBuffer(src, offset));
+    uint32_t size = 0;
+    ASSIGN_OR_RETURN(size, ReadUint32FromBuffer(src, offset));
+    if (src.size() - offset != size)
+    {
+        return Dive::InvalidArgumentError("StreamFileChunk size does not match its payload.");
+    }
+    m_data.assign(src.begin() + static_cast<ptrdiff_t>(offset), src.end());
+    return Dive::OkStatus();
+}
+
+absl::Status StreamFileEnd::Serialize(Buffer& dest) const
+{
+    dest.clear();
+    WriteBoolToBuffer(m_found, dest);
+    WriteStringToBuffer(m_error_reason, dest);
+    WriteUint64ToBuffer(m_file_size, dest);
+    return Dive::OkStatus();
+}
+
+absl::Status StreamFileEnd::Deserialize(const Buffer& src)
+{
+    size_t offset = 0;
+    ASSIGN_OR_RETURN(m_found, ReadBoolFromBuffer(src, offset));
+    ASSIGN_OR_RETURN(m_error_reason, ReadStringFromBuffer(src, offset));
+    ASSIGN_OR_RETURN(m_file_size, ReadUint64FromBuffer(src, offset));
+    if (offset != src.size())
+    {
+        return Dive::InvalidArgumentError("StreamFileEnd has unexpected trailing data.");
+    }
+    return Dive::OkStatus();
+}
+
 absl::Status FileSizeResponse::Serialize(Buffer& dest) const
 {
     dest.clear();
@@ -325,6 +413,241 @@ absl::Status DisableTimestampRequest::Deserialize(const Buffer& src)
     return Dive::OkStatus();
 }
 
+absl::Status LiveStateDeltaRequest::Serialize(Buffer& dest) const
+{
+    dest.clear();
+    WriteUint64ToBuffer(m_pso_generation, dest);
+    WriteUint64ToBuffer(m_render_pass_generation, dest);
+    return Dive::OkStatus();
+}
+
+absl::Status LiveStateDeltaRequest::Deserialize(const Buffer& src)
+{
+    size_t offset = 0;
+    ASSIGN_OR_RETURN(m_pso_generation, ReadUint64FromBuffer(src, offset));
+    ASSIGN_OR_RETURN(m_render_pass_generation, ReadUint64FromBuffer(src, offset));
+    if (offset != src.size())
+    {
+        return Dive::InvalidArgumentError("LiveStateDeltaRequest has unexpected trailing data.");
+    }
+    return Dive::OkStatus();
+}
+
+absl::Status LiveStateDeltaResponse::Serialize(Buffer& dest) const
+{
+    dest.clear();
+
+    // Build the string table first, so that the entries can reference names by index.
+    std::vector<std::string_view> string_table;
+    std::unordered_map<std::string_view, uint32_t> string_indices;
+    auto intern = [&](const std::string& str) {
+        auto [it, inserted] =
+            string_indices.try_emplace(str, static_cast<uint32_t>(string_table.size()));
+        if (inserted)
+        {
+            string_table.push_back(str);
+        }
+        return it->second;
+    };
+    std::vector<uint32_t> pso_name_indices;
+    pso_name_indices.reserve(m_psos_delta.upserted.size());
+    for (const auto& pso : m_psos_delta.upserted)
+    {
+        pso_name_indices.push_back(intern(pso.name));
+    }
+    std::vector<uint32_t> rp_name_indices;
+    rp_name_indices.reserve(m_rps_delta.upserted.size());
+    for (const auto& rp : m_rps_delta.upserted)
+    {
+        rp_name_indices.push_back(intern(rp.name));
+    }
+
+    WriteUint32ToBuffer(static_cast<uint32_t>(string_table.size()), dest);
+    for (std::string_view str : string_table)
+    {
+        WriteUint32ToBuffer(static_cast<uint32_t>(str.length()), dest);
+        dest.insert(dest.end(), str.begin(), str.end());
+    }
+
+    WriteUint64ToBuffer(m_psos_delta.generation, dest);
+    WriteBoolToBuffer(m_psos_delta.full_snapshot, dest);
+    WriteUint32ToBuffer(static_cast<uint32_t>(m_psos_delta.upserted.size()), dest);
+    for (size_t i = 0; i < m_psos_delta.upserted.size(); ++i)
+    {
+        WriteUint64ToBuffer(m_psos_delta.upserted[i].pipeline_handle, dest);
+        WriteUint32ToBuffer(pso_name_indices[i], dest);
+        WriteBoolToBuffer(m_psos_delta.upserted[i].has_alpha_blend, dest);
+    }
+    WriteUint32ToBuffer(static_cast<uint32_t>(m_psos_delta.removed.size()), dest);
+    for (uint64_t handle : m_psos_delta.removed)
+    {
+        WriteUint64ToBuffer(handle, dest);
+    }
+
+    WriteUint64ToBuffer(m_rps_delta.generation, dest);
+    WriteBoolToBuffer(m_rps_delta.full_snapshot, dest);
+    WriteUint32ToBuffer(static_cast<uint32_t>(m_rps_delta.upserted.size()), dest);
+    for (size_t i = 0; i < m_rps_delta.upserted.size(); ++i)
+    {
+        WriteUint64ToBuffer(m_rps_delta.upserted[i].render_pass_handle, dest);
+        WriteUint32ToBuffer(rp_name_indices[i], dest);
+    }
+    WriteUint32ToBuffer(static_cast<uint32_t>(m_rps_delta.removed.size()), dest);
+    for (uint64_t handle : m_rps_delta.removed)
+    {
+        WriteUint64ToBuffer(handle, dest);
+    }
+    return Dive::OkStatus();
+}
+
+absl::Status LiveStateDeltaResponse::Deserialize(const Buffer& src)
+{
+    size_t offset = 0;
+    uint32_t count = 0;
+
+    ASSIGN_OR_RETURN(count, ReadUint32FromBuffer(src, offset));
+    RETURN_IF_ERROR(CheckElementCount(src, offset, count));
+    std::vector<std::string> string_table(count);
+    for (auto& str : string_table)
+    {
+        ASSIGN_OR_RETURN(str, ReadStringFromBuffer(src, offset));
+    }
+    auto lookup = [&](uint32_t index) -> absl::StatusOr<std::string> {
+        if (index >= string_table.size())
+        {
+            return Dive::InvalidArgumentError(
+                absl::StrCat("LiveStateDeltaResponse: Invalid string index ", index));
+        }
+        return string_table[index];
+    };
+
+    m_psos_delta = LivePSOsDelta{};
+    ASSIGN_OR_RETURN(m_psos_delta.generation, ReadUint64FromBuffer(src, offset));
+    ASSIGN_OR_RETURN(m_psos_delta.full_snapshot, ReadBoolFromBuffer(src, offset));
+    ASSIGN_OR_RETURN(count, ReadUint32FromBuffer(src, offset));
+    RETURN_IF_ERROR(CheckElementCount(src, offset, count));
+    m_psos_delta.upserted.resize(count);
+    for (auto& pso : m_psos_delta.upserted)
+    {
+        uint32_t name_index = 0;
+        ASSIGN_OR_RETURN(pso.pipeline_handle, ReadUint64FromBuffer(src, offset));
+        ASSIGN_OR_RETURN(name_index, ReadUint32FromBuffer(src, offset));
+        ASSIGN_OR_RETURN(pso.name, lookup(name_index));
+        ASSIGN_OR_RETURN(pso.has_alpha_blend, ReadBoolFromBuffer(src, offset));
+    }
+    ASSIGN_OR_RETURN(count, ReadUint32FromBuffer(src, offset));
+    RETURN_IF_ERROR(CheckElementCount(src, offset, count));
+    m_psos_delta.removed.resize(count);
+    for (auto& handle : m_psos_delta.removed)
+    {
+        ASSIGN_OR_RETURN(handle, ReadUint64FromBuffer(src, offset));
+    }
+
+    m_rps_delta = LiveRenderPassesDelta{};
+    ASSIGN_OR_RETURN(m_rps_delta.generation, ReadUint64FromBuffer(src, offset));
+    ASSIGN_OR_RETURN(m_rps_delta.full_snapshot, ReadBoolFromBuffer(src, offset));
+    ASSIGN_OR_RETURN(count, ReadUint32FromBuffer(src, offset));
+    RETURN_IF_ERROR(CheckElementCount(src, offset, count));
+    m_rps_delta.upserted.resize(count);
+    for (auto& rp : m_rps_delta.upserted)
+    {
+        uint32_t name_index = 0;
+        ASSIGN_OR_RETURN(rp.render_pass_handle, ReadUint64FromBuffer(src, offset));
+        ASSIGN_OR_RETURN(name_index, ReadUint32FromBuffer(src, offset));
+        ASSIGN_OR_RETURN(rp.name, lookup(name_index));
+    }
+    ASSIGN_OR_RETURN(count, ReadUint32FromBuffer(src, offset));
+    RETURN_IF_ERROR(CheckElementCount(src, offset, count));
+    m_rps_delta.removed.resize(count);
+    for (auto& handle : m_rps_delta.removed)
+    {
+        ASSIGN_OR_RETURN(handle, ReadUint64FromBuffer(src, offset));
+    }
+
+    if (offset != src.size())
+    {
+        return Dive::InvalidArgumentError("LiveStateDeltaResponse has unexpected trailing data.");
+    }
+    return Dive::OkStatus();
+}
+
+absl::Status TelemetrySubscribeRequest::Serialize(Buffer& dest) const
+{
+    dest.clear();
+    WriteBoolToBuffer(m_enable, dest);
+    WriteUint32ToBuffer(m_frames_per_batch, dest);
+    return Dive::OkStatus();
+}
+
+absl::Status TelemetrySubscribeRequest::Deserialize(const Buffer& src)
+{
+    size_t offset = 0;
+    ASSIGN_OR_RETURN(m_enable, ReadBoolFromBuffer(src, offset));
+    ASSIGN_OR_RETURN(m_frames_per_batch, ReadUint32FromBuffer(src, offset));
+    if (offset != src.size())
+    {
+        return Dive::InvalidArgumentError(
+            "TelemetrySubscribeRequest has unexpected trailing data.");
+    }
+    return Dive::OkStatus();
+}
+
+absl::Status TelemetryBatch::Serialize(Buffer& dest) const
+{
+    dest.clear();
+    WriteUint64ToBuffer(m_first_frame_index, dest);
+    WriteUint32ToBuffer(static_cast<uint32_t>(m_samples.size()), dest);
+    for (const auto& sample : m_samples)
+    {
+        WriteUint32ToBuffer(sample.frame_time_us, dest);
+        WriteUint32ToBuffer(sample.draw_count, dest);
+    }
+    WriteBoolToBuffer(m_has_gpu_time, dest);
+    if (m_has_gpu_time)
+    {
+        WriteUint32ToBuffer(m_gpu_time.average_us, dest);
+        WriteUint32ToBuffer(m_gpu_time.median_us, dest);
+        WriteUint32ToBuffer(m_gpu_time.min_us, dest);
+        WriteUint32ToBuffer(m_gpu_time.max_us, dest);
+        WriteUint32ToBuffer(m_gpu_time.stddev_us, dest);
+    }
+    return Dive::OkStatus();
+}
+
+absl::Status TelemetryBatch::Deserialize(const Buffer& src)
+{
+    size_t offset = 0;
+    ASSIGN_OR_RETURN(m_first_frame_index, ReadUint64FromBuffer(src, offset));
+
+    uint32_t count = 0;
+    ASSIGN_OR_RETURN(count, ReadUint32FromBuffer(src, offset));
+    RETURN_IF_ERROR(CheckElementCount(src, offset, count));
+    m_samples.clear();
+    m_samples.resize(count);
+    for (auto& sample : m_samples)
+    {
+        ASSIGN_OR_RETURN(sample.frame_time_us, ReadUint32FromBuffer(src, offset));
+        ASSIGN_OR_RETURN(sample.draw_count, ReadUint32FromBuffer(src, offset));
+    }
+
+    ASSIGN_OR_RETURN(m_has_gpu_time, ReadBoolFromBuffer(src, offset));
+    m_gpu_time = {};
+    if (m_has_gpu_time)
+    {
+        ASSIGN_OR_RETURN(m_gpu_time.average_us, ReadUint32FromBuffer(src, offset));
+        ASSIGN_OR_RETURN(m_gpu_time.median_us, ReadUint32FromBuffer(src, offset));
+        ASSIGN_OR_RETURN(m_gpu_time.min_us, ReadUint32FromBuffer(src, offset));
+        ASSIGN_OR_RETURN(m_gpu_time.max_us, ReadUint32FromBuffer(src, offset));
+        ASSIGN_OR_RETURN(m_gpu_time.stddev_us, ReadUint32FromBuffer(src, offset));
+    }
+
+    if (offset != src.size())
+    {
+        return Dive::InvalidArgumentError("TelemetryBatch has unexpected trailing data.");
+    }
+    return Dive::OkStatus();
+}
+
 absl::Status ReceiveBuffer(SocketConnection* conn, uint8_t* buffer, size_t size, int timeout_ms)
 {
     if (!conn)
@@ -354,46 +677,25 @@ absl::Status SendBuffer(SocketConnection* conn, const uint8_t* buffer, size_t si
     return conn->Send(buffer, size);
 }
 
-absl::StatusOr<std::unique_ptr<ISerializable>> ReceiveSocketMessage(SocketConnection* conn,
-                                                                    int timeout_ms)
+absl::Status ParseMessageHeader(const uint8_t* header, uint32_t& type, uint32_t& payload_length)
 {
-    if (!conn)
-    {
-        return Dive::InvalidArgumentError("Provided SocketConnection is null.");
-    }
-
-    constexpr size_t kHeaderSize = sizeof(uint32_t) * 2;
-    uint8_t header_buffer[kHeaderSize];
-
-    // Receive the message header.
-    absl::Status status = ReceiveBuffer(conn, header_buffer, kHeaderSize, timeout_ms);
-    if (!status.ok())
-    {
-        return status;
-    }
-
-    // Parse header.
     uint32_t net_type = 0, net_length = 0;
-    std::memcpy(&net_type, header_buffer, sizeof(uint32_t));
-    std::memcpy(&net_length, header_buffer + sizeof(uint32_t), sizeof(uint32_t));
-    uint32_t type = ntohl(net_type);
-    uint32_t payload_length = ntohl(net_length);
+    std::memcpy(&net_type, header, sizeof(uint32_t));
+    std::memcpy(&net_length, header + sizeof(uint32_t), sizeof(uint32_t));
+    type = ntohl(net_type);
+    payload_length = ntohl(net_length);
 
     if (payload_length > kMaxPayloadSize)
     {
-        conn->Close();
         return Dive::InvalidArgumentError(
             absl::StrCat("Payload size ", payload_length, " exceeds limit."));
     }
+    return Dive::OkStatus();
+}
 
-    // Receive the message payload.
-    Buffer payload_buffer(payload_length);
-    status = ReceiveBuffer(conn, payload_buffer.data(), payload_length, timeout_ms);
-    if (!status.ok())
-    {
-        return status;
-    }
-
+absl::StatusOr<std::unique_ptr<ISerializable>> DeserializeMessage(uint32_t type,
+                                                                  const Buffer& payload)
+{
     // Create and deserialize the message object.
     std::unique_ptr<ISerializable> message;
     switch (static_cast<MessageType>(type))
@@ -458,18 +760,84 @@ absl::StatusOr<std::unique_ptr<ISerializable>> ReceiveSocketMessage(SocketConnec
         case MessageType::DISABLE_TIMESTAMP_RESPONSE:
             message = std::make_unique<DisableTimestampResponse>();
             break;
+        case MessageType::LIVE_STATE_DELTA_REQUEST:
+            message = std::make_unique<LiveStateDeltaRequest>();
+            break;
+        case MessageType::LIVE_STATE_DELTA_RESPONSE:
+            message = std::make_unique<LiveStateDeltaResponse>();
+            break;
+        case MessageType::TELEMETRY_SUBSCRIBE_REQUEST:
+            message = std::make_unique<TelemetrySubscribeRequest>();
+            break;
+        case MessageType::TELEMETRY_SUBSCRIBE_RESPONSE:
+            message = std::make_unique<TelemetrySubscribeResponse>();
+            break;
+        case MessageType::TELEMETRY_BATCH:
+            message = std::make_unique<TelemetryBatch>();
+            break;
+        case MessageType::STREAM_FILE_REQUEST:
+            message = std::make_unique<StreamFileRequest>();
+            break;
+        case MessageType::STREAM_FILE_CHUNK:
+            message = std::make_unique<StreamFileChunk>();
+            break;
+        case MessageType::STREAM_FILE_END:
+            message = std::make_unique<StreamFileEnd>();
+            break;
         default:
-            conn->Close();
             return Dive::InvalidArgumentError(absl::StrCat("Unknown message type: ", type));
     }
 
-    status = message->Deserialize(payload_buffer);
+    absl::Status status = message->Deserialize(payload);
+    if (!status.ok())
+    {
+        return status;
+    }
+
+    return message;
+}
+
+absl::StatusOr<std::unique_ptr<ISerializable>> ReceiveSocketMessage(SocketConnection* conn,
+                                                                    int timeout_ms)
+{
+    if (!conn)
+    {
+        return Dive::InvalidArgumentError("Provided SocketConnection is null.");
+    }
+
+    uint8_t header_buffer[kMessageHeaderSize];
+
+    // Receive the message header.
+    absl::Status status = ReceiveBuffer(conn, header_buffer, kMessageHeaderSize, timeout_ms);
+    if (!status.ok())
+    {
+        return status;
+    }
+
+    // Parse header.
+    uint32_t type = 0, payload_length = 0;
+    status = ParseMessageHeader(header_buffer, type, payload_length);
     if (!status.ok())
     {
         conn->Close();
         return status;
     }
 
+    // Receive the message payload.
+    Buffer payload_buffer(payload_length);
+    status = ReceiveBuffer(conn, payload_buffer.data(), payload_length, timeout_ms);
+    if (!status.ok())
+    {
+        return status;
+    }
+
+    auto message = DeserializeMessage(type, payload_buffer);
+    if (!message.ok())
+    {
+        conn->Close();
+        return message.status();
+    }
+
     return message;
 }
 
@@ -495,12 +863,11 @@ absl::Status SendSocketMessage(SocketConnection* conn, const ISerializable& mess
     // Construct and send the header.
     uint32_t net_type = htonl(static_cast<uint32_t>(message.GetMessageType()));
     uint32_t net_payload_length = htonl(static_cast<uint32_t>(payload_buffer.size()));
-    constexpr size_t kHeaderSize = sizeof(net_type) + sizeof(net_payload_length);
-    uint8_t header_buffer[kHeaderSize];
+    uint8_t header_buffer[kMessageHeaderSize];
     std::memcpy(header_buffer, &net_type, sizeof(uint32_t));
     std::memcpy(header_buffer + sizeof(uint32_t), &net_payload_length, sizeof(uint32_t));
 
-    status = SendBuffer(conn, header_buffer, kHeaderSize);
+    status = SendBuffer(conn, header_buffer, kMessageHeaderSize);
     if (!status.ok())
     {
         return status;
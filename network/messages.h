@@ -18,6 +18,7 @@ limitations under the License.
 
 #include "dive/common/status.h"
 #include "drawcall_filter_config.h"
+#include "live_state.h"
 #include "serializable.h"
 #include "socket_connection.h"
 
@@ -70,6 +71,14 @@ enum class MessageType : uint32_t
     LIVE_RENDER_PASSES_RESPONSE = 18,
     DISABLE_TIMESTAMP_REQUEST = 19,
     DISABLE_TIMESTAMP_RESPONSE = 20,
+    LIVE_STATE_DELTA_REQUEST = 21,
+    LIVE_STATE_DELTA_RESPONSE = 22,
+    TELEMETRY_SUBSCRIBE_REQUEST = 23,
+    TELEMETRY_SUBSCRIBE_RESPONSE = 24,
+    TELEMETRY_BATCH = 25,
+    STREAM_FILE_REQUEST = 26,
+    STREAM_FILE_CHUNK = 27,
+    STREAM_FILE_END = 28,
 };
 
 class HandshakeMessage : public ISerializable
@@ -211,6 +220,77 @@ class DownloadFileResponse : public ISerializable
     uint64_t m_file_size{};
 };
 
+// StreamFileRequest asks the server to send a file that may still be growing, e.g. a capture that
+// is being written. The server sends the data from `offset` on as StreamFileChunk messages while
+// it is appended, and a StreamFileEnd once the file has not grown for `idle_timeout_ms` (or does
+// not appear within that time).
+class StreamFileRequest : public ISerializable
+{
+ public:
+    MessageType GetMessageType() const override { return MessageType::STREAM_FILE_REQUEST; }
+    absl::Status Serialize(Buffer& dest) const override;
+    absl::Status Deserialize(const Buffer& src) override;
+
+    const std::string& GetFilePath() const { return m_file_path; }
+    void SetFilePath(std::string file_path) { m_file_path = std::move(file_path); }
+
+    uint64_t GetOffset() const { return m_offset; }
+    void SetOffset(uint64_t offset) { m_offset = offset; }
+
+    uint32_t GetIdleTimeoutMs() const { return m_idle_timeout_ms; }
+    void SetIdleTimeoutMs(uint32_t timeout_ms) { m_idle_timeout_ms = timeout_ms; }
+
+ private:
+    std::string m_file_path;
+    // Position in the file to start streaming from, to resume an interrupted stream.
+    uint64_t m_offset{};
+    uint32_t m_idle_timeout_ms{};
+};
+
+class StreamFileChunk : public ISerializable
+{
+ public:
+    MessageType GetMessageType() const override { return MessageType::STREAM_FILE_CHUNK; }
+    absl::Status Serialize(Buffer& dest) const override;
+    absl::Status Deserialize(const Buffer& src) override;
+
+    uint64_t GetOffset() const { return m_offset; }
+    void SetOffset(uint64_t offset) { m_offset = offset; }
+
+    const Buffer& GetData() const { return m_data; }
+    void SetData(Buffer data) { m_data = std::move(data); }
+
+ private:
+    // Position of the data in the file.
+    uint64_t m_offset{};
+    Buffer m_data;
+};
+
+class StreamFileEnd : public ISerializable
+{
+ public:
+    MessageType GetMessageType() const override { return MessageType::STREAM_FILE_END; }
+    absl::Status Serialize(Buffer& dest) const override;
+    absl::Status Deserialize(const Buffer& src) override;
+
+    bool GetFound() const { return m_found; }
+    void SetFound(bool found) { m_found = found; }
+
+    const std::string& GetErrorReason() const { return m_error_reason; }
+    void SetErrorReason(std::string error_reason) { m_error_reason = std::move(error_reason); }
+
+    uint64_t GetFileSize() const { return m_file_size; }
+    void SetFileSize(uint64_t file_size) { m_file_size = file_size; }
+
+ private:
+    // Flag indicating whether the file was found and streamed without error.
+    bool m_found = false;
+    // A description of the error if the stream failed. Empty if successful.
+    std::string m_error_reason;
+    // Size of the file when the stream ended, i.e. the end of the last chunk.
+    uint64_t m_file_size{};
+};
+
 // FileSizeRequest uses the string message as the file path for which we want to determine the size.
 class FileSizeRequest : public StringMessage
 {
@@ -375,8 +455,146 @@ class DisableTimestampResponse : public EmptyMessage
     MessageType GetMessageType() const override { return MessageType::DISABLE_TIMESTAMP_RESPONSE; }
 };
 
+// LiveStateDeltaRequest asks for the changes to the live PSOs and render passes since the given
+// generations. A generation of 0 requests a full snapshot.
+class LiveStateDeltaRequest : public ISerializable
+{
+ public:
+    MessageType GetMessageType() const override { return MessageType::LIVE_STATE_DELTA_REQUEST; }
+    absl::Status Serialize(Buffer& dest) const override;
+    absl::Status Deserialize(const Buffer& src) override;
+
+    uint64_t GetPSOGeneration() const { return m_pso_generation; }
+    void SetPSOGeneration(uint64_t generation) { m_pso_generation = generation; }
+
+    uint64_t GetRenderPassGeneration() const { return m_render_pass_generation; }
+    void SetRenderPassGeneration(uint64_t generation) { m_render_pass_generation = generation; }
+
+ private:
+    uint64_t m_pso_generation{};
+    uint64_t m_render_pass_generation{};
+};
+
+// LiveStateDeltaResponse carries the added, renamed and removed PSOs and render passes. On the
+// wire, names are stored once in a string table and referenced by index, since many objects
+// share the same name.
+class LiveStateDeltaResponse : public ISerializable
+{
+ public:
+    MessageType GetMessageType() const override { return MessageType::LIVE_STATE_DELTA_RESPONSE; }
+    absl::Status Serialize(Buffer& dest) const override;
+    absl::Status Deserialize(const Buffer& src) override;
+
+    const LivePSOsDelta& GetPSOsDelta() const { return m_psos_delta; }
+    LivePSOsDelta TakePSOsDelta() { return std::move(m_psos_delta); }
+    void SetPSOsDelta(LivePSOsDelta delta) { m_psos_delta = std::move(delta); }
+
+    const LiveRenderPassesDelta& GetRenderPassesDelta() const { return m_rps_delta; }
+    LiveRenderPassesDelta TakeRenderPassesDelta() { return std::move(m_rps_delta); }
+    void SetRenderPassesDelta(LiveRenderPassesDelta delta) { m_rps_delta = std::move(delta); }
+
+ private:
+    LivePSOsDelta m_psos_delta;
+    LiveRenderPassesDelta m_rps_delta;
+};
+
+// TelemetrySubscribeRequest starts (or, when disabled, stops) the telemetry stream to the
+// requesting connection. The server then pushes a TelemetryBatch every `frames_per_batch` frames
+// until the connection is closed. Since batches arrive unsolicited, the stream should use a
+// connection of its own.
+class TelemetrySubscribeRequest : public ISerializable
+{
+ public:
+    MessageType GetMessageType() const override
+    {
+        return MessageType::TELEMETRY_SUBSCRIBE_REQUEST;
+    }
+    absl::Status Serialize(Buffer& dest) const override;
+    absl::Status Deserialize(const Buffer& src) override;
+
+    bool GetEnable() const { return m_enable; }
+    void SetEnable(bool enable) { m_enable = enable; }
+
+    uint32_t GetFramesPerBatch() const { return m_frames_per_batch; }
+    void SetFramesPerBatch(uint32_t frames) { m_frames_per_batch = frames; }
+
+ private:
+    bool m_enable = true;
+    uint32_t m_frames_per_batch = 1;
+};
+
+class TelemetrySubscribeResponse : public EmptyMessage
+{
+ public:
+    MessageType GetMessageType() const override
+    {
+        return MessageType::TELEMETRY_SUBSCRIBE_RESPONSE;
+    }
+};
+
+// Counters of one frame, as seen by the runtime layer.
+struct TelemetryFrameSample
+{
+    // CPU time between the previous frame boundary and this one.
+    uint32_t frame_time_us = 0;
+    // Draw calls in the command buffers submitted during the frame, including command buffers
+    // recorded in earlier frames.
+    uint32_t draw_count = 0;
+};
+
+// GPU frame time statistics over the recent frames measured by the runtime layer.
+struct GpuTimeSummary
+{
+    uint32_t average_us = 0;
+    uint32_t median_us = 0;
+    uint32_t min_us = 0;
+    uint32_t max_us = 0;
+    uint32_t stddev_us = 0;
+};
+
+// TelemetryBatch is pushed by the server to subscribed connections. It holds the samples of
+// consecutive frames, and a GPU time summary if GPU timing is enabled in the layer.
+class TelemetryBatch : public ISerializable
+{
+ public:
+    MessageType GetMessageType() const override { return MessageType::TELEMETRY_BATCH; }
+    absl::Status Serialize(Buffer& dest) const override;
+    absl::Status Deserialize(const Buffer& src) override;
+
+    // Index of the frame of the first sample, counted from the start of the application.
+    uint64_t GetFirstFrameIndex() const { return m_first_frame_index; }
+    void SetFirstFrameIndex(uint64_t index) { m_first_frame_index = index; }
+
+    const std::vector<TelemetryFrameSample>& GetSamples() const { return m_samples; }
+    void AddSample(const TelemetryFrameSample& sample) { m_samples.push_back(sample); }
+
+    bool HasGpuTime() const { return m_has_gpu_time; }
+    const GpuTimeSummary& GetGpuTime() const { return m_gpu_time; }
+    void SetGpuTime(const GpuTimeSummary& gpu_time)
+    {
+        m_has_gpu_time = true;
+        m_gpu_time = gpu_time;
+    }
+
+ private:
+    uint64_t m_first_frame_index = 0;
+    std::vector<TelemetryFrameSample> m_samples;
+    bool m_has_gpu_time = false;
+    GpuTimeSummary m_gpu_time;
+};
+
 // Message Helper Functions (TLV Framing).
 
+// Size of the TLV header (message type + payload length) preceding every payload.
+constexpr size_t kMessageHeaderSize = sizeof(uint32_t) * 2;
+
+// Parses a TLV header of kMessageHeaderSize bytes and validates the payload length.
+absl::Status ParseMessageHeader(const uint8_t* header, uint32_t& type, uint32_t& payload_length);
+
+// Creates a message object of the given type and deserializes the payload into it.
+absl::StatusOr<std::unique_ptr<ISerializable>> DeserializeMessage(uint32_t type,
+                                                                  const Buffer& payload);
+
 // Helper to receive an exact number of bytes.
 absl::Status ReceiveBuffer(SocketConnection* conn, uint8_t* buffer, size_t size,
                            int timeout_ms = kNoTimeout);
@@ -413,4 +413,250 @@ TEST(MessagesTest, LiveRenderPassesResponse)
     ASSERT_EQ(deserialized_rps[1].name, "MainForwardPass");
 }
 
+TEST(MessagesTest, LiveStateDeltaRequest)
+{
+    Network::LiveStateDeltaRequest req_serialize;
+    req_serialize.SetPSOGeneration(42);
+    req_serialize.SetRenderPassGeneration(7);
+
+    Network::Buffer buf;
+    absl::Status status = req_serialize.Serialize(buf);
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(req_serialize.GetMessageType(), Network::MessageType::LIVE_STATE_DELTA_REQUEST);
+
+    Network::LiveStateDeltaRequest req_deserialize;
+    status = req_deserialize.Deserialize(buf);
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(req_deserialize.GetPSOGeneration(), 42);
+    ASSERT_EQ(req_deserialize.GetRenderPassGeneration(), 7);
+}
+
+TEST(MessagesTest, LiveStateDeltaResponse)
+{
+    Network::LivePSOsDelta psos_delta;
+    psos_delta.generation = 12;
+    psos_delta.full_snapshot = false;
+    psos_delta.upserted.push_back({"Opaque", 0x1000, false});
+    psos_delta.upserted.push_back({"Alpha_blend_enabled", 0x2000, true});
+    psos_delta.upserted.push_back({"Opaque", 0x3000, false});
+    psos_delta.removed = {0x4000, 0x5000};
+
+    Network::LiveRenderPassesDelta rps_delta;
+    rps_delta.generation = 3;
+    rps_delta.full_snapshot = true;
+    rps_delta.upserted.push_back({"Opaque", 0x6000});
+
+    Network::LiveStateDeltaResponse res_serialize;
+    res_serialize.SetPSOsDelta(psos_delta);
+    res_serialize.SetRenderPassesDelta(rps_delta);
+
+    Network::Buffer buf;
+    absl::Status status = res_serialize.Serialize(buf);
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(res_serialize.GetMessageType(), Network::MessageType::LIVE_STATE_DELTA_RESPONSE);
+
+    // "Opaque" is used three times but only stored once.
+    std::string buf_str(buf.begin(), buf.end());
+    ASSERT_EQ(buf_str.find("Opaque"), buf_str.rfind("Opaque"));
+
+    Network::LiveStateDeltaResponse res_deserialize;
+    status = res_deserialize.Deserialize(buf);
+    ASSERT_TRUE(status.ok());
+
+    const auto& psos = res_deserialize.GetPSOsDelta();
+    ASSERT_EQ(psos.generation, 12);
+    ASSERT_FALSE(psos.full_snapshot);
+    ASSERT_EQ(psos.upserted.size(), 3);
+    ASSERT_EQ(psos.upserted[0].name, "Opaque");
+    ASSERT_EQ(psos.upserted[0].pipeline_handle, 0x1000);
+    ASSERT_EQ(psos.upserted[1].name, "Alpha_blend_enabled");
+    ASSERT_EQ(psos.upserted[1].has_alpha_blend, true);
+    ASSERT_EQ(psos.upserted[2].name, "Opaque");
+    ASSERT_EQ(psos.upserted[2].pipeline_handle, 0x3000);
+    ASSERT_EQ(psos.removed, psos_delta.removed);
+
+    const auto& rps = res_deserialize.GetRenderPassesDelta();
+    ASSERT_EQ(rps.generation, 3);
+    ASSERT_TRUE(rps.full_snapshot);
+    ASSERT_EQ(rps.upserted.size(), 1);
+    ASSERT_EQ(rps.upserted[0].name, "Opaque");
+    ASSERT_EQ(rps.upserted[0].render_pass_handle, 0x6000);
+    ASSERT_TRUE(rps.removed.empty());
+}
+
+TEST(MessagesTest, LiveStateDeltaResponseRejectsBadStringIndex)
+{
+    Network::LiveStateDeltaResponse res_serialize;
+    Network::LivePSOsDelta psos_delta;
+    psos_delta.upserted.push_back({"Opaque", 0x1000, false});
+    res_serialize.SetPSOsDelta(psos_delta);
+
+    Network::Buffer buf;
+    ASSERT_TRUE(res_serialize.Serialize(buf).ok());
+
+    // The name index follows the string table (count, length, "Opaque"), the generation, the
+    // snapshot flag, the entry count and the handle.
+    size_t name_index_offset = 4 + 4 + 6 + 8 + 1 + 4 + 8;
+    buf[name_index_offset + 3] = 5;
+
+    Network::LiveStateDeltaResponse res_deserialize;
+    ASSERT_FALSE(res_deserialize.Deserialize(buf).ok());
+}
+
+TEST(MessagesTest, TelemetrySubscribeRequest)
+{
+    Network::TelemetrySubscribeRequest req_serialize;
+    req_serialize.SetEnable(true);
+    req_serialize.SetFramesPerBatch(30);
+
+    Network::Buffer buf;
+    absl::Status status = req_serialize.Serialize(buf);
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(req_serialize.GetMessageType(), Network::MessageType::TELEMETRY_SUBSCRIBE_REQUEST);
+
+    Network::TelemetrySubscribeRequest req_deserialize;
+    status = req_deserialize.Deserialize(buf);
+    ASSERT_TRUE(status.ok());
+    ASSERT_TRUE(req_deserialize.GetEnable());
+    ASSERT_EQ(req_deserialize.GetFramesPerBatch(), 30);
+}
+
+TEST(MessagesTest, TelemetryBatch)
+{
+    Network::TelemetryBatch batch_serialize;
+    batch_serialize.SetFirstFrameIndex(1200);
+    batch_serialize.AddSample({16667, 850});
+    batch_serialize.AddSample({33000, 912});
+    batch_serialize.SetGpuTime({12000, 11800, 9000, 20500, 1500});
+
+    Network::Buffer buf;
+    absl::Status status = batch_serialize.Serialize(buf);
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(batch_serialize.GetMessageType(), Network::MessageType::TELEMETRY_BATCH);
+
+    Network::TelemetryBatch batch_deserialize;
+    status = batch_deserialize.Deserialize(buf);
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(batch_deserialize.GetFirstFrameIndex(), 1200);
+    ASSERT_EQ(batch_deserialize.GetSamples().size(), 2);
+    ASSERT_EQ(batch_deserialize.GetSamples()[1].frame_time_us, 33000);
+    ASSERT_EQ(batch_deserialize.GetSamples()[1].draw_count, 912);
+    ASSERT_TRUE(batch_deserialize.HasGpuTime());
+    ASSERT_EQ(batch_deserialize.GetGpuTime().median_us, 11800);
+    ASSERT_EQ(batch_deserialize.GetGpuTime().stddev_us, 1500);
+
+    // Without GPU timing, the summary is omitted.
+    Network::TelemetryBatch no_gpu_serialize;
+    no_gpu_serialize.AddSample({16667, 850});
+    ASSERT_TRUE(no_gpu_serialize.Serialize(buf).ok());
+    Network::TelemetryBatch no_gpu_deserialize;
+    ASSERT_TRUE(no_gpu_deserialize.Deserialize(buf).ok());
+    ASSERT_FALSE(no_gpu_deserialize.HasGpuTime());
+    ASSERT_EQ(no_gpu_deserialize.GetSamples().size(), 1);
+}
+
+TEST(MessagesTest, StreamFileRequest)
+{
+    Network::StreamFileRequest req_serialize;
+    req_serialize.SetFilePath("/sdcard/Download/capture.gfxr");
+    req_serialize.SetOffset(1ull << 33);
+    req_serialize.SetIdleTimeoutMs(2000);
+
+    Network::Buffer buf;
+    absl::Status status = req_serialize.Serialize(buf);
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(req_serialize.GetMessageType(), Network::MessageType::STREAM_FILE_REQUEST);
+
+    Network::StreamFileRequest req_deserialize;
+    status = req_deserialize.Deserialize(buf);
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(req_deserialize.GetFilePath(), "/sdcard/Download/capture.gfxr");
+    ASSERT_EQ(req_deserialize.GetOffset(), 1ull << 33);
+    ASSERT_EQ(req_deserialize.GetIdleTimeoutMs(), 2000);
+}
+
+TEST(MessagesTest, StreamFileChunk)
+{
+    Network::StreamFileChunk chunk_serialize;
+    chunk_serialize.SetOffset(4096);
+    chunk_serialize.SetData({0x00, 0x01, 0xFE, 0xFF});
+
+    Network::Buffer buf;
+    absl::Status status = chunk_serialize.Serialize(buf);
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(chunk_serialize.GetMessageType(), Network::MessageType::STREAM_FILE_CHUNK);
+
+    Network::StreamFileChunk chunk_deserialize;
+    status = chunk_deserialize.Deserialize(buf);
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(chunk_deserialize.GetOffset(), 4096);
+    ASSERT_EQ(chunk_deserialize.GetData(), chunk_serialize.GetData());
+
+    // A chunk whose declared size does not match its payload is rejected.
+    buf.pop_back();
+    ASSERT_FALSE(chunk_deserialize.Deserialize(buf).ok());
+}
+
+TEST(MessagesTest, StreamFileEnd)
+{
+    Network::StreamFileEnd end_serialize;
+    end_serialize.SetFound(false);
+    end_serialize.SetErrorReason("File was truncated while being streamed");
+    end_serialize.SetFileSize(123456);
+
+    Network::Buffer buf;
+    absl::Status status = end_serialize.Serialize(buf);
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(end_serialize.GetMessageType(), Network::MessageType::STREAM_FILE_END);
+
+    Network::StreamFileEnd end_deserialize;
+    status = end_deserialize.Deserialize(buf);
+    ASSERT_TRUE(status.ok());
+    ASSERT_FALSE(end_deserialize.GetFound());
+    ASSERT_EQ(end_deserialize.GetErrorReason(), "File was truncated while being streamed");
+    ASSERT_EQ(end_deserialize.GetFileSize(), 123456);
+}
+
+TEST(MessagesTest, LiveStateMirrorAppliesDeltas)
+{
+    Network::LiveStateMirror mirror;
+    ASSERT_EQ(mirror.GetPSOGeneration(), 0);
+
+    Network::LivePSOsDelta snapshot;
+    snapshot.generation = 2;
+    snapshot.full_snapshot = true;
+    snapshot.upserted.push_back({"Opaque", 0x2000, false});
+    snapshot.upserted.push_back({"Opaque", 0x1000, false});
+    mirror.ApplyPSOsDelta(snapshot);
+    ASSERT_EQ(mirror.GetPSOGeneration(), 2);
+    ASSERT_EQ(mirror.GetPSOs().size(), 2);
+    ASSERT_EQ(mirror.GetPSOs()[0].pipeline_handle, 0x1000);
+
+    // 0x1000 is destroyed and its handle reused by a new PSO; 0x2000 is renamed.
+    Network::LivePSOsDelta delta;
+    delta.generation = 5;
+    delta.upserted.push_back({"Reused", 0x1000, true});
+    delta.upserted.push_back({"Renamed", 0x2000, false});
+    delta.removed.push_back(0x1000);
+    mirror.ApplyPSOsDelta(delta);
+    ASSERT_EQ(mirror.GetPSOGeneration(), 5);
+    auto psos = mirror.GetPSOs();
+    ASSERT_EQ(psos.size(), 2);
+    ASSERT_EQ(psos[0].name, "Reused");
+    ASSERT_EQ(psos[1].name, "Renamed");
+
+    // A full snapshot replaces everything.
+    Network::LivePSOsDelta reset;
+    reset.generation = 9;
+    reset.full_snapshot = true;
+    reset.upserted.push_back({"Opaque", 0x3000, false});
+    mirror.ApplyPSOsDelta(reset);
+    ASSERT_EQ(mirror.GetPSOs().size(), 1);
+    ASSERT_EQ(mirror.GetPSOs()[0].pipeline_handle, 0x3000);
+
+    mirror.Reset();
+    ASSERT_EQ(mirror.GetPSOGeneration(), 0);
+    ASSERT_TRUE(mirror.GetPSOs().empty());
+}
+
 }  // namespace
@@ -0,0 +1,435 @@
+/*
+Copyright 2026 Google Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+// Loopback benchmarks of the host <-> device transport. A UnixDomainServer with a fake device
+// handler runs in the benchmark process, listening both on a Unix domain socket (as in the
+// runtime layer) and on a TCP port (as seen by the host through `adb forward`). They measure the
+// round-trip latency of each request type, the throughput of small pipelined messages and the
+// bandwidth of capture file transfers, so that regressions in the capture transfer path show up
+// without a device.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "base_message_handler.h"
+#include "live_state.h"
+#include "message_utils.h"
+#include "messages.h"
+#include "socket_connection.h"
+#include "tcp_client.h"
+#include "unix_domain_server.h"
+
+namespace Network
+{
+namespace
+{
+
+constexpr char kUnixDomainAddress[] = "dive_network_benchmark";
+constexpr char kLoopbackHost[] = "127.0.0.1";
+// Size of the live state returned by the fake device, similar to a mid-sized game.
+constexpr uint64_t kFakeLivePSOs = 512;
+constexpr uint64_t kFakeLiveRenderPasses = 32;
+
+enum Transport : int64_t
+{
+    kUnixDomain = 0,
+    kTcp = 1,
+};
+
+enum RequestKind : int64_t
+{
+    kPing = 0,
+    kFileSize = 1,
+    kLivePSOs = 2,
+    kLiveStateDelta = 3,
+};
+
+// Stands in for the runtime layer: file requests are served from the local file system by
+// BaseMessageHandler, and live state requests return a fixed set of objects. Pings are answered
+// here without logging, so that the ping round trip only measures the transport.
+class FakeDeviceHandler : public BaseMessageHandler
+{
+ public:
+    FakeDeviceHandler()
+    {
+        for (uint64_t i = 0; i < kFakeLivePSOs; ++i)
+        {
+            m_psos.push_back(PSOInfo{.name = absl::StrCat("pipeline_", i % 64),
+                                     .pipeline_handle = 0x1000 + i,
+                                     .has_alpha_blend = (i % 3) == 0});
+        }
+        for (uint64_t i = 0; i < kFakeLiveRenderPasses; ++i)
+        {
+            m_render_passes.push_back(RenderPassInfo{.name = absl::StrCat("render_pass_", i),
+                                                     .render_pass_handle = 0x9000 + i});
+        }
+    }
+
+    void OnConnect(uint64_t) override {}
+    void OnDisconnect(uint64_t) override {}
+
+    void HandleMessage(std::unique_ptr<ISerializable> message,
+                       SocketConnection* client_conn) override
+    {
+        switch (message->GetMessageType())
+        {
+            case MessageType::PING_MESSAGE:
+            {
+                (void)SendPong(client_conn);
+                return;
+            }
+            case MessageType::LIVE_PSOS_REQUEST:
+            {
+                LivePSOsResponse response;
+                response.SetPSOs(m_psos);
+                (void)SendSocketMessage(client_conn, response);
+                return;
+            }
+            case MessageType::LIVE_STATE_DELTA_REQUEST:
+            {
+                // Always a full snapshot, the worst case of a delta update.
+                LiveStateDeltaResponse response;
+                response.SetPSOsDelta(
+                    LivePSOsDelta{.generation = 1, .full_snapshot = true, .upserted = m_psos});
+                response.SetRenderPassesDelta(LiveRenderPassesDelta{
+                    .generation = 1, .full_snapshot = true, .upserted = m_render_passes});
+                (void)SendSocketMessage(client_conn, response);
+                return;
+            }
+            default:
+            {
+                BaseMessageHandler::HandleMessage(std::move(message), client_conn);
+                return;
+            }
+        }
+    }
+
+ private:
+    std::vector<PSOInfo> m_psos;
+    std::vector<RenderPassInfo> m_render_passes;
+};
+
+// The servers are shared by all benchmarks and live until the process exits.
+class LoopbackServers
+{
+ public:
+    static LoopbackServers& Get()
+    {
+        static LoopbackServers* servers = new LoopbackServers();
+        return *servers;
+    }
+
+    const std::string& GetError() const { return m_error; }
+    int GetTcpPort() const { return m_tcp_port; }
+
+    absl::StatusOr<std::unique_ptr<SocketConnection>> Connect(Transport transport)
+    {
+        auto connection = SocketConnection::Create();
+        if (!connection.ok())
+        {
+            return connection.status();
+        }
+        absl::Status status = (transport == kUnixDomain) ?
+                                  (*connection)->ConnectToUnixDomain(kUnixDomainAddress) :
+                                  (*connection)->Connect(kLoopbackHost, m_tcp_port);
+        if (!status.ok())
+        {
+            return status;
+        }
+        return connection;
+    }
+
+ private:
+    LoopbackServers()
+        : m_unix_domain_server(std::make_unique<FakeDeviceHandler>()),
+          m_tcp_server(std::make_unique<FakeDeviceHandler>())
+    {
+        if (absl::Status status = m_unix_domain_server.Start(kUnixDomainAddress); !status.ok())
+        {
+            m_error = std::string(status.message());
+            return;
+        }
+        if (absl::Status status = m_tcp_server.StartTcp(kLoopbackHost, 0); !status.ok())
+        {
+            m_error = std::string(status.message());
+            return;
+        }
+        auto port = m_tcp_server.GetTcpPort();
+        if (!port.ok())
+        {
+            m_error = std::string(port.status().message());
+            return;
+        }
+        m_tcp_port = *port;
+    }
+
+    UnixDomainServer m_unix_domain_server;
+    UnixDomainServer m_tcp_server;
+    int m_tcp_port = 0;
+    std::string m_error;
+};
+
+// A file of `size` bytes that the fake device can serve, removed at exit.
+class TempFile
+{
+ public:
+    explicit TempFile(uint64_t size)
+        : m_path((std::filesystem::temp_directory_path() /
+                  absl::StrCat("dive_network_benchmark_", size, ".bin"))
+                     .string())
+    {
+        std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+        std::vector<char> block(1 << 20, 'D');
+        for (uint64_t written = 0; written < size; written += block.size())
+        {
+            file.write(block.data(), std::min<uint64_t>(block.size(), size - written));
+        }
+    }
+    ~TempFile() { std::filesystem::remove(m_path); }
+
+    const std::string& GetPath() const { return m_path; }
+
+ private:
+    std::string m_path;
+};
+
+std::unique_ptr<ISerializable> MakeRequest(RequestKind kind, const std::string& file_path)
+{
+    switch (kind)
+    {
+        case kPing:
+            return std::make_unique<PingMessage>();
+        case kFileSize:
+        {
+            auto request = std::make_unique<FileSizeRequest>();
+            request->SetString(file_path);
+            return request;
+        }
+        case kLivePSOs:
+            return std::make_unique<LivePSOsRequest>();
+        case kLiveStateDelta:
+            return std::make_unique<LiveStateDeltaRequest>();
+    }
+    return nullptr;
+}
+
+MessageType GetExpectedResponse(RequestKind kind)
+{
+    switch (kind)
+    {
+        case kPing:
+            return MessageType::PONG_MESSAGE;
+        case kFileSize:
+            return MessageType::FILE_SIZE_RESPONSE;
+        case kLivePSOs:
+            return MessageType::LIVE_PSOS_RESPONSE;
+        case kLiveStateDelta:
+            return MessageType::LIVE_STATE_DELTA_RESPONSE;
+    }
+    return MessageType::PONG_MESSAGE;
+}
+
+// Connects to the loopback server of `transport`, or skips the benchmark with an error.
+std::unique_ptr<SocketConnection> ConnectOrSkip(benchmark::State& state, Transport transport)
+{
+    LoopbackServers& servers = LoopbackServers::Get();
+    if (!servers.GetError().empty())
+    {
+        state.SkipWithError(servers.GetError().c_str());
+        return nullptr;
+    }
+    auto connection = servers.Connect(transport);
+    if (!connection.ok())
+    {
+        state.SkipWithError(std::string(connection.status().message()).c_str());
+        return nullptr;
+    }
+    return *std::move(connection);
+}
+
+// Latency of one request and its response. Args: transport, request kind.
+void BM_RoundTrip(benchmark::State& state)
+{
+    auto transport = static_cast<Transport>(state.range(0));
+    auto kind = static_cast<RequestKind>(state.range(1));
+    std::unique_ptr<SocketConnection> connection = ConnectOrSkip(state, transport);
+    if (!connection)
+    {
+        return;
+    }
+    TempFile file(4096);
+    std::unique_ptr<ISerializable> request = MakeRequest(kind, file.GetPath());
+    MessageType expected_response = GetExpectedResponse(kind);
+
+    for (auto _ : state)
+    {
+        if (!SendSocketMessage(connection.get(), *request).ok())
+        {
+            state.SkipWithError("Send failed");
+            break;
+        }
+        auto response = ReceiveSocketMessage(connection.get());
+        if (!response.ok() || (*response)->GetMessageType() != expected_response)
+        {
+            state.SkipWithError("Receive failed");
+            break;
+        }
+        benchmark::DoNotOptimize(*response);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RoundTrip)
+    ->ArgNames({"transport", "request"})
+    ->ArgsProduct({{kUnixDomain, kTcp}, {kPing, kFileSize, kLivePSOs, kLiveStateDelta}})
+    ->UseRealTime();
+
+// Throughput of small messages: sends a batch of pings before reading the pongs, as the
+// keep-alive and polling requests of several tools do. Args: transport, batch size.
+void BM_PipelinedPings(benchmark::State& state)
+{
+    auto transport = static_cast<Transport>(state.range(0));
+    int64_t batch_size = state.range(1);
+    std::unique_ptr<SocketConnection> connection = ConnectOrSkip(state, transport);
+    if (!connection)
+    {
+        return;
+    }
+    PingMessage ping;
+
+    for (auto _ : state)
+    {
+        for (int64_t i = 0; i < batch_size; ++i)
+        {
+            if (!SendSocketMessage(connection.get(), ping).ok())
+            {
+                state.SkipWithError("Send failed");
+                return;
+            }
+        }
+        for (int64_t i = 0; i < batch_size; ++i)
+        {
+            auto response = ReceiveSocketMessage(connection.get());
+            if (!response.ok())
+            {
+                state.SkipWithError("Receive failed");
+                return;
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_PipelinedPings)
+    ->ArgNames({"transport", "batch"})
+    ->ArgsProduct({{kUnixDomain, kTcp}, {16, 256}})
+    ->UseRealTime();
+
+// Bandwidth of a DOWNLOAD_FILE_REQUEST, written to a local file like a retrieved capture.
+// Args: transport, file size.
+void BM_DownloadFile(benchmark::State& state)
+{
+    auto transport = static_cast<Transport>(state.range(0));
+    uint64_t file_size = static_cast<uint64_t>(state.range(1));
+    std::unique_ptr<SocketConnection> connection = ConnectOrSkip(state, transport);
+    if (!connection)
+    {
+        return;
+    }
+    TempFile file(file_size);
+    std::string local_path = file.GetPath() + ".download";
+    DownloadFileRequest request;
+    request.SetString(file.GetPath());
+
+    for (auto _ : state)
+    {
+        if (!SendSocketMessage(connection.get(), request).ok())
+        {
+            state.SkipWithError("Send failed");
+            break;
+        }
+        auto response = ReceiveSocketMessage(connection.get());
+        if (!response.ok() || (*response)->GetMessageType() != MessageType::DOWNLOAD_FILE_RESPONSE)
+        {
+            state.SkipWithError("Receive failed");
+            break;
+        }
+        auto* download_response = static_cast<DownloadFileResponse*>(response->get());
+        if (!download_response->GetFound() ||
+            !connection->ReceiveFile(local_path, download_response->GetFileSize()).ok())
+        {
+            state.SkipWithError("Download failed");
+            break;
+        }
+    }
+    std::filesystem::remove(local_path);
+    state.SetBytesProcessed(state.iterations() * file_size);
+}
+BENCHMARK(BM_DownloadFile)
+    ->ArgNames({"transport", "bytes"})
+    ->ArgsProduct({{kUnixDomain, kTcp}, {1 << 20, 64 << 20}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// End-to-end bandwidth of the host client streaming a finished capture over TCP.
+// Args: file size.
+void BM_TcpClientStreamFile(benchmark::State& state)
+{
+    uint64_t file_size = static_cast<uint64_t>(state.range(0));
+    LoopbackServers& servers = LoopbackServers::Get();
+    if (!servers.GetError().empty())
+    {
+        state.SkipWithError(servers.GetError().c_str());
+        return;
+    }
+    TcpClient client;
+    if (!client.Connect(kLoopbackHost, servers.GetTcpPort()).ok())
+    {
+        state.SkipWithError("Connect failed");
+        return;
+    }
+    TempFile file(file_size);
+    std::string local_path = file.GetPath() + ".stream";
+
+    for (auto _ : state)
+    {
+        std::filesystem::remove(local_path);
+        auto streamed = client.StreamFileFromServer(file.GetPath(), local_path,
+                                                    /*idle_timeout_ms=*/0);
+        if (!streamed.ok() || *streamed != file_size)
+        {
+            state.SkipWithError("Stream failed");
+            break;
+        }
+    }
+    std::filesystem::remove(local_path);
+    client.Disconnect();
+    state.SetBytesProcessed(state.iterations() * file_size);
+}
+BENCHMARK(BM_TcpClientStreamFile)
+    ->ArgNames({"bytes"})
+    ->Arg(1 << 20)
+    ->Arg(64 << 20)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace Network
@@ -55,10 +55,16 @@ class SocketConnection
 
     // Server methods.
     absl::Status BindAndListenOnUnixDomain(const std::string& server_address);
+    // Listens on a TCP port of `host`. A port of 0 picks a free port, see GetLocalPort().
+    absl::Status BindAndListenOnTcp(const std::string& host, int port);
     absl::StatusOr<std::unique_ptr<SocketConnection>> Accept();
 
-    // Client method.
+    // Returns the local TCP port the socket is bound to.
+    absl::StatusOr<int> GetLocalPort() const;
+
+    // Client methods.
     absl::Status Connect(const std::string& host, int port);
+    absl::Status ConnectToUnixDomain(const std::string& server_address);
 
     // Data transfer methods.
     absl::Status Send(const uint8_t* data, size_t size);
@@ -72,6 +78,9 @@ class SocketConnection
     void Close();
     bool IsOpen() const;
 
+    // Returns the underlying socket handle, e.g. to register it with an event loop.
+    SocketType GetSocket() const { return m_socket; }
+
  private:
     explicit SocketConnection(SocketType initial_socket_value);
 
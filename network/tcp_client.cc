@@ -16,6 +16,7 @@ limitations under the License.
 #include "tcp_client.h"
 
 #include <chrono>
+#include <fstream>
 
 #include "absl/strings/str_cat.h"
 #include "dive/common/status.h"
@@ -44,6 +45,10 @@ absl::Status TcpClient::Connect(const std::string& host, int port)
 
     StopKeepAlive();
     m_connection.reset();
+    m_live_state.Reset();
+    m_live_state_deltas_supported = true;
+    m_host = host;
+    m_port = port;
 
     SetClientStatus(ClientStatus::CONNECTING);
     auto connection = SocketConnection::Create();
@@ -64,7 +69,11 @@ absl::Status TcpClient::Connect(const std::string& host, int port)
     SetClientStatus(ClientStatus::CONNECTED);
 
     std::cout << "Client: Connected & handshaking." << std::endl;
-    auto handshake_status = PerformHandshake();
+    absl::Status handshake_status;
+    {
+        std::lock_guard<std::mutex> lock(m_connection_mutex);
+        handshake_status = PerformHandshake();
+    }
     if (!handshake_status.ok())
     {
         m_connection.reset();
@@ -97,6 +106,7 @@ void TcpClient::Disconnect()
 {
     StopKeepAlive();
     m_connection.reset();
+    m_live_state.Reset();
     SetClientStatus(ClientStatus::DISCONNECTED);
     std::cout << "Client: Disconnected." << std::endl;
 }
@@ -225,6 +235,110 @@ absl::Status TcpClient::DownloadFileFromServer(const std::string& remote_file_pa
     return Dive::OkStatus();
 }
 
+absl::StatusOr<uint64_t> TcpClient::StreamFileFromServer(
+    const std::string& remote_file_path, const std::string& local_save_path,
+    uint32_t idle_timeout_ms, uint64_t offset, std::function<void(size_t)> progress_callback)
+{
+    std::lock_guard<std::mutex> lock(m_connection_mutex);
+    if (!IsConnected())
+    {
+        return Dive::FailedPreconditionError("StreamFileFromServer: Client is not connected.");
+    }
+
+    std::ofstream file(local_save_path,
+                       std::ios::binary | (offset > 0 ? std::ios::app : std::ios::trunc));
+    if (!file.is_open())
+    {
+        return Dive::InternalError(
+            absl::StrCat("StreamFileFromServer: Failed to open local file ", local_save_path));
+    }
+
+    StreamFileRequest stream_request;
+    stream_request.SetFilePath(remote_file_path);
+    stream_request.SetOffset(offset);
+    stream_request.SetIdleTimeoutMs(idle_timeout_ms);
+
+    std::cout << "Client: Requesting to stream file from server '" << remote_file_path
+              << "' to '" << local_save_path << "' from offset " << offset << "." << std::endl;
+    absl::Status send_status = SendSocketMessage(m_connection.get(), stream_request);
+    if (!send_status.ok())
+    {
+        return SetStatusAndReturnError(ClientStatus::CONNECTION_FAILED,
+                                       Dive::StatusWithContext(send_status,
+                                                               "StreamFileFromServer: "
+                                                               "SendSocketMessage fail"));
+    }
+
+    uint64_t received_size = offset;
+    while (true)
+    {
+        absl::StatusOr<std::unique_ptr<ISerializable>> receive =
+            ReceiveSocketMessage(m_connection.get());
+        if (!receive.ok())
+        {
+            return SetStatusAndReturnError(ClientStatus::CONNECTION_FAILED,
+                                           Dive::StatusWithContext(receive.status(),
+                                                                   "StreamFileFromServer: "
+                                                                   "ReceiveSocketMessage fail"));
+        }
+
+        std::unique_ptr<ISerializable> message = *std::move(receive);
+        if (message->GetMessageType() == MessageType::STREAM_FILE_CHUNK)
+        {
+            auto* chunk = static_cast<StreamFileChunk*>(message.get());
+            if (chunk->GetOffset() != received_size)
+            {
+                // The rest of the stream cannot be consumed reliably anymore.
+                std::string error = absl::StrCat("StreamFileFromServer: Expected chunk at offset ",
+                                                 received_size, ", got ", chunk->GetOffset());
+                return SetStatusAndReturnError(ClientStatus::CONNECTION_FAILED,
+                                               Dive::DataLossError(error));
+            }
+            const Buffer& data = chunk->GetData();
+            file.write(reinterpret_cast<const char*>(data.data()),
+                       static_cast<std::streamsize>(data.size()));
+            if (!file)
+            {
+                return SetStatusAndReturnError(
+                    ClientStatus::CONNECTION_FAILED,
+                    Dive::InternalError(absl::StrCat(
+                        "StreamFileFromServer: Failed to write local file ", local_save_path)));
+            }
+            received_size += data.size();
+            if (progress_callback)
+            {
+                progress_callback(static_cast<size_t>(received_size));
+            }
+            continue;
+        }
+
+        if (message->GetMessageType() != MessageType::STREAM_FILE_END)
+        {
+            return Dive::FailedPreconditionError(absl::StrCat(
+                "StreamFileFromServer: Unexpected message type in stream (Expected: ",
+                MessageType::STREAM_FILE_END, ", Got: ", message->GetMessageType(), ")."));
+        }
+        auto* end = static_cast<StreamFileEnd*>(message.get());
+        if (!end->GetFound())
+        {
+            return Dive::NotFoundError(
+                absl::StrCat("StreamFileFromServer: Server could not stream file. Reason: ",
+                             end->GetErrorReason()));
+        }
+        if (end->GetFileSize() != received_size)
+        {
+            return Dive::DataLossError(absl::StrCat("StreamFileFromServer: Received ",
+                                                    received_size, " bytes, server sent ",
+                                                    end->GetFileSize()));
+        }
+        break;
+    }
+
+    std::cout << "Client: File from server '" << remote_file_path << "' streamed successfully to '"
+              << local_save_path << "' (" << received_size << " bytes)." << std::endl;
+    return received_size;
+}
+
 absl::StatusOr<size_t> TcpClient::GetCaptureFileSize(const std::string& remote_file_path)
 {
     std::lock_guard<std::mutex> lock(m_connection_mutex);
@@ -391,6 +505,111 @@ absl::StatusOr<std::vector<PSOInfo>> TcpClient::GetLivePSOs()
         return Dive::FailedPreconditionError("GetLivePSOs: Client not connected.");
     }
 
+    absl::Status sync_status = SyncLiveState();
+    if (absl::IsUnimplemented(sync_status))
+    {
+        return RequestLivePSOs();
+    }
+    if (!sync_status.ok())
+    {
+        return Dive::StatusWithContext(sync_status, "GetLivePSOs");
+    }
+    return m_live_state.GetPSOs();
+}
+
+absl::StatusOr<std::vector<RenderPassInfo>> TcpClient::GetLiveRenderPasses()
+{
+    std::lock_guard<std::mutex> lock(m_connection_mutex);
+    if (!IsConnected())
+    {
+        return Dive::FailedPreconditionError("GetLiveRenderPasses: Client not connected.");
+    }
+
+    absl::Status sync_status = SyncLiveState();
+    if (absl::IsUnimplemented(sync_status))
+    {
+        return RequestLiveRenderPasses();
+    }
+    if (!sync_status.ok())
+    {
+        return Dive::StatusWithContext(sync_status, "GetLiveRenderPasses");
+    }
+    return m_live_state.GetRenderPasses();
+}
+
+absl::Status TcpClient::Reconnect()
+{
+    m_connection.reset();
+    auto connection = SocketConnection::Create();
+    if (!connection.ok())
+    {
+        return Dive::StatusWithContext(connection.status(), "Reconnect");
+    }
+    absl::Status conn_status = (*connection)->Connect(m_host, m_port);
+    if (!conn_status.ok())
+    {
+        return Dive::StatusWithContext(conn_status, "Reconnect: Connect fail");
+    }
+    m_connection = *std::move(connection);
+    return PerformHandshake();
+}
+
+absl::Status TcpClient::SyncLiveState()
+{
+    if (!m_live_state_deltas_supported)
+    {
+        return Dive::UnimplementedError("SyncLiveState: Server doesn't support live-state deltas.");
+    }
+
+    LiveStateDeltaRequest request;
+    request.SetPSOGeneration(m_live_state.GetPSOGeneration());
+    request.SetRenderPassGeneration(m_live_state.GetRenderPassGeneration());
+    absl::Status send_status = SendSocketMessage(m_connection.get(), request);
+    if (!send_status.ok())
+    {
+        return SetStatusAndReturnError(
+            ClientStatus::CONNECTION_FAILED,
+            Dive::StatusWithContext(send_status, "SyncLiveState: SendSocketMessage fail"));
+    }
+
+    absl::StatusOr<std::unique_ptr<ISerializable>> receive =
+        ReceiveSocketMessage(m_connection.get());
+    if (!receive.ok())
+    {
+        // Servers that predate the deltas drop the connection on the unknown request. If the
+        // server is still there, it is one of them.
+        absl::Status reconnect_status = Reconnect();
+        if (!reconnect_status.ok())
+        {
+            return SetStatusAndReturnError(
+                ClientStatus::CONNECTION_FAILED,
+                Dive::StatusWithContext(receive.status(),
+                                        "SyncLiveState: ReceiveSocketMessage fail"));
+        }
+        std::cout << "Client: Server doesn't support live-state deltas, reconnected." << std::endl;
+        m_live_state_deltas_supported = false;
+        return Dive::UnimplementedError("SyncLiveState: Server doesn't support live-state deltas.");
+    }
+
+    std::unique_ptr<ISerializable> response = *std::move(receive);
+    if (response->GetMessageType() != MessageType::LIVE_STATE_DELTA_RESPONSE)
+    {
+        std::cout << "Client: Server rejected the live-state delta request (response type "
+                  << static_cast<uint32_t>(response->GetMessageType()) << ")." << std::endl;
+        m_live_state_deltas_supported = false;
+        return Dive::UnimplementedError(absl::StrCat(
+            "SyncLiveState: Unexpected message type in response (Expected: ",
+            MessageType::LIVE_STATE_DELTA_RESPONSE, ", Got: ", response->GetMessageType(), ")."));
+    }
+
+    auto* delta_response = static_cast<LiveStateDeltaResponse*>(response.get());
+    m_live_state.ApplyPSOsDelta(delta_response->TakePSOsDelta());
+    m_live_state.ApplyRenderPassesDelta(delta_response->TakeRenderPassesDelta());
+    return Dive::OkStatus();
+}
+
+absl::StatusOr<std::vector<PSOInfo>> TcpClient::RequestLivePSOs()
+{
     LivePSOsRequest request;
     absl::Status send_status = SendSocketMessage(m_connection.get(), request);
     if (!send_status.ok())
@@ -420,14 +639,8 @@ absl::StatusOr<std::vector<PSOInfo>> TcpClient::GetLivePSOs()
     return static_cast<LivePSOsResponse*>(response.get())->TakePSOs();
 }
 
-absl::StatusOr<std::vector<RenderPassInfo>> TcpClient::GetLiveRenderPasses()
+absl::StatusOr<std::vector<RenderPassInfo>> TcpClient::RequestLiveRenderPasses()
 {
-    std::lock_guard<std::mutex> lock(m_connection_mutex);
-    if (!IsConnected())
-    {
-        return Dive::FailedPreconditionError("GetLiveRenderPasses: Client not connected.");
-    }
-
     LiveRenderPassesRequest request;
     absl::Status send_status = SendSocketMessage(m_connection.get(), request);
     if (!send_status.ok())
@@ -547,7 +760,6 @@ absl::Status TcpClient::PingServer()
 
 absl::Status TcpClient::PerformHandshake()
 {
-    std::lock_guard<std::mutex> lock(m_connection_mutex);
     if (!IsConnected())
     {
         return Dive::FailedPreconditionError(
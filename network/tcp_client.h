@@ -62,6 +62,15 @@ class TcpClient
                                         const std::string& local_save_path,
                                         std::function<void(size_t)> progress_callback = nullptr);
 
+    // Streams a file that is still being written on the server, appending the data to a local
+    // file as it arrives. Returns the size of the file once it has not grown for
+    // `idle_timeout_ms`. A non-zero `offset` resumes an earlier stream: the local file must hold
+    // exactly the first `offset` bytes.
+    absl::StatusOr<uint64_t> StreamFileFromServer(
+        const std::string& remote_file_path, const std::string& local_save_path,
+        uint32_t idle_timeout_ms, uint64_t offset = 0,
+        std::function<void(size_t)> progress_callback = nullptr);
+
     // Gets the capture file size from the server.
     absl::StatusOr<size_t> GetCaptureFileSize(const std::string& remote_file_path);
 
@@ -71,10 +80,12 @@ class TcpClient
     // Sends a drawcall filter configuration request to the server.
     absl::Status SendDrawcallFilterConfig(const DrawcallFilterConfig& config);
 
-    // Requests the list of live PSOs from the server.
+    // Returns the list of live PSOs on the server. Only the changes since the previous call are
+    // transferred, unless the server predates live-state deltas.
     absl::StatusOr<std::vector<PSOInfo>> GetLivePSOs();
 
-    // Requests the list of live render passes from the server.
+    // Returns the list of live render passes on the server. Only the changes since the previous
+    // call are transferred, unless the server predates live-state deltas.
     absl::StatusOr<std::vector<RenderPassInfo>> GetLiveRenderPasses();
 
     // Sends a disable timestamp request to the server.
@@ -84,9 +95,23 @@ class TcpClient
     // Performs a ping-pong check with the server.
     absl::Status PingServer();
 
-    // Performs a handshake with the server.
+    // Performs a handshake with the server. The caller must hold m_connection_mutex.
     absl::Status PerformHandshake();
 
+    // Replaces the connection with a new one to the same server. The caller must hold
+    // m_connection_mutex.
+    absl::Status Reconnect();
+
+    // Brings m_live_state up to date with the server. Returns UnimplementedError if the server
+    // doesn't support live-state deltas, in which case the full lists have to be requested. The
+    // caller must hold m_connection_mutex.
+    absl::Status SyncLiveState();
+
+    // Requests the full lists of live PSOs and render passes. The caller must hold
+    // m_connection_mutex.
+    absl::StatusOr<std::vector<PSOInfo>> RequestLivePSOs();
+    absl::StatusOr<std::vector<RenderPassInfo>> RequestLiveRenderPasses();
+
     // Starts the keep-alive checking.
     absl::Status StartKeepAlive();
 
@@ -101,8 +126,15 @@ class TcpClient
     absl::Status SetStatusAndReturnError(ClientStatus status, const absl::Status& error_status);
 
     std::unique_ptr<SocketConnection> m_connection;
+    std::string m_host;
+    int m_port = 0;
     std::mutex m_connection_mutex;
     ClientStatus m_status = ClientStatus::DISCONNECTED;
+    // Local copy of the server's live PSOs and render passes, guarded by m_connection_mutex.
+    LiveStateMirror m_live_state;
+    // False once the server turned out not to support live-state deltas, guarded by
+    // m_connection_mutex.
+    bool m_live_state_deltas_supported = true;
     mutable std::mutex m_status_mutex;
 
     // KeepAlive is used to check the connection with the server periodically via a ping-pong
@@ -0,0 +1,150 @@
+/*
+Copyright 2026 Google Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "telemetry_client.h"
+
+#include <utility>
+
+#include "dive/common/log.h"
+#include "dive/common/macros.h"
+#include "dive/common/status.h"
+
+namespace Network
+{
+
+namespace
+{
+
+// How long to wait for the subscription to be acknowledged.
+constexpr int kSubscribeTimeoutMs = 5000;
+
+// How often the receive thread checks for Stop() while no batch arrives.
+constexpr int kStopPollIntervalMs = 200;
+
+// Receives the rest of a message whose first byte has already been read.
+absl::StatusOr<std::unique_ptr<ISerializable>> ReceiveRemainingMessage(SocketConnection* conn,
+                                                                       uint8_t first_byte)
+{
+    uint8_t header[kMessageHeaderSize] = {first_byte};
+    RETURN_IF_ERROR(ReceiveBuffer(conn, header + 1, kMessageHeaderSize - 1));
+    uint32_t type = 0, payload_length = 0;
+    RETURN_IF_ERROR(ParseMessageHeader(header, type, payload_length));
+    Buffer payload(payload_length);
+    RETURN_IF_ERROR(ReceiveBuffer(conn, payload.data(), payload_length));
+    return DeserializeMessage(type, payload);
+}
+
+}  // namespace
+
+TelemetryClient::~TelemetryClient() { Stop(); }
+
+absl::Status TelemetryClient::Start(const std::string& host, int port, uint32_t frames_per_batch,
+                                    BatchCallback callback)
+{
+    if (m_receive_thread.joinable())
+    {
+        return Dive::AlreadyExistsError("Start: Telemetry client is already running.");
+    }
+    if (frames_per_batch == 0 || !callback)
+    {
+        return Dive::InvalidArgumentError("Start: Invalid batch size or callback.");
+    }
+
+    auto connection = SocketConnection::Create();
+    if (!connection.ok())
+    {
+        return Dive::StatusWithContext(connection.status(), "Start");
+    }
+    auto status = (*connection)->Connect(host, port);
+    if (!status.ok())
+    {
+        return Dive::StatusWithContext(status, "Start: Connect fail");
+    }
+
+    TelemetrySubscribeRequest request;
+    request.SetEnable(true);
+    request.SetFramesPerBatch(frames_per_batch);
+    status = SendSocketMessage(connection->get(), request);
+    if (!status.ok())
+    {
+        return Dive::StatusWithContext(status, "Start: Send subscribe request");
+    }
+    auto response = ReceiveSocketMessage(connection->get(), kSubscribeTimeoutMs);
+    if (!response.ok())
+    {
+        return Dive::StatusWithContext(response.status(), "Start: Receive subscribe response");
+    }
+    if ((*response)->GetMessageType() != MessageType::TELEMETRY_SUBSCRIBE_RESPONSE)
+    {
+        return Dive::InternalError("Start: Unexpected response to the subscribe request.");
+    }
+
+    m_connection = *std::move(connection);
+    m_callback = std::move(callback);
+    m_stop_requested.store(false);
+    m_running.store(true);
+    m_receive_thread = std::thread(&TelemetryClient::ReceiveLoop, this);
+    return Dive::OkStatus();
+}
+
+void TelemetryClient::Stop()
+{
+    m_stop_requested.store(true);
+    if (m_receive_thread.joinable())
+    {
+        m_receive_thread.join();
+    }
+    m_connection.reset();
+    m_callback = nullptr;
+}
+
+void TelemetryClient::ReceiveLoop()
+{
+    while (!m_stop_requested.load())
+    {
+        // Only the first byte is awaited with a timeout: a message is never abandoned halfway,
+        // which would desynchronize the stream.
+        uint8_t first_byte = 0;
+        auto received = m_connection->Recv(&first_byte, 1, kStopPollIntervalMs);
+        if (!received.ok())
+        {
+            if (absl::IsDeadlineExceeded(received.status()))
+            {
+                continue;
+            }
+            LOGW("TelemetryClient: Stream ended: %.*s",
+                 static_cast<int>(received.status().message().length()),
+                 received.status().message().data());
+            break;
+        }
+        auto message = ReceiveRemainingMessage(m_connection.get(), first_byte);
+        if (!message.ok())
+        {
+            LOGW("TelemetryClient: Failed to receive batch: %.*s",
+                 static_cast<int>(message.status().message().length()),
+                 message.status().message().data());
+            break;
+        }
+
+        if ((*message)->GetMessageType() == MessageType::TELEMETRY_BATCH)
+        {
+            m_callback(static_cast<const TelemetryBatch&>(**message));
+        }
+    }
+    m_running.store(false);
+}
+
+}  // namespace Network
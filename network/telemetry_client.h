@@ -0,0 +1,63 @@
+/*
+Copyright 2026 Google Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "messages.h"
+
+namespace Network
+{
+
+// Receives the telemetry stream pushed by the runtime layer (frame times, draw counts and GPU
+// time summaries), e.g. to drive a live performance HUD. It uses a connection of its own, next to
+// the TcpClient used for requests, since batches arrive without being asked for.
+class TelemetryClient
+{
+ public:
+    // Called from the receive thread for every batch.
+    using BatchCallback = std::function<void(const TelemetryBatch&)>;
+
+    ~TelemetryClient();
+
+    // Connects to the server, subscribes to batches of `frames_per_batch` frames and starts the
+    // receive thread.
+    absl::Status Start(const std::string& host, int port, uint32_t frames_per_batch,
+                       BatchCallback callback);
+
+    // Stops the receive thread and closes the connection, which ends the subscription.
+    void Stop();
+
+    // Returns true while batches are being received.
+    bool IsRunning() const { return m_running.load(); }
+
+ private:
+    void ReceiveLoop();
+
+    std::unique_ptr<SocketConnection> m_connection;
+    BatchCallback m_callback;
+    std::thread m_receive_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_stop_requested{false};
+};
+
+}  // namespace Network
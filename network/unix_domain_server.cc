@@ -16,6 +16,20 @@ limitations under the License.
 
 #include "unix_domain_server.h"
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+#ifndef WIN32
+#include <sys/socket.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+
+#include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "dive/common/log.h"
 #include "dive/common/status.h"
@@ -23,9 +37,108 @@ limitations under the License.
 namespace Network
 {
 
+namespace
+{
+
+// Maximum number of bytes read from one client per readiness notification. Bounding it keeps the
+// event loop fair between clients.
+constexpr size_t kReadChunkSize = 64 * 1024;
+
+// Maximum number of events handled per epoll_wait() call.
+constexpr int kMaxEpollEvents = 32;
+
+// Maximum number of messages a handler thread processes for one client before giving the other
+// clients a turn.
+constexpr uint32_t kMaxMessagesPerDispatch = 8;
+
+// epoll user data of the listen socket and of the wake-up eventfd. Client ids start after them.
+constexpr uint64_t kListenEventId = 0;
+constexpr uint64_t kWakeEventId = 1;
+constexpr uint64_t kFirstClientId = 2;
+
+// Receives the data available on a socket, up to `size` bytes. The event loop must never block,
+// while the receive threads of the fallback wait for data. Returns 0 once the peer has closed the
+// connection.
+ssize_t ReceiveAvailable(SocketType socket, uint8_t* data, size_t size)
+{
+#if defined(__linux__)
+    return ::recv(socket, data, size, MSG_DONTWAIT);
+#elif defined(WIN32)
+    return ::recv(static_cast<SOCKET>(socket), reinterpret_cast<char*>(data),
+                  static_cast<int>(size), 0);
+#else
+    return ::recv(socket, data, size, 0);
+#endif
+}
+
+// Shuts down both directions of a socket, waking up any thread blocked on it, without releasing
+// the handle.
+void ShutdownSocket(SocketType socket)
+{
+#ifdef WIN32
+    ::shutdown(static_cast<SOCKET>(socket), SD_BOTH);
+#else
+    ::shutdown(socket, SHUT_RDWR);
+#endif
+}
+
+#ifndef __linux__
+// Duplicates the handle of a client socket for its receive thread, so that the handle the thread
+// blocks on stays valid when a handler thread closes the connection. Server sockets are not
+// supported on Windows, see SocketConnection::Accept().
+SocketType DuplicateSocket(SocketType socket)
+{
+#ifdef WIN32
+    return kInvalidSocketValue;
+#else
+    return ::dup(socket);
+#endif
+}
+#endif
+
+}  // namespace
+
+struct UnixDomainServer::ClientState
+{
+    uint64_t id = 0;
+    std::unique_ptr<SocketConnection> connection;
+    // Socket handle the client is read from, while the handler threads write responses through
+    // `connection`. With the event loop, it is the handle of `connection` captured at accept time.
+    // Otherwise it is a duplicate owned by `receive_connection`, which the receive thread reads.
+    SocketType socket = kInvalidSocketValue;
+    std::unique_ptr<SocketConnection> receive_connection;
+    // Received bytes that do not form a complete message yet. Only used by the reading thread.
+    Buffer read_buffer;
+
+    std::mutex mutex;
+    // Work waiting for a handler thread: received messages to handle, and pushed messages to
+    // send. Both share the queue so that pushes are ordered with the responses.
+    struct PendingMessage
+    {
+        std::unique_ptr<ISerializable> message;
+        bool is_push = false;
+    };
+    std::deque<PendingMessage> pending_messages;
+    // Number of pushed messages in `pending_messages`.
+    uint32_t pending_pushes = 0;
+    // True while the client is queued for, or being processed by, a handler thread.
+    bool scheduled = false;
+    // True while the socket is removed from the epoll read set because of back-pressure.
+    bool reading_paused = false;
+    // True once a handler thread has closed the connection (e.g. the peer reset it on send).
+    bool socket_closed = false;
+    // True once the I/O thread has dropped the client. No work may be queued after that.
+    bool closed = false;
+    // Signaled when reading resumes or the client closes, for the receive thread of the fallback.
+    std::condition_variable resume_cv;
+};
+
 DefaultMessageHandler::DefaultMessageHandler() {}
 
-void DefaultMessageHandler::OnConnect() { LOGI("DefaultMessageHandler::OnConnect()"); }
+void DefaultMessageHandler::OnConnect(uint64_t client_id)
+{
+    LOGI("DefaultMessageHandler::OnConnect(%" PRIu64 ")", client_id);
+}
 
 void DefaultMessageHandler::HandleMessage(std::unique_ptr<ISerializable> message,
                                           SocketConnection* client_conn)
@@ -91,10 +204,20 @@ void DefaultMessageHandler::HandleMessage(std::unique_ptr<ISerializable> message
     }
 }
 
-void DefaultMessageHandler::OnDisconnect() { LOGI("DefaultMessageHandler::OnDisconnect()"); }
+void DefaultMessageHandler::OnDisconnect(uint64_t client_id)
+{
+    LOGI("DefaultMessageHandler::OnDisconnect(%" PRIu64 ")", client_id);
+}
 
-UnixDomainServer::UnixDomainServer(std::unique_ptr<IMessageHandler> handler)
-    : m_handler(std::move(handler)), m_is_running(false)
+UnixDomainServer::UnixDomainServer(std::unique_ptr<IMessageHandler> handler,
+                                   uint32_t num_handler_threads)
+    : m_epoll_fd(-1),
+      m_wake_fd(-1),
+      m_next_client_id(kFirstClientId),
+      m_num_handler_threads(std::max(num_handler_threads, 1u)),
+      m_handlers_running(false),
+      m_handler(std::move(handler)),
+      m_is_running(false)
 {
 }
 
@@ -117,10 +240,75 @@ absl::Status UnixDomainServer::Start(const std::string& server_address)
     {
         return Dive::StatusWithContext(conn_status, "Start: Failed to bind and listen socket");
     }
+    return StartEventLoop(*std::move(connection));
+}
+
+absl::Status UnixDomainServer::StartTcp(const std::string& host, int port)
+{
+    if (m_is_running.load())
+    {
+        return Dive::AlreadyExistsError("StartTcp: Server is already running.");
+    }
+
+    auto connection = SocketConnection::Create();
+    if (!connection.ok())
+    {
+        return Dive::StatusWithContext(connection.status(), "StartTcp: Failed to create socket");
+    }
+    auto conn_status = (*connection)->BindAndListenOnTcp(host, port);
+    if (!conn_status.ok())
+    {
+        return Dive::StatusWithContext(conn_status, "StartTcp: Failed to bind and listen socket");
+    }
+    return StartEventLoop(*std::move(connection));
+}
+
+absl::StatusOr<int> UnixDomainServer::GetTcpPort() const
+{
+    if (!m_is_running.load() || !m_listen_connection)
+    {
+        return Dive::FailedPreconditionError("GetTcpPort: Server is not running.");
+    }
+    return m_listen_connection->GetLocalPort();
+}
 
-    m_listen_connection = *std::move(connection);
+absl::Status UnixDomainServer::StartEventLoop(std::unique_ptr<SocketConnection> listen_connection)
+{
+#ifdef __linux__
+    m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    m_wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_epoll_fd < 0 || m_wake_fd < 0)
+    {
+        auto status = Dive::InternalError(
+            absl::StrCat("Start: Failed to create event loop: ", strerror(errno)));
+        Stop();
+        return status;
+    }
+
+    epoll_event listen_event{.events = EPOLLIN, .data = {.u64 = kListenEventId}};
+    epoll_event wake_event{.events = EPOLLIN, .data = {.u64 = kWakeEventId}};
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, listen_connection->GetSocket(), &listen_event) < 0 ||
+        epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_wake_fd, &wake_event) < 0)
+    {
+        auto status = Dive::InternalError(
+            absl::StrCat("Start: Failed to register with event loop: ", strerror(errno)));
+        Stop();
+        return status;
+    }
+#endif
+
+    m_listen_connection = std::move(listen_connection);
     m_is_running.store(true);
-    m_server_thread = std::thread(&UnixDomainServer::AcceptAndHandleClientLoop, this);
+
+    {
+        std::lock_guard<std::mutex> lock(m_scheduled_mutex);
+        m_handlers_running = true;
+    }
+    for (uint32_t i = 0; i < m_num_handler_threads; ++i)
+    {
+        m_handler_threads.emplace_back(&UnixDomainServer::HandlerLoop, this);
+    }
+    m_server_thread = std::thread(&UnixDomainServer::EventLoop, this);
     return Dive::OkStatus();
 }
 
@@ -132,100 +320,639 @@ void UnixDomainServer::Wait()
 
 void UnixDomainServer::Stop()
 {
+    // The I/O thread closes all client connections on exit, which also unblocks handler threads
+    // that are still sending to them. Without the event loop, it notices the stop once Accept()
+    // times out.
     m_is_running.store(false);
-    m_listen_connection.reset();
-    ResetClientConnection();
+    WakeEventLoop();
     if (m_server_thread.joinable())
     {
         m_server_thread.join();
     }
 
+    {
+        std::lock_guard<std::mutex> lock(m_scheduled_mutex);
+        m_handlers_running = false;
+        m_scheduled_clients.clear();
+    }
+    m_scheduled_cv.notify_all();
+    for (auto& thread : m_handler_threads)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+    m_handler_threads.clear();
+
+    m_listen_connection.reset();
+#ifdef __linux__
+    if (m_wake_fd >= 0)
+    {
+        ::close(m_wake_fd);
+        m_wake_fd = -1;
+    }
+    if (m_epoll_fd >= 0)
+    {
+        ::close(m_epoll_fd);
+        m_epoll_fd = -1;
+    }
+#endif
+
     m_wait_cv.notify_one();
     LOGI("UnixDomainServer: Stopped completely.");
 }
 
-void UnixDomainServer::AcceptAndHandleClientLoop()
+size_t UnixDomainServer::GetClientCount() const
 {
+    std::lock_guard<std::mutex> lock(m_clients_mutex);
+    return m_clients.size();
+}
+
+absl::StatusOr<std::shared_ptr<UnixDomainServer::PushChannel>> UnixDomainServer::CreatePushChannel(
+    const SocketConnection* client_conn)
+{
+    std::lock_guard<std::mutex> lock(m_clients_mutex);
+    // While its message is being handled, the client cannot be destroyed, so its connection is
+    // unambiguous.
+    for (const auto& [id, client] : m_clients)
+    {
+        if (client->connection.get() == client_conn)
+        {
+            return std::shared_ptr<PushChannel>(new PushChannel(this, client));
+        }
+    }
+    return Dive::NotFoundError("CreatePushChannel: Client is not connected.");
+}
+
+UnixDomainServer::PushChannel::PushChannel(UnixDomainServer* server,
+                                           std::shared_ptr<ClientState> client)
+    : m_server(server),
+      m_client_id(client->id),
+      m_client(client)
+{
+}
+
+absl::Status UnixDomainServer::PushChannel::Push(std::unique_ptr<ISerializable> message)
+{
+    std::shared_ptr<ClientState> client = m_client.lock();
+    if (!client)
+    {
+        return Dive::FailedPreconditionError("Push: Client has disconnected.");
+    }
+    // The client lock is held while scheduling: the I/O thread marks every client closed before
+    // the server stops, so the server is still alive here.
+    std::lock_guard<std::mutex> lock(client->mutex);
+    if (client->closed || client->socket_closed)
+    {
+        return Dive::FailedPreconditionError("Push: Client has disconnected.");
+    }
+    if (client->pending_pushes >= kMaxPendingPushesPerClient)
+    {
+        return Dive::UnavailableError("Push: Too many messages waiting for the client.");
+    }
+    client->pending_messages.push_back({std::move(message), /*is_push=*/true});
+    ++client->pending_pushes;
+    if (!client->scheduled)
+    {
+        client->scheduled = true;
+        m_server->ScheduleClient(client);
+    }
+    return Dive::OkStatus();
+}
+
+#ifdef __linux__
+void UnixDomainServer::EventLoop()
+{
+    epoll_event events[kMaxEpollEvents];
     while (m_is_running.load())
     {
-        // We only accept one client connection at a time.
-        if (!m_client_connection)
+        int num_events = epoll_wait(m_epoll_fd, events, kMaxEpollEvents, -1);
+        if (num_events < 0)
         {
-            if (!m_listen_connection || !m_listen_connection->IsOpen())
+            if (errno == EINTR)
             {
-                LOGI(m_is_running.load()
-                         ? "AcceptAndHandleClientLoop: Listen socket closed unexpectedly. Stopping."
-                         : "AcceptAndHandleClientLoop: Listen socket closed for shutdown.");
-                break;
+                continue;
             }
+            LOGW("EventLoop: epoll_wait() failed: %s", strerror(errno));
+            break;
+        }
 
-            auto acc_connection = m_listen_connection->Accept();
-            if (!acc_connection.ok())
+        bool accept_pending = false;
+        for (int i = 0; i < num_events; ++i)
+        {
+            uint64_t id = events[i].data.u64;
+            if (id == kListenEventId)
+            {
+                accept_pending = true;
+                continue;
+            }
+            if (id == kWakeEventId)
             {
-                if (!m_is_running.load())
+                uint64_t count = 0;
+                while (::read(m_wake_fd, &count, sizeof(count)) > 0)
                 {
-                    LOGI("AcceptAndHandleClientLoop: Accept: Exiting loop due to shutdown.");
-                    break;
                 }
-                LOGI("AcceptAndHandleClientLoop: Error accepting new client: %.*s",
-                     static_cast<int>(acc_connection.status().message().length()),
-                     acc_connection.status().message().data());
                 continue;
             }
 
+            auto it = m_clients.find(id);
+            if (it == m_clients.end())
             {
-                std::lock_guard<std::mutex> lk(m_client_mutex);
-                m_client_connection = *std::move(acc_connection);
+                continue;
+            }
+            bool keep_client = true;
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP))
+            {
+                keep_client = ReadFromClient(it->second);
+            }
+            else if (events[i].events & (EPOLLHUP | EPOLLERR))
+            {
+                keep_client = false;
+            }
+            if (!keep_client)
+            {
+                CloseClient(id);
             }
-            LOGI("AcceptAndHandleClientLoop: New client accepted.");
-            m_handler->OnConnect();
         }
 
-        // Having accepted the only client connection, we're now ready to receive messages from it.
-        if (m_client_connection)
+        std::vector<std::pair<uint64_t, bool>> posted_requests;
         {
-            if (!m_client_connection->IsOpen())
+            std::lock_guard<std::mutex> lock(m_posted_mutex);
+            posted_requests.swap(m_posted_requests);
+        }
+        for (const auto& [id, resume] : posted_requests)
+        {
+            auto it = m_clients.find(id);
+            if (it == m_clients.end())
             {
-                LOGI("AcceptAndHandleClientLoop: Client connection is closed.");
-                m_handler->OnDisconnect();
-                ResetClientConnection();
                 continue;
             }
+            if (!resume)
+            {
+                CloseClient(id);
+                continue;
+            }
+            epoll_event event{.events = EPOLLIN | EPOLLRDHUP, .data = {.u64 = id}};
+            if (epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, it->second->socket, &event) < 0)
+            {
+                LOGW("EventLoop: Failed to resume reading from client %" PRIu64 ": %s", id,
+                     strerror(errno));
+                CloseClient(id);
+            }
+        }
 
-            auto recv_message = ReceiveSocketMessage(m_client_connection.get());
-            if (!recv_message.ok())
+        // Accept new clients only after handling the events of this batch, so that a socket
+        // handle released by a closed client is never mistaken for the newly accepted one.
+        if (accept_pending && m_is_running.load())
+        {
+            AcceptClient();
+        }
+    }
+
+    std::vector<uint64_t> client_ids;
+    client_ids.reserve(m_clients.size());
+    for (const auto& [id, client] : m_clients)
+    {
+        client_ids.push_back(id);
+    }
+    for (uint64_t id : client_ids)
+    {
+        CloseClient(id);
+    }
+
+    LOGI("EventLoop: Exiting loop.");
+    m_is_running.store(false);
+    m_wait_cv.notify_one();
+}
+#else
+void UnixDomainServer::EventLoop()
+{
+    // Without epoll, the I/O thread only accepts clients, and each client gets a receive thread.
+    while (m_is_running.load())
+    {
+        AcceptClient();
+        JoinReceiveThreads(/*all=*/false);
+    }
+
+    std::vector<uint64_t> client_ids;
+    {
+        std::lock_guard<std::mutex> lock(m_clients_mutex);
+        client_ids.reserve(m_clients.size());
+        for (const auto& [id, client] : m_clients)
+        {
+            client_ids.push_back(id);
+        }
+    }
+    for (uint64_t id : client_ids)
+    {
+        CloseClient(id);
+    }
+    JoinReceiveThreads(/*all=*/true);
+
+    LOGI("EventLoop: Exiting loop.");
+    m_is_running.store(false);
+    m_wait_cv.notify_one();
+}
+
+void UnixDomainServer::ReceiveLoop(std::shared_ptr<ClientState> client)
+{
+    while (true)
+    {
+        {
+            // Back-pressure: wait for the handlers to catch up.
+            std::unique_lock<std::mutex> lock(client->mutex);
+            client->resume_cv.wait(lock, [&client] {
+                return !client->reading_paused || client->closed || client->socket_closed;
+            });
+            if (client->closed || client->socket_closed)
+            {
+                break;
+            }
+        }
+        if (!ReadFromClient(client))
+        {
+            break;
+        }
+    }
+    CloseClient(client->id);
+}
+
+void UnixDomainServer::JoinReceiveThreads(bool all)
+{
+    auto it = m_receive_threads.begin();
+    while (it != m_receive_threads.end())
+    {
+        if (!all)
+        {
+            std::lock_guard<std::mutex> lock(m_clients_mutex);
+            if (m_clients.count(it->first) != 0)
+            {
+                ++it;
+                continue;
+            }
+        }
+        it->second.join();
+        it = m_receive_threads.erase(it);
+    }
+}
+#endif
+
+void UnixDomainServer::AcceptClient()
+{
+    auto acc_connection = m_listen_connection->Accept();
+    if (!acc_connection.ok())
+    {
+        // Without the event loop, Accept() times out regularly so that the I/O thread can stop.
+        if (!absl::IsDeadlineExceeded(acc_connection.status()))
+        {
+            LOGI("AcceptClient: Error accepting new client: %.*s",
+                 static_cast<int>(acc_connection.status().message().length()),
+                 acc_connection.status().message().data());
+        }
+        return;
+    }
+    if (size_t num_clients = GetClientCount(); num_clients >= kMaxClients)
+    {
+        // The accepted connection is closed when it goes out of scope.
+        LOGW("AcceptClient: Refusing new client, already serving %zu clients.", num_clients);
+        return;
+    }
+
+    auto client = std::make_shared<ClientState>();
+    client->id = m_next_client_id++;
+    client->connection = *std::move(acc_connection);
+
+#ifdef __linux__
+    client->socket = client->connection->GetSocket();
+    epoll_event event{.events = EPOLLIN | EPOLLRDHUP, .data = {.u64 = client->id}};
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, client->socket, &event) < 0)
+    {
+        LOGW("AcceptClient: Failed to register client with event loop: %s", strerror(errno));
+        return;
+    }
+#else
+    SocketType receive_socket = DuplicateSocket(client->connection->GetSocket());
+    if (receive_socket == kInvalidSocketValue)
+    {
+        LOGW("AcceptClient: Failed to duplicate client socket: %s", strerror(errno));
+        return;
+    }
+    auto receive_connection = SocketConnection::Create(receive_socket);
+    if (!receive_connection.ok())
+    {
+        LOGW("AcceptClient: Failed to create receive connection: %.*s",
+             static_cast<int>(receive_connection.status().message().length()),
+             receive_connection.status().message().data());
+#ifndef WIN32
+        ::close(receive_socket);
+#endif
+        return;
+    }
+    client->receive_connection = *std::move(receive_connection);
+    client->socket = receive_socket;
+#endif
+
+    {
+        std::lock_guard<std::mutex> lock(m_clients_mutex);
+        m_clients.emplace(client->id, client);
+    }
+    LOGI("AcceptClient: New client %" PRIu64 " accepted.", client->id);
+    m_handler->OnConnect(client->id);
+#ifndef __linux__
+    m_receive_threads.emplace_back(client->id,
+                                   std::thread(&UnixDomainServer::ReceiveLoop, this, client));
+#endif
+}
+
+bool UnixDomainServer::ReadFromClient(const std::shared_ptr<ClientState>& client)
+{
+    Buffer& buffer = client->read_buffer;
+    size_t old_size = buffer.size();
+    buffer.resize(old_size + kReadChunkSize);
+    ssize_t received = ReceiveAvailable(client->socket, buffer.data() + old_size, kReadChunkSize);
+    if (received <= 0)
+    {
+        buffer.resize(old_size);
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        {
+            return true;
+        }
+        if (received == 0)
+        {
+            LOGI("ReadFromClient: Client %" PRIu64 " closed the connection.", client->id);
+        }
+        else
+        {
+            LOGI("ReadFromClient: recv() from client %" PRIu64 " failed: %s", client->id,
+                 strerror(errno));
+        }
+        return false;
+    }
+    buffer.resize(old_size + static_cast<size_t>(received));
+    return QueueReceivedMessages(client);
+}
+
+bool UnixDomainServer::QueueReceivedMessages(const std::shared_ptr<ClientState>& client)
+{
+    // Frame all complete messages; a partial message stays in the buffer for the next read.
+    Buffer& buffer = client->read_buffer;
+    std::vector<std::unique_ptr<ISerializable>> messages;
+    size_t offset = 0;
+    while (buffer.size() - offset >= kMessageHeaderSize)
+    {
+        uint32_t type = 0, payload_length = 0;
+        absl::Status status = ParseMessageHeader(buffer.data() + offset, type, payload_length);
+        if (!status.ok())
+        {
+            LOGW("ReadFromClient: Invalid message header from client %" PRIu64 ": %.*s",
+                 client->id, static_cast<int>(status.message().length()),
+                 status.message().data());
+            return false;
+        }
+        if (buffer.size() - offset - kMessageHeaderSize < payload_length)
+        {
+            break;
+        }
+
+        auto payload_begin = buffer.begin() + static_cast<ptrdiff_t>(offset + kMessageHeaderSize);
+        Buffer payload(payload_begin, payload_begin + payload_length);
+        offset += kMessageHeaderSize + payload_length;
+
+        auto message = DeserializeMessage(type, payload);
+        if (!message.ok())
+        {
+            LOGW("ReadFromClient: Invalid message from client %" PRIu64 ": %.*s", client->id,
+                 static_cast<int>(message.status().message().length()),
+                 message.status().message().data());
+            return false;
+        }
+        messages.push_back(*std::move(message));
+    }
+    buffer.erase(buffer.begin(), buffer.begin() + static_cast<ptrdiff_t>(offset));
+    if (messages.empty())
+    {
+        return true;
+    }
+
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(client->mutex);
+        for (auto& message : messages)
+        {
+            client->pending_messages.push_back({std::move(message), /*is_push=*/false});
+        }
+        if (!client->scheduled)
+        {
+            client->scheduled = true;
+            schedule = true;
+        }
+        // Back-pressure: stop reading until the handlers catch up. HUP/ERR are still reported.
+        size_t pending_requests = client->pending_messages.size() - client->pending_pushes;
+        if (!client->reading_paused && pending_requests >= kMaxPendingMessagesPerClient)
+        {
+#ifdef __linux__
+            epoll_event event{.events = 0, .data = {.u64 = client->id}};
+            if (epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, client->socket, &event) == 0)
+            {
+                client->reading_paused = true;
+            }
+#else
+            // The receive thread waits before its next read.
+            client->reading_paused = true;
+#endif
+        }
+    }
+    if (schedule)
+    {
+        ScheduleClient(client);
+    }
+    return true;
+}
+
+void UnixDomainServer::CloseClient(uint64_t client_id)
+{
+    std::shared_ptr<ClientState> client;
+    {
+        std::lock_guard<std::mutex> lock(m_clients_mutex);
+        auto it = m_clients.find(client_id);
+        if (it == m_clients.end())
+        {
+            return;
+        }
+        client = it->second;
+        m_clients.erase(it);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(client->mutex);
+        client->closed = true;
+        client->pending_messages.clear();
+        client->pending_pushes = 0;
+#ifdef __linux__
+        // A socket already closed by a handler thread has left the epoll set, and its handle may
+        // have been reused by a newer client.
+        if (!client->socket_closed)
+        {
+            epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, client->socket, nullptr);
+            // Shut down rather than close: a handler thread may still hold the connection, and
+            // the handle must not be reused before it lets go. The connection closes the handle
+            // when the last reference is dropped.
+            ShutdownSocket(client->socket);
+        }
+#else
+        // The duplicated handle stays valid until the client is destroyed. Shutting it down
+        // wakes up the receive thread.
+        ShutdownSocket(client->socket);
+#endif
+    }
+    client->resume_cv.notify_all();
+
+    LOGI("CloseClient: Client %" PRIu64 " disconnected.", client_id);
+    m_handler->OnDisconnect(client_id);
+}
+
+void UnixDomainServer::HandlerLoop()
+{
+    while (true)
+    {
+        std::shared_ptr<ClientState> client;
+        {
+            std::unique_lock<std::mutex> lock(m_scheduled_mutex);
+            m_scheduled_cv.wait(lock, [this] {
+                return !m_handlers_running || !m_scheduled_clients.empty();
+            });
+            if (!m_handlers_running)
             {
-                if (!m_is_running.load())
+                return;
+            }
+            client = std::move(m_scheduled_clients.front());
+            m_scheduled_clients.pop_front();
+        }
+
+        for (uint32_t i = 0; i < kMaxMessagesPerDispatch; ++i)
+        {
+            ClientState::PendingMessage pending;
+            bool resume = false;
+            {
+                std::lock_guard<std::mutex> lock(client->mutex);
+                if (client->pending_messages.empty())
                 {
-                    LOGI(
-                        "AcceptAndHandleClientLoop: ReceiveSocketMessage: Exiting loop due to "
-                        "shutdown.");
-                    m_handler->OnDisconnect();
                     break;
                 }
+                pending = std::move(client->pending_messages.front());
+                client->pending_messages.pop_front();
+                if (pending.is_push)
+                {
+                    --client->pending_pushes;
+                }
+                size_t pending_requests = client->pending_messages.size() - client->pending_pushes;
+                if (client->reading_paused &&
+                    pending_requests <= kMaxPendingMessagesPerClient / 2)
+                {
+                    client->reading_paused = false;
+                    resume = true;
+                }
+            }
+            if (resume)
+            {
+                PostToEventLoop(client->id, /*resume=*/true);
+            }
 
-                LOGI("AcceptAndHandleClientLoop: ReceiveSocketMessage failed: %.*s",
-                     static_cast<int>(recv_message.status().message().length()),
-                     recv_message.status().message().data());
-                m_handler->OnDisconnect();
-                ResetClientConnection();
+            if (pending.is_push)
+            {
+                absl::Status status = SendSocketMessage(client->connection.get(), *pending.message);
+                if (!status.ok())
+                {
+                    LOGW("HandlerLoop: Failed to push message to client %" PRIu64 ": %.*s",
+                         client->id, static_cast<int>(status.message().length()),
+                         status.message().data());
+                }
             }
             else
             {
-                m_handler->HandleMessage(*std::move(recv_message), m_client_connection.get());
+                m_handler->HandleMessage(std::move(pending.message), client->connection.get());
+            }
+
+            if (!client->connection->IsOpen())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(client->mutex);
+                    client->socket_closed = true;
+                    client->pending_messages.clear();
+                    client->pending_pushes = 0;
+                }
+                PostToEventLoop(client->id, /*resume=*/false);
+                break;
             }
         }
+
+        bool has_more = false;
+        {
+            std::lock_guard<std::mutex> lock(client->mutex);
+            has_more = !client->pending_messages.empty();
+            client->scheduled = has_more;
+        }
+        if (has_more)
+        {
+            // Re-queue at the back so that other clients get their turn.
+            ScheduleClient(std::move(client));
+        }
     }
+}
 
-    LOGI("AcceptAndHandleClientLoop: Exiting loop.");
-    m_is_running.store(false);
-    m_wait_cv.notify_one();
+void UnixDomainServer::ScheduleClient(std::shared_ptr<ClientState> client)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_scheduled_mutex);
+        if (!m_handlers_running)
+        {
+            return;
+        }
+        m_scheduled_clients.push_back(std::move(client));
+    }
+    m_scheduled_cv.notify_one();
+}
+
+void UnixDomainServer::PostToEventLoop(uint64_t client_id, bool resume)
+{
+#ifdef __linux__
+    {
+        std::lock_guard<std::mutex> lock(m_posted_mutex);
+        m_posted_requests.emplace_back(client_id, resume);
+    }
+    WakeEventLoop();
+#else
+    // Without the event loop, the receive thread of the client handles the request.
+    std::shared_ptr<ClientState> client;
+    {
+        std::lock_guard<std::mutex> lock(m_clients_mutex);
+        auto it = m_clients.find(client_id);
+        if (it == m_clients.end())
+        {
+            return;
+        }
+        client = it->second;
+    }
+    if (!resume)
+    {
+        // The receive thread closes the client once its read fails.
+        std::lock_guard<std::mutex> lock(client->mutex);
+        ShutdownSocket(client->socket);
+    }
+    client->resume_cv.notify_all();
+#endif
 }
 
-void UnixDomainServer::ResetClientConnection()
+void UnixDomainServer::WakeEventLoop()
 {
-    std::lock_guard<std::mutex> lk(m_client_mutex);
-    m_client_connection.reset();
+#ifdef __linux__
+    if (m_wake_fd >= 0)
+    {
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t ret = ::write(m_wake_fd, &one, sizeof(one));
+    }
+#endif
 }
 
-}  // namespace Network
\ No newline at end of file
+}  // namespace Network
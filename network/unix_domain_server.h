@@ -18,10 +18,15 @@ limitations under the License.
 
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "message_handler.h"
 #include "messages.h"
@@ -34,22 +39,70 @@ class DefaultMessageHandler : public IMessageHandler
 {
  public:
     DefaultMessageHandler();
-    void OnConnect() override;
+    void OnConnect(uint64_t client_id) override;
     void HandleMessage(std::unique_ptr<ISerializable> message,
                        SocketConnection* client_conn) override;
-    void OnDisconnect() override;
+    void OnDisconnect(uint64_t client_id) override;
 };
 
-// The UnixDomainServer is designed to run two threads. One thread accepts and handles a single
-// client connection, while the main thread starts the server and waits for the first thread to
-// finish or for an unexpected error to occur that necessitates stopping the server.
-// The server is designed to accept only one client connection at a time.
+// The UnixDomainServer serves several concurrent clients (e.g. the UI, the CLI and automation
+// tools) from a single event loop. One I/O thread waits on the listen socket and all client
+// sockets with epoll, reads and frames incoming messages without blocking, and hands them to a
+// pool of handler threads. Messages from the same client are handled one at a time and in order,
+// so responses keep the request order, while slow requests such as file downloads from one client
+// do not stall the others. When a client has too many messages waiting for a handler, the server
+// stops reading from its socket until the backlog drains (per-connection back-pressure).
+//
+// Besides answering requests, the server can push messages to a client at any time through a
+// PushChannel (e.g. for telemetry streams). Pushed messages are sent by a handler thread in the
+// same per-client order as the responses, so they never interleave with a response on the wire.
+//
+// The event loop relies on epoll, so it is only used on Linux and Android. Other platforms fall
+// back to one blocking receive thread per client, which feeds the same handler threads.
 class UnixDomainServer
 {
  public:
-    // Constructs the server, taking ownership of the provided IMessageHandler.
+    // Default number of threads that run IMessageHandler::HandleMessage.
+    static constexpr uint32_t kDefaultHandlerThreads = 4;
+    // Maximum number of clients connected at the same time; extra connections are refused.
+    static constexpr uint32_t kMaxClients = 16;
+    // Once a client has this many messages waiting for a handler, reading from it is paused.
+    static constexpr uint32_t kMaxPendingMessagesPerClient = 32;
+    // Maximum number of pushed messages waiting to be sent to one client. Further pushes are
+    // dropped until the client catches up.
+    static constexpr uint32_t kMaxPendingPushesPerClient = 64;
+
+ private:
+    struct ClientState;
+
+ public:
+    // Sends messages to one client outside of request handling. A channel may outlive its client
+    // and its server, in which case pushing fails. It is safe to use from any thread.
+    class PushChannel
+    {
+     public:
+        // Queues a message for the client. Returns UnavailableError if too many pushed messages
+        // are already waiting (the message is dropped), and FailedPreconditionError once the
+        // client has disconnected.
+        absl::Status Push(std::unique_ptr<ISerializable> message);
+
+        // Returns the id of the client, unique for the lifetime of the server.
+        uint64_t GetClientId() const { return m_client_id; }
+
+     private:
+        friend class UnixDomainServer;
+        PushChannel(UnixDomainServer* server, std::shared_ptr<ClientState> client);
+
+        UnixDomainServer* m_server;
+        uint64_t m_client_id;
+        std::weak_ptr<ClientState> m_client;
+    };
+
+    // Constructs the server, taking ownership of the provided IMessageHandler. The handler is
+    // called from several threads, see IMessageHandler for its thread-safety requirements.
     explicit UnixDomainServer(
-        std::unique_ptr<IMessageHandler> handler = std::make_unique<DefaultMessageHandler>());
+        std::unique_ptr<IMessageHandler> handler = std::make_unique<DefaultMessageHandler>(),
+        uint32_t num_handler_threads = kDefaultHandlerThreads);
 
     // Stops the server and cleans up all resources.
     ~UnixDomainServer();
@@ -57,29 +110,99 @@ class UnixDomainServer
     // Starts the server to listen on a Unix Domain.
     absl::Status Start(const std::string& server_address);
 
+    // Starts the server to listen on a TCP port instead, e.g. to serve a TcpClient in the same
+    // process for tests and benchmarks. A port of 0 picks a free port, see GetTcpPort().
+    absl::Status StartTcp(const std::string& host, int port);
+
+    // Returns the TCP port the server listens on.
+    absl::StatusOr<int> GetTcpPort() const;
+
     // Blocks the calling thread until the server stops.
     void Wait();
 
-    // Gracefully stops the server thread and closes connections.
+    // Gracefully stops the server threads and closes connections.
     void Stop();
 
+    // Returns the number of currently connected clients.
+    size_t GetClientCount() const;
+
+    // Creates a channel to push messages to the client that sent a message. Must be called from
+    // IMessageHandler::HandleMessage with the `client_conn` it received.
+    absl::StatusOr<std::shared_ptr<PushChannel>> CreatePushChannel(
+        const SocketConnection* client_conn);
+
  private:
-    // The primary run loop for the server's worker thread.
-    void AcceptAndHandleClientLoop();
+    // Starts the I/O and handler threads serving clients of `listen_connection`.
+    absl::Status StartEventLoop(std::unique_ptr<SocketConnection> listen_connection);
+
+    // The primary run loop for the server's I/O thread.
+    void EventLoop();
+
+    // Accepts a pending connection on the listen socket and registers it with the event loop.
+    void AcceptClient();
+
+    // Reads available data from a client and queues every complete message for the handlers.
+    // Returns false if the client has to be closed.
+    bool ReadFromClient(const std::shared_ptr<ClientState>& client);
+
+    // Frames the complete messages in the read buffer of a client and queues them for the
+    // handlers, pausing reading if too many are waiting. Returns false if the data is invalid.
+    bool QueueReceivedMessages(const std::shared_ptr<ClientState>& client);
+
+    // Receives the messages of one client on platforms without the event loop.
+    void ReceiveLoop(std::shared_ptr<ClientState> client);
+
+    // Joins the receive threads of the clients that have disconnected, or of all the clients if
+    // `all` is true.
+    void JoinReceiveThreads(bool all);
+
+    // Unregisters a client from the event loop and shuts down its connection.
+    void CloseClient(uint64_t client_id);
+
+    // Runs queued client work on a handler thread.
+    void HandlerLoop();
+
+    // Queues a client whose pending messages need to be handled.
+    void ScheduleClient(std::shared_ptr<ClientState> client);
+
+    // Asks the I/O thread to resume reading from (resume == true) or to close a client.
+    void PostToEventLoop(uint64_t client_id, bool resume);
 
-    // Resets the client connection to prepare for a new client.
-    void ResetClientConnection();
+    // Wakes up the I/O thread.
+    void WakeEventLoop();
 
     // Server connection.
     std::unique_ptr<SocketConnection> m_listen_connection;
-    // The only one client connection at a time.
-    std::unique_ptr<SocketConnection> m_client_connection;
-    // The thread that accepts and handles the only one client connection at a time.
+    // The I/O thread running EventLoop().
     std::thread m_server_thread;
+    // The epoll instance and the eventfd used to wake up the I/O thread.
+    int m_epoll_fd;
+    int m_wake_fd;
+
+    // Connected clients, keyed by a unique client id. With the event loop, only the I/O thread
+    // modifies it, and other threads lock `m_clients_mutex` to read it.
+    std::unordered_map<uint64_t, std::shared_ptr<ClientState>> m_clients;
+    uint64_t m_next_client_id;
+    mutable std::mutex m_clients_mutex;
+
+    // Receive threads of the clients on platforms without the event loop, with their client id.
+    // Only accessed from the I/O thread.
+    std::vector<std::pair<uint64_t, std::thread>> m_receive_threads;
+
+    // Requests posted by handler threads to the I/O thread.
+    std::vector<std::pair<uint64_t, bool>> m_posted_requests;
+    std::mutex m_posted_mutex;
+
+    // Handler thread pool and the clients waiting for a handler thread.
+    uint32_t m_num_handler_threads;
+    std::vector<std::thread> m_handler_threads;
+    std::deque<std::shared_ptr<ClientState>> m_scheduled_clients;
+    bool m_handlers_running;
+    std::mutex m_scheduled_mutex;
+    std::condition_variable m_scheduled_cv;
 
     std::unique_ptr<IMessageHandler> m_handler;
     std::atomic<bool> m_is_running;
-    std::mutex m_client_mutex;
     std::mutex m_wait_mutex;
     std::condition_variable m_wait_cv;
 };
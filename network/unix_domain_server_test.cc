@@ -0,0 +1,354 @@
+/*
+Copyright 2026 Google Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "unix_domain_server.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "absl/status/status_matchers.h"
+#include "base_message_handler.h"
+#include "message_utils.h"
+#include "messages.h"
+#include "socket_connection.h"
+#include "tcp_client.h"
+
+namespace
+{
+
+using ::absl_testing::IsOk;
+using ::absl_testing::IsOkAndHolds;
+
+// Abstract Unix domain addresses are only supported on Linux.
+#ifdef __linux__
+TEST(UnixDomainServerTest, PingOverUnixDomain)
+{
+    Network::UnixDomainServer server(std::make_unique<Network::BaseMessageHandler>());
+    ASSERT_THAT(server.Start("dive_unix_domain_server_test"), IsOk());
+
+    auto connection = Network::SocketConnection::Create();
+    ASSERT_THAT(connection, IsOk());
+    ASSERT_THAT((*connection)->ConnectToUnixDomain("dive_unix_domain_server_test"), IsOk());
+
+    Network::PingMessage ping;
+    ASSERT_THAT(Network::SendSocketMessage(connection->get(), ping), IsOk());
+    auto response = Network::ReceiveSocketMessage(connection->get(), 2000);
+    ASSERT_THAT(response, IsOk());
+    EXPECT_EQ((*response)->GetMessageType(), Network::MessageType::PONG_MESSAGE);
+    server.Stop();
+}
+#endif
+
+TEST(UnixDomainServerTest, TcpClientOverTcpListener)
+{
+    Network::UnixDomainServer server(std::make_unique<Network::BaseMessageHandler>());
+    ASSERT_THAT(server.StartTcp("127.0.0.1", 0), IsOk());
+    auto port = server.GetTcpPort();
+    ASSERT_THAT(port, IsOk());
+    EXPECT_NE(*port, 0);
+
+    std::string path =
+        (std::filesystem::temp_directory_path() / "dive_uds_server_test.bin").string();
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << std::string(5000, 'x');
+    }
+
+    Network::TcpClient client;
+    ASSERT_THAT(client.Connect("127.0.0.1", *port), IsOk());
+    EXPECT_THAT(client.GetCaptureFileSize(path), IsOkAndHolds(5000u));
+    EXPECT_THAT(client.StreamFileFromServer(path, path + ".copy", /*idle_timeout_ms=*/0),
+                IsOkAndHolds(5000u));
+    EXPECT_EQ(std::filesystem::file_size(path + ".copy"), 5000u);
+    client.Disconnect();
+    server.Stop();
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".copy");
+}
+
+TEST(UnixDomainServerTest, StreamFileResumesAfterGrowth)
+{
+    Network::UnixDomainServer server(std::make_unique<Network::BaseMessageHandler>());
+    ASSERT_THAT(server.StartTcp("127.0.0.1", 0), IsOk());
+    auto port = server.GetTcpPort();
+    ASSERT_THAT(port, IsOk());
+
+    std::string path =
+        (std::filesystem::temp_directory_path() / "dive_uds_server_test_resume.bin").string();
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << std::string(3000, 'a');
+    }
+
+    Network::TcpClient client;
+    ASSERT_THAT(client.Connect("127.0.0.1", *port), IsOk());
+    EXPECT_THAT(client.StreamFileFromServer(path, path + ".copy", /*idle_timeout_ms=*/0),
+                IsOkAndHolds(3000u));
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file << std::string(2000, 'b');
+    }
+    // A later round picks up where the previous one ended.
+    EXPECT_THAT(client.StreamFileFromServer(path, path + ".copy", /*idle_timeout_ms=*/0,
+                                            /*offset=*/3000),
+                IsOkAndHolds(5000u));
+    client.Disconnect();
+    server.Stop();
+
+    std::ifstream copy(path + ".copy", std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(copy)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(contents, std::string(3000, 'a') + std::string(2000, 'b'));
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".copy");
+}
+
+// Blocks each ping until `expected` pings are being handled at the same time, or a timeout.
+class ConcurrentPingHandler : public Network::BaseMessageHandler
+{
+ public:
+    explicit ConcurrentPingHandler(int expected) : m_expected(expected) {}
+
+    void HandleMessage(std::unique_ptr<Network::ISerializable> message,
+                       Network::SocketConnection* client_conn) override
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            ++m_active;
+            m_max_active = std::max(m_max_active, m_active);
+            m_cv.notify_all();
+            m_cv.wait_for(lock, std::chrono::seconds(5), [this]() {
+                return m_max_active >= m_expected;
+            });
+            --m_active;
+        }
+        Network::BaseMessageHandler::HandleMessage(std::move(message), client_conn);
+    }
+
+    int GetMaxActive()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_max_active;
+    }
+
+ private:
+    const int m_expected;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    int m_active = 0;
+    int m_max_active = 0;
+};
+
+TEST(UnixDomainServerTest, HandlesClientsConcurrently)
+{
+    auto handler = std::make_unique<ConcurrentPingHandler>(/*expected=*/2);
+    ConcurrentPingHandler* handler_ptr = handler.get();
+    Network::UnixDomainServer server(std::move(handler));
+    ASSERT_THAT(server.StartTcp("127.0.0.1", 0), IsOk());
+    auto port = server.GetTcpPort();
+    ASSERT_THAT(port, IsOk());
+
+    std::vector<std::unique_ptr<Network::SocketConnection>> connections;
+    for (int i = 0; i < 2; ++i)
+    {
+        auto connection = Network::SocketConnection::Create();
+        ASSERT_THAT(connection, IsOk());
+        ASSERT_THAT((*connection)->Connect("127.0.0.1", *port), IsOk());
+        Network::PingMessage ping;
+        ASSERT_THAT(Network::SendSocketMessage(connection->get(), ping), IsOk());
+        connections.push_back(*std::move(connection));
+    }
+    for (auto& connection : connections)
+    {
+        auto response = Network::ReceiveSocketMessage(connection.get(), 10000);
+        ASSERT_THAT(response, IsOk());
+        EXPECT_EQ((*response)->GetMessageType(), Network::MessageType::PONG_MESSAGE);
+    }
+    // The second ping was handled while the first one was still blocked.
+    EXPECT_EQ(handler_ptr->GetMaxActive(), 2);
+    server.Stop();
+}
+
+// Pushes pings to the client from within its own request. Its messages are handled one at a time,
+// so none of the pushes can be sent before the handler returns.
+class PushingHandler : public Network::BaseMessageHandler
+{
+ public:
+    void HandleMessage(std::unique_ptr<Network::ISerializable> message,
+                       Network::SocketConnection* client_conn) override
+    {
+        auto channel = m_server->CreatePushChannel(client_conn);
+        if (channel.ok())
+        {
+            for (uint32_t i = 0; i <= Network::UnixDomainServer::kMaxPendingPushesPerClient; ++i)
+            {
+                m_push_results.push_back(
+                    (*channel)->Push(std::make_unique<Network::PingMessage>()));
+            }
+        }
+        Network::BaseMessageHandler::HandleMessage(std::move(message), client_conn);
+    }
+
+    Network::UnixDomainServer* m_server = nullptr;
+    std::vector<absl::Status> m_push_results;
+};
+
+TEST(UnixDomainServerTest, PushChannelDropsPushesOverTheLimit)
+{
+    auto handler = std::make_unique<PushingHandler>();
+    PushingHandler* handler_ptr = handler.get();
+    Network::UnixDomainServer server(std::move(handler));
+    handler_ptr->m_server = &server;
+    ASSERT_THAT(server.StartTcp("127.0.0.1", 0), IsOk());
+    auto port = server.GetTcpPort();
+    ASSERT_THAT(port, IsOk());
+
+    auto connection = Network::SocketConnection::Create();
+    ASSERT_THAT(connection, IsOk());
+    ASSERT_THAT((*connection)->Connect("127.0.0.1", *port), IsOk());
+    Network::PingMessage ping;
+    ASSERT_THAT(Network::SendSocketMessage(connection->get(), ping), IsOk());
+
+    // The response is sent from the handler, before the queued pushes.
+    auto response = Network::ReceiveSocketMessage(connection->get(), 2000);
+    ASSERT_THAT(response, IsOk());
+    EXPECT_EQ((*response)->GetMessageType(), Network::MessageType::PONG_MESSAGE);
+    for (uint32_t i = 0; i < Network::UnixDomainServer::kMaxPendingPushesPerClient; ++i)
+    {
+        auto pushed = Network::ReceiveSocketMessage(connection->get(), 2000);
+        ASSERT_THAT(pushed, IsOk());
+        EXPECT_EQ((*pushed)->GetMessageType(), Network::MessageType::PING_MESSAGE);
+    }
+    server.Stop();
+
+    const std::vector<absl::Status>& results = handler_ptr->m_push_results;
+    ASSERT_EQ(results.size(), Network::UnixDomainServer::kMaxPendingPushesPerClient + 1);
+    for (uint32_t i = 0; i < Network::UnixDomainServer::kMaxPendingPushesPerClient; ++i)
+    {
+        EXPECT_THAT(results[i], IsOk());
+    }
+    EXPECT_TRUE(absl::IsUnavailable(results.back()));
+}
+
+// Answers the full live-state requests like a layer that predates live-state deltas. Such layers
+// drop the connection on the unknown delta request; `reject_deltas` answers it with another message
+// type instead.
+class LegacyLiveStateHandler : public Network::BaseMessageHandler
+{
+ public:
+    explicit LegacyLiveStateHandler(bool reject_deltas) : m_reject_deltas(reject_deltas) {}
+
+    void HandleMessage(std::unique_ptr<Network::ISerializable> message,
+                       Network::SocketConnection* client_conn) override
+    {
+        switch (message->GetMessageType())
+        {
+            case Network::MessageType::LIVE_STATE_DELTA_REQUEST:
+                if (m_reject_deltas)
+                {
+                    EXPECT_THAT(Network::SendPong(client_conn), IsOk());
+                }
+                else
+                {
+                    client_conn->Close();
+                }
+                return;
+            case Network::MessageType::LIVE_PSOS_REQUEST:
+            {
+                Network::LivePSOsResponse response;
+                response.SetPSOs({{"pso", 1, true}});
+                EXPECT_THAT(Network::SendSocketMessage(client_conn, response), IsOk());
+                return;
+            }
+            case Network::MessageType::LIVE_RENDER_PASSES_REQUEST:
+            {
+                Network::LiveRenderPassesResponse response;
+                response.SetRenderPasses({{"render_pass", 2}});
+                EXPECT_THAT(Network::SendSocketMessage(client_conn, response), IsOk());
+                return;
+            }
+            default:
+                Network::BaseMessageHandler::HandleMessage(std::move(message), client_conn);
+                return;
+        }
+    }
+
+ private:
+    const bool m_reject_deltas;
+};
+
+void ExpectFullLiveStateFallback(bool reject_deltas)
+{
+    Network::UnixDomainServer server(std::make_unique<LegacyLiveStateHandler>(reject_deltas));
+    ASSERT_THAT(server.StartTcp("127.0.0.1", 0), IsOk());
+    auto port = server.GetTcpPort();
+    ASSERT_THAT(port, IsOk());
+
+    Network::TcpClient client;
+    ASSERT_THAT(client.Connect("127.0.0.1", *port), IsOk());
+    // Twice, to also cover the requests made once deltas are known to be unsupported.
+    for (int i = 0; i < 2; ++i)
+    {
+        auto psos = client.GetLivePSOs();
+        ASSERT_THAT(psos, IsOk());
+        ASSERT_EQ(psos->size(), 1u);
+        EXPECT_EQ((*psos)[0].name, "pso");
+        EXPECT_EQ((*psos)[0].pipeline_handle, 1u);
+
+        auto render_passes = client.GetLiveRenderPasses();
+        ASSERT_THAT(render_passes, IsOk());
+        ASSERT_EQ(render_passes->size(), 1u);
+        EXPECT_EQ((*render_passes)[0].render_pass_handle, 2u);
+    }
+    EXPECT_TRUE(client.IsConnected());
+    client.Disconnect();
+    server.Stop();
+}
+
+TEST(UnixDomainServerTest, LiveStateFallsBackWhenServerDropsDeltaRequest)
+{
+    ExpectFullLiveStateFallback(/*reject_deltas=*/false);
+}
+
+TEST(UnixDomainServerTest, LiveStateFallsBackWhenServerRejectsDeltaRequest)
+{
+    ExpectFullLiveStateFallback(/*reject_deltas=*/true);
+}
+
+TEST(UnixDomainServerTest, StartTwiceFails)
+{
+    Network::UnixDomainServer server(std::make_unique<Network::BaseMessageHandler>());
+    ASSERT_THAT(server.StartTcp("127.0.0.1", 0), IsOk());
+    EXPECT_FALSE(server.StartTcp("127.0.0.1", 0).ok());
+#ifdef __linux__
+    EXPECT_FALSE(server.Start("dive_unix_domain_server_test_twice").ok());
+#endif
+    server.Stop();
+    EXPECT_FALSE(server.GetTcpPort().ok());
+}
+
+}  // namespace
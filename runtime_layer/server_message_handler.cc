@@ -99,6 +99,58 @@ void ServerMessageHandler::HandleMessage(std::unique_ptr<Network::ISerializable>
             }
             return;
         }
+        case Network::MessageType::LIVE_STATE_DELTA_REQUEST:
+        {
+            auto* request = static_cast<Network::LiveStateDeltaRequest*>(message.get());
+
+            Network::LiveStateDeltaResponse response;
+            response.SetPSOsDelta(sDiveRuntimeLayer.GetLivePSOsDelta(request->GetPSOGeneration()));
+            response.SetRenderPassesDelta(
+                sDiveRuntimeLayer.GetLiveRenderPassesDelta(request->GetRenderPassGeneration()));
+            if (absl::Status status = Network::SendSocketMessage(client_conn, response);
+                !status.ok())
+            {
+                LOG(ERROR) << "Send LiveStateDeltaResponse failed: " << status.message();
+            }
+            return;
+        }
+        case Network::MessageType::TELEMETRY_SUBSCRIBE_REQUEST:
+        {
+            auto* request = static_cast<Network::TelemetrySubscribeRequest*>(message.get());
+            LOG(INFO) << "Message received: TelemetrySubscribeRequest, enable: "
+                      << request->GetEnable() << ", frames per batch: "
+                      << request->GetFramesPerBatch();
+
+            if (!m_server)
+            {
+                LOG(ERROR) << "Telemetry is not available without a server";
+                return;
+            }
+            auto channel = m_server->CreatePushChannel(client_conn);
+            if (!channel.ok())
+            {
+                LOG(ERROR) << "Create telemetry channel failed: " << channel.status().message();
+                return;
+            }
+            // The response is sent before the first batch is pushed, since pushed messages are
+            // queued behind the message being handled.
+            if (request->GetEnable())
+            {
+                sDiveRuntimeLayer.SubscribeTelemetry(*channel, request->GetFramesPerBatch());
+            }
+            else
+            {
+                sDiveRuntimeLayer.UnsubscribeTelemetry((*channel)->GetClientId());
+            }
+
+            Network::TelemetrySubscribeResponse response;
+            if (absl::Status status = Network::SendSocketMessage(client_conn, response);
+                !status.ok())
+            {
+                LOG(ERROR) << "Send TelemetrySubscribeResponse failed: " << status.message();
+            }
+            return;
+        }
         case Network::MessageType::DISABLE_TIMESTAMP_REQUEST:
         {
             LOG(INFO) << "Message received: DisableTimestampRequest";
@@ -122,4 +174,10 @@ void ServerMessageHandler::HandleMessage(std::unique_ptr<Network::ISerializable>
     }
 }
 
+void ServerMessageHandler::OnDisconnect(uint64_t client_id)
+{
+    Network::BaseMessageHandler::OnDisconnect(client_id);
+    sDiveRuntimeLayer.UnsubscribeTelemetry(client_id);
+}
+
 }  // namespace DiveLayer
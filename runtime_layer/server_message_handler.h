@@ -22,11 +22,23 @@ limitations under the License.
 namespace DiveLayer
 {
 
+// Handles the requests of the layer's clients. The server calls it concurrently for different
+// clients; all the state it touches lives in DiveRuntimeLayer, whose accessors lock their own data.
 class ServerMessageHandler : public Network::BaseMessageHandler
 {
  public:
     void HandleMessage(std::unique_ptr<Network::ISerializable> message,
                        Network::SocketConnection* client_conn) override;
+
+    // Drops the telemetry subscription of the client, if any.
+    void OnDisconnect(uint64_t client_id) override;
+
+    // Sets the server this handler is attached to, which is used to push telemetry to clients.
+    // Must be called before the server starts.
+    void SetServer(Network::UnixDomainServer* server) { m_server = server; }
+
+ private:
+    Network::UnixDomainServer* m_server = nullptr;
 };
 
 }  // namespace DiveLayer
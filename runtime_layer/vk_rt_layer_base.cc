@@ -66,8 +66,10 @@ class LayerManager
 
             LOGI("Layer is ready, starting server...");
 
-            m_server = std::make_unique<Network::UnixDomainServer>(
-                std::make_unique<ServerMessageHandler>());
+            auto handler = std::make_unique<ServerMessageHandler>();
+            ServerMessageHandler* handler_ptr = handler.get();
+            m_server = std::make_unique<Network::UnixDomainServer>(std::move(handler));
+            handler_ptr->SetServer(m_server.get());
 
             std::string server_address = Dive::DeviceResourcesConstants::kUnixAbstractPath;
             auto status = m_server->Start(server_address);
@@ -28,6 +28,7 @@ limitations under the License.
 #include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <optional>
 
 #include "common/log.h"
 
@@ -66,6 +67,11 @@ static thread_local absl::flat_hash_map<VkCommandBuffer, bool> sCmdBufferInFilte
 static thread_local absl::flat_hash_map<VkCommandPool, std::vector<VkCommandBuffer>>
     sCommandPoolBuffers;
 
+// Draws recorded so far in the command buffers being recorded on this thread while telemetry is
+// active. The count moves to DiveRuntimeLayer::m_cmd_buffer_draws when the command buffer ends,
+// since it may be submitted from another thread.
+static thread_local absl::flat_hash_map<VkCommandBuffer, uint32_t> sCmdBufferRecordedDraws;
+
 // DiveRuntimeLayer
 DiveRuntimeLayer::DiveRuntimeLayer() : m_device_proc_addr(nullptr) {}
 
@@ -153,6 +159,7 @@ VkResult DiveRuntimeLayer::CreateGraphicsPipelines(PFN_vkCreateGraphicsPipelines
             TrackedPSO info{
                 .name = has_alpha ? "Alpha_blend_enabled" : "Opaque",
                 .has_alpha_blend = has_alpha,
+                .generation = ++m_pso_generation,
             };
             m_live_psos[pPipelines[i]] = info;
         }
@@ -165,7 +172,10 @@ void DiveRuntimeLayer::DestroyPipeline(PFN_vkDestroyPipeline pfn, VkDevice devic
 {
     {
         std::unique_lock<std::shared_mutex> lock(m_pso_mutex);
-        m_live_psos.erase(pipeline);
+        if (m_live_psos.erase(pipeline) > 0)
+        {
+            m_removed_psos.Add(reinterpret_cast<uint64_t>(pipeline), ++m_pso_generation);
+        }
     }
     pfn(device, pipeline, pAllocator);
 }
@@ -183,6 +193,7 @@ VkResult DiveRuntimeLayer::SetDebugUtilsObjectNameEXT(
             if (auto it = m_live_psos.find(pipeline); it != m_live_psos.end())
             {
                 it->second.name = pNameInfo->pObjectName;
+                it->second.generation = ++m_pso_generation;
             }
         }
         else if (pNameInfo->objectType == VK_OBJECT_TYPE_RENDER_PASS)
@@ -192,6 +203,7 @@ VkResult DiveRuntimeLayer::SetDebugUtilsObjectNameEXT(
             if (auto it = m_render_passes.find(rp); it != m_render_passes.end())
             {
                 it->second.name = pNameInfo->pObjectName;
+                it->second.generation = ++m_rp_generation;
             }
         }
     }
@@ -232,7 +244,7 @@ void DiveRuntimeLayer::CmdDraw(PFN_vkCmdDraw pfn, VkCommandBuffer commandBuffer,
     {
         return;
     }
-    if (CheckAndIncrementDrawcallCount())
+    if (CheckAndIncrementDrawcallCount(commandBuffer))
     {
         return;
     }
@@ -249,7 +261,7 @@ void DiveRuntimeLayer::CmdDrawIndexed(PFN_vkCmdDrawIndexed pfn, VkCommandBuffer
     {
         return;
     }
-    if (CheckAndIncrementDrawcallCount())
+    if (CheckAndIncrementDrawcallCount(commandBuffer))
     {
         return;
     }
@@ -284,7 +296,7 @@ void DiveRuntimeLayer::CmdDrawIndirect(PFN_vkCmdDrawIndirect pfn, VkCommandBuffe
     {
         return;
     }
-    if (CheckAndIncrementDrawcallCount())
+    if (CheckAndIncrementDrawcallCount(commandBuffer))
     {
         return;
     }
@@ -301,7 +313,7 @@ void DiveRuntimeLayer::CmdDrawIndexedIndirect(PFN_vkCmdDrawIndexedIndirect pfn,
     {
         return;
     }
-    if (CheckAndIncrementDrawcallCount())
+    if (CheckAndIncrementDrawcallCount(commandBuffer))
     {
         return;
     }
@@ -319,7 +331,7 @@ void DiveRuntimeLayer::CmdDrawIndirectCount(PFN_vkCmdDrawIndirectCount pfn,
     {
         return;
     }
-    if (CheckAndIncrementDrawcallCount())
+    if (CheckAndIncrementDrawcallCount(commandBuffer))
     {
         return;
     }
@@ -337,7 +349,7 @@ void DiveRuntimeLayer::CmdDrawIndexedIndirectCount(PFN_vkCmdDrawIndexedIndirectC
     {
         return;
     }
-    if (CheckAndIncrementDrawcallCount())
+    if (CheckAndIncrementDrawcallCount(commandBuffer))
     {
         return;
     }
@@ -353,7 +365,7 @@ void DiveRuntimeLayer::CmdDrawMeshTasksEXT(PFN_vkCmdDrawMeshTasksEXT pfn,
     {
         return;
     }
-    if (CheckAndIncrementDrawcallCount())
+    if (CheckAndIncrementDrawcallCount(commandBuffer))
     {
         return;
     }
@@ -370,7 +382,7 @@ void DiveRuntimeLayer::CmdDrawMeshTasksIndirectEXT(PFN_vkCmdDrawMeshTasksIndirec
     {
         return;
     }
-    if (CheckAndIncrementDrawcallCount())
+    if (CheckAndIncrementDrawcallCount(commandBuffer))
     {
         return;
     }
@@ -389,7 +401,7 @@ void DiveRuntimeLayer::CmdDrawMeshTasksIndirectCountEXT(PFN_vkCmdDrawMeshTasksIn
     {
         return;
     }
-    if (CheckAndIncrementDrawcallCount())
+    if (CheckAndIncrementDrawcallCount(commandBuffer))
     {
         return;
     }
@@ -470,6 +482,15 @@ void DiveRuntimeLayer::DestroyCommandPool(PFN_vkDestroyCommandPool pfn, VkDevice
         {
             sCmdBufferCurrentPipelineHasAlpha.erase(cb);
             sCmdBufferInFilteredRenderPass.erase(cb);
+            sCmdBufferRecordedDraws.erase(cb);
+        }
+        if (m_telemetry_active.load(std::memory_order_relaxed))
+        {
+            std::unique_lock<std::shared_mutex> lock(m_cmd_buffer_draws_mutex);
+            for (VkCommandBuffer cb : it->second)
+            {
+                m_cmd_buffer_draws.erase(cb);
+            }
         }
         sCommandPoolBuffers.erase(it);
     }
@@ -514,10 +535,19 @@ void DiveRuntimeLayer::FreeCommandBuffers(PFN_vkFreeCommandBuffers pfn, VkDevice
                                           VkCommandPool commandPool, uint32_t commandBufferCount,
                                           const VkCommandBuffer* pCommandBuffers)
 {
+    if (m_telemetry_active.load(std::memory_order_relaxed))
+    {
+        std::unique_lock<std::shared_mutex> lock(m_cmd_buffer_draws_mutex);
+        for (uint32_t i = 0; i < commandBufferCount; ++i)
+        {
+            m_cmd_buffer_draws.erase(pCommandBuffers[i]);
+        }
+    }
     for (uint32_t i = 0; i < commandBufferCount; ++i)
     {
         sCmdBufferCurrentPipelineHasAlpha.erase(pCommandBuffers[i]);
         sCmdBufferInFilteredRenderPass.erase(pCommandBuffers[i]);
+        sCmdBufferRecordedDraws.erase(pCommandBuffers[i]);
     }
 
     m_boundary_detector.OnFreeCommandBuffers(commandBufferCount, pCommandBuffers);
@@ -578,6 +608,10 @@ VkResult DiveRuntimeLayer::BeginCommandBuffer(PFN_vkBeginCommandBuffer pfn,
                                               const VkCommandBufferBeginInfo* pBeginInfo)
 {
     sCmdBufferCurrentPipelineHasAlpha[commandBuffer] = false;
+    if (m_telemetry_active.load(std::memory_order_relaxed))
+    {
+        sCmdBufferRecordedDraws[commandBuffer] = 0;
+    }
 
     VkResult result = pfn(commandBuffer, pBeginInfo);
     if (sEnableDrawcallReport)
@@ -603,6 +637,17 @@ VkResult DiveRuntimeLayer::EndCommandBuffer(PFN_vkEndCommandBuffer pfn,
                                             VkCommandBuffer commandBuffer)
 {
     sCmdBufferCurrentPipelineHasAlpha.erase(commandBuffer);
+    uint32_t draw_count = 0;
+    if (auto it = sCmdBufferRecordedDraws.find(commandBuffer); it != sCmdBufferRecordedDraws.end())
+    {
+        draw_count = it->second;
+        sCmdBufferRecordedDraws.erase(it);
+    }
+    if (m_telemetry_active.load(std::memory_order_relaxed))
+    {
+        std::unique_lock<std::shared_mutex> lock(m_cmd_buffer_draws_mutex);
+        m_cmd_buffer_draws[commandBuffer] = draw_count;
+    }
 
     Dive::GPUTime::GpuTimeStatus status =
         m_gpu_time.OnEndCommandBuffer(commandBuffer, m_pfn_vkCmdWriteTimestamp);
@@ -703,6 +748,27 @@ VkResult DiveRuntimeLayer::QueueSubmit(PFN_vkQueueSubmit pfn, VkQueue queue, uin
         return result;
     }
 
+    if (m_telemetry_active.load(std::memory_order_relaxed))
+    {
+        // Draws are counted per submission, so that command buffers recorded once and submitted
+        // every frame count in every frame. Draws in secondary command buffers are not counted,
+        // since vkCmdExecuteCommands is not intercepted.
+        uint32_t draw_count = 0;
+        std::shared_lock<std::shared_mutex> lock(m_cmd_buffer_draws_mutex);
+        for (uint32_t i = 0; i < submitCount; ++i)
+        {
+            for (uint32_t j = 0; j < pSubmits[i].commandBufferCount; ++j)
+            {
+                if (auto it = m_cmd_buffer_draws.find(pSubmits[i].pCommandBuffers[j]);
+                    it != m_cmd_buffer_draws.end())
+                {
+                    draw_count += it->second;
+                }
+            }
+        }
+        m_telemetry_drawcall_counter.fetch_add(draw_count, std::memory_order_relaxed);
+    }
+
     if (sEnableGPUTiming)
     {
         auto submit_status =
@@ -790,6 +856,7 @@ VkResult DiveRuntimeLayer::CreateRenderPass(PFN_vkCreateRenderPass pfn, VkDevice
         std::unique_lock<std::shared_mutex> lock(m_rp_mutex);
         TrackedRenderPass info{
             .name = "Unnamed RenderPass",
+            .generation = ++m_rp_generation,
         };
         m_render_passes[*pRenderPass] = info;
     }
@@ -848,6 +915,7 @@ VkResult DiveRuntimeLayer::CreateRenderPass2(PFN_vkCreateRenderPass2 pfn, VkDevi
         std::unique_lock<std::shared_mutex> lock(m_rp_mutex);
         TrackedRenderPass info{
             .name = "Unnamed RenderPass",
+            .generation = ++m_rp_generation,
         };
         m_render_passes[*pRenderPass] = info;
     }
@@ -901,7 +969,10 @@ void DiveRuntimeLayer::DestroyRenderPass(PFN_vkDestroyRenderPass pfn, VkDevice d
 {
     {
         std::unique_lock<std::shared_mutex> lock(m_rp_mutex);
-        m_render_passes.erase(renderPass);
+        if (m_render_passes.erase(renderPass) > 0)
+        {
+            m_removed_rps.Add(reinterpret_cast<uint64_t>(renderPass), ++m_rp_generation);
+        }
     }
     pfn(device, renderPass, pAllocator);
 }
@@ -965,6 +1036,12 @@ void DiveRuntimeLayer::ProcessFrameBoundaryTasks()
 
     m_global_drawcall_counter.store(0, std::memory_order_relaxed);
 
+    uint64_t frame_index = m_frame_count.fetch_add(1, std::memory_order_relaxed);
+    if (m_telemetry_active.load(std::memory_order_relaxed))
+    {
+        RecordTelemetryFrame(frame_index);
+    }
+
     std::vector<std::function<void()>> tasks_to_run;
     {
         std::lock_guard<std::mutex> lock(m_task_mutex);
@@ -1013,8 +1090,174 @@ std::vector<Network::RenderPassInfo> DiveRuntimeLayer::GetLiveRenderPasses()
     return result;
 }
 
-bool DiveRuntimeLayer::CheckAndIncrementDrawcallCount()
+Network::LivePSOsDelta DiveRuntimeLayer::GetLivePSOsDelta(uint64_t since_generation)
+{
+    Network::LivePSOsDelta delta;
+    std::shared_lock<std::shared_mutex> lock(m_pso_mutex);
+    delta.generation = m_pso_generation;
+    // A generation newer than ours comes from a different layer instance.
+    delta.full_snapshot = since_generation == 0 || since_generation > m_pso_generation ||
+                          !m_removed_psos.CollectSince(since_generation, delta.removed);
+    if (delta.full_snapshot)
+    {
+        delta.removed.clear();
+        since_generation = 0;
+    }
+    for (const auto& [pipeline, state] : m_live_psos)
+    {
+        if (state.generation > since_generation)
+        {
+            delta.upserted.push_back(Network::PSOInfo{
+                .name = state.name,
+                .pipeline_handle = reinterpret_cast<uint64_t>(pipeline),
+                .has_alpha_blend = state.has_alpha_blend,
+            });
+        }
+    }
+    return delta;
+}
+
+Network::LiveRenderPassesDelta DiveRuntimeLayer::GetLiveRenderPassesDelta(uint64_t since_generation)
+{
+    Network::LiveRenderPassesDelta delta;
+    std::shared_lock<std::shared_mutex> lock(m_rp_mutex);
+    delta.generation = m_rp_generation;
+    delta.full_snapshot = since_generation == 0 || since_generation > m_rp_generation ||
+                          !m_removed_rps.CollectSince(since_generation, delta.removed);
+    if (delta.full_snapshot)
+    {
+        delta.removed.clear();
+        since_generation = 0;
+    }
+    for (const auto& [rp, state] : m_render_passes)
+    {
+        if (state.generation > since_generation)
+        {
+            delta.upserted.push_back(Network::RenderPassInfo{
+                .name = state.name,
+                .render_pass_handle = reinterpret_cast<uint64_t>(rp),
+            });
+        }
+    }
+    return delta;
+}
+
+void DiveRuntimeLayer::SubscribeTelemetry(
+    std::shared_ptr<Network::UnixDomainServer::PushChannel> channel, uint32_t frames_per_batch)
+{
+    uint64_t client_id = channel->GetClientId();
+    std::lock_guard<std::mutex> lock(m_telemetry_mutex);
+    std::erase_if(m_telemetry_subscribers, [client_id](const TelemetrySubscriber& subscriber) {
+        return subscriber.channel->GetClientId() == client_id;
+    });
+    m_telemetry_subscribers.push_back(TelemetrySubscriber{
+        .channel = std::move(channel),
+        .frames_per_batch = std::clamp(frames_per_batch, 1u, kMaxTelemetryFramesPerBatch),
+    });
+    if (!m_telemetry_active.load(std::memory_order_relaxed))
+    {
+        // The first frame time is measured from now rather than from a stale boundary.
+        m_last_telemetry_frame = std::chrono::steady_clock::now();
+        m_telemetry_drawcall_counter.store(0, std::memory_order_relaxed);
+        SetTelemetryActive(true);
+    }
+}
+
+void DiveRuntimeLayer::UnsubscribeTelemetry(uint64_t client_id)
+{
+    std::lock_guard<std::mutex> lock(m_telemetry_mutex);
+    std::erase_if(m_telemetry_subscribers, [client_id](const TelemetrySubscriber& subscriber) {
+        return subscriber.channel->GetClientId() == client_id;
+    });
+    SetTelemetryActive(!m_telemetry_subscribers.empty());
+}
+
+void DiveRuntimeLayer::RecordTelemetryFrame(uint64_t frame_index)
 {
+    auto now = std::chrono::steady_clock::now();
+    Network::TelemetryFrameSample sample;
+    sample.draw_count = m_telemetry_drawcall_counter.exchange(0, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_telemetry_mutex);
+    int64_t frame_time_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(now - m_last_telemetry_frame).count();
+    sample.frame_time_us = static_cast<uint32_t>(
+        std::clamp<int64_t>(frame_time_us, 0, std::numeric_limits<uint32_t>::max()));
+    m_last_telemetry_frame = now;
+
+    bool gpu_time_queried = false;
+    std::optional<Network::GpuTimeSummary> gpu_time;
+    for (auto it = m_telemetry_subscribers.begin(); it != m_telemetry_subscribers.end();)
+    {
+        if (!it->batch)
+        {
+            it->batch = std::make_unique<Network::TelemetryBatch>();
+            it->batch->SetFirstFrameIndex(frame_index);
+        }
+        it->batch->AddSample(sample);
+        if (it->batch->GetSamples().size() < it->frames_per_batch)
+        {
+            ++it;
+            continue;
+        }
+
+        if (!gpu_time_queried && m_gpu_time.IsEnabled())
+        {
+            gpu_time_queried = true;
+            // The stats cover the GPU timer's window of recent frames, in milliseconds.
+            Dive::GPUTime::Stats stats = m_gpu_time.GetFrameTimeStats();
+            auto to_us = [](double ms) {
+                return static_cast<uint32_t>(std::clamp(ms * 1000.0, 0.0, 4e9));
+            };
+            if (stats.min <= stats.max)
+            {
+                gpu_time = Network::GpuTimeSummary{
+                    .average_us = to_us(stats.average),
+                    .median_us = to_us(stats.median),
+                    .min_us = to_us(stats.min),
+                    .max_us = to_us(stats.max),
+                    .stddev_us = to_us(stats.stddev),
+                };
+            }
+        }
+        if (gpu_time)
+        {
+            it->batch->SetGpuTime(*gpu_time);
+        }
+
+        // A batch that does not fit in the client's queue is dropped; a disconnected client is
+        // unsubscribed.
+        absl::Status status = it->channel->Push(std::move(it->batch));
+        if (absl::IsFailedPrecondition(status))
+        {
+            it = m_telemetry_subscribers.erase(it);
+            continue;
+        }
+        ++it;
+    }
+    SetTelemetryActive(!m_telemetry_subscribers.empty());
+}
+
+void DiveRuntimeLayer::SetTelemetryActive(bool active)
+{
+    const bool was_active = m_telemetry_active.exchange(active, std::memory_order_relaxed);
+    if (was_active && !active)
+    {
+        // The hooks stop updating the counts, which would be stale once telemetry resumes.
+        std::unique_lock<std::shared_mutex> lock(m_cmd_buffer_draws_mutex);
+        m_cmd_buffer_draws.clear();
+    }
+}
+
+bool DiveRuntimeLayer::CheckAndIncrementDrawcallCount(VkCommandBuffer command_buffer)
+{
+    // While telemetry is active, every draw that reaches this point is counted, including the
+    // ones dropped by the drawcall limit below. Command buffers recorded before a client
+    // subscribed are not counted, so that apps pay nothing for telemetry nobody listens to.
+    if (m_telemetry_active.load(std::memory_order_relaxed))
+    {
+        ++sCmdBufferRecordedDraws[command_buffer];
+    }
     if (!m_active_filter_config.enable_drawcall_limit)
     {
         return false;
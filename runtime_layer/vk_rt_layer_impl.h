@@ -19,6 +19,9 @@ limitations under the License.
 #include <vulkan/vk_layer.h>
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <deque>
 #include <filesystem>
 #include <functional>
@@ -28,6 +31,7 @@ limitations under the License.
 #include <set>
 #include <shared_mutex>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -35,6 +39,8 @@ limitations under the License.
 #include "frame_boundary_detector.h"
 #include "gpu_time.h"
 #include "network/drawcall_filter_config.h"
+#include "network/live_state.h"
+#include "network/unix_domain_server.h"
 
 namespace DiveLayer
 {
@@ -46,11 +52,15 @@ class DiveRuntimeLayer
     {
         std::string name;
         bool has_alpha_blend{};
+        // Value of m_pso_generation when this PSO was created or last renamed.
+        uint64_t generation{};
     };
 
     struct TrackedRenderPass
     {
         std::string name;
+        // Value of m_rp_generation when this render pass was created or last renamed.
+        uint64_t generation{};
     };
 
     DiveRuntimeLayer();
@@ -223,13 +233,83 @@ class DiveRuntimeLayer
 
     std::vector<Network::RenderPassInfo> GetLiveRenderPasses();
 
+    // Return the PSOs/render passes created, renamed or destroyed after the given generation.
+    // A full snapshot is returned if the generation is 0 or too old to build a delta from.
+    Network::LivePSOsDelta GetLivePSOsDelta(uint64_t since_generation);
+
+    Network::LiveRenderPassesDelta GetLiveRenderPassesDelta(uint64_t since_generation);
+
     void SetDisableTimestamp(bool disable)
     {
         m_disable_timestamp.store(disable, std::memory_order_relaxed);
     }
 
+    // Pushes a telemetry batch to the client every `frames_per_batch` frames, until it unsubscribes
+    // or disconnects. Subscribing again replaces the client's previous subscription.
+    void SubscribeTelemetry(std::shared_ptr<Network::UnixDomainServer::PushChannel> channel,
+                            uint32_t frames_per_batch);
+
+    void UnsubscribeTelemetry(uint64_t client_id);
+
  private:
-    bool CheckAndIncrementDrawcallCount();
+    // Largest telemetry batch, to bound the memory held for slow subscribers.
+    static constexpr uint32_t kMaxTelemetryFramesPerBatch = 4096;
+
+    struct TelemetrySubscriber
+    {
+        std::shared_ptr<Network::UnixDomainServer::PushChannel> channel;
+        uint32_t frames_per_batch = 1;
+        // Samples not pushed yet; null until the first sample of the batch.
+        std::unique_ptr<Network::TelemetryBatch> batch;
+    };
+    // Recently destroyed objects, used to build live-state deltas. Only the newest kMaxEntries
+    // removals are kept; a client that is further behind gets a full snapshot instead.
+    struct RemovedObjectLog
+    {
+        static constexpr size_t kMaxEntries = 4096;
+
+        void Add(uint64_t handle, uint64_t generation)
+        {
+            if (entries.size() == kMaxEntries)
+            {
+                dropped_generation = entries.front().second;
+                entries.pop_front();
+            }
+            entries.emplace_back(handle, generation);
+        }
+
+        // Appends the handles removed after `since_generation`. Returns false if some of them
+        // have already been dropped from the log.
+        bool CollectSince(uint64_t since_generation, std::vector<uint64_t>& removed) const
+        {
+            if (since_generation < dropped_generation)
+            {
+                return false;
+            }
+            auto it = std::upper_bound(entries.begin(), entries.end(), since_generation,
+                                       [](uint64_t generation, const auto& entry) {
+                                           return generation < entry.second;
+                                       });
+            for (; it != entries.end(); ++it)
+            {
+                removed.push_back(it->first);
+            }
+            return true;
+        }
+
+        // (handle, generation of the removal), ordered by generation.
+        std::deque<std::pair<uint64_t, uint64_t>> entries;
+        uint64_t dropped_generation = 0;
+    };
+
+    bool CheckAndIncrementDrawcallCount(VkCommandBuffer command_buffer);
+
+    // Updates m_telemetry_active, dropping the recorded draw counts when it turns off. The caller
+    // must hold m_telemetry_mutex.
+    void SetTelemetryActive(bool active);
+
+    // Adds the sample of the frame that just ended to every subscriber and pushes full batches.
+    void RecordTelemetryFrame(uint64_t frame_index);
 
     template <bool HasVertex, bool HasIndex, bool HasInstance>
     bool ShouldFilterDrawCall(VkCommandBuffer command_buffer, uint32_t vertex_count = 0,
@@ -268,6 +348,23 @@ class DiveRuntimeLayer
     // Global drawcall counter.
     std::atomic<uint32_t> m_global_drawcall_counter{0};
 
+    // Number of frame boundaries seen so far.
+    std::atomic<uint64_t> m_frame_count{0};
+
+    // Telemetry stream. The draw and frame hooks only check m_telemetry_active while nobody is
+    // subscribed.
+    std::atomic<bool> m_telemetry_active{false};
+    // Draws of the command buffers submitted since the last frame boundary.
+    std::atomic<uint32_t> m_telemetry_drawcall_counter{0};
+    std::mutex m_telemetry_mutex;
+    // Draws recorded in each ended command buffer, added to the telemetry count on submission.
+    // Only vkEndCommandBuffer, vkQueueSubmit and the command buffer lifetime hooks lock it, and
+    // only while telemetry is active.
+    std::shared_mutex m_cmd_buffer_draws_mutex;
+    absl::flat_hash_map<VkCommandBuffer, uint32_t> m_cmd_buffer_draws;
+    std::vector<TelemetrySubscriber> m_telemetry_subscribers;
+    std::chrono::steady_clock::time_point m_last_telemetry_frame;
+
     // Pipeline State Object (PSO) state tracking.
     // Performance Note: std::unique_lock (exclusive write) is strictly limited to
     // infrequent pipeline lifecycle events (CreateGraphicsPipelines, DestroyPipeline,
@@ -277,9 +374,15 @@ class DiveRuntimeLayer
     // The hottest paths (CmdDraw*) do not touch this mutex at all.
     std::shared_mutex m_pso_mutex;
     absl::flat_hash_map<VkPipeline, TrackedPSO> m_live_psos;
+    // Bumped on every change to m_live_psos, so that clients can poll for deltas.
+    uint64_t m_pso_generation = 0;
+    RemovedObjectLog m_removed_psos;
 
     std::shared_mutex m_rp_mutex;
     absl::flat_hash_map<VkRenderPass, TrackedRenderPass> m_render_passes;
+    // Bumped on every change to m_render_passes, so that clients can poll for deltas.
+    uint64_t m_rp_generation = 0;
+    RemovedObjectLog m_removed_rps;
 
     std::atomic<bool> m_disable_timestamp{false};
     std::shared_mutex m_query_pool_mutex;
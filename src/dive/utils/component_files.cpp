@@ -64,9 +64,15 @@ absl::StatusOr<Dive::ComponentFilePaths> GetComponentFilesHostPaths(
     artifacts.perf_counter_csv =
         parent_dir / absl::StrFormat("%s%s%s", gfxr_stem, constants.kProfilingMetricsHostSuffix,
                                      constants.kCsvExt);
+    artifacts.perf_counter_bin =
+        parent_dir / absl::StrFormat("%s%s%s", gfxr_stem, constants.kProfilingMetricsHostSuffix,
+                                     constants.kPerfMetricsExt);
     artifacts.gpu_timing_csv =
         parent_dir /
         absl::StrFormat("%s%s%s", gfxr_stem, constants.kGpuTimingHostSuffix, constants.kCsvExt);
+    artifacts.gpu_timing_distribution_csv =
+        parent_dir / absl::StrFormat("%s%s%s", gfxr_stem,
+                                     constants.kGpuTimingDistributionHostSuffix, constants.kCsvExt);
     artifacts.pm4_rd = parent_dir / absl::StrFormat("%s%s", gfxr_stem, constants.kRdExt);
     artifacts.screenshot_png = parent_dir / absl::StrFormat("%s%s", gfxr_stem, constants.kPngExt);
     artifacts.renderdoc_rdc =
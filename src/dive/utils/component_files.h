@@ -33,7 +33,9 @@ struct ComponentFilePaths
     std::filesystem::path gfxr;
     std::filesystem::path gfxa;
     std::filesystem::path perf_counter_csv;
+    std::filesystem::path perf_counter_bin;
     std::filesystem::path gpu_timing_csv;
+    std::filesystem::path gpu_timing_distribution_csv;
     std::filesystem::path pm4_rd;
     std::filesystem::path screenshot_png;
     std::filesystem::path renderdoc_rdc;
@@ -30,6 +30,7 @@ struct ComponentFileConstants
     static constexpr std::string_view kRdExt = ".rd";
     static constexpr std::string_view kPngExt = ".png";
     static constexpr std::string_view kCsvExt = ".csv";
+    static constexpr std::string_view kPerfMetricsExt = ".dpm";
     static constexpr std::string_view kRdcExt = ".rdc";
 
     // Filename substrings recognized by GFXR
@@ -43,7 +44,10 @@ struct ComponentFileConstants
     // gfxr:            <package>_trim_trigger_<id>.gfxr
     // gfxa:            <package>_asset_file_<id>.gfxr
     // perf counter:    <package>_trim_trigger_<id>_profiling_metrics.csv
+    //                  <package>_trim_trigger_<id>_profiling_metrics.dpm (binary, from the .csv)
     // gpu timing:      <package>_trim_trigger_<id>_gpu_time.csv
+    // gpu timing distribution:
+    //                  <package>_trim_trigger_<id>_gpu_time_distribution.csv
     // pm4:             <package>_trim_trigger_<id>.rd
     // screenshot:      <package>_trim_trigger_<id>.png
     // renderdoc:       <package>_trim_trigger_<id>_capture.rdc (not loaded in UI)
@@ -51,6 +55,7 @@ struct ComponentFileConstants
     // Substrings used for host names
     static constexpr std::string_view kProfilingMetricsHostSuffix = "_profiling_metrics";
     static constexpr std::string_view kGpuTimingHostSuffix = "_gpu_time";
+    static constexpr std::string_view kGpuTimingDistributionHostSuffix = "_gpu_time_distribution";
     static constexpr std::string_view kRenderDocHostSuffix = "_capture";
 
     // ----------------------------------------------------------------------------
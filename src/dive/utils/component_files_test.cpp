@@ -33,7 +33,9 @@ MATCHER_P(PathsEq, expected, "")
     EXPECT_EQ(arg.gfxr, expected.gfxr);
     EXPECT_EQ(arg.gfxa, expected.gfxa);
     EXPECT_EQ(arg.perf_counter_csv, expected.perf_counter_csv);
+    EXPECT_EQ(arg.perf_counter_bin, expected.perf_counter_bin);
     EXPECT_EQ(arg.gpu_timing_csv, expected.gpu_timing_csv);
+    EXPECT_EQ(arg.gpu_timing_distribution_csv, expected.gpu_timing_distribution_csv);
     EXPECT_EQ(arg.pm4_rd, expected.pm4_rd);
     EXPECT_EQ(arg.screenshot_png, expected.screenshot_png);
     EXPECT_EQ(arg.renderdoc_rdc, expected.renderdoc_rdc);
@@ -70,7 +72,11 @@ TEST(ValidateGfxrReplaySettingsTest, BasicPass)
     expected_res.gfxa = parent_dir / "PLACEHOLDER_asset_file_ID.gfxa";
     expected_res.perf_counter_csv =
         parent_dir / "PLACEHOLDER_trim_trigger_ID_profiling_metrics.csv";
+    expected_res.perf_counter_bin =
+        parent_dir / "PLACEHOLDER_trim_trigger_ID_profiling_metrics.dpm";
     expected_res.gpu_timing_csv = parent_dir / "PLACEHOLDER_trim_trigger_ID_gpu_time.csv";
+    expected_res.gpu_timing_distribution_csv =
+        parent_dir / "PLACEHOLDER_trim_trigger_ID_gpu_time_distribution.csv";
     expected_res.pm4_rd = parent_dir / "PLACEHOLDER_trim_trigger_ID.rd";
     expected_res.screenshot_png = parent_dir / "PLACEHOLDER_trim_trigger_ID.png";
     expected_res.renderdoc_rdc = parent_dir / "PLACEHOLDER_trim_trigger_ID_capture.rdc";
@@ -91,7 +97,11 @@ TEST(ValidateGfxrReplaySettingsTest, GfxrSubstringInParentPathPass)
     expected_res.gfxa = parent_dir / "PLACEHOLDER_asset_file_ID.gfxa";
     expected_res.perf_counter_csv =
         parent_dir / "PLACEHOLDER_trim_trigger_ID_profiling_metrics.csv";
+    expected_res.perf_counter_bin =
+        parent_dir / "PLACEHOLDER_trim_trigger_ID_profiling_metrics.dpm";
     expected_res.gpu_timing_csv = parent_dir / "PLACEHOLDER_trim_trigger_ID_gpu_time.csv";
+    expected_res.gpu_timing_distribution_csv =
+        parent_dir / "PLACEHOLDER_trim_trigger_ID_gpu_time_distribution.csv";
     expected_res.pm4_rd = parent_dir / "PLACEHOLDER_trim_trigger_ID.rd";
     expected_res.screenshot_png = parent_dir / "PLACEHOLDER_trim_trigger_ID.png";
     expected_res.renderdoc_rdc = parent_dir / "PLACEHOLDER_trim_trigger_ID_capture.rdc";
@@ -111,7 +121,11 @@ TEST(ValidateGfxrReplaySettingsTest, DotinGfxrStemPass)
     expected_res.gfxa = parent_dir / "PLACEHOLDER._asset_file_ID.test.gfxa";
     expected_res.perf_counter_csv =
         parent_dir / "PLACEHOLDER._trim_trigger_ID.test_profiling_metrics.csv";
+    expected_res.perf_counter_bin =
+        parent_dir / "PLACEHOLDER._trim_trigger_ID.test_profiling_metrics.dpm";
     expected_res.gpu_timing_csv = parent_dir / "PLACEHOLDER._trim_trigger_ID.test_gpu_time.csv";
+    expected_res.gpu_timing_distribution_csv =
+        parent_dir / "PLACEHOLDER._trim_trigger_ID.test_gpu_time_distribution.csv";
     expected_res.pm4_rd = parent_dir / "PLACEHOLDER._trim_trigger_ID.test.rd";
     expected_res.screenshot_png = parent_dir / "PLACEHOLDER._trim_trigger_ID.test.png";
     expected_res.renderdoc_rdc = parent_dir / "PLACEHOLDER._trim_trigger_ID.test_capture.rdc";
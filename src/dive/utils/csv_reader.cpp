@@ -0,0 +1,298 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include "dive/utils/csv_reader.h"
+
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Dive
+{
+namespace
+{
+
+bool IsBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+std::string_view TrimBlanks(std::string_view s)
+{
+    while (!s.empty() && IsBlank(s.front()))
+    {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && IsBlank(s.back()))
+    {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+}  // namespace
+
+MappedFile::~MappedFile() { Close(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+        m_file_handle = std::exchange(other.m_file_handle, nullptr);
+        m_mapping_handle = std::exchange(other.m_mapping_handle, nullptr);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::filesystem::path& file_path)
+{
+    Close();
+
+    HANDLE file = CreateFileW(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    m_file_handle = file;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size))
+    {
+        Close();
+        return false;
+    }
+    if (size.QuadPart == 0)
+    {
+        // Empty files can't be mapped.
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        Close();
+        return false;
+    }
+    m_mapping_handle = mapping;
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr)
+    {
+        Close();
+        return false;
+    }
+    m_data = static_cast<const char*>(data);
+    m_size = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data != nullptr)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping_handle != nullptr)
+    {
+        CloseHandle(m_mapping_handle);
+    }
+    if (m_file_handle != nullptr)
+    {
+        CloseHandle(m_file_handle);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_mapping_handle = nullptr;
+    m_file_handle = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const std::filesystem::path& file_path)
+{
+    Close();
+
+    int fd = open(file_path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat file_stat
+    {
+    };
+    if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode))
+    {
+        close(fd);
+        return false;
+    }
+    if (file_stat.st_size == 0)
+    {
+        // Empty files can't be mapped.
+        close(fd);
+        return true;
+    }
+
+    size_t size = static_cast<size_t>(file_stat.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file.
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    m_data = static_cast<const char*>(data);
+    m_size = size;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data != nullptr)
+    {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+}
+
+#endif
+
+std::string_view CsvReader::ReadField()
+{
+    while (m_offset < m_data.size() && IsBlank(m_data[m_offset]))
+    {
+        ++m_offset;
+    }
+
+    if (m_offset < m_data.size() && m_data[m_offset] == '"')
+    {
+        size_t begin = ++m_offset;
+        size_t end = m_data.size();
+        while (m_offset < m_data.size())
+        {
+            if (m_data[m_offset] == '"')
+            {
+                if (m_offset + 1 < m_data.size() && m_data[m_offset + 1] == '"')
+                {
+                    // Escaped quote.
+                    m_offset += 2;
+                    continue;
+                }
+                end = m_offset++;
+                break;
+            }
+            ++m_offset;
+        }
+        // Anything between the closing quote and the delimiter is dropped.
+        while (m_offset < m_data.size() && m_data[m_offset] != ',' && m_data[m_offset] != '\n')
+        {
+            ++m_offset;
+        }
+        return TrimBlanks(m_data.substr(begin, end - begin));
+    }
+
+    size_t begin = m_offset;
+    while (m_offset < m_data.size() && m_data[m_offset] != ',' && m_data[m_offset] != '\n')
+    {
+        ++m_offset;
+    }
+    return TrimBlanks(m_data.substr(begin, m_offset - begin));
+}
+
+bool CsvReader::ReadRecord(std::vector<std::string_view>& fields)
+{
+    while (m_offset < m_data.size())
+    {
+        fields.clear();
+        while (true)
+        {
+            fields.push_back(ReadField());
+            if (m_offset < m_data.size() && m_data[m_offset] == ',')
+            {
+                ++m_offset;
+                continue;
+            }
+            // End of the line or of the data.
+            if (m_offset < m_data.size())
+            {
+                ++m_offset;
+            }
+            break;
+        }
+
+        if (fields.size() > 1 || !fields.front().empty())
+        {
+            return true;
+        }
+        // Blank line.
+    }
+    fields.clear();
+    return false;
+}
+
+std::vector<std::string_view> SplitCsvChunks(std::string_view data, size_t max_chunk_count)
+{
+    if (max_chunk_count <= 1 || data.find('"') != std::string_view::npos)
+    {
+        return {data};
+    }
+
+    std::vector<std::string_view> chunks;
+    chunks.reserve(max_chunk_count);
+    size_t target_size = data.size() / max_chunk_count;
+    size_t begin = 0;
+    while (begin < data.size())
+    {
+        size_t end = data.size();
+        if (chunks.size() + 1 < max_chunk_count)
+        {
+            size_t newline = data.find('\n', std::min(begin + target_size, data.size() - 1));
+            if (newline != std::string_view::npos)
+            {
+                end = newline + 1;
+            }
+        }
+        chunks.push_back(data.substr(begin, end - begin));
+        begin = end;
+    }
+    if (chunks.empty())
+    {
+        chunks.push_back(data);
+    }
+    return chunks;
+}
+
+}  // namespace Dive
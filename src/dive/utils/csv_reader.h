@@ -0,0 +1,176 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#pragma once
+
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace Dive
+{
+
+// Read-only view of the whole contents of a file, memory-mapped so that large files are not copied
+// into the heap before being parsed.
+class MappedFile
+{
+ public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps `file_path`, replacing any previously mapped file. Returns false if the file can't be
+    // opened or mapped.
+    bool Open(const std::filesystem::path& file_path);
+
+    // Valid until the file is closed or another file is opened.
+    std::string_view GetContents() const { return std::string_view(m_data, m_size); }
+
+ private:
+    void Close();
+
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file_handle = nullptr;
+    void* m_mapping_handle = nullptr;
+#endif
+};
+
+// Single-pass CSV tokenizer over an in-memory buffer. Fields are returned as views into the buffer,
+// so reading a record does not allocate once `fields` has grown to the widest record.
+class CsvReader
+{
+ public:
+    explicit CsvReader(std::string_view data) : m_data(data) {}
+
+    // Splits the next non-blank record into `fields`. Fields are trimmed and have their enclosing
+    // quotes removed; escaped quotes ("") inside a quoted field are left as-is. A quoted field may
+    // span several lines. Returns false once the data is exhausted.
+    bool ReadRecord(std::vector<std::string_view>& fields);
+
+    // Number of bytes consumed so far, i.e. the offset of the next record.
+    size_t GetOffset() const { return m_offset; }
+
+ private:
+    // Reads one field starting at m_offset and leaves m_offset on the delimiter that ends it.
+    std::string_view ReadField();
+
+    std::string_view m_data;
+    size_t m_offset = 0;
+};
+
+// Splits `data` into at most `max_chunk_count` consecutive chunks of similar size, each ending at a
+// line boundary, so that they can be tokenized independently. Since a newline inside a quoted field
+// can't be told apart from the end of a record without scanning from the start, data that contains
+// quotes is returned as a single chunk.
+std::vector<std::string_view> SplitCsvChunks(std::string_view data, size_t max_chunk_count);
+
+// Converts a whole CSV field to a number. Integers are parsed with std::from_chars, which neither
+// allocates nor depends on the locale. Floating-point std::from_chars is missing from some
+// standard libraries (e.g. Apple libc++), so floating-point numbers are parsed with strtod on a
+// null-terminated copy of the field, as StringUtils::SafeConvertFromString does. A leading '+' is
+// accepted, leading whitespace and trailing characters are not. Floating-point fields may also be
+// nan, inf or infinity, in any case and with a sign.
+template <typename T>
+bool ParseCsvNumber(std::string_view field, T& out)
+{
+    static_assert(std::is_arithmetic_v<T>, "ParseCsvNumber only supports numbers");
+
+    if (!field.empty() && field.front() == '+')
+    {
+        field.remove_prefix(1);
+    }
+
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        // strtod skips whitespace, takes a second '+' and parses hexadecimal numbers, which
+        // std::from_chars would reject. Like both of them, nan and inf(inity) are accepted in
+        // any case.
+        size_t sign_size = (!field.empty() && field.front() == '-') ? 1 : 0;
+        char first = field.size() > sign_size ? field[sign_size] : '\0';
+        bool is_digit = first == '.' || (first >= '0' && first <= '9');
+        bool is_nan_or_inf = first == 'n' || first == 'N' || first == 'i' || first == 'I';
+        if ((!is_digit && !is_nan_or_inf) || field.find_first_of("xX") != std::string_view::npos)
+        {
+            return false;
+        }
+
+        // Fields are copied to the stack unless they are unusually long
+        char buffer[64];
+        std::string long_field;
+        const char* start = buffer;
+        if (field.size() < sizeof(buffer))
+        {
+            std::memcpy(buffer, field.data(), field.size());
+            buffer[field.size()] = '\0';
+        }
+        else
+        {
+            long_field.assign(field);
+            start = long_field.c_str();
+        }
+
+        char* end = nullptr;
+        errno = 0;
+        T value{};
+        if constexpr (std::is_same_v<T, float>)
+        {
+            value = std::strtof(start, &end);
+        }
+        else if constexpr (std::is_same_v<T, double>)
+        {
+            value = std::strtod(start, &end);
+        }
+        else
+        {
+            value = std::strtold(start, &end);
+        }
+        if (errno == ERANGE || end != start + field.size())
+        {
+            return false;
+        }
+        out = value;
+        return true;
+    }
+    else
+    {
+        const char* begin = field.data();
+        const char* end = field.data() + field.size();
+        T value{};
+        std::from_chars_result result = std::from_chars(begin, end, value, 10);
+        if (result.ec != std::errc() || result.ptr != end)
+        {
+            return false;
+        }
+        out = value;
+        return true;
+    }
+}
+
+}  // namespace Dive
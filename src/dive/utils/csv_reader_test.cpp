@@ -0,0 +1,233 @@
+/*
+ Copyright 2026 Google LLC
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+*/
+
+#include "dive/utils/csv_reader.h"
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Dive
+{
+namespace
+{
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+std::vector<std::vector<std::string_view>> ReadAll(std::string_view data)
+{
+    CsvReader reader(data);
+    std::vector<std::vector<std::string_view>> records;
+    std::vector<std::string_view> fields;
+    while (reader.ReadRecord(fields))
+    {
+        records.push_back(fields);
+    }
+    return records;
+}
+
+TEST(CsvReader, SplitsRecordsAndFields)
+{
+    auto records = ReadAll("a,b,c\n1,2,3\n");
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_THAT(records[0], ElementsAre("a", "b", "c"));
+    EXPECT_THAT(records[1], ElementsAre("1", "2", "3"));
+}
+
+TEST(CsvReader, TrimsFieldsAndSkipsBlankLines)
+{
+    auto records = ReadAll(" a ,\tb\r\n\r\n\n  \n1, 2 \r\n");
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_THAT(records[0], ElementsAre("a", "b"));
+    EXPECT_THAT(records[1], ElementsAre("1", "2"));
+}
+
+TEST(CsvReader, KeepsEmptyFields)
+{
+    auto records = ReadAll(",x,\nlast,");
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_THAT(records[0], ElementsAre("", "x", ""));
+    EXPECT_THAT(records[1], ElementsAre("last", ""));
+}
+
+TEST(CsvReader, QuotedFields)
+{
+    auto records = ReadAll("\"a,b\",\" c \",\"say \"\"hi\"\"\"\n\"multi\nline\",2\n");
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_THAT(records[0], ElementsAre("a,b", "c", "say \"\"hi\"\""));
+    EXPECT_THAT(records[1], ElementsAre("multi\nline", "2"));
+}
+
+TEST(CsvReader, OffsetPointsAtNextRecord)
+{
+    std::string_view data = "header\nrow\n";
+    CsvReader reader(data);
+    std::vector<std::string_view> fields;
+    ASSERT_TRUE(reader.ReadRecord(fields));
+    EXPECT_EQ(data.substr(reader.GetOffset()), "row\n");
+    ASSERT_TRUE(reader.ReadRecord(fields));
+    EXPECT_FALSE(reader.ReadRecord(fields));
+    EXPECT_THAT(fields, IsEmpty());
+}
+
+TEST(CsvReader, SplitChunksEndOnLineBoundaries)
+{
+    std::string data;
+    for (int i = 0; i < 100; ++i)
+    {
+        data += std::to_string(i) + ",value\n";
+    }
+
+    std::vector<std::string_view> chunks = SplitCsvChunks(data, 4);
+    ASSERT_EQ(chunks.size(), 4u);
+    std::string joined;
+    for (std::string_view chunk : chunks)
+    {
+        EXPECT_EQ(chunk.back(), '\n');
+        joined += chunk;
+    }
+    EXPECT_EQ(joined, data);
+}
+
+TEST(CsvReader, SplitChunksKeepsQuotedDataWhole)
+{
+    std::string_view data = "\"a\nb\",1\n\"c\nd\",2\n";
+    EXPECT_THAT(SplitCsvChunks(data, 4), ElementsAre(data));
+    EXPECT_THAT(SplitCsvChunks("x\ny\n", 1), ElementsAre("x\ny\n"));
+}
+
+TEST(CsvReader, ParseNumbers)
+{
+    uint32_t u = 0;
+    EXPECT_TRUE(ParseCsvNumber("123", u));
+    EXPECT_EQ(u, 123u);
+    EXPECT_TRUE(ParseCsvNumber("+7", u));
+    EXPECT_EQ(u, 7u);
+    EXPECT_FALSE(ParseCsvNumber("-1", u));
+    EXPECT_FALSE(ParseCsvNumber("4294967296", u));
+    EXPECT_FALSE(ParseCsvNumber("12a", u));
+    EXPECT_FALSE(ParseCsvNumber("1.5", u));
+    EXPECT_FALSE(ParseCsvNumber("", u));
+    EXPECT_EQ(u, 7u);
+
+    int8_t i = 0;
+    EXPECT_TRUE(ParseCsvNumber("-128", i));
+    EXPECT_EQ(i, -128);
+    EXPECT_FALSE(ParseCsvNumber("128", i));
+
+    double d = 0.0;
+    EXPECT_TRUE(ParseCsvNumber("0.25", d));
+    EXPECT_DOUBLE_EQ(d, 0.25);
+    EXPECT_TRUE(ParseCsvNumber("-1e3", d));
+    EXPECT_DOUBLE_EQ(d, -1000.0);
+    EXPECT_FALSE(ParseCsvNumber("0.25ms", d));
+    EXPECT_FALSE(ParseCsvNumber("abc", d));
+    EXPECT_FALSE(ParseCsvNumber(" 1", d));
+    EXPECT_FALSE(ParseCsvNumber("0x10", d));
+    EXPECT_FALSE(ParseCsvNumber("1e999", d));
+    EXPECT_FALSE(ParseCsvNumber("", d));
+    EXPECT_DOUBLE_EQ(d, -1000.0);
+
+    // Only the field is parsed, not the data after it
+    std::string_view row = "2.5,3";
+    EXPECT_TRUE(ParseCsvNumber(row.substr(0, 3), d));
+    EXPECT_DOUBLE_EQ(d, 2.5);
+    std::string long_field = "1." + std::string(100, '0') + "5";
+    EXPECT_TRUE(ParseCsvNumber(long_field, d));
+    EXPECT_DOUBLE_EQ(d, 1.0);
+
+    float f = 0.0f;
+    EXPECT_TRUE(ParseCsvNumber("+1.5", f));
+    EXPECT_FLOAT_EQ(f, 1.5f);
+}
+
+TEST(CsvReader, ParseNanAndInfinity)
+{
+    double d = 0.0;
+    for (std::string_view field : {"nan", "NaN", "-nan", "+NAN"})
+    {
+        d = 0.0;
+        EXPECT_TRUE(ParseCsvNumber(field, d)) << field;
+        EXPECT_TRUE(std::isnan(d)) << field;
+    }
+    for (std::string_view field : {"inf", "INF", "+Infinity", "infinity"})
+    {
+        d = 0.0;
+        EXPECT_TRUE(ParseCsvNumber(field, d)) << field;
+        EXPECT_EQ(d, std::numeric_limits<double>::infinity()) << field;
+    }
+    EXPECT_TRUE(ParseCsvNumber("-Inf", d));
+    EXPECT_EQ(d, -std::numeric_limits<double>::infinity());
+
+    float f = 0.0f;
+    EXPECT_TRUE(ParseCsvNumber("-INFINITY", f));
+    EXPECT_EQ(f, -std::numeric_limits<float>::infinity());
+    EXPECT_TRUE(ParseCsvNumber("nan", f));
+    EXPECT_TRUE(std::isnan(f));
+
+    // Only whole words are accepted
+    d = 1.0;
+    for (std::string_view field : {"n", "in", "infinit", "nanx", "infs", "--inf", "-+inf", " inf"})
+    {
+        EXPECT_FALSE(ParseCsvNumber(field, d)) << field;
+    }
+    EXPECT_DOUBLE_EQ(d, 1.0);
+
+    // Integers don't take them
+    int32_t i = 0;
+    EXPECT_FALSE(ParseCsvNumber("nan", i));
+    EXPECT_FALSE(ParseCsvNumber("inf", i));
+}
+
+TEST(MappedFile, MapsFileContents)
+{
+    std::filesystem::path path =
+        std::filesystem::path(testing::TempDir()) /
+        (std::string(testing::UnitTest::GetInstance()->current_test_info()->name()) + ".csv");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "a,b\n1,2\n";
+    }
+
+    MappedFile mapped;
+    ASSERT_TRUE(mapped.Open(path));
+    EXPECT_EQ(mapped.GetContents(), "a,b\n1,2\n");
+
+    MappedFile moved = std::move(mapped);
+    EXPECT_EQ(moved.GetContents(), "a,b\n1,2\n");
+    EXPECT_TRUE(mapped.GetContents().empty());
+
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    }
+    ASSERT_TRUE(moved.Open(path));
+    EXPECT_TRUE(moved.GetContents().empty());
+
+    std::filesystem::remove(path);
+    EXPECT_FALSE(moved.Open(path));
+}
+
+}  // namespace
+}  // namespace Dive
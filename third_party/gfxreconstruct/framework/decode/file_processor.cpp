@@ -317,7 +317,8 @@ bool FileProcessor::ProcessBlocks()
                     block_parser.SetFrameNumber(current_frame_number_);
                     // NOTE: upon successful parsing, the block_buffer block data has been moved to the
                     // parsed_block, though the block header is still valid.
-                    ParsedBlock parsed_block = block_parser.ParseBlock(block_buffer);
+                    // GOOGLE: [block-prefetch] Parse through the overridable hook
+                    ParsedBlock parsed_block = ParseBlock(block_parser, block_buffer);
 
                     // NOTE: Visitable is either Ready or DeferredDecompression,
                     //       Invalid, Unknown, and Skip are not Visitable
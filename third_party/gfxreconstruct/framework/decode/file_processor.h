@@ -189,6 +189,13 @@ class FileProcessor
     // Gets the block buffer from input stream or preloaded data if available
     virtual bool GetBlockBuffer(BlockParser& parser, BlockBuffer& block_buffer);
 
+    // GOOGLE: [block-prefetch] Allow derived classes to supply blocks that were parsed (and decompressed) ahead of
+    // time, e.g. on worker threads. The block_buffer is the one returned by the last GetBlockBuffer call.
+    virtual ParsedBlock ParseBlock(BlockParser& parser, BlockBuffer& block_buffer)
+    {
+        return parser.ParseBlock(block_buffer);
+    }
+
     void UpdateEndFrameState();
 
     // Returns whether the call_id is a frame delimiter and handles frame delimiting logic
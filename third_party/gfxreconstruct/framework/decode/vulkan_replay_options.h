@@ -171,6 +171,8 @@ struct VulkanReplayOptions : public ReplayOptions
 
     // GOOGLE: [enable-gpu-time]
     bool enable_gpu_time;
+    // GOOGLE: [gpu-time-early-stop] Stop looping the single frame once the GPU times have converged
+    bool gpu_time_early_stop{ false };
 };
 
 GFXRECON_END_NAMESPACE(decode)
@@ -195,6 +195,16 @@ void android_main(struct android_app* app)
                 if (arg_parser.IsOptionSet(kEnableGPUTime))
                 {
                     vulkan_replay_consumer.SetEnableGPUTime(replay_options.enable_gpu_time);
+
+                    // GOOGLE: Stop looping the frame once the gpu times have converged
+                    if (use_dive_file_processor && replay_options.gpu_time_early_stop)
+                    {
+                        auto* dive_file_processor =
+                            dynamic_cast<gfxrecon::decode::DiveFileProcessor*>(file_processor.get());
+                        GFXRECON_ASSERT(dive_file_processor)
+                        dive_file_processor->SetLoopEarlyStop(
+                            [&vulkan_replay_consumer]() { return vulkan_replay_consumer.HasGPUTimeConverged(); });
+                    }
                 }
 
                 if (replay_options.capture)
@@ -327,6 +337,13 @@ void android_main(struct android_app* app)
                     {
                         GFXRECON_WRITE_CONSOLE("Unable to write GPU stats file");
                     }
+                    // GOOGLE: Save GPU time distribution file
+                    res = dive_file_processor->WriteFile("gpu_time_distribution.csv",
+                                                         vulkan_replay_consumer.GetGPUTimeDistributionCSVStr());
+                    if (!res)
+                    {
+                        GFXRECON_WRITE_CONSOLE("Unable to write GPU time distribution file");
+                    }
                 }
 
                 if (replay_options.capture)
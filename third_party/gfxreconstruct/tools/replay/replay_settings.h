@@ -28,6 +28,7 @@
 
 // GOOGLE: [single-frame-looping] Adding flags to usage message
 // GOOGLE: [enable-gpu-time] Adding flags to usage message
+// GOOGLE: [gpu-time-early-stop] Adding flags to usage message
 const char kOptions[] =
     "-h|--help,--version,--log-debugview,--no-debug-popup,--paused,--sync,--sfa|--skip-failed-allocations,--opcd|--"
     "omit-pipeline-cache-data,--remove-unsupported,--validate,--debug-device-lost,--create-dummy-allocations,--"
@@ -36,7 +37,8 @@ const char kOptions[] =
     "indices,--dcp,--discard-cached-psos,--use-colorspace-fallback,--use-cached-psos,--dx12-override-object-names,--"
     "dx12-ags-inject-markers,--offscreen-swapchain-frame-boundary,--wait-before-present,--dump-resources-before-draw,"
     "--dump-resources-modifiable-state-only,--pbi-all,--preload-measurement-range,--add-new-pipeline-caches,--"
-    "screenshot-ignore-FrameBoundaryANDROID,--deduplicate-device,--log-timestamps,--capture,--enable-gpu-time";
+    "screenshot-ignore-FrameBoundaryANDROID,--deduplicate-device,--log-timestamps,--capture,--enable-gpu-time,"
+    "--gpu-time-early-stop";
 const char kArguments[] =
     "--log-level,--log-file,--cpu-mask,--gpu,--gpu-group,--pause-frame,--wsi,--surface-index,-m|--memory-translation,"
     "--replace-shaders,--screenshots,--screenshot-interval,--denied-messages,--allowed-messages,--screenshot-format,--"
@@ -94,6 +96,8 @@ static void PrintUsage(const char* exe_name)
     GFXRECON_WRITE_CONSOLE("\t\t\t[--loop-single-frame-count <n>]");
     // GOOGLE: [enable-gpu-time] Usage message
     GFXRECON_WRITE_CONSOLE("\t\t\t[--enable-gpu-time]");
+    // GOOGLE: [gpu-time-early-stop] Usage message
+    GFXRECON_WRITE_CONSOLE("\t\t\t[--gpu-time-early-stop]");
 
 #if defined(WIN32)
     GFXRECON_WRITE_CONSOLE("\t\t\t[--dump-resources <submit-index,command-index,drawcall-index>]");
@@ -199,6 +203,14 @@ static void PrintUsage(const char* exe_name)
     // GOOGLE: [enable-gpu-time] Usage message details
     GFXRECON_WRITE_CONSOLE("  --enable-gpu-time");
     GFXRECON_WRITE_CONSOLE("          \t\tWhen enabled, gpu time measurement will be enabled for replay.");
+    GFXRECON_WRITE_CONSOLE("          \t\tThe distributions of the gpu times are written to ");
+    GFXRECON_WRITE_CONSOLE("          \t\tgpu_time_distribution.csv next to gpu_time.csv.");
+    // GOOGLE: [gpu-time-early-stop] Usage message details
+    GFXRECON_WRITE_CONSOLE("  --gpu-time-early-stop");
+    GFXRECON_WRITE_CONSOLE("          \t\tWith --enable-gpu-time and a non-zero --loop-single-frame-count, ");
+    GFXRECON_WRITE_CONSOLE("          \t\tstop looping the frame once the 95%% confidence intervals of ");
+    GFXRECON_WRITE_CONSOLE("          \t\tthe steady-state gpu times are within 1%% of their means. The ");
+    GFXRECON_WRITE_CONSOLE("          \t\tloop count is then the maximum number of loops.");
 #if defined(WIN32)
     GFXRECON_WRITE_CONSOLE("")
     GFXRECON_WRITE_CONSOLE("Windows only:")
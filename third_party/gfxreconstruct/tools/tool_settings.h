@@ -167,6 +167,8 @@ const char kLoopSingleFrameCount[] = "--loop-single-frame-count";
 
 // GOOGLE: [enable-gpu-time]
 const char kEnableGPUTime[] = "--enable-gpu-time";
+// GOOGLE: [gpu-time-early-stop]
+const char kGPUTimeEarlyStop[] = "--gpu-time-early-stop";
 
 enum class WsiPlatform
 {
@@ -1255,6 +1257,8 @@ GetVulkanReplayOptions(const gfxrecon::util::ArgumentParser&           arg_parse
     {
         replay_options.enable_gpu_time = true;
     }
+    // GOOGLE: [gpu-time-early-stop] Parse additional parameters
+    replay_options.gpu_time_early_stop = arg_parser.IsOptionSet(kGPUTimeEarlyStop);
 
     // GOOGLE: [single-frame-looping] Parse additional parameters
     replay_options.loop_single_frame_count = GetLoopSingleFrameCount(arg_parser);
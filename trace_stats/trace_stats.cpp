@@ -16,113 +16,14 @@
 
 #include "trace_stats.h"
 
-#include <condition_variable>
-#include <deque>
-#include <functional>
-#include <mutex>
-#include <thread>
+#include <algorithm>
+#include <atomic>
 
 #include "dive_core/event_state.h"
+#include "dive_core/task_scheduler.h"
 
 namespace Dive
 {
-namespace
-{
-
-class ThreadPool
-{
- public:
-    ThreadPool() = default;
-    ThreadPool(const ThreadPool&) = delete;
-    ThreadPool& operator=(const ThreadPool&) = delete;
-    ~ThreadPool() { Stop(); }
-
-    void Run(std::function<void()>&& func)
-    {
-        {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_tasks.push_back(std::move(func));
-        }
-        m_condition_variable.notify_one();
-    }
-
-    void Start(unsigned int num_workers = 0)
-    {
-        num_workers = (num_workers > 0 ? num_workers : GetDefaultThreadCount());
-
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_running = true;
-        for (unsigned int i = static_cast<unsigned int>(m_workers.size()); i < num_workers; ++i)
-        {
-            m_workers.emplace_back([this]() { this->WorkerImpl(); });
-        }
-    }
-
-    void Stop()
-    {
-        std::deque<std::thread> workers;
-        {
-            std::unique_lock<std::mutex> lock(m_mutex);
-            if (!m_running)
-            {
-                return;
-            }
-            m_running = false;
-            std::swap(workers, m_workers);
-        }
-        m_condition_variable.notify_all();
-        for (std::thread& worker : workers)
-        {
-            worker.join();
-        }
-    }
-
-    static unsigned int SuggestedNumberOfWorkers(unsigned int task_count)
-    {
-        // We are still bottlenecked by the slowest disassembly task.
-        // 4x less worker than disassembly tasks seems be the point of diminishing return.
-        constexpr unsigned int kLoadFactor = 4;
-        return std::min<unsigned int>((task_count + kLoadFactor - 1) / kLoadFactor,
-                                      GetDefaultThreadCount());
-    }
-
- private:
-    std::function<void()> NextTask()
-    {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_condition_variable.wait(lock, [this] { return !m_running || !m_tasks.empty(); });
-        if (!m_running || m_tasks.empty())
-        {
-            return {};
-        }
-        std::function<void()> result = m_tasks.front();
-        m_tasks.pop_front();
-        return result;
-    }
-
-    static unsigned int GetDefaultThreadCount()
-    {
-        unsigned int count = std::thread::hardware_concurrency();
-        return (count > 1 ? count - 1 : 1);
-    }
-
-    void WorkerImpl()
-    {
-        while (auto task = NextTask())
-        {
-            task();
-        }
-    }
-
-    bool m_running{};
-    std::mutex m_mutex;
-    std::deque<std::thread> m_workers;
-    std::deque<std::function<void()>> m_tasks;
-    std::condition_variable m_condition_variable;
-};
-
-}  // namespace
-
 #define CHECK_AND_TRACK_STATE_1(stats_enum, state) \
     if (event_state_it->Is##state##Set() && event_state_it->state()) stats_list[stats_enum]++;
 
@@ -157,24 +58,25 @@ class ThreadPool
 #define CHECK_AND_TRACK_STATE(stats_enum, ...) \
     CHECK_AND_TRACK_STATE_N(__VA_ARGS__)(stats_enum, __VA_ARGS__)
 
+// Only partially sorts the values: the median and its lower neighbour are all that's needed.
 #define GATHER_TOTAL_MIN_MAX_MEDIAN(array_name, type)                                         \
     {                                                                                         \
-        std::sort(array_name.begin(), array_name.end());                                      \
         size_t n = array_name.size();                                                         \
+        auto mid = array_name.begin() + n / 2;                                                \
+        std::nth_element(array_name.begin(), mid, array_name.end());                          \
         if (n % 2 != 0)                                                                       \
         {                                                                                     \
-            stats_list[Dive::Stats::kMedian##type] = array_name[n / 2];                       \
+            stats_list[Dive::Stats::kMedian##type] = *mid;                                    \
         }                                                                                     \
         else                                                                                  \
         {                                                                                     \
-            auto mid1 = array_name[n / 2 - 1];                                                \
-            auto mid2 = array_name[n / 2];                                                    \
+            auto mid1 = *std::max_element(array_name.begin(), mid);                           \
+            auto mid2 = *mid;                                                                 \
             stats_list[Dive::Stats::kMedian##type] = (uint64_t)((float)(mid1 + mid2) / 2.0f); \
         }                                                                                     \
-        stats_list[Dive::Stats::kMin##type] =                                                 \
-            *std::min_element(array_name.begin(), array_name.end());                          \
-        stats_list[Dive::Stats::kMax##type] =                                                 \
-            *std::max_element(array_name.begin(), array_name.end());                          \
+        auto [min_it, max_it] = std::minmax_element(array_name.begin(), array_name.end());    \
+        stats_list[Dive::Stats::kMin##type] = *min_it;                                        \
+        stats_list[Dive::Stats::kMax##type] = *max_it;                                        \
         stats_list[Dive::Stats::kTotal##type] =                                               \
             std::accumulate(array_name.begin(), array_name.end(), (uint64_t)0);               \
     }
@@ -186,25 +88,29 @@ class ThreadPool
         stats_list[Dive::Stats::k##type##Resolves]++; \
     } while (0)
 
-//--------------------------------------------------------------------------------------------------
-void TraceStats::GatherTraceStats(const Dive::Context& context,
-                                  const Dive::CaptureMetadata& meta_data,
-                                  CaptureStats& capture_stats)
+namespace
 {
-    capture_stats = CaptureStats();  // Reset any previous stats
 
+// Below this, splitting the events costs more than it saves.
+constexpr size_t kMinEventsPerChunk = 4096;
+
+// Gathers the stats of the events [begin, end) into `capture_stats`. Render passes are counted as
+// if the events before `begin` had been gathered too, so that partial stats of consecutive ranges
+// add up to the stats of the whole range. Returns false if cancelled.
+bool GatherEventStats(const Dive::Context& context, const Dive::CaptureMetadata& meta_data,
+                      size_t begin, size_t end, CaptureStats& capture_stats)
+{
     std::array<uint64_t, Dive::Stats::kNumStats>& stats_list = capture_stats.m_stats_list;
 
-    size_t event_count = meta_data.m_event_info.size();
     const Dive::EventStateInfo& event_state = meta_data.m_event_state;
 
-    Dive::RenderModeType cur_type = Dive::RenderModeType::kUnknown;
-    for (size_t i = 0; i < event_count; ++i)
+    Dive::RenderModeType cur_type = (begin > 0 ? meta_data.m_event_info[begin - 1].m_render_mode
+                                               : Dive::RenderModeType::kUnknown);
+    for (size_t i = begin; i < end; ++i)
     {
         if (context.Cancelled())
         {
-            capture_stats = CaptureStats();
-            return;
+            return false;
         }
         const Dive::EventInfo& info = meta_data.m_event_info[i];
 
@@ -316,6 +222,77 @@ void TraceStats::GatherTraceStats(const Dive::Context& context,
             if (info.m_shader_references[ref].m_shader_index != UINT32_MAX)
                 capture_stats.m_shader_ref_set.insert(info.m_shader_references[ref]);
     }
+    return true;
+}
+
+// Adds the partial stats `other`, gathered over the events following those of `capture_stats`.
+void MergeCaptureStats(CaptureStats& capture_stats, CaptureStats&& other)
+{
+    for (size_t i = 0; i < capture_stats.m_stats_list.size(); ++i)
+    {
+        capture_stats.m_stats_list[i] += other.m_stats_list[i];
+    }
+    capture_stats.m_event_num_indices.insert(capture_stats.m_event_num_indices.end(),
+                                             other.m_event_num_indices.begin(),
+                                             other.m_event_num_indices.end());
+    capture_stats.m_shader_ref_set.merge(other.m_shader_ref_set);
+    capture_stats.m_viewports.merge(other.m_viewports);
+    capture_stats.m_window_scissors.merge(other.m_window_scissors);
+    capture_stats.m_num_binning_passes += other.m_num_binning_passes;
+    capture_stats.m_num_tiling_passes += other.m_num_tiling_passes;
+}
+
+}  // namespace
+
+//--------------------------------------------------------------------------------------------------
+void TraceStats::GatherTraceStats(const Dive::Context& context,
+                                  const Dive::CaptureMetadata& meta_data,
+                                  CaptureStats& capture_stats)
+{
+    capture_stats = CaptureStats();  // Reset any previous stats
+
+    std::array<uint64_t, Dive::Stats::kNumStats>& stats_list = capture_stats.m_stats_list;
+
+    TaskScheduler& scheduler = TaskScheduler::GetDefault();
+
+    const size_t event_count = meta_data.m_event_info.size();
+    const size_t chunk_count = std::clamp<size_t>(event_count / kMinEventsPerChunk, 1,
+                                                  scheduler.GetWorkerCount() + 1);
+    const size_t chunk_size = (event_count + chunk_count - 1) / chunk_count;
+    // The first chunk is gathered straight into `capture_stats`, the others into partial stats
+    // that are merged in event order.
+    std::vector<CaptureStats> partial_stats(chunk_count - 1);
+    std::atomic<bool> cancelled = false;
+    TaskGroup event_group(scheduler, context);
+    for (size_t chunk = 1; chunk < chunk_count; ++chunk)
+    {
+        event_group.Run([&, chunk]() {
+            size_t begin = std::min(chunk * chunk_size, event_count);
+            size_t end = std::min(begin + chunk_size, event_count);
+            if (!GatherEventStats(context, meta_data, begin, end, partial_stats[chunk - 1]))
+            {
+                cancelled = true;
+            }
+        });
+    }
+    // Shaders are disassembled while the events are gathered, and used once they are.
+    TaskGroup disassembly_group(scheduler, context);
+    Dive::QueueDisassembly(disassembly_group, meta_data.m_shaders);
+
+    if (!GatherEventStats(context, meta_data, 0, std::min(chunk_size, event_count),
+                          capture_stats))
+    {
+        cancelled = true;
+    }
+    if (!event_group.Wait() || cancelled)
+    {
+        capture_stats = CaptureStats();
+        return;
+    }
+    for (CaptureStats& partial : partial_stats)
+    {
+        MergeCaptureStats(capture_stats, std::move(partial));
+    }
 
     stats_list[Dive::Stats::kNumBinningPasses] = capture_stats.m_num_binning_passes;
     stats_list[Dive::Stats::kNumTilingPasses] = capture_stats.m_num_tiling_passes;
@@ -330,23 +307,6 @@ void TraceStats::GatherTraceStats(const Dive::Context& context,
 
     stats_list[Dive::Stats::kShaders] = meta_data.m_shaders.size();
 
-    ThreadPool thread_pool;
-    if (meta_data.m_shaders.size() > 0)
-    {
-        auto task_count = static_cast<unsigned int>(meta_data.m_shaders.size());
-        thread_pool.Start(thread_pool.SuggestedNumberOfWorkers(task_count));
-        for (const Dive::Disassembly& disassembly : meta_data.m_shaders)
-        {
-            thread_pool.Run([&context, &disassembly]() {
-                if (context.Cancelled())
-                {
-                    return;
-                }
-                disassembly.EagerEval();
-            });
-        }
-    }
-
     for (const Dive::ShaderReference& ref : capture_stats.m_shader_ref_set)
     {
         if (context.Cancelled())
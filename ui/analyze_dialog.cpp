@@ -840,6 +840,7 @@ void AnalyzeDialog::DeleteReplayArtifactsImpl()
     UpdateReplayStatus(ReplayStatusUpdateCode::kDeletingReplayArtifacts);
 
     AttemptDeletingTemporaryLocalFile(m_local_capture_files.perf_counter_csv);
+    AttemptDeletingTemporaryLocalFile(m_local_capture_files.perf_counter_bin);
     AttemptDeletingTemporaryLocalFile(m_local_capture_files.gpu_timing_csv);
     AttemptDeletingTemporaryLocalFile(m_local_capture_files.pm4_rd);
 }
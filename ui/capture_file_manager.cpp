@@ -146,7 +146,9 @@ Dive::ComponentFilePaths CaptureFileManager::ResolveComponents(const Dive::FileP
             .gfxr = {},
             .gfxa = {},
             .perf_counter_csv = {},
+            .perf_counter_bin = {},
             .gpu_timing_csv = {},
+            .gpu_timing_distribution_csv = {},
             .pm4_rd = reference.value,
             .screenshot_png = {},
             .renderdoc_rdc = {},
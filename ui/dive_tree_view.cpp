@@ -723,10 +723,16 @@ void DiveTreeView::searchNodeByText(const QString& search_text)
         {
             if (vulkan_command_proxy_model)
             {
-                m_search_indexes = vulkan_command_proxy_model->match(
-                    vulkan_command_proxy_model->index(0, 0), Qt::DisplayRole,
-                    QVariant::fromValue(search_text), -1,
-                    Qt::MatchContains | Qt::MatchRecursive | Qt::MatchWrap);
+                // The source model also searches the arguments of commands that have not been
+                // expanded yet. Results that the filter hides are dropped.
+                QList<QModelIndex> source_indexes = gfxr_vulkan_command_model->search(
+                    gfxr_vulkan_command_model->index(0, 0), QVariant::fromValue(search_text));
+                for (const QModelIndex& source_index : source_indexes)
+                {
+                    QModelIndex proxy_index =
+                        vulkan_command_proxy_model->mapFromSource(source_index);
+                    if (proxy_index.isValid()) m_search_indexes.append(proxy_index);
+                }
             }
             else
             {
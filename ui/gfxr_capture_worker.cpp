@@ -20,10 +20,18 @@
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+#include "network/tcp_client.h"
 #include "utils/component_files.h"
 
 static constexpr int kStallTimeoutSeconds = 10;
 static constexpr int kFileStatusPollingIntervalMs = 50;
+// While the capture runs, the file is streamed in rounds that end after this long without new
+// data, so that a stop request is noticed even if the app pauses writing.
+static constexpr uint32_t kStreamRoundIdleTimeoutMs = 250;
+// Once the capture is stopped, the layer may still be flushing the file. The stream ends after it
+// has not grown for this long.
+static constexpr uint32_t kStreamIdleTimeoutMs = 2000;
 
 void GfxrCaptureWorker::SetGfxrSourceCaptureDir(const std::string& source_capture_dir)
 {
@@ -56,6 +64,122 @@ bool GfxrCaptureWorker::AreTimestampsCurrent(
     return true;
 }
 
+//--------------------------------------------------------------------------------------------------
+absl::StatusOr<std::string> GfxrCaptureWorker::StreamGfxrCaptureFile(Dive::AndroidDevice* device)
+{
+    // GFXR creates the capture file once the capture trigger has been set.
+    std::string gfxr_file;
+    auto start_time = std::chrono::steady_clock::now();
+    while (gfxr_file.empty())
+    {
+        absl::StatusOr<std::string> ls_output =
+            device->Adb().RunAndGetResult("shell ls " + m_source_capture_dir);
+        if (ls_output.ok())
+        {
+            for (absl::string_view line : absl::StrSplit(*ls_output, '\n', absl::SkipEmpty()))
+            {
+                std::string file_name(absl::StripSuffix(line, "\r"));
+                if (Dive::IsGfxrFile(file_name))
+                {
+                    gfxr_file = file_name;
+                    break;
+                }
+            }
+        }
+        if (gfxr_file.empty())
+        {
+            if (std::chrono::steady_clock::now() - start_time >
+                std::chrono::seconds(kStallTimeoutSeconds))
+            {
+                return absl::DeadlineExceededError("GFXR capture file was not created.");
+            }
+            QThread::msleep(kFileStatusPollingIntervalMs);
+        }
+    }
+
+    std::error_code error_code;
+    std::filesystem::create_directories(m_host_capture_dir, error_code);
+    if (error_code)
+    {
+        return absl::InternalError(absl::StrCat("Failed to create ", m_host_capture_dir.string(),
+                                                ": ", error_code.message()));
+    }
+
+    Network::TcpClient client;
+    absl::Status status = client.Connect("127.0.0.1", *m_streaming_port);
+    if (!status.ok())
+    {
+        return status;
+    }
+
+    std::string source_file = absl::StrCat(m_source_capture_dir, "/", gfxr_file);
+    std::filesystem::path host_path = m_host_capture_dir / gfxr_file;
+    qDebug() << "Begin to stream the gfxr capture file to " << host_path.generic_string().c_str();
+    auto progress = [this](size_t size) {
+        emit UpdateProgressDialog(
+            QString("Streaming GFXR Capture ... %1 MB").arg(static_cast<qulonglong>(size >> 20)));
+    };
+    // A round ending only means the app has not written anything for a while; the stream only
+    // ends with the round started after the capture was stopped.
+    uint64_t size = 0;
+    bool stopped = false;
+    while (!stopped)
+    {
+        stopped = m_stop_requested;
+        absl::StatusOr<uint64_t> streamed = client.StreamFileFromServer(
+            source_file, host_path.string(),
+            stopped ? kStreamIdleTimeoutMs : kStreamRoundIdleTimeoutMs, size, progress);
+        if (!streamed.ok())
+        {
+            return streamed.status();
+        }
+        size = *streamed;
+    }
+    qDebug() << "Streamed " << static_cast<qulonglong>(size) << " bytes of " << gfxr_file.c_str();
+    return gfxr_file;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool GfxrCaptureWorker::CompleteStreamedFile(Dive::AndroidDevice* device,
+                                             const std::string& source_file,
+                                             const std::filesystem::path& host_path)
+{
+    absl::StatusOr<std::string> remote_size_str =
+        device->Adb().RunAndGetResult(absl::StrCat("shell stat -c %s ", source_file));
+    qlonglong remote_size = 0;
+    if (!remote_size_str.ok() ||
+        !absl::SimpleAtoi(absl::StripSuffix(*remote_size_str, "\r"), &remote_size))
+    {
+        return false;
+    }
+    std::error_code error_code;
+    auto local_size = std::filesystem::file_size(host_path, error_code);
+    if (error_code)
+    {
+        return false;
+    }
+
+    if (static_cast<qlonglong>(local_size) < remote_size)
+    {
+        // The file is no longer written to, so the tail is read without waiting for more data.
+        Network::TcpClient client;
+        if (!client.Connect("127.0.0.1", *m_streaming_port).ok())
+        {
+            return false;
+        }
+        absl::StatusOr<uint64_t> size = client.StreamFileFromServer(
+            source_file, host_path.string(), /*idle_timeout_ms=*/0, local_size);
+        if (!size.ok())
+        {
+            qDebug() << "Failed to stream the end of " << source_file.c_str() << ": "
+                     << size.status().message().data();
+            return false;
+        }
+        local_size = *size;
+    }
+    return static_cast<qlonglong>(local_size) == remote_size;
+}
+
 //--------------------------------------------------------------------------------------------------
 absl::StatusOr<qlonglong> GfxrCaptureWorker::getGfxrCaptureDirectorySize(
     Dive::AndroidDevice* device)
@@ -212,6 +336,25 @@ void GfxrCaptureWorker::run()
         return;
     }
 
+    if (m_streaming_port.has_value())
+    {
+        absl::StatusOr<std::string> streamed_file = StreamGfxrCaptureFile(device);
+        if (streamed_file.ok())
+        {
+            m_streamed_file = *streamed_file;
+        }
+        else
+        {
+            // The capture is downloaded once it is complete instead.
+            qDebug() << "Failed to stream gfxr capture, falling back to download: "
+                     << streamed_file.status().message().data();
+            while (!m_stop_requested)
+            {
+                QThread::msleep(kFileStatusPollingIntervalMs);
+            }
+        }
+    }
+
     qlonglong capture_directory_size = 0;
     {
         absl::StatusOr<qlonglong> ret = getGfxrCaptureDirectorySize(device);
@@ -245,7 +388,16 @@ void GfxrCaptureWorker::run()
         // Source path is intended for Android, cannot use std::filesystem here
         std::string source_file = absl::StrCat(m_source_capture_dir, "/", filename.string());
 
-        auto retrieve_file = device->RetrieveFile(source_file, m_host_capture_dir.string());
+        absl::Status retrieve_file;
+        if (file == m_streamed_file && CompleteStreamedFile(device, source_file, host_path))
+        {
+            // Already on the host; only remove it from the device, as RetrieveFile() does.
+            retrieve_file = device->Adb().Run(absl::StrCat("shell rm ", source_file));
+        }
+        else
+        {
+            retrieve_file = device->RetrieveFile(source_file, m_host_capture_dir.string());
+        }
 
         if (!retrieve_file.ok())
         {
@@ -18,7 +18,9 @@
 
 #include <qobject.h>
 
+#include <atomic>
 #include <filesystem>
+#include <optional>
 
 #include "capture_service/device_mgr.h"
 #include "capture_worker.h"
@@ -32,12 +34,32 @@ class GfxrCaptureWorker : public CaptureWorker
 
     void run() override;
     void SetGfxrSourceCaptureDir(const std::string& source_capture_dir);
+    // Streams the capture file through the Dive server forwarded to `port` while the capture is
+    // still being written, instead of waiting for it to finish before downloading. The worker must
+    // then be started when the capture starts, and StopStreaming() called once it is stopped.
+    void SetStreamingPort(int port) { m_streaming_port = port; }
+    // Tells a streaming worker that the capture trigger has been cleared, so the capture file is
+    // complete once the layer stops writing it. May be called from any thread.
+    void StopStreaming() { m_stop_requested = true; }
     bool AreTimestampsCurrent(Dive::AndroidDevice* device,
                               const std::map<std::string, std::string>& previous_timestamps);
     absl::StatusOr<qlonglong> getGfxrCaptureDirectorySize(Dive::AndroidDevice* device);
 
  private:
+    // Waits for the capture file to be created on the device, then streams it to the host capture
+    // directory until the capture is stopped and the file stops growing. Returns the name of the
+    // streamed file.
+    absl::StatusOr<std::string> StreamGfxrCaptureFile(Dive::AndroidDevice* device);
+    // Transfers whatever was appended to a streamed file after its stream ended. Returns true if
+    // the local copy is then as large as the file on the device.
+    bool CompleteStreamedFile(Dive::AndroidDevice* device, const std::string& source_file,
+                              const std::filesystem::path& host_path);
+
     std::string m_source_capture_dir;  // On Android, better to keep as std::string since the
                                        // host platform delimiter may be inconsistent
     std::vector<std::string> m_file_list;
+    std::optional<int> m_streaming_port;
+    std::atomic<bool> m_stop_requested = false;
+    // Capture file already transferred by streaming; empty if nothing was streamed.
+    std::string m_streamed_file;
 };
@@ -116,6 +116,9 @@ void GfxrVulkanCommandArgumentsTabView::OnSelectionChanged(const QModelIndex& in
         }
     }
 
+    // The argument nodes are only created once the command is selected.
+    m_command_hierarchy_model->ExpandNode(source_index);
+
     // Always use the source_index, regardless of whether a proxy was involved.
     m_arg_proxy_model->SetTargetParentSourceIndex(source_index);
 
@@ -29,7 +29,7 @@ static_assert(sizeof(void*) == sizeof(uint64_t),
 // =================================================================================================
 // GfxrVulkanCommandModel
 // =================================================================================================
-GfxrVulkanCommandModel::GfxrVulkanCommandModel(const Dive::CommandHierarchy& command_hierarchy)
+GfxrVulkanCommandModel::GfxrVulkanCommandModel(Dive::CommandHierarchy& command_hierarchy)
     : m_command_hierarchy(command_hierarchy),
       m_topology_ptr(nullptr),
       m_vulkan_command_tool_tip_summaries(GetVulkanCommandToolTipSummaries())
@@ -62,6 +62,22 @@ void GfxrVulkanCommandModel::SetTopologyToView(const Dive::Topology* topology_pt
     EndResetModel();
 }
 
+//--------------------------------------------------------------------------------------------------
+void GfxrVulkanCommandModel::ExpandNode(const QModelIndex& index)
+{
+    if (!index.isValid() || index.model() != this || m_topology_ptr == nullptr) return;
+
+    uint64_t node_index = index.internalId();
+    int num_pending_children =
+        static_cast<int>(m_command_hierarchy.GetNumPendingChildren(node_index));
+    if (num_pending_children == 0) return;
+
+    // The new children go in front of the existing ones
+    beginInsertRows(index, 0, num_pending_children - 1);
+    m_command_hierarchy.ExpandNode(node_index);
+    endInsertRows();
+}
+
 //--------------------------------------------------------------------------------------------------
 QVariant GfxrVulkanCommandModel::data(const QModelIndex& index, int role) const
 {
@@ -229,7 +245,10 @@ QList<QModelIndex> GfxrVulkanCommandModel::search(const QModelIndex& start,
 
         if (text.isEmpty()) text = value.toString();
         QString t = v.toString();
-        if (t.contains(text, cs)) result.append(idx);
+        // Argument nodes that are not created yet are searched too, and match their command
+        if (t.contains(text, cs) ||
+            m_command_hierarchy.PendingChildrenContain(idx.internalId(), text.toStdString()))
+            result.append(idx);
 
         // Search the hierarchy
         if (hasChildren(idx))
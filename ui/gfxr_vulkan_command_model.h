@@ -32,7 +32,7 @@ class GfxrVulkanCommandModel : public QAbstractItemModel
     Q_OBJECT
 
  public:
-    explicit GfxrVulkanCommandModel(const Dive::CommandHierarchy& command_hierarchy);
+    explicit GfxrVulkanCommandModel(Dive::CommandHierarchy& command_hierarchy);
     ~GfxrVulkanCommandModel();
 
     void Reset();
@@ -40,6 +40,9 @@ class GfxrVulkanCommandModel : public QAbstractItemModel
     void EndResetModel();
     void SetTopologyToView(const Dive::Topology* topology_ptr);
 
+    // Creates the argument nodes of a command, which are only created when first shown
+    void ExpandNode(const QModelIndex& index);
+
     QVariant data(const QModelIndex& index, int role) const override;
     Qt::ItemFlags flags(const QModelIndex& index) const override;
     QVariant headerData(int section, Qt::Orientation orientation,
@@ -58,7 +61,7 @@ class GfxrVulkanCommandModel : public QAbstractItemModel
  private:
     void BuildNodeLookup(const QModelIndex& parent = QModelIndex()) const;
 
-    const Dive::CommandHierarchy& m_command_hierarchy;
+    Dive::CommandHierarchy& m_command_hierarchy;
     const Dive::Topology* m_topology_ptr;
     const std::unordered_map<std::string, const char*>& m_vulkan_command_tool_tip_summaries;
     mutable std::vector<QPersistentModelIndex> m_node_lookup;
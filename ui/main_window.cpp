@@ -269,7 +269,7 @@ MainWindow::MainWindow(ApplicationController& controller) : m_controller(control
 
         m_command_hierarchy_model = new CommandModel(m_data_core->GetCommandHierarchy());
         m_gfxr_vulkan_command_hierarchy_model =
-            new GfxrVulkanCommandModel(m_data_core->GetCommandHierarchy());
+            new GfxrVulkanCommandModel(m_data_core->GetMutableCommandHierarchy());
 
         m_command_hierarchy_view = new DiveTreeView(m_data_core->GetCommandHierarchy());
         m_command_hierarchy_view->SetDataCore(m_data_core.get());
@@ -1078,8 +1078,19 @@ void MainWindow::OnPendingScreenshot(const QString& file_name)
 //--------------------------------------------------------------------------------------------------
 void MainWindow::EmitLoadAssociatedFileTasks(const Dive::ComponentFilePaths& components)
 {
-    if (!components.perf_counter_csv.empty() &&
-        std::filesystem::exists(components.perf_counter_csv))
+    // The binary copy is written when the .csv is first loaded, and is much faster to load
+    if (!components.perf_counter_bin.empty() &&
+        std::filesystem::exists(components.perf_counter_bin) &&
+        (!std::filesystem::exists(components.perf_counter_csv) ||
+         std::filesystem::last_write_time(components.perf_counter_bin) >=
+             std::filesystem::last_write_time(components.perf_counter_csv)))
+    {
+        qDebug() << "Attempting to load perf counter data from: "
+                 << components.perf_counter_bin.string().c_str();
+        PendingPerfCounterResults(QString::fromStdString(components.perf_counter_bin.string()));
+    }
+    else if (!components.perf_counter_csv.empty() &&
+             std::filesystem::exists(components.perf_counter_csv))
     {
         qDebug() << "Attempting to load perf counter data from: "
                  << components.perf_counter_csv.string().c_str();
@@ -21,6 +21,7 @@
 
 #include "dive_core/available_metrics.h"
 #include "dive_core/perf_metrics_data.h"
+#include "utils/component_files_constants.h"
 
 struct FixedHeader
 {
@@ -55,7 +56,22 @@ void PerfCounterModel::OnPerfCounterResultsGenerated(
         return;
     }
 
-    auto perf_metrics_data = Dive::PerfMetricsData::LoadFromCsv(file_path, *available_metrics);
+    std::unique_ptr<Dive::PerfMetricsData> perf_metrics_data;
+    if (file_path.extension() == Dive::ComponentFileConstants::kPerfMetricsExt)
+    {
+        perf_metrics_data = Dive::PerfMetricsData::LoadFromBinary(file_path, *available_metrics);
+    }
+    else
+    {
+        perf_metrics_data = Dive::PerfMetricsData::LoadFromCsv(file_path, *available_metrics);
+        // Keep a binary copy next to the .csv, so that the capture loads faster next time
+        std::filesystem::path binary_path = file_path;
+        binary_path.replace_extension(Dive::ComponentFileConstants::kPerfMetricsExt);
+        if (perf_metrics_data && !perf_metrics_data->WriteBinary(binary_path))
+        {
+            qDebug() << "Could not write perf counter data to: " << binary_path.string().c_str();
+        }
+    }
     m_perf_metrics_data_provider =
         Dive::PerfMetricsDataProvider::Create(std::move(perf_metrics_data));
     m_perf_metrics_data_provider->Analyze();
@@ -78,7 +94,6 @@ void PerfCounterModel::LoadData()
 
     m_headers = headers;
     m_column_count = static_cast<int>(m_headers.size());
-    m_perf_metrics_record = m_perf_metrics_data_provider->GetComputedRecords();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -89,7 +104,7 @@ QModelIndex PerfCounterModel::index(int row, int column, const QModelIndex& pare
         return QModelIndex();
     }
 
-    const size_t num_rows = m_perf_metrics_record.size();
+    const size_t num_rows = m_perf_metrics_data_provider->GetComputedRecords().size();
 
     if (row < 0 || static_cast<size_t>(row) >= num_rows || column < 0 || column >= columnCount())
     {
@@ -108,7 +123,7 @@ int PerfCounterModel::rowCount(const QModelIndex& parent) const
     {
         return 0;
     }
-    return static_cast<int>(m_perf_metrics_record.size());
+    return static_cast<int>(m_perf_metrics_data_provider->GetComputedRecords().size());
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -129,7 +144,7 @@ QVariant PerfCounterModel::data(const QModelIndex& index, int role) const
         return QVariant(Qt::AlignRight);
     }
 
-    if (role != Qt::DisplayRole)
+    if (role != Qt::DisplayRole && role != Qt::ToolTipRole)
     {
         return QVariant();
     }
@@ -137,13 +152,12 @@ QVariant PerfCounterModel::data(const QModelIndex& index, int role) const
     int row = index.row();
     int col = index.column();
 
-    if (static_cast<size_t>(row) >= m_perf_metrics_record.size())
+    const Dive::PerfMetricsColumns& records = m_perf_metrics_data_provider->GetComputedRecords();
+    if (static_cast<size_t>(row) >= records.size())
     {
         return QVariant();
     }
 
-    const auto& record = m_perf_metrics_record.at(row);
-
     if (col >= m_headers.length())
     {
         return QVariant();
@@ -151,22 +165,43 @@ QVariant PerfCounterModel::data(const QModelIndex& index, int role) const
 
     if (col < FixedHeader::kFixedHeaderCount)
     {
+        if (role == Qt::ToolTipRole)
+        {
+            return QVariant();
+        }
         switch (col)
         {
             case FixedHeader::kDrawID:
-                return record.m_draw_id;
+                return records.GetDrawIds()[row];
             case FixedHeader::kLRZState:
-                return record.m_lrz_state;
+                return records.GetLRZStates()[row];
             default:
                 return QVariant();
         }
     }
 
     int metric_col_index = col - FixedHeader::kFixedHeaderCount;
-    if (static_cast<size_t>(metric_col_index) < record.m_metric_values.size())
+    if (static_cast<size_t>(metric_col_index) < records.GetMetricCount())
     {
-        const auto& metric_value = record.m_metric_values.at(metric_col_index);
-        return metric_value;
+        if (role == Qt::ToolTipRole)
+        {
+            // The value is a mean over the frames, so show the distribution behind it
+            const Dive::PerfMetricsStats& stats =
+                m_perf_metrics_data_provider->GetComputedStats(row, metric_col_index);
+            QString tool_tip = QString("Mean of %1 frames\nMedian: %2\nMin: %3\nMax: %4\n"
+                                       "Standard deviation: %5")
+                                   .arg(stats.m_sample_count)
+                                   .arg(stats.m_median)
+                                   .arg(stats.m_min)
+                                   .arg(stats.m_max)
+                                   .arg(stats.m_stddev);
+            if (stats.m_has_outliers)
+            {
+                tool_tip += "\nHas outliers";
+            }
+            return tool_tip;
+        }
+        return records.GetMetricValue(row, metric_col_index);
     }
 
     return QVariant();
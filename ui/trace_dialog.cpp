@@ -875,7 +875,15 @@ void TraceDialog::OnGfxrCaptureClicked()
             return;
         }
 
-        RetrieveGfxrCapture();
+        // A streaming worker finishes the transfer once the layer has stopped writing the file.
+        if (m_gfxr_streaming_worker)
+        {
+            m_gfxr_streaming_worker->StopStreaming();
+        }
+        else
+        {
+            RetrieveGfxrCapture();
+        }
 
         m_gfxr_capture_button->setText(kStartGfxrRuntimeCapture);
         m_gfxr_capture_button->setEnabled(true);
@@ -923,12 +931,19 @@ void TraceDialog::OnGfxrCaptureClicked()
             return;
         }
 
+        // With a Dive server reachable on the device, the capture is transferred while it is
+        // being written rather than after it is retrieved.
+        if (device->Port().has_value())
+        {
+            RetrieveGfxrCapture(/*stream=*/true);
+        }
+
         m_gfxr_capture_button->setText(kRetrieveGfxrRuntimeCapture);
         m_run_button->setEnabled(false);
     }
 }
 
-void TraceDialog::RetrieveGfxrCapture()
+void TraceDialog::RetrieveGfxrCapture(bool stream)
 {
     Dive::AndroidDevice* device = GetAndValidateDevice();
     if (device == nullptr)
@@ -963,9 +978,21 @@ void TraceDialog::RetrieveGfxrCapture()
                 }
                 progress_bar->setValue(percentage);
             });
+    if (stream)
+    {
+        workerThread->SetStreamingPort(*device->Port());
+        progress_bar->setLabelText("Streaming GFXR Capture ... ");
+        connect(workerThread, &GfxrCaptureWorker::UpdateProgressDialog, progress_bar,
+                &QProgressDialog::setLabelText);
+        m_gfxr_streaming_worker = workerThread;
+    }
     workerThread->start();
 
-    m_gfxr_capture_button->setEnabled(false);
+    // The capture keeps running while it is streamed, so it must still be possible to stop it.
+    if (!stream)
+    {
+        m_gfxr_capture_button->setEnabled(false);
+    }
 }
 
 void TraceDialog::UpdateCaptureFileDirectories(std::string on_device_capture_file_directory)
@@ -1013,6 +1040,11 @@ void TraceDialog::SetTraceDialogForCapture()
 
 void TraceDialog::ResetTraceDialogOnAppStop()
 {
+    // The capture cannot grow anymore once the app has stopped.
+    if (m_gfxr_streaming_worker)
+    {
+        m_gfxr_streaming_worker->StopStreaming();
+    }
     m_run_button->setEnabled(true);
     m_run_button->setText(kStartApplication);
     m_gfxr_capture_button->setEnabled(false);
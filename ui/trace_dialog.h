@@ -17,6 +17,7 @@
 #include <qspinbox.h>
 
 #include <QDialog>
+#include <QPointer>
 #include <QSortFilterProxyModel>
 #include <QThread>
 #include <cstdint>
@@ -44,6 +45,7 @@ class QRadioButton;
 class QButtonGroup;
 
 class ApplicationController;
+class GfxrCaptureWorker;
 
 class AppTypeFilterModel : public QSortFilterProxyModel
 {
@@ -73,7 +75,9 @@ class DIVE_UI_LIB_EXPORT TraceDialog : public DeviceDialog
     void ShowGfxrFields();
     void HideGfxrFields();
     void EnableDialogInputs(bool enable);
-    void RetrieveGfxrCapture();
+    // Downloads the GFXR capture. With `stream`, the worker starts right away and streams the
+    // capture file while it is being written.
+    void RetrieveGfxrCapture(bool stream = false);
     Dive::AndroidDevice* GetAndValidateDevice();
     void SetResetDialogOnClose(bool reset) { m_dialog_reset_on_close = reset; }
     void UpdateCaptureFileDirectories(std::string on_device_capture_file_directory = "");
@@ -162,6 +166,8 @@ class DIVE_UI_LIB_EXPORT TraceDialog : public DeviceDialog
     std::string m_command_args;
     std::string m_on_device_capture_file_directory;
     bool m_gfxr_capture = false;
+    // Worker started with the capture to stream it to the host; null when not streaming.
+    QPointer<GfxrCaptureWorker> m_gfxr_streaming_worker;
     // m_dialog_reset_on_close is true by default, meaning that when the dialog is closed it will
     // perform the usual cleanup and reset flow. However, in some cases such as when the dialog is
     // being used by plugins, this behavior may not be desired. In those cases, this flag can be set